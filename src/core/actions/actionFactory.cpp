@@ -68,8 +68,12 @@ Action makeAction(ID id, ID channelId, Frame frame, MidiEvent e)
 Action makeAction(const Patch::Action& a)
 {
 	actionId_.set(a.id);
-	return Action{a.id, a.channelId, a.frame,
-	    MidiEvent::makeFromRaw(a.event, /*numBytes=*/3), -1, -1, a.prevId, a.nextId};
+
+	MidiEvent e = MidiEvent::makeFromRaw(a.event, /*numBytes=*/3);
+	if (a.pluginId != -1)
+		e.setVelocityFloat(a.value);
+
+	return Action{a.id, a.channelId, a.frame, e, a.pluginId, a.pluginParam, a.prevId, a.nextId};
 }
 
 /* -------------------------------------------------------------------------- */
@@ -131,6 +135,9 @@ std::vector<Patch::Action> serializeActions(const model::Actions::Map& actions)
 			    a.event.getRaw(),
 			    a.prevId,
 			    a.nextId,
+			    a.pluginId,
+			    a.pluginParam,
+			    a.event.getVelocityFloat(),
 			});
 		}
 	}
@@ -0,0 +1,118 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#include "core/actions/actionIndex.h"
+#include <algorithm>
+#include <cassert>
+
+namespace giada::m
+{
+namespace
+{
+Frame getEnd_(const Action& a, Frame framesInLoop)
+{
+	if (a.next == nullptr)
+		return a.frame + 1;
+	if (a.next->frame > a.frame)
+		return a.next->frame;
+	return std::max(framesInLoop, a.frame + 1); // Ring-loop
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+ActionIndex::ActionIndex(std::vector<Action> actions, Frame framesInLoop)
+: m_actions(std::move(actions))
+{
+	assert(std::is_sorted(m_actions.begin(), m_actions.end(),
+	    [](const Action& a, const Action& b) { return a.frame < b.frame; }));
+
+	m_ends.reserve(m_actions.size());
+	m_maxEnds.reserve(m_actions.size());
+
+	Frame maxEnd = 0;
+	for (const Action& a : m_actions)
+	{
+		const Frame end = getEnd_(a, framesInLoop);
+		maxEnd          = std::max(maxEnd, end);
+		m_ends.push_back(end);
+		m_maxEnds.push_back(maxEnd);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::size_t ActionIndex::size() const
+{
+	return m_actions.size();
+}
+
+bool ActionIndex::empty() const
+{
+	return m_actions.empty();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void ActionIndex::forEachInRange(Frame a, Frame b, std::function<void(const Action&)> f) const
+{
+	/* Actions before 'first' all end at or before 'a', so they can't overlap
+	the range. Scan from there until actions start past the range. */
+
+	const auto  it    = std::upper_bound(m_maxEnds.begin(), m_maxEnds.end(), a);
+	std::size_t first = std::distance(m_maxEnds.begin(), it);
+
+	for (std::size_t i = first; i < m_actions.size() && m_actions[i].frame < b; i++)
+		if (m_ends[i] > a)
+			f(m_actions[i]);
+}
+
+/* -------------------------------------------------------------------------- */
+
+const Action* ActionIndex::findBefore(Frame f, std::function<bool(const Action&)> p) const
+{
+	const auto it = std::lower_bound(m_actions.begin(), m_actions.end(), f,
+	    [](const Action& a, Frame f) { return a.frame < f; });
+
+	for (auto r = std::make_reverse_iterator(it); r != m_actions.rend(); ++r)
+		if (p(*r))
+			return &*r;
+	return nullptr;
+}
+
+const Action* ActionIndex::findAfter(Frame f, std::function<bool(const Action&)> p) const
+{
+	const auto it = std::lower_bound(m_actions.begin(), m_actions.end(), f,
+	    [](const Action& a, Frame f) { return a.frame < f; });
+
+	for (auto i = it; i != m_actions.end(); ++i)
+		if (p(*i))
+			return &*i;
+	return nullptr;
+}
+} // namespace giada::m
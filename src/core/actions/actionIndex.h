@@ -0,0 +1,89 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef G_ACTION_INDEX_H
+#define G_ACTION_INDEX_H
+
+#include "core/actions/action.h"
+#include "core/types.h"
+#include <functional>
+#include <vector>
+
+namespace giada::m
+{
+/* ActionIndex
+Read-only interval index over the actions of a channel. Each action covers the
+span [frame, end), where 'end' is the frame of the next action for a composite
+action (e.g. note on/note off), the end of the loop for a ring-loop one and
+frame + 1 otherwise. Lets the Action Editor visit only the actions that fall in
+the visible window, without scanning all of them. */
+
+class ActionIndex
+{
+public:
+	ActionIndex() = default;
+
+	/* ActionIndex (1)
+	Builds the index out of a vector of actions, sorted by frame. */
+
+	ActionIndex(std::vector<Action>, Frame framesInLoop);
+
+	std::size_t size() const;
+	bool        empty() const;
+
+	/* forEachInRange
+	Calls 'f' on each action whose span overlaps [a, b), in frame order. */
+
+	void forEachInRange(Frame a, Frame b, std::function<void(const Action&)> f) const;
+
+	/* findBefore, findAfter
+	Return the last action starting before 'f' or the first one starting at or
+	after 'f' that satisfies the predicate. Nullptr if not found. */
+
+	const Action* findBefore(Frame f, std::function<bool(const Action&)> p) const;
+	const Action* findAfter(Frame f, std::function<bool(const Action&)> p) const;
+
+private:
+	/* m_actions
+	Actions sorted by frame. */
+
+	std::vector<Action> m_actions;
+
+	/* m_ends
+	Span end of each action, parallel to m_actions. */
+
+	std::vector<Frame> m_ends;
+
+	/* m_maxEnds
+	Running maximum of the span ends: m_maxEnds[i] is the farthest frame
+	reached by any of the actions in [0, i]. Being monotonic, it can be binary
+	searched to find the first action that might overlap a range. */
+
+	std::vector<Frame> m_maxEnds;
+};
+} // namespace giada::m
+
+#endif
@@ -32,6 +32,7 @@
 #include "core/model/model.h"
 #include "core/patch.h"
 #include "utils/log.h"
+#include "utils/vector.h"
 #include "utils/ver.h"
 #include <algorithm>
 #include <cassert>
@@ -43,24 +44,53 @@ namespace giada::m
 {
 namespace
 {
-constexpr int MAX_LIVE_RECS_CHUNK = 128;
+constexpr int MAX_LIVE_PRODUCERS = 2; // MIDI thread and main thread
 } // namespace
 
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
-ActionRecorder::ActionRecorder(model::Model& m)
+ActionRecorder::ActionRecorder(model::Model& m, Scheduler& s)
 : m_model(m)
+, m_scheduler(s)
+, m_liveQueue(G_DEFAULT_LIVE_RECS_CAPACITY, 0, MAX_LIVE_PRODUCERS) // See https://github.com/cameron314/concurrentqueue#preallocation-correctly-using-try_enqueue
+, m_liveRecorded(0)
+, m_liveDropped(0)
+{
+	m_liveTask = m_scheduler.addTask("ActionRecorder live", [this]() {
+		std::scoped_lock lock(m_liveMutex);
+		drainLiveEvents();
+	});
+}
+
+/* -------------------------------------------------------------------------- */
+
+void ActionRecorder::init(int capacity)
 {
-	m_liveActions.reserve(MAX_LIVE_RECS_CHUNK);
+	capacity = std::max(capacity, 1);
+
+	std::scoped_lock lock(m_liveMutex);
+
+	m_liveQueue = moodycamel::ConcurrentQueue<LiveEvent>(capacity, 0, MAX_LIVE_PRODUCERS);
+	m_liveActions.reserve(capacity);
 }
 
 /* -------------------------------------------------------------------------- */
 
 void ActionRecorder::reset()
 {
-	m_liveActions.clear();
+	{
+		std::scoped_lock lock(m_liveMutex);
+
+		LiveEvent e;
+		while (m_liveQueue.try_dequeue(e))
+			;
+		m_liveActions.clear();
+		m_liveNotesOn.clear();
+	}
+	m_liveRecorded.store(0);
+	m_liveDropped.store(0);
 	actionFactory::reset();
 	m_model.get().actions.clearAll();
 	m_model.swap(model::SwapType::NONE);
@@ -103,14 +133,24 @@ void ActionRecorder::updateBpm(float ratio, int quantizerStep)
 /* -------------------------------------------------------------------------- */
 
 void ActionRecorder::updateSamplerate(int systemRate, int patchRate)
+{
+	if (systemRate == patchRate)
+		return;
+
+	updateSamplerate(m_model.get().actions, systemRate, patchRate);
+	m_model.swap(model::SwapType::NONE);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void ActionRecorder::updateSamplerate(model::Actions& actions, int systemRate, int patchRate)
 {
 	if (systemRate == patchRate)
 		return;
 
 	float ratio = systemRate / (float)patchRate;
 
-	m_model.get().actions.updateKeyFrames([=](Frame old) { return floorf(old * ratio); });
-	m_model.swap(model::SwapType::NONE);
+	actions.updateKeyFrames([=](Frame old) { return floorf(old * ratio); });
 }
 
 /* -------------------------------------------------------------------------- */
@@ -122,7 +162,10 @@ bool ActionRecorder::cloneActions(ID channelId, ID newChannelId)
 	std::unordered_map<ID, ID> map; // Action ID mapper, old -> new
 
 	m_model.get().actions.forEachAction([&](const Action& a) {
-		if (a.channelId != channelId)
+		/* Plug-in automation refers to plug-ins of the original channel: the
+		clone gets its own plug-in instances, so it's not cloned. */
+
+		if (a.channelId != channelId || a.pluginId != -1)
 			return;
 
 		ID newActionId = actionFactory::getNewActionId();
@@ -149,7 +192,7 @@ bool ActionRecorder::cloneActions(ID channelId, ID newChannelId)
 
 	m_model.get().actions.rec(actions);
 	m_model.get().channels.get(newChannelId).hasActions = true;
-	m_model.swap(model::SwapType::HARD);
+	m_model.swap(model::SwapType::HARD, {model::Change::ACTIONS, newChannelId});
 
 	return cloned;
 }
@@ -160,11 +203,55 @@ void ActionRecorder::liveRec(ID channelId, MidiEvent e, Frame globalFrame)
 {
 	assert(e.isNoteOnOff()); // Can't record any other kind of events for now
 
-	/* TODO - this might allocate on the MIDI thread */
-	if (m_liveActions.size() >= m_liveActions.capacity())
-		m_liveActions.reserve(m_liveActions.size() + MAX_LIVE_RECS_CHUNK);
+	/* The frame is captured right now, while the ID is assigned later on by the
+	consolidation: the ID generator is not thread-safe. */
 
-	m_liveActions.push_back(actionFactory::makeAction(actionFactory::getNewActionId(), channelId, globalFrame, e));
+	enqueueLiveEvent({channelId, globalFrame, e});
+}
+
+/* -------------------------------------------------------------------------- */
+
+void ActionRecorder::liveRecPluginParam(ID channelId, ID pluginId, int paramIndex,
+    float value, Frame globalFrame)
+{
+	assert(value >= 0.0f && value <= 1.0f);
+
+	/* A plug-in not bound to any channel can't be automated. Channels that no
+	longer exist are filtered out later on, by consolidate(). */
+
+	if (channelId == 0)
+		return;
+
+	/* Plug-in parameters are stored as CC events: the 7-bit value is just a
+	rough copy for display purposes, the actual one lives in the event's float
+	velocity. */
+
+	MidiEvent e = MidiEvent::makeFrom3Bytes(MidiEvent::CHANNEL_CC, paramIndex & 0x7F,
+	    static_cast<int>(value * G_MAX_VELOCITY));
+	e.setVelocityFloat(value);
+
+	enqueueLiveEvent({channelId, globalFrame, e, pluginId, paramIndex});
+}
+
+/* -------------------------------------------------------------------------- */
+
+void ActionRecorder::enqueueLiveEvent(const LiveEvent& e)
+{
+	if (!m_liveQueue.try_enqueue(e))
+	{
+		m_liveDropped.fetch_add(1);
+		return;
+	}
+
+	m_liveRecorded.fetch_add(1);
+	m_scheduler.notify(m_liveTask);
+}
+
+/* -------------------------------------------------------------------------- */
+
+ActionRecorder::LiveStats ActionRecorder::getLiveStats() const
+{
+	return {m_liveRecorded.load(), m_liveDropped.load()};
 }
 
 /* -------------------------------------------------------------------------- */
@@ -340,8 +427,32 @@ void ActionRecorder::updateVelocity(const Action& a, int value)
 
 std::unordered_set<ID> ActionRecorder::consolidate()
 {
-	for (auto it = m_liveActions.begin(); it != m_liveActions.end(); ++it)
-		consolidate(*it, it - m_liveActions.begin()); // Pass current index
+	std::scoped_lock lock(m_liveMutex);
+
+	/* Most of the live actions have already been drained and linked in
+	background while recording: only the last few are left. */
+
+	drainLiveEvents();
+
+	/* Replace temporary IDs with real ones, siblings included. */
+
+	for (Action& a : m_liveActions)
+		a.id = actionFactory::getNewActionId();
+	for (Action& a : m_liveActions)
+	{
+		if (a.prevId != 0)
+			a.prevId = m_liveActions[a.prevId - 1].id;
+		if (a.nextId != 0)
+			a.nextId = m_liveActions[a.nextId - 1].id;
+	}
+
+	/* Drop actions of channels deleted while recording. Composite actions
+	belong to a single channel, so they go away in pairs. */
+
+	const model::Channels& channels = m_model.get().channels;
+	u::vector::removeIf(m_liveActions, [&channels](const Action& a) {
+		return !channels.anyOf([&a](const Channel& c) { return c.id == a.channelId; });
+	});
 
 	m_model.get().actions.rec(m_liveActions);
 	m_model.swap(model::SwapType::SOFT);
@@ -351,6 +462,7 @@ std::unordered_set<ID> ActionRecorder::consolidate()
 		out.insert(action.channelId);
 
 	m_liveActions.clear();
+	m_liveNotesOn.clear();
 	return out;
 }
 
@@ -361,7 +473,7 @@ void ActionRecorder::clearAllActions()
 	for (Channel& ch : m_model.get().channels.getAll())
 		ch.hasActions = false;
 	m_model.get().actions.clearAll();
-	m_model.swap(model::SwapType::HARD);
+	m_model.swap(model::SwapType::HARD, model::Change::ACTIONS);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -396,25 +508,49 @@ bool ActionRecorder::isSinglePressMode(ID channelId) const
 
 /* -------------------------------------------------------------------------- */
 
-void ActionRecorder::consolidate(const Action& a1, std::size_t i)
+void ActionRecorder::drainLiveEvents()
 {
-	/* This algorithm must start searching from the element next to 'a1': since 
-	live actions are recorded in linear sequence, the potential partner of 'a1' 
-	always lies beyond a1 itself. Without this trick (i.e. if it loops from 
-	vector.begin() each time) the algorithm would end up matching wrong partners. */
+	/* Live events come in linear sequence, so the partner of a NOTE_OFF is the
+	last NOTE_ON on the same channel and note not yet linked to anything. */
 
-	for (auto it = m_liveActions.begin() + i; it != m_liveActions.end(); ++it)
+	LiveEvent e;
+	while (m_liveQueue.try_dequeue(e))
 	{
+		/* Temporary ID, i.e. position + 1: real IDs are given on the main 
+		thread by consolidate(), along with all the other actions. */
+
+		Action& a2     = m_liveActions.emplace_back();
+		a2.id          = static_cast<ID>(m_liveActions.size());
+		a2.channelId   = e.channelId;
+		a2.frame       = e.frame;
+		a2.event       = e.event;
+		a2.pluginId    = e.pluginId;
+		a2.pluginParam = e.pluginParam;
 
-		const Action& a2 = *it;
+		/* Plug-in automation points stand alone: no partner to look for. */
 
-		if (!areComposite(a1, a2))
+		if (a2.pluginId != -1)
 			continue;
 
-		const_cast<Action&>(a1).nextId = a2.id;
-		const_cast<Action&>(a2).prevId = a1.id;
+		const std::pair<ID, int> key = {a2.channelId, a2.event.getNote()};
 
-		break;
+		if (a2.event.getStatus() == MidiEvent::CHANNEL_NOTE_ON)
+		{
+			m_liveNotesOn[key] = m_liveActions.size() - 1;
+			continue;
+		}
+
+		const auto it = m_liveNotesOn.find(key);
+		if (it == m_liveNotesOn.end())
+			continue;
+
+		Action& a1 = m_liveActions[it->second];
+		if (areComposite(a1, a2))
+		{
+			a1.nextId = a2.id;
+			a2.prevId = a1.id;
+		}
+		m_liveNotesOn.erase(it);
 	}
 }
 
@@ -472,14 +608,14 @@ void ActionRecorder::clearChannel(ID channelId)
 {
 	m_model.get().channels.get(channelId).hasActions = false;
 	m_model.get().actions.clearChannel(channelId);
-	m_model.swap(model::SwapType::HARD);
+	m_model.swap(model::SwapType::HARD, {model::Change::ACTIONS, channelId});
 }
 
 void ActionRecorder::clearActions(ID channelId, int type)
 {
 	m_model.get().actions.clearActions(channelId, type);
 	m_model.get().channels.get(channelId).hasActions = hasActions(channelId);
-	m_model.swap(model::SwapType::HARD);
+	m_model.swap(model::SwapType::HARD, {model::Change::ACTIONS, channelId});
 }
 
 Action ActionRecorder::rec(ID channelId, Frame frame, MidiEvent e)
@@ -487,7 +623,7 @@ Action ActionRecorder::rec(ID channelId, Frame frame, MidiEvent e)
 	Action action = m_model.get().actions.rec(channelId, frame, e);
 
 	m_model.get().channels.get(channelId).hasActions = true;
-	m_model.swap(model::SwapType::HARD);
+	m_model.swap(model::SwapType::HARD, {model::Change::ACTIONS, channelId});
 	return action;
 }
 
@@ -495,32 +631,32 @@ void ActionRecorder::rec(ID channelId, Frame f1, Frame f2, MidiEvent e1, MidiEve
 {
 	m_model.get().channels.get(channelId).hasActions = true;
 	m_model.get().actions.rec(channelId, f1, f2, e1, e2);
-	m_model.swap(model::SwapType::HARD);
+	m_model.swap(model::SwapType::HARD, {model::Change::ACTIONS, channelId});
 }
 
 void ActionRecorder::updateSiblings(ID id, ID prevId, ID nextId)
 {
 	m_model.get().actions.updateSiblings(id, prevId, nextId);
-	m_model.swap(model::SwapType::HARD);
+	m_model.swap(model::SwapType::HARD, model::Change::ACTIONS);
 }
 
 void ActionRecorder::deleteAction(ID channelId, ID id)
 {
 	m_model.get().actions.deleteAction(id);
 	m_model.get().channels.get(channelId).hasActions = hasActions(channelId);
-	m_model.swap(model::SwapType::HARD);
+	m_model.swap(model::SwapType::HARD, {model::Change::ACTIONS, channelId});
 }
 
 void ActionRecorder::deleteAction(ID channelId, ID currId, ID nextId)
 {
 	m_model.get().actions.deleteAction(currId, nextId);
 	m_model.get().channels.get(channelId).hasActions = hasActions(channelId);
-	m_model.swap(model::SwapType::HARD);
+	m_model.swap(model::SwapType::HARD, {model::Change::ACTIONS, channelId});
 }
 
 void ActionRecorder::updateEvent(ID id, MidiEvent e)
 {
 	m_model.get().actions.updateEvent(id, e);
-	m_model.swap(model::SwapType::HARD);
+	m_model.swap(model::SwapType::HARD, model::Change::ACTIONS);
 }
 } // namespace giada::m
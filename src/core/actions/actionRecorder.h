@@ -29,9 +29,16 @@
 
 #include "core/midiEvent.h"
 #include "core/model/model.h"
+#include "core/scheduler.h"
 #include "core/types.h"
+#include "deps/concurrentqueue/concurrentqueue.h"
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
 #include <unordered_set>
+#include <utility>
 
 namespace giada::patch
 {
@@ -44,7 +51,24 @@ struct Action;
 class ActionRecorder
 {
 public:
-	ActionRecorder(model::Model&);
+	/* LiveStats
+	Number of actions recorded live so far and of those dropped because the
+	live buffer was full. */
+
+	struct LiveStats
+	{
+		uint64_t recorded = 0;
+		uint64_t dropped  = 0;
+	};
+
+	ActionRecorder(model::Model&, Scheduler&);
+
+	/* init
+	Preallocates the live buffer, able to hold 'capacity' live actions not yet
+	picked up by the background consolidation. Call it before any live 
+	recording takes place. */
+
+	void init(int capacity);
 
 	/* reset
 	Brings everything back to the initial state. */
@@ -56,13 +80,18 @@ public:
 
 	void updateBpm(float ratio, int quantizerStep);
 
-	/* updateSamplerate
+	/* updateSamplerate (1)
     Changes actions position by taking in account the new samplerate. If 
     f_system == f_patch nothing will change, otherwise the conversion is 
     mandatory. */
 
 	void updateSamplerate(int systemRate, int patchRate);
 
+	/* updateSamplerate (2)
+	Same as above, on actions not in the layout (e.g. a staged project's ones). */
+
+	static void updateSamplerate(model::Actions&, int systemRate, int patchRate);
+
 	/* cloneActions
     Clones actions in channel 'channelId', giving them a new channel ID. Returns
     whether any action has been cloned. */
@@ -70,10 +99,22 @@ public:
 	bool cloneActions(ID channelId, ID newChannelId);
 
 	/* liveRec
-    Records a user-generated action. NOTE_ON or NOTE_OFF only for now. */
+    Records a user-generated action. NOTE_ON or NOTE_OFF only for now. 
+    Lock-free and allocation-free, it can be called by multiple threads at once
+    (e.g. MIDI and UI). The action is dropped if the live buffer is full. */
 
 	void liveRec(ID channelId, MidiEvent e, Frame global);
 
+	/* liveRecPluginParam
+	Records a plug-in parameter change as an automation point, same guarantees
+	as liveRec() above. 'value' is in range [0.0, 1.0]. */
+
+	void liveRecPluginParam(ID channelId, ID pluginId, int paramIndex, float value, Frame global);
+
+	/* getLiveStats */
+
+	LiveStats getLiveStats() const;
+
 	/* record*Action */
 
 	void recordEnvelopeAction(ID channelId, Frame frame, int value, Frame lastFrameInLoop);
@@ -95,7 +136,7 @@ public:
 
 	/* consolidate
     Records all live actions. Returns a set of channels IDs that have been 
-    recorded. */
+    recorded. Main thread only. */
 
 	std::unordered_set<ID> consolidate();
 
@@ -118,6 +159,19 @@ public:
 	void                updateEvent(ID id, MidiEvent e);
 
 private:
+	/* LiveEvent
+	Raw event captured by liveRec(), timestamped by the caller. Turned into a
+	proper Action by the background consolidation. */
+
+	struct LiveEvent
+	{
+		ID        channelId;
+		Frame     frame;
+		MidiEvent event;
+		ID        pluginId    = -1;
+		int       pluginParam = -1;
+	};
+
 	/* areComposite
     Composite: NOTE_ON + NOTE_OFF on the same note. */
 
@@ -137,16 +191,43 @@ private:
 
 	void recordNonFirstEnvelopeAction(ID channelId, Frame frame, int value);
 
-	/* consolidate
-    Given an action 'a1' tries to find the matching NOTE_OFF and updates the
-    action accordingly. */
+	/* drainLiveEvents
+	Moves pending live events into m_liveActions, linking each NOTE_OFF to its
+	NOTE_ON as soon as it comes in. Runs in background on the Scheduler thread 
+	while recording and once more on consolidate(). Actions get a temporary ID
+	(their position + 1): the action ID generator is used on the main thread 
+	only. Requires m_liveMutex to be locked. */
+
+	void drainLiveEvents();
 
-	void consolidate(const Action& a1, std::size_t i);
+	/* enqueueLiveEvent
+	Pushes a live event to the live buffer, or drops it if full. */
+
+	void enqueueLiveEvent(const LiveEvent&);
 
 	bool isBoundaryEnvelopeAction(const Action&) const;
 
-	model::Model&       m_model;
-	std::vector<Action> m_liveActions;
+	model::Model&     m_model;
+	Scheduler&        m_scheduler;
+	Scheduler::TaskId m_liveTask;
+
+	/* m_liveQueue
+	Preallocated multi-producer buffer filled by liveRec(). */
+
+	moodycamel::ConcurrentQueue<LiveEvent> m_liveQueue;
+
+	/* m_liveActions, m_liveNotesOn
+	Live actions drained so far and, for each (channel, note) pair, the index of
+	the last NOTE_ON still waiting for its NOTE_OFF. Both guarded by 
+	m_liveMutex: the Scheduler thread fills them, the main thread consumes them
+	on consolidate(). */
+
+	std::mutex                                m_liveMutex;
+	std::vector<Action>                       m_liveActions;
+	std::map<std::pair<ID, int>, std::size_t> m_liveNotesOn;
+
+	std::atomic<uint64_t> m_liveRecorded;
+	std::atomic<uint64_t> m_liveDropped;
 };
 } // namespace giada::m
 
@@ -94,7 +94,7 @@ void IOApi::channel_setMidiOutputFilter(ID channelId, int ch)
 bool IOApi::channel_setKey(ID channelId, int k)
 {
 	m_model.get().channels.get(channelId).key = k;
-	m_model.swap(m::model::SwapType::HARD);
+	m_model.swap(m::model::SwapType::HARD, {m::model::Change::CHANNELS, channelId});
 	return true;
 }
 
@@ -74,6 +74,13 @@ std::vector<Channel>& ChannelsApi::getAll()
 
 /* -------------------------------------------------------------------------- */
 
+model::Transaction ChannelsApi::transaction()
+{
+	return m_model.beginTransaction();
+}
+
+/* -------------------------------------------------------------------------- */
+
 Channel& ChannelsApi::add(ID columnId, ChannelType type)
 {
 	const int position   = m_channelManager.getLastChannelPosition(columnId);
@@ -209,6 +216,8 @@ void ChannelsApi::toggleMute(ID channelId)
 
 void ChannelsApi::toggleSolo(ID channelId)
 {
+	model::Transaction t = m_model.beginTransaction();
+
 	m_channelManager.toggleSolo(channelId);
 	m_mixer.updateSoloCount(m_channelManager.hasSolos());
 }
@@ -310,4 +319,51 @@ bool ChannelsApi::saveSample(ID channelId, const std::string& filePath)
 {
 	return m_channelManager.saveSample(channelId, filePath);
 }
+
+/* -------------------------------------------------------------------------- */
+
+ID ChannelsApi::storeScene(const std::string& name)
+{
+	const ID id = m_model.get().scenes.add(name, m_channelManager.getSceneChannels()).id;
+	m_model.swap(model::SwapType::NONE);
+	return id;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void ChannelsApi::launchScene(ID sceneId)
+{
+	/* Work on a copy: the scene lives in the layout being edited. */
+
+	const model::Scene* scene = m_model.get().scenes.find(sceneId);
+	if (scene == nullptr)
+		return;
+
+	const model::Scene copy = *scene;
+
+	model::Transaction t = m_model.beginTransaction();
+
+	m_channelManager.recallScene(copy);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void ChannelsApi::renameScene(ID sceneId, const std::string& name)
+{
+	m_model.get().scenes.rename(sceneId, name);
+	m_model.swap(model::SwapType::NONE);
+}
+
+void ChannelsApi::removeScene(ID sceneId)
+{
+	m_model.get().scenes.remove(sceneId);
+	m_model.swap(model::SwapType::NONE);
+}
+
+/* -------------------------------------------------------------------------- */
+
+const std::vector<model::Scene>& ChannelsApi::getScenes() const
+{
+	return m_model.get().scenes.getAll();
+}
 } // namespace giada::m
@@ -28,6 +28,7 @@
 #define G_CHANNELS_API_H
 
 #include "core/channels/channelFactory.h"
+#include "core/model/model.h"
 #include "core/patch.h"
 #include "core/types.h"
 #include <string>
@@ -59,6 +60,12 @@ public:
 	Channel&              get(ID);
 	std::vector<Channel>& getAll();
 
+	/* transaction
+	Returns a scoped model::Transaction: all channel operations performed while
+	it's alive are committed in a single swap when it goes out of scope. */
+
+	[[nodiscard]] model::Transaction transaction();
+
 	Channel& add(ID columnId, ChannelType);
 	int      loadSampleChannel(ID channelId, const std::string& filePath);
 	void     loadSampleChannel(ID channelId, Wave&);
@@ -92,6 +99,20 @@ public:
 	void sendMidi(ID, MidiEvent);
 	bool saveSample(ID, const std::string& filePath);
 
+	/* storeScene
+	Stores the current state of all channels in a new Scene. Returns its ID. */
+
+	ID storeScene(const std::string& name);
+
+	/* launchScene
+	Recalls a Scene in a single transaction. */
+
+	void launchScene(ID);
+
+	void                             renameScene(ID, const std::string& name);
+	void                             removeScene(ID);
+	const std::vector<model::Scene>& getScenes() const;
+
 private:
 	model::Model&   m_model;
 	KernelAudio&    m_kernelAudio;
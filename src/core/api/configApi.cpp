@@ -26,17 +26,19 @@
 
 #include "core/api/configApi.h"
 #include "core/kernelAudio.h"
+#include "core/midiLightingService.h"
 #include "core/midiSynchronizer.h"
 #include "core/model/model.h"
 
 namespace giada::m
 {
 ConfigApi::ConfigApi(model::Model& m, KernelAudio& ka, KernelMidi& km, MidiMapper<KernelMidi>& mm,
-    MidiSynchronizer& ms)
+    MidiLightingService<KernelMidi>& mls, MidiSynchronizer& ms)
 : m_model(m)
 , m_kernelAudio(ka)
 , m_kernelMidi(km)
 , m_midiMapper(mm)
+, m_midiLightingService(mls)
 , m_midiSynchronizer(ms)
 {
 }
@@ -199,13 +201,11 @@ KernelMidi::Result ConfigApi::midi_openInPort(int in)
 
 void ConfigApi::midi_setSyncMode(int syncMode)
 {
-	const float currentBpm = m_model.get().sequencer.bpm;
-
 	m_model.get().kernelMidi.sync = syncMode;
 	m_model.swap(model::SwapType::NONE);
 
 	m_midiSynchronizer.stopSendClock();
-	m_midiSynchronizer.startSendClock(currentBpm);
+	m_midiSynchronizer.startSendClock();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -217,6 +217,7 @@ void ConfigApi::midi_setMidiMapPath(const std::string& midiMapPath)
 
 	m_midiMapper.read(midiMapPath);
 	m_midiMapper.sendInitMessages();
+	m_midiLightingService.reset();
 }
 
 /* -------------------------------------------------------------------------- */
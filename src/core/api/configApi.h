@@ -35,12 +35,19 @@ namespace giada::m::model
 class Model;
 }
 
+namespace giada::m
+{
+template <typename KernelMidiI>
+class MidiLightingService;
+}
+
 namespace giada::m
 {
 class ConfigApi
 {
 public:
-	ConfigApi(model::Model&, KernelAudio&, KernelMidi&, MidiMapper<KernelMidi>&, MidiSynchronizer&);
+	ConfigApi(model::Model&, KernelAudio&, KernelMidi&, MidiMapper<KernelMidi>&,
+	    MidiLightingService<KernelMidi>&, MidiSynchronizer&);
 
 	bool                             audio_hasAPI(RtAudio::Api) const;
 	RtAudio::Api                     audio_getAPI() const;
@@ -85,11 +92,12 @@ public:
 	void behaviors_storeData(const model::Behaviors&);
 
 private:
-	model::Model&           m_model;
-	KernelAudio&            m_kernelAudio;
-	KernelMidi&             m_kernelMidi;
-	MidiMapper<KernelMidi>& m_midiMapper;
-	MidiSynchronizer&       m_midiSynchronizer;
+	model::Model&                    m_model;
+	KernelAudio&                     m_kernelAudio;
+	KernelMidi&                      m_kernelMidi;
+	MidiMapper<KernelMidi>&          m_midiMapper;
+	MidiLightingService<KernelMidi>& m_midiLightingService;
+	MidiSynchronizer&                m_midiSynchronizer;
 };
 } // namespace giada::m
 
@@ -28,16 +28,15 @@
 #include "core/channels/channelManager.h"
 #include "core/engine.h"
 #include "core/kernelAudio.h"
-#include "core/midiSynchronizer.h"
 #include "core/mixer.h"
 
 namespace giada::m
 {
-MainApi::MainApi(KernelAudio& ka, Mixer& m, Sequencer& s, MidiSynchronizer& ms, ChannelManager& cm, Recorder& r)
-: m_kernelAudio(ka)
+MainApi::MainApi(model::Model& mo, KernelAudio& ka, Mixer& m, Sequencer& s, ChannelManager& cm, Recorder& r)
+: m_model(mo)
+, m_kernelAudio(ka)
 , m_mixer(m)
 , m_sequencer(s)
-, m_midiSynchronizer(ms)
 , m_channelManager(cm)
 , m_recorder(r)
 {
@@ -165,6 +164,13 @@ SeqStatus MainApi::getSequencerStatus() const
 
 /* -------------------------------------------------------------------------- */
 
+model::Transaction MainApi::transaction()
+{
+	return m_model.beginTransaction();
+}
+
+/* -------------------------------------------------------------------------- */
+
 void MainApi::toggleMetronome()
 {
 	m_sequencer.toggleMetronome();
@@ -201,7 +207,6 @@ void MainApi::setBpm(float bpm)
 	if (m_mixer.isRecordingInput())
 		return;
 	m_sequencer.setBpm(bpm, m_kernelAudio.getSampleRate());
-	m_midiSynchronizer.setClockBpm(bpm);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -28,19 +28,19 @@
 #define G_MAIN_API_H
 
 #include "core/mixer.h"
+#include "core/model/model.h"
 
 namespace giada::m
 {
 class Engine;
 class KernelAudio;
 class Sequencer;
-class MidiSynchronizer;
 class ChannelManager;
 class Recorder;
 class MainApi
 {
 public:
-	MainApi(KernelAudio&, Mixer&, Sequencer&, MidiSynchronizer&, ChannelManager&, Recorder&);
+	MainApi(model::Model&, KernelAudio&, Mixer&, Sequencer&, ChannelManager&, Recorder&);
 
 	bool              isRecordingInput() const;
 	bool              isRecordingActions() const;
@@ -64,6 +64,12 @@ public:
 	int               getFramesInBeat() const;
 	SeqStatus         getSequencerStatus() const;
 
+	/* transaction
+	Returns a scoped model::Transaction: all operations performed while it's
+	alive are committed in a single swap when it goes out of scope. */
+
+	[[nodiscard]] model::Transaction transaction();
+
 	void toggleMetronome();
 	void setMasterInVolume(float);
 	void setMasterOutVolume(float);
@@ -87,12 +93,12 @@ public:
 	void startActionRecOnCallback();
 
 private:
-	KernelAudio&      m_kernelAudio;
-	Mixer&            m_mixer;
-	Sequencer&        m_sequencer;
-	MidiSynchronizer& m_midiSynchronizer;
-	ChannelManager&   m_channelManager;
-	Recorder&         m_recorder;
+	model::Model&   m_model;
+	KernelAudio&    m_kernelAudio;
+	Mixer&          m_mixer;
+	Sequencer&      m_sequencer;
+	ChannelManager& m_channelManager;
+	Recorder&       m_recorder;
 };
 } // namespace giada::m
 
@@ -25,19 +25,26 @@
  * -------------------------------------------------------------------------- */
 
 #include "pluginsApi.h"
+#include "core/actions/actionRecorder.h"
 #include "core/channels/channelManager.h"
 #include "core/engine.h"
 #include "core/kernelAudio.h"
 #include "core/mixer.h"
 #include "core/plugins/pluginFactory.h"
+#include "core/recorder.h"
+#include "core/sequencer.h"
 #include "utils/fs.h"
 
 namespace giada::m
 {
-PluginsApi::PluginsApi(KernelAudio& ka, PluginManager& pm, PluginHost& ph, model::Model& m)
+PluginsApi::PluginsApi(KernelAudio& ka, PluginManager& pm, PluginHost& ph, Sequencer& s,
+    Recorder& r, ActionRecorder& ar, model::Model& m)
 : m_kernelAudio(ka)
 , m_pluginManager(pm)
 , m_pluginHost(ph)
+, m_sequencer(s)
+, m_recorder(r)
+, m_actionRecorder(ar)
 , m_model(m)
 {
 }
@@ -85,7 +92,7 @@ void PluginsApi::add(int pluginListIndex, ID channelId)
 	    presence of the non-const processBlock() method. Why not const_casting
 	    only in the Plugin class? */
 	m_model.get().channels.get(channelId).plugins.push_back(const_cast<Plugin*>(pluginPtr));
-	m_model.swap(model::SwapType::HARD);
+	m_model.swap(model::SwapType::HARD, {model::Change::PLUGINS, channelId});
 }
 
 /* -------------------------------------------------------------------------- */
@@ -93,7 +100,7 @@ void PluginsApi::add(int pluginListIndex, ID channelId)
 void PluginsApi::swap(const Plugin& p1, const Plugin& p2, ID channelId)
 {
 	m_pluginHost.swapPlugin(p1, p2, m_model.get().channels.get(channelId).plugins);
-	m_model.swap(model::SwapType::HARD);
+	m_model.swap(model::SwapType::HARD, {model::Change::PLUGINS, channelId});
 }
 
 /* -------------------------------------------------------------------------- */
@@ -108,7 +115,7 @@ void PluginsApi::sort(PluginManager::SortMethod method)
 void PluginsApi::free(const Plugin& plugin, ID channelId)
 {
 	u::vector::remove(m_model.get().channels.get(channelId).plugins, &plugin);
-	m_model.swap(model::SwapType::HARD);
+	m_model.swap(model::SwapType::HARD, {model::Change::PLUGINS, channelId});
 	m_pluginHost.freePlugin(plugin);
 }
 
@@ -128,9 +135,13 @@ void PluginsApi::toggleBypass(ID pluginId)
 
 /* -------------------------------------------------------------------------- */
 
-void PluginsApi::setParameter(ID pluginId, int paramIndex, float value)
+void PluginsApi::setParameter(ID channelId, ID pluginId, int paramIndex, float value)
 {
 	m_pluginHost.setPluginParameter(pluginId, paramIndex, value);
+
+	if (m_recorder.canRecordActions())
+		m_actionRecorder.liveRecPluginParam(channelId, pluginId, paramIndex, value,
+		    m_sequencer.getCurrentFrame());
 }
 
 /* -------------------------------------------------------------------------- */
@@ -143,8 +154,9 @@ void PluginsApi::scan(const std::string& dir, const std::function<void(float)>&
 
 /* -------------------------------------------------------------------------- */
 
-void PluginsApi::process(mcl::AudioBuffer& outBuf, const std::vector<Plugin*>& plugins, juce::MidiBuffer* events)
+void PluginsApi::process(mcl::AudioBuffer& outBuf, const std::vector<Plugin*>& plugins,
+    juce::MidiBuffer* events, std::span<const PluginHost::ParamChange> paramChanges, int renderSlot)
 {
-	m_pluginHost.processStack(outBuf, plugins, events);
+	m_pluginHost.processStack(outBuf, plugins, events, paramChanges, renderSlot);
 }
 } // namespace giada::m
@@ -27,6 +27,7 @@
 #ifndef G_PLUGINS_API_H
 #define G_PLUGINS_API_H
 
+#include "core/plugins/pluginHost.h"
 #include "core/plugins/pluginManager.h"
 #include "core/types.h"
 
@@ -41,12 +42,15 @@ class MidiEvent;
 
 class KernelAudio;
 class ChannelManager;
-class PluginHost;
+class Sequencer;
+class Recorder;
+class ActionRecorder;
 class Plugin;
 class PluginsApi
 {
 public:
-	PluginsApi(KernelAudio&, PluginManager&, PluginHost&, model::Model&);
+	PluginsApi(KernelAudio&, PluginManager&, PluginHost&, Sequencer&, Recorder&, ActionRecorder&,
+	    model::Model&);
 
 	const Plugin*                          get(ID pluginId) const;
 	std::vector<PluginManager::PluginInfo> getInfo() const;
@@ -58,16 +62,25 @@ public:
 	void free(const Plugin&, ID channelId);
 	void setProgram(ID pluginId, int programIndex);
 	void toggleBypass(ID pluginId);
-	void setParameter(ID pluginId, int paramIndex, float value);
+
+	/* setParameter
+	Changes a plug-in parameter. The change is also recorded as an automation
+	point on channel 'channelId' if action recording is active. */
+
+	void setParameter(ID channelId, ID pluginId, int paramIndex, float value);
 
 	void scan(const std::string& dir, const std::function<void(float)>& progress);
-	void process(mcl::AudioBuffer& outBuf, const std::vector<Plugin*>&, juce::MidiBuffer* events = nullptr);
+	void process(mcl::AudioBuffer& outBuf, const std::vector<Plugin*>&, juce::MidiBuffer* events = nullptr,
+	    std::span<const PluginHost::ParamChange> paramChanges = {}, int renderSlot = 0);
 
 private:
-	KernelAudio&   m_kernelAudio;
-	PluginManager& m_pluginManager;
-	PluginHost&    m_pluginHost;
-	model::Model&  m_model;
+	KernelAudio&    m_kernelAudio;
+	PluginManager&  m_pluginManager;
+	PluginHost&     m_pluginHost;
+	Sequencer&      m_sequencer;
+	Recorder&       m_recorder;
+	ActionRecorder& m_actionRecorder;
+	model::Model&   m_model;
 };
 } // namespace giada::m
 
@@ -27,115 +27,112 @@
 #include "sampleEditorApi.h"
 #include "core/channels/channelManager.h"
 #include "core/kernelAudio.h"
+#include "core/peakCache.h"
 #include "core/waveFactory.h"
 #include "core/waveFx.h"
 #include "utils/log.h"
 
 namespace giada::m
 {
-SampleEditorApi::SampleEditorApi(KernelAudio& k, model::Model& m, ChannelManager& cm)
+SampleEditorApi::SampleEditorApi(KernelAudio& k, model::Model& m, ChannelManager& cm, PeakCache& pc)
 : m_kernelAudio(k)
 , m_model(m)
 , m_channelManager(cm)
+, m_peakCache(pc)
 {
 }
 
 /* -------------------------------------------------------------------------- */
 
+SampleEditorApi::~SampleEditorApi()
+{
+	cancel();
+}
+
+/* -------------------------------------------------------------------------- */
+
 void SampleEditorApi::cut(ID channelId, Frame a, Frame b)
 {
+	if (isBusy())
+		return;
 	copy(channelId, a, b);
-	model::DataLock lock = m_model.lockData();
-	wfx::cut(getWave(channelId), a, b);
-	resetBeginEnd(channelId);
+	editWave(channelId, [this, channelId, a, b](Wave& wave) {
+		wave.cut(a, b);
+		resetBeginEnd(channelId);
+	});
 }
 
 /* -------------------------------------------------------------------------- */
 
 void SampleEditorApi::copy(ID channelId, Frame a, Frame b)
 {
-	m_waveBuffer = waveFactory::createFromWave(getWave(channelId), a, b);
+	m_clipboard = std::make_shared<const mcl::AudioBuffer>(getWave(channelId).render(a, b));
 }
 
 /* -------------------------------------------------------------------------- */
 
 void SampleEditorApi::paste(ID channelId, Frame a)
 {
-	if (m_waveBuffer == nullptr)
+	if (m_clipboard == nullptr)
 	{
 		u::log::print("[sampleEditor::paste] Buffer is empty, nothing to paste\n");
 		return;
 	}
 
-	/* Get the existing wave in channel. */
+	editWave(channelId, [this, channelId, a](Wave& wave) {
+		wave.paste(m_clipboard, a);
 
-	Wave& wave = getWave(channelId);
+		/* Pass the old wave that contains the pasted data to channel, then
+		just brutally restore begin/end points. */
 
-	/* Temporary disable wave reading in channel. From now on, the audio
-	    thread won't be reading any wave, so editing it is safe.  */
-
-	model::DataLock lock = m_model.lockData();
-
-	/* Paste copied data to destination wave. */
-
-	wfx::paste(*m_waveBuffer, wave, a);
-
-	/* Pass the old wave that contains the pasted data to channel. */
-
-	m_channelManager.getChannel(channelId).samplePlayer->setWave(&wave, 1.0f);
+		m_channelManager.getChannel(channelId).samplePlayer->setWave(&wave, 1.0f);
+		resetBeginEnd(channelId);
+	});
+}
 
-	/* Just brutally restore begin/end points. */
+/* -------------------------------------------------------------------------- */
 
-	resetBeginEnd(channelId);
+void SampleEditorApi::trim(ID channelId, Frame a, Frame b)
+{
+	editWave(channelId, [this, channelId, a, b](Wave& wave) {
+		wave.trim(a, b);
+		resetBeginEnd(channelId);
+	});
 }
 
 /* -------------------------------------------------------------------------- */
 
 void SampleEditorApi::silence(ID channelId, Frame a, Frame b)
 {
-	model::DataLock lock = m_model.lockData();
-	wfx::silence(getWave(channelId), a, b);
+	startJob(channelId, [a, b](const mcl::AudioBuffer& buf, wfx::Progress& p) { return wfx::silence(buf, a, b, p); });
 }
 
 /* -------------------------------------------------------------------------- */
 
 void SampleEditorApi::fade(ID channelId, Frame a, Frame b, wfx::Fade type)
 {
-	model::DataLock lock = m_model.lockData();
-	wfx::fade(getWave(channelId), a, b, type);
+	startJob(channelId, [a, b, type](const mcl::AudioBuffer& buf, wfx::Progress& p) { return wfx::fade(buf, a, b, type, p); });
 }
 
 /* -------------------------------------------------------------------------- */
 
 void SampleEditorApi::smoothEdges(ID channelId, Frame a, Frame b)
 {
-	model::DataLock lock = m_model.lockData();
-	wfx::smooth(getWave(channelId), a, b);
+	startJob(channelId, [a, b](const mcl::AudioBuffer& buf, wfx::Progress& p) { return wfx::smooth(buf, a, b, p); });
 }
 
 /* -------------------------------------------------------------------------- */
 
 void SampleEditorApi::reverse(ID channelId, Frame a, Frame b)
 {
-	model::DataLock lock = m_model.lockData();
-	wfx::reverse(getWave(channelId), a, b);
+	startJob(channelId, [a, b](const mcl::AudioBuffer& buf, wfx::Progress& p) { return wfx::reverse(buf, a, b, p); });
 }
 
 /* -------------------------------------------------------------------------- */
 
 void SampleEditorApi::normalize(ID channelId, Frame a, Frame b)
 {
-	model::DataLock lock = m_model.lockData();
-	wfx::normalize(getWave(channelId), a, b);
-}
-
-/* -------------------------------------------------------------------------- */
-
-void SampleEditorApi::trim(ID channelId, Frame a, Frame b)
-{
-	model::DataLock lock = m_model.lockData();
-	wfx::trim(getWave(channelId), a, b);
-	resetBeginEnd(channelId);
+	startJob(channelId, [a, b](const mcl::AudioBuffer& buf, wfx::Progress& p) { return wfx::normalize(buf, a, b, p); });
 }
 
 /* -------------------------------------------------------------------------- */
@@ -146,10 +143,9 @@ void SampleEditorApi::shift(ID channelId, Frame offset)
 	const SamplePlayer& samplePlayer = ch.samplePlayer.value();
 	const Frame         oldShift     = samplePlayer.shift;
 
-	m::model::DataLock lock = m_model.lockData();
-	m::wfx::shift(getWave(channelId), offset - oldShift);
-	// Model has been swapped by DataLock constructor, needs to get Channel again
-	m_channelManager.getChannel(channelId).samplePlayer->shift = offset;
+	startJob(
+	    channelId, [delta = offset - oldShift](const mcl::AudioBuffer& buf, wfx::Progress& p) { return wfx::shift(buf, delta, p); },
+	    [this, channelId, offset](Wave&) { m_channelManager.getChannel(channelId).samplePlayer->shift = offset; });
 }
 
 /* -------------------------------------------------------------------------- */
@@ -181,6 +177,8 @@ void SampleEditorApi::resetBeginEnd(ID channelId)
 
 void SampleEditorApi::reload(ID channelId)
 {
+	cancel(); // The Wave is about to be replaced
+
 	const int                sampleRate  = m_kernelAudio.getSampleRate();
 	const Resampler::Quality rsmpQuality = m_model.get().kernelAudio.rsmpQuality;
 	// TODO - error checking
@@ -189,6 +187,112 @@ void SampleEditorApi::reload(ID channelId)
 
 /* -------------------------------------------------------------------------- */
 
+void SampleEditorApi::undo(ID channelId)
+{
+	if (!canUndo(channelId))
+		return;
+	editWave(channelId, [this, channelId](Wave& wave) {
+		wave.undo();
+		resetBeginEnd(channelId);
+	});
+}
+
+void SampleEditorApi::redo(ID channelId)
+{
+	if (!canRedo(channelId))
+		return;
+	editWave(channelId, [this, channelId](Wave& wave) {
+		wave.redo();
+		resetBeginEnd(channelId);
+	});
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool SampleEditorApi::canUndo(ID channelId) const
+{
+	return getWave(channelId).canUndo();
+}
+
+bool SampleEditorApi::canRedo(ID channelId) const
+{
+	return getWave(channelId).canRedo();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void SampleEditorApi::consolidate(ID channelId)
+{
+	editWave(channelId, [](Wave& wave) { wave.consolidate(); });
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::shared_ptr<const WavePeaks> SampleEditorApi::getPeaks(ID channelId) const
+{
+	return m_peakCache.get(getWave(channelId));
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool SampleEditorApi::isBusy() const
+{
+	return m_job != nullptr;
+}
+
+/* -------------------------------------------------------------------------- */
+
+float SampleEditorApi::getProgress() const
+{
+	return m_job != nullptr ? m_job->progress.get() : 0.0f;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void SampleEditorApi::cancel()
+{
+	if (m_job == nullptr)
+		return;
+	m_job->progress.cancel();
+	m_job->thread.join();
+	m_job.reset();
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool SampleEditorApi::update()
+{
+	if (m_job == nullptr || !m_job->done.load())
+		return false;
+
+	m_job->thread.join();
+
+	const std::unique_ptr<Job> job  = std::move(m_job);
+	Wave*                      wave = m_model.findWave(job->waveId);
+
+	/* The Wave might have been removed or replaced while the job was running:
+	discard the result. */
+
+	if (job->progress.isCancelled() || wave == nullptr || wave->getRevision() != job->revision)
+		return false;
+
+	/* Everything has been computed already: the model stays locked just for the
+	time of a buffer move. */
+
+	model::DataLock lock = m_model.lockData(model::SwapType::HARD, {model::Change::CHANNELS, job->channelId});
+
+	wave->edit(std::move(job->result));
+	wave->setEdited(true);
+	if (job->onApplied != nullptr)
+		job->onApplied(*wave);
+
+	m_peakCache.request(*wave);
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
 Wave& SampleEditorApi::getWave(ID channelId) const
 {
 	Channel&      ch           = m_channelManager.getChannel(channelId);
@@ -196,4 +300,55 @@ Wave& SampleEditorApi::getWave(ID channelId) const
 
 	return *samplePlayer.getWave();
 }
+
+/* -------------------------------------------------------------------------- */
+
+void SampleEditorApi::editWave(ID channelId, std::function<void(Wave&)> f)
+{
+	if (isBusy())
+	{
+		u::log::print("[SampleEditorApi::editWave] Another operation is in progress, skipping\n");
+		return;
+	}
+
+	Wave& wave = getWave(channelId);
+
+	model::DataLock lock = m_model.lockData(model::SwapType::HARD, {model::Change::CHANNELS, channelId});
+
+	f(wave);
+	wave.setEdited(true);
+
+	m_peakCache.request(wave);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void SampleEditorApi::startJob(ID channelId, Job::Func f, Job::Callback onApplied)
+{
+	if (isBusy())
+	{
+		u::log::print("[SampleEditorApi::startJob] Another operation is in progress, skipping\n");
+		return;
+	}
+
+	const Wave& wave = getWave(channelId);
+
+	m_job            = std::make_unique<Job>();
+	m_job->channelId = channelId;
+	m_job->waveId    = wave.id;
+	m_job->revision  = wave.getRevision();
+	m_job->onApplied = onApplied;
+	m_job->thread    = std::thread([job = m_job.get(), snapshot = Wave(wave), f]() {
+		/* The job works on a snapshot that shares audio data with the Wave in 
+		the model, which can be deleted or replaced in the meantime (channel 
+		deleted, project loaded) without invalidating it. Edited Waves are 
+		rendered into a contiguous buffer first. */
+
+		if (snapshot.isConsolidated())
+			job->result = f(snapshot.getBuffer(), job->progress);
+		else
+			job->result = f(snapshot.render(0, snapshot.countFrames()), job->progress);
+		job->done.store(true);
+	});
+}
 } // namespace giada::m
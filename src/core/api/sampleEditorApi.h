@@ -30,44 +30,135 @@
 #include "core/model/model.h"
 #include "core/types.h"
 #include "core/waveFx.h"
+#include "deps/mcl-audio-buffer/src/audioBuffer.hpp"
+#include <atomic>
+#include <functional>
 #include <memory>
+#include <thread>
 
 namespace giada::m
 {
 class KernelAudio;
 class ChannelManager;
+class PeakCache;
 class Wave;
+class WavePeaks;
 class SampleEditorApi
 {
 public:
-	SampleEditorApi(KernelAudio&, model::Model&, ChannelManager&);
+	SampleEditorApi(KernelAudio&, model::Model&, ChannelManager&, PeakCache&);
+	~SampleEditorApi();
+
+	/* cut, copy, paste, trim
+	Non-destructive editing operations: they just rewrite the Wave's segment 
+	list and take effect immediately. */
 
 	void cut(ID channelId, Frame a, Frame b);
 	void copy(ID channelId, Frame a, Frame b);
 	void paste(ID channelId, Frame a);
+	void trim(ID channelId, Frame a, Frame b);
+
+	/* silence, fade, smoothEdges, reverse, normalize, shift
+	Editing operations run in background: the new audio data is computed on a 
+	separate thread while the original Wave keeps playing. Only one operation
+	at a time is allowed; requests made while busy are discarded. Call update() 
+	to apply the result once done. */
+
 	void silence(ID channelId, Frame a, Frame b);
 	void fade(ID channelId, Frame a, Frame b, wfx::Fade);
 	void smoothEdges(ID channelId, Frame a, Frame b);
 	void reverse(ID channelId, Frame a, Frame b);
 	void normalize(ID channelId, Frame a, Frame b);
-	void trim(ID channelId, Frame a, Frame b);
 	void shift(ID channelId, Frame offset);
 	void toNewChannel(ID channelId, ID columnId, Frame a, Frame b);
 	void setBeginEnd(ID channelId, Frame b, Frame e);
 	void resetBeginEnd(ID channelId);
 	void reload(ID channelId);
 
+	/* undo, redo
+	Move back and forth in the editing history of the Wave. */
+
+	void undo(ID channelId);
+	void redo(ID channelId);
+	bool canUndo(ID channelId) const;
+	bool canRedo(ID channelId) const;
+
+	/* consolidate
+	Flattens all edits into a single buffer, discarding the editing history. */
+
+	void consolidate(ID channelId);
+
+	/* getPeaks
+	Returns the peaks of the Wave in channel 'channelId' for drawing, or nullptr
+	if they are still being computed in background. */
+
+	std::shared_ptr<const WavePeaks> getPeaks(ID channelId) const;
+
+	/* isBusy
+	True if a background operation is running or waiting to be applied. */
+
+	bool isBusy() const;
+
+	/* getProgress
+	Returns the progress of the current background operation, in [0.0, 1.0]. */
+
+	float getProgress() const;
+
+	/* cancel
+	Cancels the current background operation, if any, and waits for its thread
+	to finish. */
+
+	void cancel();
+
+	/* update
+	Moves the result of a completed background operation into its Wave. Returns
+	true if a Wave has been changed. Main thread only. */
+
+	bool update();
+
 private:
+	/* Job
+	A background editing operation. 'func' computes the new audio data out of
+	the Wave's buffer on a separate thread; 'onApplied' is invoked by update() 
+	right after the new data has been moved into the Wave. */
+
+	struct Job
+	{
+		using Func     = std::function<mcl::AudioBuffer(const mcl::AudioBuffer&, wfx::Progress&)>;
+		using Callback = std::function<void(Wave&)>;
+
+		ID                channelId;
+		ID                waveId;
+		int               revision; // Of the Wave when the job has started
+		Callback          onApplied;
+		wfx::Progress     progress;
+		mcl::AudioBuffer  result;
+		std::atomic<bool> done = false;
+		std::thread       thread;
+	};
+
 	Wave& getWave(ID channelId) const;
 
+	/* editWave
+	Applies a synchronous edit 'f' to the Wave while the model is locked. Skipped
+	if a background operation is running, as it is reading the same Wave. */
+
+	void editWave(ID channelId, std::function<void(Wave&)> f);
+
+	void startJob(ID channelId, Job::Func, Job::Callback onApplied = nullptr);
+
 	KernelAudio&    m_kernelAudio;
 	model::Model&   m_model;
 	ChannelManager& m_channelManager;
+	PeakCache&      m_peakCache;
+
+	/* clipboard
+	Audio data used during cut/copy/paste operations. Immutable, so that pasted 
+	segments can point to it safely. */
 
-	/* waveBuffer
-	A Wave used during cut/copy/paste operations. */
+	std::shared_ptr<const mcl::AudioBuffer> m_clipboard;
 
-	std::unique_ptr<m::Wave> m_waveBuffer;
+	std::unique_ptr<Job> m_job;
 };
 } // namespace giada::m
 
@@ -31,15 +31,48 @@
 #include "core/midiSynchronizer.h"
 #include "core/model/model.h"
 #include "core/patchFactory.h"
+#include "core/peakCache.h"
 #include "core/plugins/pluginFactory.h"
 #include "core/waveFactory.h"
 #include "utils/fs.h"
 #include "utils/log.h"
+#include <filesystem>
 
 namespace giada::m
 {
+namespace
+{
+/* readPatch_
+Reads the project patch. The binary one is preferred, unless the JSON one has
+been modified afterwards (e.g. edited by hand or by another tool). */
+
+Patch readPatch_(const std::string& projectPath)
+{
+	namespace stdfs = std::filesystem;
+
+	const std::string name     = u::fs::stripExt(u::fs::basename(projectPath));
+	const std::string jsonPath = u::fs::join(projectPath, name + G_PATCH_EXT);
+	const std::string binPath  = u::fs::join(projectPath, name + G_PATCH_BIN_EXT);
+
+	std::error_code ec; // Missing files give the minimum time
+	if (stdfs::last_write_time(binPath, ec) >= stdfs::last_write_time(jsonPath, ec))
+	{
+		const Patch patch = patchFactory::deserialize(binPath);
+		if (patch.status == G_FILE_OK)
+			return patch;
+		u::log::print("[StorageApi::loadProject] Can't read binary patch, falling back to JSON\n");
+	}
+
+	return patchFactory::deserialize(jsonPath);
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
 StorageApi::StorageApi(Engine& e, model::Model& m, PluginManager& pm, MidiSynchronizer& ms,
-    Mixer& mx, ChannelManager& cm, KernelAudio& ka, Sequencer& s, ActionRecorder& ar)
+    Mixer& mx, ChannelManager& cm, KernelAudio& ka, Sequencer& s, ActionRecorder& ar, PeakCache& pc)
 : m_engine(e)
 , m_model(m)
 , m_pluginManager(pm)
@@ -49,14 +82,30 @@ StorageApi::StorageApi(Engine& e, model::Model& m, PluginManager& pm, MidiSynchr
 , m_kernelAudio(ka)
 , m_sequencer(s)
 , m_actionRecorder(ar)
+, m_peakCache(pc)
+, m_saving(false)
+, m_switchPending(false)
+, m_preloading(false)
+{
+}
+
+/* -------------------------------------------------------------------------- */
+
+StorageApi::~StorageApi()
 {
+	waitForSave();
+	discardPreloadedProject();
 }
 
 /* -------------------------------------------------------------------------- */
 
 bool StorageApi::storeProject(const std::string& projectPath, const v::Model& uiModel,
-    std::function<void(float)> progress) const
+    std::function<void(float)> progress, std::function<void(bool)> onSaved)
 {
+	/* A previous save might still be writing into the same folder. */
+
+	waitForSave();
+
 	progress(0.0f);
 
 	if (!u::fs::mkdir(projectPath))
@@ -69,7 +118,8 @@ bool StorageApi::storeProject(const std::string& projectPath, const v::Model& ui
 
 	progress(0.3f);
 
-	/* Write Model into Patch, then into file. */
+	/* Write Model into Patch. This only takes snapshots of new or modified 
+	Waves and of plug-in states, to be written later on. */
 
 	Patch patch;
 
@@ -80,16 +130,74 @@ bool StorageApi::storeProject(const std::string& projectPath, const v::Model& ui
 	patch.metronome  = m_sequencer.isMetronomeOn(); // TODO - addShared bool metronome to Layout
 	patch.samplerate = m_kernelAudio.getSampleRate();
 
-	m_model.store(patch, projectPath);
+	model::SaveRequests requests = m_model.store(patch, projectPath, uiModel.compressSamples);
 
 	progress(0.6f);
 
-	const std::string patchPath = u::fs::join(projectPath, patch.name + G_PATCH_EXT);
-
-	if (!patchFactory::serialize(patch, patchPath))
-		return false;
-
-	u::log::print("[StorageApi::storeProject] Project patch saved as {}\n", patchPath);
+	/* Write plug-in states, Waves and patch files on a background thread. 
+	Everything it needs has been copied already: the engine can keep going. */
+
+	m_saving.store(true);
+	m_saveThread = std::thread([this, patch = std::move(patch), requests = std::move(requests), projectPath, onSaved]() mutable {
+		bool ok = true;
+
+		/* A plug-in state that can't be written to file is embedded into the
+		patch instead, by all plug-ins sharing it. */
+
+		for (const pluginFactory::SaveRequest& req : requests.states)
+		{
+			if (pluginFactory::saveState(projectPath, req))
+				continue;
+			u::log::print("[StorageApi::storeProject] Unable to save plug-in state {}\n", req.fileName);
+			for (Patch::Plugin& pplugin : patch.plugins)
+			{
+				if (pplugin.statePath != req.fileName)
+					continue;
+				pplugin.statePath.clear();
+				pplugin.state = req.state.asBase64();
+			}
+		}
+
+		for (const waveFactory::SaveRequest& req : requests.waves)
+		{
+			if (waveFactory::save(req) == G_RES_OK)
+			{
+				std::scoped_lock lock(m_savedMutex);
+				m_savedWaves.push_back({req.wave.id, req.wave.getRevision()});
+				continue;
+			}
+			u::log::print("[StorageApi::storeProject] Unable to save sample {}\n", req.wave.getPath());
+			ok = false;
+		}
+
+		const std::string patchPath = u::fs::join(projectPath, patch.name + G_PATCH_EXT);
+
+		/* Old state files can go only once the new patch no longer references
+		them. */
+
+		if (patchFactory::serialize(patch, patchPath))
+		{
+			u::log::print("[StorageApi::storeProject] Project patch saved as {}\n", patchPath);
+			pluginFactory::removeUnusedStates(projectPath, patch.plugins);
+		}
+		else
+			ok = false;
+
+		/* The binary patch is written last, so that it's newer than the JSON one
+		and gets picked when loading. Failing here is not fatal: the JSON patch 
+		is still valid. */
+
+		const std::string binPatchPath = u::fs::join(projectPath, patch.name + G_PATCH_BIN_EXT);
+
+		if (!patchFactory::serializeBinary(patch, binPatchPath))
+			u::log::print("[StorageApi::storeProject] Unable to save binary patch {}\n", binPatchPath);
+
+		u::log::print("[StorageApi::storeProject] {} sample(s) written\n", requests.waves.size());
+
+		m_saving.store(false);
+		if (onSaved != nullptr)
+			onSaved(ok);
+	});
 
 	progress(1.0f);
 
@@ -98,17 +206,59 @@ bool StorageApi::storeProject(const std::string& projectPath, const v::Model& ui
 
 /* -------------------------------------------------------------------------- */
 
+void StorageApi::commitSave()
+{
+	std::vector<std::pair<ID, int>> savedWaves;
+	{
+		std::scoped_lock lock(m_savedMutex);
+		savedWaves.swap(m_savedWaves);
+	}
+
+	/* A different revision means the Wave has been edited or replaced after the
+	snapshot was taken: what's on disk is already stale. */
+
+	model::DataLock lock = m_model.lockData(model::SwapType::NONE);
+
+	for (const auto& [id, revision] : savedWaves)
+	{
+		Wave* wave = m_model.findWave(id);
+		if (wave == nullptr || wave->getRevision() != revision)
+			continue;
+		wave->setLogical(false);
+		wave->setEdited(false);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool StorageApi::isSaving() const
+{
+	return m_saving.load();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void StorageApi::waitForSave()
+{
+	if (m_saveThread.joinable())
+		m_saveThread.join();
+}
+
+/* -------------------------------------------------------------------------- */
+
 model::LoadState StorageApi::loadProject(const std::string& projectPath, PluginManager::SortMethod pluginSortMethod,
     std::function<void(float)> progress)
 {
 	u::log::print("[StorageApi::loadProject] Load project from {}\n", projectPath);
 
+	waitForSave();
+	discardPreloadedProject();
+
 	progress(0.0f);
 
 	/* Read the selected project's patch. */
 
-	const std::string patchPath = u::fs::join(projectPath, u::fs::stripExt(u::fs::basename(projectPath)) + G_PATCH_EXT);
-	const Patch       patch     = patchFactory::deserialize(patchPath);
+	const Patch patch = readPatch_(projectPath);
 
 	if (patch.status != G_FILE_OK)
 		return {};
@@ -147,10 +297,240 @@ model::LoadState StorageApi::loadProject(const std::string& projectPath, PluginM
 	/* Bring everything back online. */
 
 	m_mixer.enable();
-	m_midiSynchronizer.startSendClock(m_model.get().sequencer.bpm);
+	m_midiSynchronizer.startSendClock();
 
 	progress(1.0f);
 
 	return state;
 }
+/* -------------------------------------------------------------------------- */
+
+bool StorageApi::preloadProject(const std::string& projectPath, std::size_t memoryBudget,
+    std::function<void(int, const model::LoadState&)> onPreloaded)
+{
+	if (m_preloading.load())
+		return false;
+
+	discardPreloadedProject();
+
+	u::log::print("[StorageApi::preloadProject] Preload project from {}\n", projectPath);
+
+	const int                sampleRate  = m_kernelAudio.getSampleRate();
+	const Resampler::Quality rsmpQuality = m_kernelAudio.getResamplerQuality();
+
+	/* Only Waves and the like are loaded here: plug-ins are created later on, 
+	from the main thread (see finishPreload()). */
+
+	m_preloading.store(true);
+	m_preloadThread = std::thread([=, this]() {
+		model::LoadState state{readPatch_(projectPath)};
+		int              res = G_RES_ERR_IO;
+
+		if (state.patch.status == G_FILE_OK)
+		{
+			std::unique_ptr<model::StagedProject> project = m_model.stage(state.patch,
+			    sampleRate, rsmpQuality, memoryBudget);
+
+			if (project == nullptr)
+				res = G_RES_ERR_MEMORY;
+			else
+			{
+				/* Do here what loadProject() does on the live model: actions and
+				sequencer frames must match the current sample rate. */
+
+				ActionRecorder::updateSamplerate(project->actions, sampleRate, state.patch.samplerate);
+				Sequencer::recomputeFrames(project->sequencer, sampleRate);
+
+				state = project->state;
+				res   = G_RES_OK;
+
+				std::scoped_lock lock(m_stagedMutex);
+				m_stagedProject = std::move(project);
+			}
+		}
+
+		u::log::print("[StorageApi::preloadProject] Preload done, res={}\n", res);
+
+		m_preloading.store(false);
+		if (onPreloaded != nullptr)
+			onPreloaded(res, state);
+	});
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void StorageApi::finishPreload()
+{
+	std::scoped_lock lock(m_stagedMutex);
+	finishPreload_();
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool StorageApi::isPreloading() const
+{
+	return m_preloading.load();
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool StorageApi::hasPreloadedProject() const
+{
+	std::scoped_lock lock(m_stagedMutex);
+	return m_stagedProject != nullptr;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void StorageApi::discardPreloadedProject()
+{
+	if (m_preloadThread.joinable())
+		m_preloadThread.join();
+
+	std::scoped_lock lock(m_stagedMutex);
+
+	/* Too late to cancel a switch the realtime thread has gone through already:
+	complete it, without notifying anyone as the project is about to be 
+	replaced anyway. */
+
+	if (m_switchPending)
+	{
+		m_sequencer.cancelCue();
+		if (!m_model.disarmSwitch())
+			completeSwitch_();
+	}
+	if (m_releaseThread.joinable())
+		m_releaseThread.join();
+
+	m_stagedProject.reset();
+	m_switchPending = false;
+	m_onSwitched    = nullptr;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool StorageApi::switchToPreloadedProject(int bar, std::function<void(const model::LoadState&)> onSwitched)
+{
+	if (m_preloading.load() || m_mixer.isRecordingInput())
+		return false;
+
+	std::unique_lock lock(m_stagedMutex);
+
+	if (m_stagedProject == nullptr || m_switchPending)
+		return false;
+
+	finishPreload_();
+
+	/* A running sequencer flips to the new project by itself, as soon as it
+	reaches the requested bar (see Engine): prepare its layout here, so that 
+	the realtime thread has nothing to do but pick it up. */
+
+	if (m_sequencer.isRunning())
+	{
+		m_model.armSwitch(*m_stagedProject);
+		m_switchPending = true;
+		m_onSwitched    = std::move(onSwitched);
+		m_sequencer.cue(bar);
+		return true;
+	}
+
+	std::unique_ptr<model::StagedProject> project = std::move(m_stagedProject);
+	const model::LoadState                state   = project->state;
+
+	u::log::print("[StorageApi::switchToPreloadedProject] Switch to project '{}'\n", project->state.patch.name);
+
+	/* Nothing is playing: the new project starts from its first beat. 
+	Everything is swapped in at once: from now on 'project' holds the old 
+	one. */
+
+	m_sequencer.rewindForced();
+	cleanUpSwitch(m_model.switchTo(std::move(project)));
+
+	lock.unlock();
+
+	if (onSwitched != nullptr)
+		onSwitched(state);
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void StorageApi::completeSwitch()
+{
+	std::unique_lock lock(m_stagedMutex);
+
+	if (!m_switchPending || !m_model.isFlipped_RT()) // Cancelled in the meantime
+		return;
+
+	const model::LoadState                       state      = m_stagedProject->state;
+	std::function<void(const model::LoadState&)> onSwitched = completeSwitch_();
+
+	lock.unlock();
+
+	if (onSwitched != nullptr)
+		onSwitched(state);
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::function<void(const model::LoadState&)> StorageApi::completeSwitch_()
+{
+	std::function<void(const model::LoadState&)> onSwitched = std::move(m_onSwitched);
+
+	m_switchPending = false;
+	m_onSwitched    = nullptr;
+
+	u::log::print("[StorageApi::completeSwitch] Switch to project '{}'\n", m_stagedProject->state.patch.name);
+
+	/* The realtime thread is playing the new project already: make it the 
+	current one. What's left is the old one. */
+
+	cleanUpSwitch(m_model.completeSwitch(std::move(m_stagedProject)));
+
+	return onSwitched;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void StorageApi::finishPreload_()
+{
+	if (m_stagedProject == nullptr || m_stagedProject->finished)
+		return;
+
+	u::log::print("[StorageApi::finishPreload] Load plug-ins for project '{}'\n", m_stagedProject->state.patch.name);
+
+	m_model.finishStage(*m_stagedProject, m_pluginManager, m_kernelAudio.getSampleRate(),
+	    m_kernelAudio.getBufferSize(), m_kernelAudio.getResamplerQuality());
+}
+
+/* -------------------------------------------------------------------------- */
+
+void StorageApi::cleanUpSwitch(std::unique_ptr<model::StagedProject> old)
+{
+	const int sampleRate = m_kernelAudio.getSampleRate();
+
+	m_peakCache.clear();
+
+	/* Update the quantizer for the new tempo and make room for input recording,
+	if the new loop is longer. The recording buffer is not in use: switching is
+	not allowed while recording. */
+
+	m_sequencer.recomputeFrames(sampleRate);
+
+	const int maxFramesInLoop = m_sequencer.getMaxFramesInLoop(sampleRate);
+	if (m_mixer.getRecBuffer().countFrames() < maxFramesInLoop)
+		m_mixer.allocRecBuffer(maxFramesInLoop);
+
+	/* Free the old project in background, as it might be large. Except for its
+	plug-ins: some of them can't be deleted outside the main thread. */
+
+	old->plugins.clear();
+
+	if (m_releaseThread.joinable())
+		m_releaseThread.join();
+	m_releaseThread = std::thread([old = std::move(old)]() mutable { old.reset(); });
+}
 } // namespace giada::m
@@ -30,8 +30,13 @@
 #include "core/model/model.h"
 #include "core/types.h"
 #include "gui/model.h"
+#include <atomic>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 namespace giada::m
@@ -43,17 +48,40 @@ class ChannelManager;
 class KernelAudio;
 class Sequencer;
 class ActionRecorder;
+class PeakCache;
 class StorageApi
 {
 public:
 	StorageApi(Engine&, model::Model&, PluginManager&, MidiSynchronizer&,
-	    Mixer&, ChannelManager&, KernelAudio&, Sequencer&, ActionRecorder&);
+	    Mixer&, ChannelManager&, KernelAudio&, Sequencer&, ActionRecorder&, PeakCache&);
+	~StorageApi();
 
 	/* storeProject
-	Saves the current project. Returns true on success. */
+	Saves the current project. Data is collected synchronously, then written to
+	disk on a background thread: only new or modified samples are written. 
+	'onSaved' is called from that thread with the final result. Returns false if
+	the save couldn't be started. */
 
 	bool storeProject(const std::string& projectPath, const v::Model&,
-	    std::function<void(float)>       progress) const;
+	    std::function<void(float)> progress, std::function<void(bool)> onSaved = nullptr);
+
+	/* commitSave
+	Marks the samples written by the last background save as saved, unless they
+	have been modified in the meantime. Call it from the main thread once 
+	'onSaved' has been fired: samples that failed to save stay dirty and will be
+	written again by the next save. */
+
+	void commitSave();
+
+	/* isSaving
+	True if a project is being written to disk in background. */
+
+	bool isSaving() const;
+
+	/* waitForSave
+	Blocks until the current background save, if any, is over. */
+
+	void waitForSave();
 
 	/* loadProject
 	Loads a new project. Returns a model::LoadState object containing the 
@@ -61,6 +89,51 @@ public:
 
 	model::LoadState loadProject(const std::string& projectPath, PluginManager::SortMethod, std::function<void(float)> progress);
 
+	/* preloadProject
+	Set-list mode: loads a project in background into a staged model, while the
+	current one keeps playing. Any project preloaded so far is discarded. 
+	'onPreloaded' is called from the loading thread with G_RES_OK, 
+	G_RES_ERR_IO (unreadable patch) or G_RES_ERR_MEMORY (audio data larger than
+	'memoryBudget' bytes, 0 = no limit). Returns false if another preload is in
+	progress. */
+
+	bool preloadProject(const std::string& projectPath, std::size_t memoryBudget,
+	    std::function<void(int, const model::LoadState&)> onPreloaded = nullptr);
+
+	/* finishPreload
+	Creates the plug-ins of the preloaded project, if any. Call it from the 
+	main thread once the preload is over: switchToPreloadedProject() does it 
+	anyway, if still needed, but plug-ins might be slow to load. */
+
+	void finishPreload();
+
+	bool isPreloading() const;
+	bool hasPreloadedProject() const;
+
+	/* discardPreloadedProject
+	Cancels a pending switch and frees the preloaded project, if any. Waits for
+	background preloads and releases to be over. */
+
+	void discardPreloadedProject();
+
+	/* switchToPreloadedProject
+	Replaces the current project with the preloaded one when the sequencer 
+	reaches bar 'bar', or right away if the sequencer is not running. The new
+	project plays from its first frame, starting with the audio block after the
+	bar. The old project is freed in background. 'onSwitched' is called with 
+	the new project's LoadState from the main thread. Returns false if there is
+	no preloaded project, a switch is pending already or input recording is in
+	progress. */
+
+	bool switchToPreloadedProject(int bar, std::function<void(const model::LoadState&)> onSwitched = nullptr);
+
+	/* completeSwitch
+	Makes the project the audio thread has switched to the current one and 
+	frees the old one. Must be called from the main thread as soon as the 
+	switch has happened, see Engine::onProjectSwitched. */
+
+	void completeSwitch();
+
 private:
 	Engine&           m_engine;
 	model::Model&     m_model;
@@ -71,6 +144,48 @@ private:
 	KernelAudio&      m_kernelAudio;
 	Sequencer&        m_sequencer;
 	ActionRecorder&   m_actionRecorder;
+	PeakCache&        m_peakCache;
+
+	/* completeSwitch_
+	Swaps in the project the audio thread has switched to. Returns the 
+	'onSwitched' callback to fire. Call it with 'm_stagedMutex' held. */
+
+	std::function<void(const model::LoadState&)> completeSwitch_();
+
+	/* finishPreload_
+	Same as finishPreload(), with 'm_stagedMutex' held. */
+
+	void finishPreload_();
+
+	/* cleanUpSwitch
+	Brings the engine in line with the project just switched to and frees the 
+	old one in background. Call it with 'm_stagedMutex' held. */
+
+	void cleanUpSwitch(std::unique_ptr<model::StagedProject> old);
+
+	std::thread       m_saveThread;
+	std::atomic<bool> m_saving;
+
+	/* m_savedWaves
+	IDs and revisions of the Waves written by the background save, waiting for
+	commitSave(). Guarded by 'm_savedMutex'. */
+
+	std::vector<std::pair<ID, int>> m_savedWaves;
+	std::mutex                      m_savedMutex;
+
+	/* m_stagedProject, m_switchPending, m_onSwitched, m_releaseThread
+	Preloaded project, pending switch to it and the thread that frees the old
+	one. Guarded by 'm_stagedMutex', as the preloaded project is handed over by
+	the preloading thread. */
+
+	std::unique_ptr<model::StagedProject>        m_stagedProject;
+	bool                                         m_switchPending;
+	std::function<void(const model::LoadState&)> m_onSwitched;
+	std::thread                                  m_releaseThread;
+	mutable std::mutex                           m_stagedMutex;
+
+	std::thread       m_preloadThread;
+	std::atomic<bool> m_preloading;
 };
 } // namespace giada::m
 
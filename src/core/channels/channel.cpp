@@ -34,9 +34,11 @@
 #include "core/plugins/pluginHost.h"
 #include "core/plugins/pluginManager.h"
 #include "core/recorder.h"
+#include <array>
 #include <cassert>
+#include <span>
 
-extern giada::m::Engine g_engine;
+extern giada::m::Engine& g_engine;
 
 namespace giada::m
 {
@@ -53,6 +55,30 @@ mcl::AudioBuffer::Pan calcPanning_(float pan)
 		return {1.0f, 1.0f};
 	return {1.0f - pan, pan};
 }
+
+/* -------------------------------------------------------------------------- */
+
+bool isPlaying_(const ChannelShared& shared)
+{
+	const ChannelStatus s = shared.playStatus.load();
+	return s == ChannelStatus::PLAY || s == ChannelStatus::ENDING;
+}
+
+/* -------------------------------------------------------------------------- */
+
+using ParamChanges_ = std::array<PluginHost::ParamChange, G_MAX_PARAM_CHANGES>;
+
+/* popParamChanges_
+Collects plug-in parameter changes for this block into 'changes'. They come in
+time order from Channel::advance(). */
+
+std::span<const PluginHost::ParamChange> popParamChanges_(ChannelShared& shared, ParamChanges_& changes)
+{
+	std::size_t count = 0;
+	while (count < changes.size() && shared.paramQueue.pop(changes[count]))
+		count++;
+	return {changes.data(), count};
+}
 } // namespace
 
 /* -------------------------------------------------------------------------- */
@@ -269,38 +295,68 @@ bool Channel::hasWave() const
 
 bool Channel::isPlaying() const
 {
-	ChannelStatus s = shared->playStatus.load();
-	return s == ChannelStatus::PLAY || s == ChannelStatus::ENDING;
+	return isPlaying_(*shared);
 }
 
 /* -------------------------------------------------------------------------- */
 
 void Channel::setMute(bool v)
 {
-	if (m_mute != v)
-		midiLighter.sendMute(v);
 	m_mute = v;
 }
 
 void Channel::setSolo(bool v)
 {
-	if (m_solo != v)
-		midiLighter.sendSolo(v);
 	m_solo = v;
 }
 
 /* -------------------------------------------------------------------------- */
 
+void Channel::recallPlayState(bool playing) const
+{
+	const ChannelStatus status = shared->playStatus.load();
+	const bool          active = status == ChannelStatus::PLAY || status == ChannelStatus::WAIT;
+
+	if (playing == active)
+		return;
+
+	/* Same as a key press: the channel starts or stops on the next bar or loop
+	start, according to its mode. */
+
+	switch (status)
+	{
+	case ChannelStatus::OFF:
+		shared->playStatus.store(ChannelStatus::WAIT);
+		break;
+	case ChannelStatus::PLAY:
+		shared->playStatus.store(ChannelStatus::ENDING);
+		break;
+	case ChannelStatus::WAIT:
+		shared->playStatus.store(ChannelStatus::OFF);
+		break;
+	case ChannelStatus::ENDING:
+		shared->playStatus.store(ChannelStatus::PLAY);
+		break;
+	default:
+		break;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
 void Channel::initCallbacks()
 {
-	shared->playStatus.onChange = [this](ChannelStatus status) {
-		midiLighter.sendStatus(status, isAudible(/*mixerHasSolos = TODO!*/ false));
+	/* Status changes might come from the realtime thread: just flag them, MIDI
+	lighting is sent later on by the MidiLightingService. */
+
+	shared->playStatus.onChange = [](ChannelStatus) {
+		g_engine.getMidiLightingService().notify();
 	};
 
 	if (samplePlayer)
 	{
-		samplePlayer->onLastFrame = [this](bool natural, bool seqIsRunning) {
-			sampleAdvancer->onLastFrame(*shared, seqIsRunning, natural, samplePlayer->mode,
+		samplePlayer->onLastFrame = [this](ChannelShared& s, bool natural, bool seqIsRunning) {
+			sampleAdvancer->onLastFrame(s, seqIsRunning, natural, samplePlayer->mode,
 			    samplePlayer->isAnyLoopMode());
 		};
 	}
@@ -310,23 +366,43 @@ void Channel::initCallbacks()
 
 void Channel::advance(const Sequencer::EventBuffer& events, Range<Frame> block, Frame quantizerStep) const
 {
-	if (shared->quantizer)
-		shared->quantizer->advance(block, quantizerStep);
+	advance(*shared, events, block, quantizerStep);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Channel::advance(ChannelShared& s, const Sequencer::EventBuffer& events, Range<Frame> block,
+    Frame quantizerStep) const
+{
+	if (s.quantizer)
+		s.quantizer->advance(block, quantizerStep);
+
+	/* Only global events and actions addressed to this channel are visited. */
+
+	events.forEach(id, [this, &s](const Sequencer::Event& e) {
+		/* Plug-in automation actions are meant for the plug-in stack only. 
+		They are played back regardless of the channel status, just like 
+		automation lanes in a DAW. */
+
+		if (e.type == Sequencer::EventType::ACTIONS && e.action->pluginId != -1)
+		{
+			s.paramQueue.push({e.action->pluginId, e.action->pluginParam,
+			    e.action->event.getVelocityFloat(), e.delta});
+			return;
+		}
 
-	for (const Sequencer::Event& e : events)
-	{
 		if (midiController)
-			midiController->advance(shared->playStatus, e);
+			midiController->advance(s.playStatus, e);
 
 		if (samplePlayer)
-			sampleAdvancer->advance(id, *shared, e, samplePlayer->mode, samplePlayer->isAnyLoopMode());
+			sampleAdvancer->advance(s, e, samplePlayer->mode, samplePlayer->isAnyLoopMode());
 
-		if (midiSender && isPlaying() && !isMuted())
-			midiSender->advance(id, e);
+		if (midiSender && isPlaying_(s) && !isMuted())
+			midiSender->advance(e);
 
-		if (midiReceiver && isPlaying())
-			midiReceiver->advance(id, shared->midiQueue, e);
-	}
+		if (midiReceiver && isPlaying_(s))
+			midiReceiver->advance(s.midiQueue, e);
+	});
 }
 
 /* -------------------------------------------------------------------------- */
@@ -338,16 +414,22 @@ void Channel::render(mcl::AudioBuffer* out, mcl::AudioBuffer* in, bool mixerHasS
 	else if (id == Mixer::MASTER_IN_CHANNEL_ID)
 		renderMasterIn(*in);
 	else
-		renderChannel(*out, *in, mixerHasSolos, seqIsRunning);
+	{
+		process(*in, seqIsRunning);
+		mix(*out, mixerHasSolos);
+	}
 }
 
 /* -------------------------------------------------------------------------- */
 
 void Channel::renderMasterOut(mcl::AudioBuffer& out) const
 {
+	ParamChanges_ paramChanges;
+	const auto    paramChangesSpan = popParamChanges_(*shared, paramChanges);
+
 	shared->audioBuffer.set(out, /*gain=*/1.0f);
 	if (plugins.size() > 0)
-		g_engine.getPluginsApi().process(shared->audioBuffer, plugins, nullptr);
+		g_engine.getPluginsApi().process(shared->audioBuffer, plugins, nullptr, paramChangesSpan);
 	out.set(shared->audioBuffer, volume);
 }
 
@@ -355,36 +437,87 @@ void Channel::renderMasterOut(mcl::AudioBuffer& out) const
 
 void Channel::renderMasterIn(mcl::AudioBuffer& in) const
 {
+	ParamChanges_ paramChanges;
+	const auto    paramChangesSpan = popParamChanges_(*shared, paramChanges);
+
 	if (plugins.size() > 0)
-		g_engine.getPluginsApi().process(in, plugins, nullptr);
+		g_engine.getPluginsApi().process(in, plugins, nullptr, paramChangesSpan);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Channel::process(const mcl::AudioBuffer& in, bool seqIsRunning) const
+{
+	process(*shared, in, seqIsRunning, /*renderSlot=*/0);
 }
 
 /* -------------------------------------------------------------------------- */
 
-void Channel::renderChannel(mcl::AudioBuffer& out, mcl::AudioBuffer& in, bool mixerHasSolos, bool seqIsRunning) const
+void Channel::process(ChannelShared& s, const mcl::AudioBuffer& in, bool seqIsRunning, int renderSlot) const
 {
-	shared->audioBuffer.clear();
+	s.audioBuffer.clear();
 
-	if (samplePlayer && isPlaying())
+	if (samplePlayer && isPlaying_(s))
 	{
+		/* Collect all render commands for this block, sorted by offset (stable,
+		so that commands on the same frame keep their order), and let the 
+		SamplePlayer render them as sub-block segments. Commands in excess are
+		dropped and counted: left in the queue, their offsets would be stale in
+		the next block. */
+
+		std::array<SamplePlayer::Render, G_MAX_RENDER_COMMANDS> commands;
+		std::size_t                                             numCommands = 0;
+		uint64_t                                                numDropped  = 0;
+
 		SamplePlayer::Render render;
-		while (shared->renderQueue->pop(render))
+		while (s.renderQueue->pop(render))
+		{
+			if (numCommands == commands.size())
+			{
+				numDropped++;
+				continue;
+			}
+			std::size_t i = numCommands++;
+			for (; i > 0 && commands[i - 1].offset > render.offset; i--)
+				commands[i] = commands[i - 1];
+			commands[i] = render;
+		}
+
+		if (numDropped > 0)
+			s.droppedRenders.store(s.droppedRenders.load() + numDropped);
+
+		samplePlayer->render(s, {commands.data(), numCommands}, seqIsRunning);
+	}
+	else if (samplePlayer)
+	{
+		/* Not playing: discard stale commands, so that they don't leak into
+		the next playback. */
+
+		SamplePlayer::Render render;
+		while (s.renderQueue->pop(render))
 			;
-		samplePlayer->render(*shared, render, seqIsRunning);
 	}
 
 	if (audioReceiver)
-		audioReceiver->render(in, shared->audioBuffer, armed);
+		audioReceiver->render(in, s.audioBuffer, armed);
+
+	ParamChanges_ paramChanges;
+	const auto    paramChangesSpan = popParamChanges_(s, paramChanges);
 
 	/* If MidiReceiver exists, let it process the plug-in stack, as it can
 	contain plug-ins that take MIDI events (i.e. synths). Otherwise process the
 	plug-in stack internally with no MIDI events. */
 
 	if (midiReceiver)
-		midiReceiver->render(*shared, plugins, g_engine.getPluginHost());
+		midiReceiver->render(s, plugins, g_engine.getPluginHost(), paramChangesSpan, renderSlot);
 	else if (plugins.size() > 0)
-		g_engine.getPluginsApi().process(shared->audioBuffer, plugins, nullptr);
+		g_engine.getPluginsApi().process(s.audioBuffer, plugins, nullptr, paramChangesSpan, renderSlot);
+}
 
+/* -------------------------------------------------------------------------- */
+
+void Channel::mix(mcl::AudioBuffer& out, bool mixerHasSolos) const
+{
 	if (isAudible(mixerHasSolos))
 		out.sum(shared->audioBuffer, volume * volume_i, calcPanning_(pan));
 }
@@ -65,17 +65,42 @@ public:
 	Channel& operator=(Channel&&) = default;
 	bool     operator==(const Channel&);
 
-	/* advance
+	/* advance (1)
 	Advances internal state by processing static events (e.g. pre-recorded 
 	actions or sequencer events) in the current block. */
 
 	void advance(const Sequencer::EventBuffer&, Range<Frame>, Frame quantizerStep) const;
 
+	/* advance (2)
+	Same as above, on state 'shared' instead of the channel's own one. Used to
+	render blocks ahead of time. */
+
+	void advance(ChannelShared&, const Sequencer::EventBuffer&, Range<Frame>, Frame quantizerStep) const;
+
 	/* render
 	Renders audio data to I/O buffers. */
 
 	void render(mcl::AudioBuffer* out, mcl::AudioBuffer* in, bool mixerHasSolos, bool seqIsRunning) const;
 
+	/* process (1)
+	First half of render() for user channels: renders samples, input and the 
+	plug-in stack into the channel's own audio buffer. */
+
+	void process(const mcl::AudioBuffer& in, bool seqIsRunning) const;
+
+	/* process (2)
+	Same as above, on state 'shared' instead of the channel's own one. A thread
+	other than the audio one must pass its own 'renderSlot' (see 
+	PluginHost::processStack). Used to render blocks ahead of time. */
+
+	void process(ChannelShared&, const mcl::AudioBuffer& in, bool seqIsRunning, int renderSlot) const;
+
+	/* mix
+	Second half of render() for user channels: sums the channel's audio buffer
+	to 'out', if audible. Must follow process(). */
+
+	void mix(mcl::AudioBuffer& out, bool mixerHasSolos) const;
+
 	bool isPlaying() const;
 	bool isInternal() const;
 	bool isMuted() const;
@@ -93,6 +118,13 @@ public:
 	void setMute(bool);
 	void setSolo(bool);
 
+	/* recallPlayState
+	Makes a loop or MIDI channel start or stop as if pressed, unless it's 
+	already in the 'playing' state (waiting included). Used to recall scenes.
+	Realtime-safe. */
+
+	void recallPlayState(bool playing) const;
+
 	ChannelShared*       shared;
 	ID                   id;
 	ChannelType          type;
@@ -124,7 +156,6 @@ public:
 private:
 	void renderMasterOut(mcl::AudioBuffer&) const;
 	void renderMasterIn(mcl::AudioBuffer&) const;
-	void renderChannel(mcl::AudioBuffer& out, mcl::AudioBuffer& in, bool mixerHasSolos, bool seqIsRunning) const;
 
 	void initCallbacks();
 
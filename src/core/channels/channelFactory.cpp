@@ -57,6 +57,9 @@ std::unique_ptr<ChannelShared> makeShared_(ChannelType type, int bufferSize, Res
 		shared->resampler.emplace(quality, G_MAX_IO_CHANS);
 	}
 
+	if (type == ChannelType::SAMPLE)
+		shared->renderLane.emplace(bufferSize);
+
 	return shared;
 }
 } // namespace
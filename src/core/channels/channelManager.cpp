@@ -98,7 +98,7 @@ Channel& ChannelManager::addChannel(ChannelType type, ID columnId, int position,
 
 	m_model.get().channels.add(data.channel);
 	m_model.addChannelShared(std::move(data.shared));
-	m_model.swap(model::SwapType::HARD);
+	m_model.swap(model::SwapType::HARD, model::Change::CHANNELS);
 
 	triggerOnChannelsAltered();
 
@@ -127,13 +127,13 @@ void ChannelManager::loadSampleChannel(ID channelId, Wave& wave)
 	const Wave* oldWave = channel.samplePlayer->getWave();
 
 	loadSampleChannel(channel, &newWave);
-	m_model.swap(model::SwapType::HARD);
+	m_model.swap(model::SwapType::HARD, {model::Change::CHANNELS, channelId});
 
 	/* Remove the old Wave, if any. It is safe to do it now: the audio thread is 
 	already processing the new layout. */
 
 	if (oldWave != nullptr)
-		m_model.removeWave(*oldWave);
+		removeWave(*oldWave);
 
 	triggerOnChannelsAltered();
 }
@@ -164,7 +164,7 @@ void ChannelManager::cloneChannel(ID channelId, int bufferSize, const std::vecto
 
 	m_model.get().channels.add(newChannelData.channel);
 	m_model.addChannelShared(std::move(newChannelData.shared));
-	m_model.swap(model::SwapType::HARD);
+	m_model.swap(model::SwapType::HARD, model::Change::CHANNELS);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -178,10 +178,10 @@ void ChannelManager::freeSampleChannel(ID channelId)
 	const Wave* wave = ch.samplePlayer->getWave();
 
 	loadSampleChannel(ch, nullptr);
-	m_model.swap(model::SwapType::HARD);
+	m_model.swap(model::SwapType::HARD, {model::Change::CHANNELS, channelId});
 
 	if (wave != nullptr)
-		m_model.removeWave(*wave);
+		removeWave(*wave);
 
 	triggerOnChannelsAltered();
 }
@@ -191,10 +191,15 @@ void ChannelManager::freeSampleChannel(ID channelId)
 void ChannelManager::freeAllSampleChannels()
 {
 	for (Channel& ch : m_model.get().channels.getAll())
-		if (ch.samplePlayer)
-			loadSampleChannel(ch, nullptr);
+	{
+		if (!ch.samplePlayer)
+			continue;
+		if (ch.samplePlayer->hasWave() && onWaveRemoved != nullptr)
+			onWaveRemoved(*ch.samplePlayer->getWave());
+		loadSampleChannel(ch, nullptr);
+	}
 
-	m_model.swap(model::SwapType::HARD);
+	m_model.swap(model::SwapType::HARD, model::Change::CHANNELS);
 	m_model.clearWaves();
 
 	triggerOnChannelsAltered();
@@ -208,10 +213,11 @@ void ChannelManager::deleteChannel(ID channelId)
 	const Wave*    wave = ch.samplePlayer ? ch.samplePlayer->getWave() : nullptr;
 
 	m_model.get().channels.remove(channelId);
-	m_model.swap(model::SwapType::HARD);
+	m_model.get().scenes.removeChannel(channelId);
+	m_model.swap(model::SwapType::HARD, {model::Change::CHANNELS, channelId});
 
 	if (wave != nullptr)
-		m_model.removeWave(*wave);
+		removeWave(*wave);
 
 	triggerOnChannelsAltered();
 }
@@ -221,7 +227,7 @@ void ChannelManager::deleteChannel(ID channelId)
 void ChannelManager::renameChannel(ID channelId, const std::string& name)
 {
 	m_model.get().channels.get(channelId).name = name;
-	m_model.swap(model::SwapType::HARD);
+	m_model.swap(model::SwapType::HARD, {model::Change::CHANNELS, channelId});
 }
 
 /* -------------------------------------------------------------------------- */
@@ -240,7 +246,7 @@ void ChannelManager::moveChannel(ID channelId, ID newColumnId, int newPosition)
 	channel.columnId = newColumnId;
 	channel.position = newPosition;
 
-	m_model.swap(model::SwapType::HARD);
+	m_model.swap(model::SwapType::HARD, {model::Change::CHANNELS, channelId});
 }
 
 /* -------------------------------------------------------------------------- */
@@ -342,7 +348,7 @@ void ChannelManager::processMidiEvent(ID channelId, const MidiEvent& e, bool can
 void ChannelManager::setInputMonitor(ID channelId, bool value)
 {
 	m_model.get().channels.get(channelId).audioReceiver->inputMonitor = value;
-	m_model.swap(model::SwapType::HARD);
+	m_model.swap(model::SwapType::HARD, {model::Change::CHANNELS, channelId});
 }
 
 /* -------------------------------------------------------------------------- */
@@ -391,7 +397,7 @@ void ChannelManager::setBeginEnd(ID channelId, Frame b, Frame e)
 
 	c.samplePlayer->begin = b;
 	c.samplePlayer->end   = e;
-	m_model.swap(model::SwapType::HARD);
+	m_model.swap(model::SwapType::HARD, {model::Change::CHANNELS, channelId});
 }
 
 void ChannelManager::resetBeginEnd(ID channelId)
@@ -402,11 +408,17 @@ void ChannelManager::resetBeginEnd(ID channelId)
 
 	c.samplePlayer->begin = 0;
 	c.samplePlayer->end   = c.samplePlayer->getWaveSize();
-	m_model.swap(model::SwapType::HARD);
+	m_model.swap(model::SwapType::HARD, {model::Change::CHANNELS, channelId});
 }
 
 /* -------------------------------------------------------------------------- */
 
+void ChannelManager::setMute(ID channelId, bool value)
+{
+	m_model.get().channels.get(channelId).setMute(value);
+	m_model.swap(model::SwapType::SOFT);
+}
+
 void ChannelManager::toggleMute(ID channelId)
 {
 	Channel& ch = m_model.get().channels.get(channelId);
@@ -470,7 +482,7 @@ void ChannelManager::setOverdubProtection(ID channelId, bool value)
 	ch.audioReceiver->overdubProtection = value;
 	if (value == true && ch.armed)
 		ch.armed = false;
-	m_model.swap(model::SwapType::HARD);
+	m_model.swap(model::SwapType::HARD, {model::Change::CHANNELS, channelId});
 }
 
 /* -------------------------------------------------------------------------- */
@@ -478,7 +490,7 @@ void ChannelManager::setOverdubProtection(ID channelId, bool value)
 void ChannelManager::setSamplePlayerMode(ID channelId, SamplePlayerMode mode)
 {
 	m_model.get().channels.get(channelId).samplePlayer->mode = mode;
-	m_model.swap(model::SwapType::HARD);
+	m_model.swap(model::SwapType::HARD, {model::Change::CHANNELS, channelId});
 }
 
 /* -------------------------------------------------------------------------- */
@@ -567,7 +579,7 @@ bool ChannelManager::saveSample(ID channelId, const std::string& filePath)
 
 	/* Reset logical and edited states in Wave. */
 
-	model::DataLock lock = m_model.lockData();
+	model::DataLock lock = m_model.lockData(model::SwapType::HARD, {model::Change::CHANNELS, channelId});
 	wave->setLogical(false);
 	wave->setEdited(false);
 
@@ -586,7 +598,55 @@ void ChannelManager::consolidateChannels(const std::unordered_set<ID>& ids)
 		if (ch.type == ChannelType::MIDI)
 			ch.shared->playStatus.store(ChannelStatus::PLAY);
 	}
-	m_model.swap(model::SwapType::HARD);
+	m_model.swap(model::SwapType::HARD, model::Change::CHANNELS);
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::vector<model::Scene::Channel> ChannelManager::getSceneChannels() const
+{
+	std::vector<model::Scene::Channel> out;
+	for (const Channel& ch : m_model.get().channels.getAll())
+		if (!ch.isInternal())
+			out.push_back({ch.id, isActive(ch), ch.isMuted(), ch.volume});
+	return out;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void ChannelManager::recallScene(const model::Scene& scene)
+{
+	const bool seqIsRunning = m_model.get().sequencer.isRunning();
+
+	std::vector<model::Scene::Channel> loops;
+
+	for (const model::Scene::Channel& sc : scene.channels)
+	{
+		if (!m_model.get().channels.anyOf([id = sc.channelId](const Channel& ch) { return ch.id == id; }))
+			continue;
+
+		const Channel& ch     = m_model.get().channels.get(sc.channelId);
+		const bool     isLoop = ch.midiController || (ch.samplePlayer && ch.samplePlayer->isAnyLoopMode());
+
+		setVolume(sc.channelId, sc.volume);
+		setMute(sc.channelId, sc.mute);
+
+		if (!isLoop)
+			continue;
+		if (seqIsRunning)
+			loops.push_back(sc);
+		else
+			ch.recallPlayState(sc.playing);
+	}
+
+	/* With the sequencer running, loop and MIDI channels must all start or 
+	stop on the same bar: let the audio thread change their play state in one
+	go, right on the next bar. */
+
+	if (seqIsRunning)
+		m_model.get().scenes.stageRecall(std::move(loops));
+
+	m_model.swap(model::SwapType::SOFT);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -621,6 +681,9 @@ void ChannelManager::loadSampleChannel(Channel& ch, Wave* w, Frame begin, Frame
 {
 	ch.samplePlayer->loadWave(*ch.shared, w, begin, end, shift);
 	ch.name = w != nullptr ? w->getBasename(/*ext=*/false) : "";
+
+	if (w != nullptr && onWaveLoaded != nullptr)
+		onWaveLoaded(*w);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -666,7 +729,7 @@ void ChannelManager::recordChannel(Channel& ch, const mcl::AudioBuffer& buffer,
 	loadSampleChannel(ch, &m_model.addWave(std::move(wave)));
 	setupChannelPostRecording(ch, currentFrame);
 
-	m_model.swap(model::SwapType::HARD);
+	m_model.swap(model::SwapType::HARD, {model::Change::CHANNELS, ch.id});
 }
 
 /* -------------------------------------------------------------------------- */
@@ -678,8 +741,9 @@ void ChannelManager::overdubChannel(Channel& ch, const mcl::AudioBuffer& buffer,
 	/* Need model::DataLock here, as data might be being read by the audio
 	thread at the same time. */
 
-	model::DataLock lock = m_model.lockData();
+	model::DataLock lock = m_model.lockData(model::SwapType::HARD, {model::Change::CHANNELS, ch.id});
 
+	wave->consolidate();
 	wave->getBuffer().sum(buffer, /*gain=*/1.0f);
 	wave->setLogical(true);
 
@@ -693,4 +757,21 @@ void ChannelManager::triggerOnChannelsAltered()
 	assert(onChannelsAltered != nullptr);
 	onChannelsAltered();
 }
+
+/* -------------------------------------------------------------------------- */
+
+void ChannelManager::removeWave(const Wave& wave)
+{
+	if (onWaveRemoved != nullptr)
+		onWaveRemoved(wave);
+	m_model.removeWave(wave);
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool ChannelManager::isActive(const Channel& ch) const
+{
+	const ChannelStatus status = ch.shared->playStatus.load();
+	return status == ChannelStatus::PLAY || status == ChannelStatus::WAIT;
+}
 } // namespace giada::m
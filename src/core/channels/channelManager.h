@@ -27,6 +27,7 @@
 #ifndef G_CHANNEL_MANAGER_H
 #define G_CHANNEL_MANAGER_H
 
+#include "core/model/scenes.h"
 #include "core/resampler.h"
 #include "core/types.h"
 #include <functional>
@@ -151,6 +152,7 @@ public:
 	void setPan(ID channelId, float value);
 	void setBeginEnd(ID channelId, Frame b, Frame e);
 	void resetBeginEnd(ID channelId);
+	void setMute(ID channelId, bool value);
 	void toggleMute(ID channelId);
 	void toggleSolo(ID channelId);
 	void toggleArm(ID channelId);
@@ -174,6 +176,21 @@ public:
 
 	void consolidateChannels(const std::unordered_set<ID>&);
 
+	/* getSceneChannels
+	Returns the current state of all user channels, ready to be stored in a 
+	Scene. */
+
+	std::vector<model::Scene::Channel> getSceneChannels() const;
+
+	/* recallScene
+	Brings the channels in a Scene back to the stored state. Volume and mute are
+	applied right away. Play state applies to loop and MIDI channels only: they
+	are toggled as if pressed, all together on the next bar if the sequencer is
+	running (see Mixer::advanceChannels). Channels no longer around are 
+	skipped. Each change swaps the layout: wrap this in a model::Transaction. */
+
+	void recallScene(const model::Scene&);
+
 	/* onChannelsAltered
 	Fired when something is done on channels (added, removed, loaded, ...). */
 
@@ -186,6 +203,16 @@ public:
 
 	std::function<std::unique_ptr<Wave>(Frame)> onChannelRecorded;
 
+	/* onWaveLoaded
+	Fired when a Wave has been loaded into a Sample channel. */
+
+	std::function<void(const Wave&)> onWaveLoaded;
+
+	/* onWaveRemoved
+	Fired when a Wave is about to be removed from the model. */
+
+	std::function<void(const Wave&)> onWaveRemoved;
+
 private:
 	void loadSampleChannel(Channel&, Wave*, Frame begin = -1, Frame end = -1, Frame shift = -1) const;
 
@@ -210,6 +237,16 @@ private:
 
 	void triggerOnChannelsAltered();
 
+	/* removeWave
+	Removes 'wave' from the model, firing onWaveRemoved first. */
+
+	void removeWave(const Wave&);
+
+	/* isActive
+	True if the channel is playing or about to play. */
+
+	bool isActive(const Channel&) const;
+
 	model::Model& m_model;
 };
 } // namespace giada::m
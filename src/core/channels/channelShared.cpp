@@ -47,5 +47,7 @@ bool ChannelShared::isReadingActions() const
 void ChannelShared::setBufferSize(int bufferSize)
 {
 	audioBuffer.alloc(bufferSize, audioBuffer.countChannels());
+	if (renderLane)
+		renderLane->setBufferSize(bufferSize);
 }
 } // namespace giada::m
\ No newline at end of file
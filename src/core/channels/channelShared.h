@@ -27,9 +27,11 @@
 #ifndef G_CHANNELSHARED_H
 #define G_CHANNELSHARED_H
 
+#include "core/channels/renderLane.h"
 #include "core/channels/samplePlayer.h"
 #include "core/const.h"
 #include "core/midiEvent.h"
+#include "core/plugins/pluginHost.h"
 #include "core/queue.h"
 #include "core/resampler.h"
 #include "deps/mcl-audio-buffer/src/audioBuffer.hpp"
@@ -41,7 +43,8 @@ namespace giada::m
 struct ChannelShared final
 {
 	using MidiQueue   = Queue<MidiEvent, 32>; // TODO - must be multi-producer (multiple midi threads)
-	using RenderQueue = Queue<SamplePlayer::Render, 2>;
+	using RenderQueue = Queue<SamplePlayer::Render, G_MAX_RENDER_COMMANDS + 1>; // One slot is always left empty
+	using ParamQueue  = Queue<PluginHost::ParamChange, G_MAX_PARAM_CHANGES + 1>;
 
 	ChannelShared(Frame bufferSize);
 
@@ -56,11 +59,23 @@ struct ChannelShared final
 	juce::MidiBuffer midiBuffer;
 	MidiQueue        midiQueue;
 
+	/* paramQueue
+	Plug-in parameter changes coming from automation actions, filled during
+	advance() and consumed by the plug-in stack in render(). */
+
+	ParamQueue paramQueue;
+
 	WeakAtomic<Frame>         tracker     = 0;
 	WeakAtomic<ChannelStatus> playStatus  = ChannelStatus::OFF;
 	WeakAtomic<ChannelStatus> recStatus   = ChannelStatus::OFF;
 	WeakAtomic<bool>          readActions = false;
 
+	/* droppedRenders
+	Render commands dropped so far because a block had more than 
+	G_MAX_RENDER_COMMANDS of them. Written by the rendering thread only. */
+
+	WeakAtomic<uint64_t> droppedRenders = 0;
+
 	std::optional<Quantizer> quantizer;
 
 	/* Optional render queue for sample-based channels. Used by SampleReactor
@@ -74,6 +89,11 @@ struct ChannelShared final
 	changes by the Swapper mechanism). Let's put it in the shared state here. */
 
 	std::optional<Resampler> resampler = {};
+
+	/* Optional render lane for Sample Channels, filled with blocks rendered
+	ahead of time by RenderAhead. */
+
+	std::optional<RenderLane> renderLane = {};
 };
 } // namespace giada::m
 
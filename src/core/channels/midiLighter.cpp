@@ -53,59 +53,77 @@ MidiLighter<KernelMidiI>::MidiLighter(MidiMapper<KernelMidiI>& m, const Patch::C
 /* -------------------------------------------------------------------------- */
 
 template <typename KernelMidiI>
-void MidiLighter<KernelMidiI>::sendStatus(ChannelStatus status, bool audible) const
+const MidiMap::Message* MidiLighter<KernelMidiI>::getStatusMessage(ChannelStatus status, bool audible) const
 {
-	const MidiMap& midiMap   = m_midiMapper->currentMap;
-	const uint32_t l_playing = playing.getValue();
+	const MidiMap& midiMap = m_midiMapper->currentMap;
 
-	if (l_playing == 0x0)
-		return;
+	if (playing.getValue() == 0x0)
+		return nullptr;
 
 	switch (status)
 	{
 	case ChannelStatus::OFF:
-		send(l_playing, midiMap.stopped);
-		break;
-
+		return &midiMap.stopped;
 	case ChannelStatus::WAIT:
-		send(l_playing, midiMap.waiting);
-		break;
-
+		return &midiMap.waiting;
 	case ChannelStatus::ENDING:
-		send(l_playing, midiMap.stopping);
-		break;
-
+		return &midiMap.stopping;
 	case ChannelStatus::PLAY:
-		send(l_playing, audible ? midiMap.playing : midiMap.playingInaudible);
-		break;
-
+		return audible ? &midiMap.playing : &midiMap.playingInaudible;
 	default:
-		break;
+		return nullptr;
 	}
 }
 
 /* -------------------------------------------------------------------------- */
 
 template <typename KernelMidiI>
-void MidiLighter<KernelMidiI>::sendMute(bool isMuted) const
+const MidiMap::Message* MidiLighter<KernelMidiI>::getMuteMessage(bool isMuted) const
 {
 	const MidiMap& midiMap = m_midiMapper->currentMap;
-	const uint32_t l_mute  = mute.getValue();
 
-	if (l_mute != 0x0)
-		send(l_mute, isMuted ? midiMap.muteOn : midiMap.muteOff);
+	if (mute.getValue() == 0x0)
+		return nullptr;
+	return isMuted ? &midiMap.muteOn : &midiMap.muteOff;
 }
 
 /* -------------------------------------------------------------------------- */
 
 template <typename KernelMidiI>
-void MidiLighter<KernelMidiI>::sendSolo(bool isSoloed) const
+const MidiMap::Message* MidiLighter<KernelMidiI>::getSoloMessage(bool isSoloed) const
 {
 	const MidiMap& midiMap = m_midiMapper->currentMap;
-	const uint32_t l_solo  = solo.getValue();
 
-	if (l_solo != 0x0)
-		send(l_solo, isSoloed ? midiMap.soloOn : midiMap.soloOff);
+	if (solo.getValue() == 0x0)
+		return nullptr;
+	return isSoloed ? &midiMap.soloOn : &midiMap.soloOff;
+}
+
+/* -------------------------------------------------------------------------- */
+
+template <typename KernelMidiI>
+void MidiLighter<KernelMidiI>::sendStatus(ChannelStatus status, bool audible) const
+{
+	if (const MidiMap::Message* msg = getStatusMessage(status, audible); msg != nullptr)
+		send(playing.getValue(), *msg);
+}
+
+/* -------------------------------------------------------------------------- */
+
+template <typename KernelMidiI>
+void MidiLighter<KernelMidiI>::sendMute(bool isMuted) const
+{
+	if (const MidiMap::Message* msg = getMuteMessage(isMuted); msg != nullptr)
+		send(mute.getValue(), *msg);
+}
+
+/* -------------------------------------------------------------------------- */
+
+template <typename KernelMidiI>
+void MidiLighter<KernelMidiI>::sendSolo(bool isSoloed) const
+{
+	if (const MidiMap::Message* msg = getSoloMessage(isSoloed); msg != nullptr)
+		send(solo.getValue(), *msg);
 }
 
 /* -------------------------------------------------------------------------- */
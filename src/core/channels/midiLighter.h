@@ -42,6 +42,14 @@ public:
 	MidiLighter(MidiMapper<KernelMidiI>&, const Patch::Channel&);
 	MidiLighter(const MidiLighter& o) = default;
 
+	/* get[Status|Mute|Solo]Message
+	Return the midimap message that displays the given state on the controller,
+	or nullptr if there's nothing to display. */
+
+	const MidiMap::Message* getStatusMessage(ChannelStatus, bool audible) const;
+	const MidiMap::Message* getMuteMessage(bool isMuted) const;
+	const MidiMap::Message* getSoloMessage(bool isSoloed) const;
+
 	void sendStatus(ChannelStatus, bool audible) const;
 	void sendMute(bool isMuted) const;
 	void sendSolo(bool isSoloed) const;
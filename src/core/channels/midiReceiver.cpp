@@ -30,18 +30,16 @@
 
 namespace giada::m
 {
-void MidiReceiver::advance(ID channelId, ChannelShared::MidiQueue& midiQueue, const Sequencer::Event& e) const
+void MidiReceiver::advance(ChannelShared::MidiQueue& midiQueue, const Sequencer::Event& e) const
 {
-	if (e.type != Sequencer::EventType::ACTIONS)
-		return;
-	for (const Action& action : *e.actions)
-		if (action.channelId == channelId)
-			sendToPlugins(midiQueue, action.event, e.delta);
+	if (e.type == Sequencer::EventType::ACTIONS)
+		sendToPlugins(midiQueue, e.action->event, e.delta);
 }
 
 /* -------------------------------------------------------------------------- */
 
-void MidiReceiver::render(ChannelShared& shared, const std::vector<Plugin*>& plugins, PluginHost& pluginHost) const
+void MidiReceiver::render(ChannelShared& shared, const std::vector<Plugin*>& plugins,
+    PluginHost& pluginHost, std::span<const PluginHost::ParamChange> paramChanges, int renderSlot) const
 {
 	shared.midiBuffer.clear();
 
@@ -55,7 +53,7 @@ void MidiReceiver::render(ChannelShared& shared, const std::vector<Plugin*>& plu
 		shared.midiBuffer.addEvent(message, e.getDelta());
 	}
 
-	pluginHost.processStack(shared.audioBuffer, plugins, &shared.midiBuffer);
+	pluginHost.processStack(shared.audioBuffer, plugins, &shared.midiBuffer, paramChanges, renderSlot);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -32,13 +32,13 @@
 
 namespace giada::m
 {
-class PluginHost;
 class Plugin;
 class MidiReceiver final
 {
 public:
-	void advance(ID channelId, ChannelShared::MidiQueue&, const Sequencer::Event&) const;
-	void render(ChannelShared&, const std::vector<Plugin*>&, PluginHost&) const;
+	void advance(ChannelShared::MidiQueue&, const Sequencer::Event&) const;
+	void render(ChannelShared&, const std::vector<Plugin*>&, PluginHost&,
+	    std::span<const PluginHost::ParamChange> paramChanges, int renderSlot) const;
 
 	void parseMidi(ChannelShared::MidiQueue&, const MidiEvent&) const;
 	void stop(ChannelShared::MidiQueue&) const;
@@ -49,12 +49,12 @@ MidiSender::MidiSender(const Patch::Channel& p, KernelMidi& k)
 
 /* -------------------------------------------------------------------------- */
 
-void MidiSender::advance(ID channelId, const Sequencer::Event& e) const
+void MidiSender::advance(const Sequencer::Event& e) const
 {
 	if (!enabled)
 		return;
 	if (e.type == Sequencer::EventType::ACTIONS)
-		parseActions(channelId, *e.actions);
+		send(e.action->event, e.delta);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -76,12 +76,12 @@ void MidiSender::send(MidiEvent e) const
 	onSend();
 }
 
-/* -------------------------------------------------------------------------- */
-
-void MidiSender::parseActions(ID channelId, const std::vector<Action>& as) const
+void MidiSender::send(MidiEvent e, Frame delta) const
 {
-	for (const Action& a : as)
-		if (a.channelId == channelId)
-			send(a.event);
+	assert(onSend != nullptr);
+
+	e.setChannel(filter);
+	kernelMidi->sendAtFrame(e, delta);
+	onSend();
 }
 } // namespace giada::m
\ No newline at end of file
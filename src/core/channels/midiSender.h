@@ -40,7 +40,7 @@ public:
 	MidiSender(const Patch::Channel& p, KernelMidi&);
 	MidiSender(const MidiSender& o) = default;
 
-	void advance(ID channelId, const Sequencer::Event& e) const;
+	void advance(const Sequencer::Event& e) const;
 
 	void stop();
 
@@ -62,8 +62,12 @@ public:
 	std::function<void()> onSend;
 
 private:
+	/* send
+	Sends a MIDI event right away, or 'delta' frames after the beginning of the
+	current audio block if called from the audio thread during advance(). */
+
 	void send(MidiEvent e) const;
-	void parseActions(ID channelId, const std::vector<Action>& as) const;
+	void send(MidiEvent e, Frame delta) const;
 };
 } // namespace giada::m
 
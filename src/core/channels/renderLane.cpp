@@ -0,0 +1,175 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#include "core/channels/renderLane.h"
+#include <cassert>
+
+namespace giada::m
+{
+namespace
+{
+/* MAX_SPINS
+Busy-wait iterations before giving up on a worker busy with a block. Workers
+run at the audio thread priority and a block takes no longer than rendering it
+in the callback, so this is rarely reached: mostly when the worker has been 
+scheduled on the audio thread core and can't run until the callback returns. */
+
+constexpr int MAX_SPINS = 1 << 20;
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+RenderLane::RenderLane(int bufferSize)
+: hold(0)
+, rendered(false)
+, m_head(0)
+, m_tail(0)
+, m_owner(Owner::AUDIO)
+{
+	setBufferSize(bufferSize);
+}
+
+/* -------------------------------------------------------------------------- */
+
+RenderLane::Owner RenderLane::getOwner() const
+{
+	return m_owner.load();
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool RenderLane::isEmpty() const
+{
+	return m_head.load() == m_tail.load();
+}
+
+bool RenderLane::isFull() const
+{
+	return increment(m_tail.load()) == m_head.load();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void RenderLane::setBufferSize(int bufferSize)
+{
+	for (Block& block : m_blocks)
+		block.audio.alloc(bufferSize, G_MAX_IO_CHANS);
+}
+
+/* -------------------------------------------------------------------------- */
+
+const RenderLane::Block* RenderLane::front() const
+{
+	if (isEmpty())
+		return nullptr;
+	return &m_blocks[m_head.load()];
+}
+
+void RenderLane::pop()
+{
+	assert(!isEmpty());
+	m_head.store(increment(m_head.load()));
+}
+
+void RenderLane::flush()
+{
+	m_head.store(m_tail.load());
+}
+
+/* -------------------------------------------------------------------------- */
+
+void RenderLane::handOver(Cursor c)
+{
+	assert(m_owner.load() == Owner::AUDIO);
+
+	flush();
+	cursor = c;
+	m_owner.store(Owner::AHEAD); // Publishes 'cursor' to workers
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool RenderLane::reclaim()
+{
+	Owner expected = Owner::AHEAD;
+	for (int spins = 0; !m_owner.compare_exchange_weak(expected, Owner::AUDIO); spins++)
+	{
+		if (expected == Owner::AUDIO)
+			return true;
+		if (spins >= MAX_SPINS)
+			return false;
+		expected = Owner::AHEAD;
+	}
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool RenderLane::wait() const
+{
+	for (int spins = 0; m_owner.load() == Owner::BUSY; spins++)
+		if (spins >= MAX_SPINS)
+			return false;
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool RenderLane::tryAcquire()
+{
+	Owner expected = Owner::AHEAD;
+	return m_owner.compare_exchange_strong(expected, Owner::BUSY);
+}
+
+void RenderLane::release()
+{
+	assert(m_owner.load() == Owner::BUSY);
+	m_owner.store(Owner::AHEAD);
+}
+
+/* -------------------------------------------------------------------------- */
+
+RenderLane::Block& RenderLane::back()
+{
+	return m_blocks[m_tail.load()];
+}
+
+void RenderLane::push()
+{
+	assert(!isFull());
+	m_tail.store(increment(m_tail.load()));
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::size_t RenderLane::increment(std::size_t i) const
+{
+	return (i + 1) % SIZE;
+}
+} // namespace giada::m
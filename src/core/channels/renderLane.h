@@ -0,0 +1,189 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+
+#ifndef G_CHANNEL_RENDER_LANE_H
+#define G_CHANNEL_RENDER_LANE_H
+
+#include "core/const.h"
+#include "core/types.h"
+#include "deps/mcl-audio-buffer/src/audioBuffer.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace giada::m
+{
+/* RenderLane
+FIFO of audio blocks rendered ahead of time for a Sample Channel by a 
+RenderAhead worker (the producer), then picked up by the audio thread (the 
+consumer). The two threads take turns in rendering the channel: plug-ins and
+resampler are stateful, and only the current owner can touch them. */
+
+class RenderLane final
+{
+public:
+	/* State
+	Channel state that evolves while rendering and is carried over from one 
+	block to the next one. */
+
+	struct State
+	{
+		bool operator==(const State&) const = default;
+
+		Frame         tracker     = 0;
+		ChannelStatus playStatus  = ChannelStatus::OFF;
+		ChannelStatus recStatus   = ChannelStatus::OFF;
+		bool          readActions = false;
+	};
+
+	/* Block
+	A block of audio starting at sequencer frame 'frame', rendered with 
+	settings 'key' while the channel went from state 'begin' to state 'end'. */
+
+	struct Block
+	{
+		Frame            frame = 0;
+		uint64_t         key   = 0;
+		State            begin;
+		State            end;
+		mcl::AudioBuffer audio;
+	};
+
+	/* Cursor
+	Where the next block to render starts. */
+
+	struct Cursor
+	{
+		Frame frame = 0;
+		State state;
+	};
+
+	/* Owner
+	AUDIO - the audio thread renders the channel in the callback;
+	AHEAD - a worker can render ahead, but is not doing it right now;
+	BUSY  - a worker is rendering ahead. */
+
+	enum class Owner
+	{
+		AUDIO,
+		AHEAD,
+		BUSY
+	};
+
+	RenderLane(int bufferSize);
+
+	RenderLane(const RenderLane&)            = delete;
+	RenderLane(RenderLane&&)                 = delete;
+	RenderLane& operator=(const RenderLane&) = delete;
+	RenderLane& operator=(RenderLane&&)      = delete;
+
+	Owner getOwner() const;
+	bool  isEmpty() const;
+	bool  isFull() const;
+
+	/* setBufferSize
+	Resizes the blocks. Not realtime-safe: call it only when neither the audio
+	thread nor the workers are using the lane. */
+
+	void setBufferSize(int);
+
+	/* front, pop, flush [audio thread]
+	Read the oldest block, if any (nullptr otherwise), discard it or discard 
+	them all. */
+
+	const Block* front() const;
+	void         pop();
+	void         flush();
+
+	/* handOver [audio thread]
+	Lets workers render the channel from 'cursor' on. The lane must be owned by
+	the audio thread. */
+
+	void handOver(Cursor);
+
+	/* reclaim [audio thread]
+	Takes the lane back from workers, spinning for a while if one of them is 
+	busy with a block. Returns false if the worker didn't finish in time: the 
+	lane is still theirs. Returns true right away if the lane is already owned
+	by the audio thread. */
+
+	bool reclaim();
+
+	/* wait [audio thread]
+	Spins for a while if a worker is busy with a block. Returns false if the 
+	worker didn't finish in time. */
+
+	bool wait() const;
+
+	/* tryAcquire, release [worker]
+	Start and end rendering a block. tryAcquire() returns false if the lane is
+	not available for rendering ahead. */
+
+	bool tryAcquire();
+	void release();
+
+	/* back, push [worker]
+	Give access to the block to fill next, then publish it. Call push() only if
+	the lane is not full. */
+
+	Block& back();
+	void   push();
+
+	/* cursor
+	Position and state of the next block to render. Owned by whoever owns the
+	lane. */
+
+	Cursor cursor;
+
+	/* hold
+	Number of blocks the audio thread waits for before handing the lane over
+	again. Audio thread only. */
+
+	int hold;
+
+	/* rendered
+	Tells whether the current block has been taken from the lane, so that the
+	channel doesn't need to be processed in the callback. Audio thread only. */
+
+	bool rendered;
+
+private:
+	/* One slot is always left empty to tell a full FIFO from an empty one. */
+
+	static constexpr std::size_t SIZE = G_RENDER_AHEAD_BLOCKS + 1;
+
+	std::size_t increment(std::size_t) const;
+
+	std::array<Block, SIZE>  m_blocks;
+	std::atomic<std::size_t> m_head;
+	std::atomic<std::size_t> m_tail;
+	std::atomic<Owner>       m_owner;
+};
+} // namespace giada::m
+
+#endif
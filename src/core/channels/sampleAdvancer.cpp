@@ -59,7 +59,7 @@ void SampleAdvancer::onLastFrame(ChannelShared& shared, bool seqIsRunning, bool
 
 /* -------------------------------------------------------------------------- */
 
-void SampleAdvancer::advance(ID channelId, ChannelShared& shared,
+void SampleAdvancer::advance(ChannelShared& shared,
     const Sequencer::Event& e, SamplePlayerMode mode, bool isLoop) const
 {
 	switch (e.type)
@@ -79,7 +79,7 @@ void SampleAdvancer::advance(ID channelId, ChannelShared& shared,
 
 	case Sequencer::EventType::ACTIONS:
 		if (!isLoop && shared.isReadingActions())
-			parseActions(channelId, shared, *e.actions, e.delta, mode);
+			parseAction(shared, *e.action, e.delta, mode);
 		break;
 
 	default:
@@ -190,29 +190,23 @@ void SampleAdvancer::onNoteOn(ChannelShared& shared, Frame localFrame, SamplePla
 
 /* -------------------------------------------------------------------------- */
 
-void SampleAdvancer::parseActions(ID channelId, ChannelShared& shared,
-    const std::vector<Action>& as, Frame localFrame, SamplePlayerMode mode) const
+void SampleAdvancer::parseAction(ChannelShared& shared, const Action& a,
+    Frame localFrame, SamplePlayerMode mode) const
 {
-	for (const Action& a : as)
+	switch (a.event.getStatus())
 	{
-		if (a.channelId != channelId)
-			continue;
-
-		switch (a.event.getStatus())
-		{
-		case MidiEvent::CHANNEL_NOTE_ON:
-			onNoteOn(shared, localFrame, mode);
-			break;
-
-		case MidiEvent::CHANNEL_NOTE_OFF:
-		case MidiEvent::CHANNEL_NOTE_KILL:
-			if (shared.playStatus.load() == ChannelStatus::PLAY)
-				stop(shared, localFrame);
-			break;
-
-		default:
-			break;
-		}
+	case MidiEvent::CHANNEL_NOTE_ON:
+		onNoteOn(shared, localFrame, mode);
+		break;
+
+	case MidiEvent::CHANNEL_NOTE_OFF:
+	case MidiEvent::CHANNEL_NOTE_KILL:
+		if (shared.playStatus.load() == ChannelStatus::PLAY)
+			stop(shared, localFrame);
+		break;
+
+	default:
+		break;
 	}
 }
 } // namespace giada::m
\ No newline at end of file
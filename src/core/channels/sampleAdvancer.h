@@ -36,7 +36,7 @@ class SampleAdvancer final
 {
 public:
 	void onLastFrame(ChannelShared&, bool seqIsRunning, bool natural, SamplePlayerMode, bool isLoop) const;
-	void advance(ID channelId, ChannelShared&, const Sequencer::Event&, SamplePlayerMode, bool isLoop) const;
+	void advance(ChannelShared&, const Sequencer::Event&, SamplePlayerMode, bool isLoop) const;
 
 private:
 	void rewind(ChannelShared&, Frame localFrame) const;
@@ -45,7 +45,7 @@ private:
 	void onFirstBeat(ChannelShared&, Frame localFrame, bool isLoop) const;
 	void onBar(ChannelShared&, Frame localFrame, SamplePlayerMode) const;
 	void onNoteOn(ChannelShared&, Frame localFrame, SamplePlayerMode) const;
-	void parseActions(ID channelId, ChannelShared&, const std::vector<Action>&, Frame localFrame, SamplePlayerMode) const;
+	void parseAction(ChannelShared&, const Action&, Frame localFrame, SamplePlayerMode) const;
 };
 } // namespace giada::m
 
@@ -93,59 +93,109 @@ ID SamplePlayer::getWaveId() const
 
 Frame SamplePlayer::getWaveSize() const
 {
-	return hasWave() ? waveReader.wave->getBuffer().countFrames() : 0;
+	return hasWave() ? waveReader.wave->countFrames() : 0;
 }
 
 /* -------------------------------------------------------------------------- */
 
-void SamplePlayer::render(ChannelShared& shared, Render renderInfo, bool seqIsRunning) const
+void SamplePlayer::render(ChannelShared& shared, std::span<const Render> commands,
+    bool seqIsRunning) const
 {
 	if (waveReader.wave == nullptr)
 		return;
 
-	mcl::AudioBuffer&   buf     = shared.audioBuffer;
-	Frame               tracker = std::clamp(shared.tracker.load(), begin, end); /* Make sure tracker stays within begin-end range. */
-	const ChannelStatus status  = shared.playStatus.load();
+	mcl::AudioBuffer&   buf        = shared.audioBuffer;
+	Frame               tracker    = std::clamp(shared.tracker.load(), begin, end); /* Make sure tracker stays within begin-end range. */
+	const ChannelStatus status     = shared.playStatus.load();
+	const Frame         bufferSize = buf.countFrames();
 
-	if (renderInfo.mode == Render::Mode::NORMAL)
-	{
-		tracker = render(buf, tracker, renderInfo.offset, status, seqIsRunning);
-	}
-	else
+	/* A leading NORMAL command starts the playback mid-block, so the buffer is
+	silent before it. Otherwise the sample was already playing. */
+
+	bool  playing = commands.empty() || commands.front().mode != Render::Mode::NORMAL;
+	bool  stopped = false;
+	Frame cursor  = 0;
+
+	for (const Render& command : commands)
 	{
-		/* Both modes: 1st = [abcdefghijklmnopq] 
+		const Frame offset = std::clamp(command.offset, cursor, bufferSize - 1);
+
+		/* A command landing after a STOP in the same block is honored only if
+		the channel is still playing, i.e. onLastFrame() listeners didn't 
+		stop it. */
+
+		if (stopped)
+		{
+			const ChannelStatus s = shared.playStatus.load();
+			if (s != ChannelStatus::PLAY && s != ChannelStatus::ENDING)
+				break;
+			stopped = false;
+		}
+
+		if (command.mode == Render::Mode::NORMAL)
+		{
+			/* Already playing: nothing changes, no need to split the block. */
+
+			if (!playing)
+			{
+				playing = true;
+				cursor  = offset;
+			}
+			continue;
+		}
+
+		/* Both modes: 1st = [abcdefghi|--------]
 		No need for fancy render() here. You don't want the chance to trigger 
-		onLastFrame() at this point which would invalidate the rewind (a listener
-		might stop the rendering): fillBuffer() is just enough. Just notify 
-		waveReader this is the last read before rewind. */
+		onLastFrame() at this point which would invalidate the rewind (a 
+		listener might stop the rendering): fillBuffer() is just enough. Just
+		notify waveReader this is the last read before rewind. */
 
-		tracker = fillBuffer(buf, tracker, 0).used;
+		if (playing && offset > cursor)
+			fillBuffer(buf, tracker, cursor, offset - cursor);
 		waveReader.last();
 
 		/* Mode::REWIND: 2nd = [abcdefghi|abcdfefg]
 		   Mode::STOP:   2nd = [abcdefghi|--------] */
 
-		if (renderInfo.mode == Render::Mode::REWIND)
-			tracker = render(buf, begin, renderInfo.offset, status, seqIsRunning);
-		else
-			tracker = stop(buf, renderInfo.offset, seqIsRunning);
+		if (command.mode == Render::Mode::REWIND)
+		{
+			tracker = begin;
+			playing = true;
+		}
+		else if (playing)
+		{
+			tracker = stop(shared, offset, seqIsRunning);
+			playing = false;
+			stopped = true;
+		}
+
+		cursor = offset;
 	}
 
+	if (playing)
+		tracker = render(shared, tracker, {cursor, bufferSize}, status, seqIsRunning);
+
 	shared.tracker.store(tracker);
 }
 
 /* -------------------------------------------------------------------------- */
 
-Frame SamplePlayer::render(mcl::AudioBuffer& buf, Frame tracker, Frame offset, ChannelStatus status, bool seqIsRunning) const
+Frame SamplePlayer::render(ChannelShared& shared, Frame tracker, Range<Frame> segment,
+    ChannelStatus status, bool seqIsRunning) const
 {
+	if (segment.getLength() <= 0)
+		return tracker;
+
+	mcl::AudioBuffer& buf = shared.audioBuffer;
+
 	/* First pass rendering. */
 
-	WaveReader::Result res = fillBuffer(buf, tracker, offset);
+	WaveReader::Result res = fillBuffer(buf, tracker, segment.getBegin(), segment.getLength());
 	tracker += res.used;
 
 	/* Second pass rendering: if tracker has looped, special care is needed. If 
-	the	channel is in loop mode, fill the second part of the buffer with data
-	coming from the sample's head, starting at 'res.generated' offset. */
+	the	channel is in loop mode, fill the second part of the segment with data
+	coming from the sample's head, starting right after the generated frames. */
 
 	if (tracker >= end)
 	{
@@ -153,10 +203,12 @@ Frame SamplePlayer::render(mcl::AudioBuffer& buf, Frame tracker, Frame offset, C
 
 		tracker = begin;
 		waveReader.last();
-		onLastFrame(/*natural=*/true, seqIsRunning);
+		onLastFrame(shared, /*natural=*/true, seqIsRunning);
 
-		if (shouldLoop(status) && res.generated < buf.countFrames())
-			tracker += fillBuffer(buf, tracker, res.generated).used;
+		if (shouldLoop(status) && res.generated < segment.getLength())
+			tracker += fillBuffer(buf, tracker, segment.getBegin() + res.generated,
+			    segment.getLength() - res.generated)
+			               .used;
 	}
 
 	return tracker;
@@ -164,14 +216,14 @@ Frame SamplePlayer::render(mcl::AudioBuffer& buf, Frame tracker, Frame offset, C
 
 /* -------------------------------------------------------------------------- */
 
-Frame SamplePlayer::stop(mcl::AudioBuffer& buf, Frame offset, bool seqIsRunning) const
+Frame SamplePlayer::stop(ChannelShared& shared, Frame offset, bool seqIsRunning) const
 {
 	assert(onLastFrame != nullptr);
 
-	onLastFrame(/*natural=*/false, seqIsRunning);
+	onLastFrame(shared, /*natural=*/false, seqIsRunning);
 
 	if (offset != 0)
-		buf.clear(offset);
+		shared.audioBuffer.clear(offset);
 
 	return begin;
 }
@@ -192,7 +244,7 @@ void SamplePlayer::loadWave(ChannelShared& shared, Wave* w, Frame newBegin, Fram
 	{
 		shift = newShift == -1 ? 0 : newShift;
 		begin = newBegin == -1 ? 0 : newBegin;
-		end   = newEnd == -1 ? w->getBuffer().countFrames() - 1 : newEnd;
+		end   = newEnd == -1 ? w->countFrames() - 1 : newEnd;
 	}
 }
 
@@ -226,9 +278,10 @@ void SamplePlayer::kickIn(ChannelShared& shared, Frame f)
 
 /* -------------------------------------------------------------------------- */
 
-WaveReader::Result SamplePlayer::fillBuffer(mcl::AudioBuffer& buf, Frame start, Frame offset) const
+WaveReader::Result SamplePlayer::fillBuffer(mcl::AudioBuffer& buf, Frame start,
+    Frame offset, Frame length) const
 {
-	return waveReader.fill(buf, start, end, offset, pitch);
+	return waveReader.fill(buf, start, end, offset, pitch, length);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -30,9 +30,11 @@
 #include "core/channels/waveReader.h"
 #include "core/const.h"
 #include "core/patch.h"
+#include "core/range.h"
 #include "core/sequencer.h"
 #include "core/types.h"
 #include <functional>
+#include <span>
 
 namespace giada::m
 {
@@ -47,7 +49,8 @@ public:
 	Mode::REWIND - two-step rendering, used when the sample must rewind at some
 		point ('offset') in the audio buffer;
 	Mode::STOP - abort rendering. The audio buffer is silenced starting at
-	'offset'. Also triggers onLastFrame(). */
+	'offset'. Also triggers onLastFrame(). 
+	Several commands can target the same block: see render() below. */
 
 	struct Render
 	{
@@ -72,7 +75,14 @@ public:
 	ID    getWaveId() const;
 	Frame getWaveSize() const;
 	Wave* getWave() const;
-	void  render(ChannelShared&, Render, bool seqIsRunning) const;
+
+	/* render
+	Renders the current block into the shared audio buffer. 'commands' are the
+	Render commands received for this block, sorted by offset: the block is 
+	split into sub-block segments at each command's offset, so that each one 
+	takes effect on its exact frame. No commands: keep on playing. */
+
+	void render(ChannelShared&, std::span<const Render> commands, bool seqIsRunning) const;
 
 	/* loadWave
 	Loads Wave and sets it up (name, markers, ...). Also updates Channel's shared
@@ -105,25 +115,26 @@ public:
 	Callback fired when the last frame has been reached. 'natural' == true
 	if the rendering has ended because the end of the sample has ben reached. 
 	'natural' == false if the rendering has been manually interrupted (by
-	a Render::Mode::STOP type). */
+	a Render::Mode::STOP type). Receives the state being rendered. */
 
-	std::function<void(bool natural, bool seqIsRunning)> onLastFrame;
+	std::function<void(ChannelShared&, bool natural, bool seqIsRunning)> onLastFrame;
 
 private:
 	/* render
 	Renders audio into the buffer. Reads audio data from 'tracker' and copies it
-	into the audio buffer at position 'offset'. May fire 'onLastFrame' callback
-	if the sample end is reached. */
+	into the audio buffer within 'segment'. May fire 'onLastFrame' callback if 
+	the sample end is reached. */
 
-	Frame render(mcl::AudioBuffer&, Frame tracker, Frame offset, ChannelStatus, bool seqIsRunning) const;
+	Frame render(ChannelShared&, Frame tracker, Range<Frame> segment, ChannelStatus,
+	    bool seqIsRunning) const;
 
 	/* stop
 	Silences the last part of the audio buffer, starting at 'offset'. Used to
 	terminate rendering. It also fire the 'onLastFrame' callback. */
 
-	Frame stop(mcl::AudioBuffer&, Frame offset, bool seqIsRunning) const;
+	Frame stop(ChannelShared&, Frame offset, bool seqIsRunning) const;
 
-	WaveReader::Result fillBuffer(mcl::AudioBuffer&, Frame start, Frame offset) const;
+	WaveReader::Result fillBuffer(mcl::AudioBuffer&, Frame start, Frame offset, Frame length) const;
 	bool               shouldLoop(ChannelStatus) const;
 };
 } // namespace giada::m
@@ -45,30 +45,42 @@ WaveReader::WaveReader(Resampler* r)
 /* -------------------------------------------------------------------------- */
 
 WaveReader::Result WaveReader::fill(mcl::AudioBuffer& out, Frame start, Frame max,
-    Frame offset, float pitch) const
+    Frame offset, float pitch, Frame length) const
 {
 	assert(wave != nullptr);
 	assert(start >= 0);
-	assert(max <= wave->getBuffer().countFrames());
+	assert(max <= wave->countFrames());
 	assert(offset < out.countFrames());
 
+	const Frame available = out.countFrames() - offset;
+	length                = length < 0 ? available : std::min(length, available);
+
 	if (pitch == 1.0f)
-		return fillCopy(out, start, max, offset);
+		return fillCopy(out, start, max, offset, length);
 	else
-		return fillResampled(out, start, max, offset, pitch);
+		return fillResampled(out, start, max, offset, length, pitch);
+}
+
+/* -------------------------------------------------------------------------- */
+
+Resampler::Input WaveReader::readWave(const void* wave, long pos)
+{
+	const Wave::Chunk chunk = static_cast<const Wave*>(wave)->getChunk(pos);
+	return {chunk.data, chunk.length};
 }
 
 /* -------------------------------------------------------------------------- */
 
 WaveReader::Result WaveReader::fillResampled(mcl::AudioBuffer& dest, Frame start,
-    Frame max, Frame offset, float pitch) const
+    Frame max, Frame offset, Frame length, float pitch) const
 {
 	Resampler::Result res = m_resampler->process(
-	    /*input=*/wave->getBuffer()[0],
+	    /*reader=*/readWave,
+	    /*context=*/wave,
 	    /*inputPos=*/start,
 	    /*inputLen=*/max,
 	    /*output=*/dest[offset],
-	    /*outputLen=*/dest.countFrames() - offset,
+	    /*outputLen=*/length,
 	    /*pitch=*/pitch);
 
 	return {
@@ -79,13 +91,13 @@ WaveReader::Result WaveReader::fillResampled(mcl::AudioBuffer& dest, Frame start
 /* -------------------------------------------------------------------------- */
 
 WaveReader::Result WaveReader::fillCopy(mcl::AudioBuffer& dest, Frame start,
-    Frame max, Frame offset) const
+    Frame max, Frame offset, Frame length) const
 {
-	Frame used = dest.countFrames() - offset;
+	Frame used = length;
 	if (used > max - start)
 		used = max - start;
 
-	dest.set(wave->getBuffer(), used, start, offset);
+	wave->copyTo(dest, start, used, offset);
 
 	return {used, used};
 }
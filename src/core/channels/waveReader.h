@@ -27,6 +27,7 @@
 #ifndef G_CHANNEL_WAVE_READER_H
 #define G_CHANNEL_WAVE_READER_H
 
+#include "core/resampler.h"
 #include "core/types.h"
 
 namespace mcl
@@ -37,7 +38,6 @@ class AudioBuffer;
 namespace giada::m
 {
 class Wave;
-class Resampler;
 class WaveReader final
 {
 public:
@@ -58,10 +58,11 @@ public:
 
 	/* fill
 	Fills audio buffer 'out' with data coming from Wave, copying it from 'start'
-	frame up to 'max'. The buffer is filled starting at 'offset'. */
+	frame up to 'max'. The buffer is filled starting at 'offset', generating at
+	most 'length' frames (-1: up to the end of the buffer). */
 
 	Result fill(mcl::AudioBuffer& out, Frame start, Frame max, Frame offset,
-	    float pitch) const;
+	    float pitch, Frame length = -1) const;
 
 	/* last
 	Call this when you are about to process the last chunk of pitched data. 
@@ -81,9 +82,16 @@ public:
 	Wave* wave;
 
 private:
+	/* readWave
+	Resampler::Reader adapter: reads contiguous chunks from a Wave, which might
+	be made of several segments. */
+
+	static Resampler::Input readWave(const void* wave, long pos);
+
 	Result fillResampled(mcl::AudioBuffer& out, Frame start, Frame max, Frame offset,
-	    float pitch) const;
-	Result fillCopy(mcl::AudioBuffer& out, Frame start, Frame max, Frame offset) const;
+	    Frame length, float pitch) const;
+	Result fillCopy(mcl::AudioBuffer& out, Frame start, Frame max, Frame offset,
+	    Frame length) const;
 
 	Resampler* m_resampler;
 };
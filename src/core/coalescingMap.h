@@ -0,0 +1,133 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef G_COALESCING_MAP_H
+#define G_COALESCING_MAP_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace giada::m
+{
+/* CoalescingMap
+A fixed-size, lock-free and allocation-free map that keeps only the latest value
+written for each key. Any number of threads can write with set(), while a single
+consumer picks up keys changed since the last consume() call. Keys are removed
+only by clear(): once the map is full, set() fails for new keys. Key 0 is 
+reserved. */
+
+template <typename V, std::size_t S>
+class CoalescingMap
+{
+public:
+	using Key = uint64_t;
+
+	/* set
+	Stores value 'v' for key 'k', replacing any value not consumed yet. Returns
+	false if there is no room for a new key. */
+
+	bool set(Key k, V v)
+	{
+		Slot* slot = find(k);
+		if (slot == nullptr)
+			return false;
+
+		slot->value.store(v, std::memory_order_relaxed);
+		slot->dirty.store(true, std::memory_order_release);
+		return true;
+	}
+
+	/* consume
+	Calls 'f(key, value)' once for each key set since the last call. Returns
+	the number of keys consumed. Single consumer only. */
+
+	template <typename F>
+	std::size_t consume(F&& f)
+	{
+		std::size_t count = 0;
+		for (Slot& slot : m_slots)
+		{
+			if (!slot.dirty.exchange(false, std::memory_order_acq_rel))
+				continue;
+			const Key key = slot.key.load(std::memory_order_acquire);
+			if (key == 0) // Unbound by clear() while being set
+				continue;
+			f(key, slot.value.load(std::memory_order_relaxed));
+			count++;
+		}
+		return count;
+	}
+
+	/* clear
+	Unbinds all keys, dropping values not consumed yet, so that the map can make
+	room for new keys. Consumer thread only. Values being set concurrently might
+	be lost. */
+
+	void clear()
+	{
+		for (Slot& slot : m_slots)
+		{
+			slot.dirty.store(false, std::memory_order_relaxed);
+			slot.key.store(0, std::memory_order_release);
+		}
+	}
+
+private:
+	struct Slot
+	{
+		std::atomic<Key>  key   = 0;
+		std::atomic<V>    value = {};
+		std::atomic<bool> dirty = false;
+	};
+
+	/* find
+	Returns the slot bound to key 'k', binding a free one if needed. Open 
+	addressing with linear probing. */
+
+	Slot* find(Key k)
+	{
+		const std::size_t start = (k * 0x9E3779B97F4A7C15ull) % S;
+
+		for (std::size_t i = 0; i < S; i++)
+		{
+			Slot& slot = m_slots[(start + i) % S];
+			Key   curr = slot.key.load(std::memory_order_acquire);
+
+			if (curr == 0 && slot.key.compare_exchange_strong(curr, k, std::memory_order_acq_rel))
+				return &slot;
+			if (curr == k) // Might have been bound by another thread in the meantime
+				return &slot;
+		}
+		return nullptr;
+	}
+
+	std::array<Slot, S> m_slots;
+};
+} // namespace giada::m
+
+#endif
@@ -55,6 +55,7 @@ struct Conf final
 	int                buffersize       = G_DEFAULT_BUFSIZE;
 	bool               limitOutput      = false;
 	Resampler::Quality rsmpQuality      = Resampler::Quality::SINC_BEST;
+	int                renderThreads    = G_DEFAULT_RENDER_THREADS; // Render-ahead workers, 0 = render in the audio callback only
 
 	RtMidi::Api midiSystem  = G_DEFAULT_MIDI_API;
 	int         midiPortOut = G_DEFAULT_MIDI_PORT_OUT;
@@ -65,12 +66,15 @@ struct Conf final
 
 	bool chansStopOnSeqHalt         = false;
 	bool treatRecsAsLoops           = false;
+	int  liveRecsCapacity           = G_DEFAULT_LIVE_RECS_CAPACITY;
 	bool inputMonitorDefaultOn      = false;
 	bool overdubProtectionDefaultOn = false;
 
 	std::string pluginPath;
 	std::string patchPath;
 	std::string samplePath;
+	bool        compressSamples  = false; // Save samples as FLAC, when lossless
+	int         preloadMaxMemory = 0;     // Set-list preload budget in MiB, 0 = no limit
 
 	geompp::Rect<int> mainWindowBounds = {-1, -1, G_MIN_GUI_WIDTH, G_MIN_GUI_HEIGHT};
 
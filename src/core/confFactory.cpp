@@ -76,6 +76,7 @@ bool serialize(const Conf& conf)
 	j[CONF_KEY_BUFFER_SIZE]                   = conf.buffersize;
 	j[CONF_KEY_LIMIT_OUTPUT]                  = conf.limitOutput;
 	j[CONF_KEY_RESAMPLE_QUALITY]              = conf.rsmpQuality;
+	j[CONF_KEY_RENDER_THREADS]                = conf.renderThreads;
 	j[CONF_KEY_MIDI_SYSTEM]                   = conf.midiSystem;
 	j[CONF_KEY_MIDI_PORT_OUT]                 = conf.midiPortOut;
 	j[CONF_KEY_MIDI_PORT_IN]                  = conf.midiPortIn;
@@ -95,11 +96,14 @@ bool serialize(const Conf& conf)
 	j[CONF_KEY_MIDI_IN_BEAT_HALF]             = conf.midiInBeatHalf;
 	j[CONF_KEY_CHANS_STOP_ON_SEQ_HALT]        = conf.chansStopOnSeqHalt;
 	j[CONF_KEY_TREAT_RECS_AS_LOOPS]           = conf.treatRecsAsLoops;
+	j[CONF_KEY_LIVE_RECS_CAPACITY]            = conf.liveRecsCapacity;
 	j[CONF_KEY_INPUT_MONITOR_DEFAULT_ON]      = conf.inputMonitorDefaultOn;
 	j[CONF_KEY_OVERDUB_PROTECTION_DEFAULT_ON] = conf.overdubProtectionDefaultOn;
 	j[CONF_KEY_PLUGINS_PATH]                  = conf.pluginPath;
 	j[CONF_KEY_PATCHES_PATH]                  = conf.patchPath;
 	j[CONF_KEY_SAMPLES_PATH]                  = conf.samplePath;
+	j[CONF_KEY_COMPRESS_SAMPLES]              = conf.compressSamples;
+	j[CONF_KEY_PRELOAD_MAX_MEMORY]            = conf.preloadMaxMemory;
 	j[CONF_KEY_MAIN_WINDOW_X]                 = conf.mainWindowBounds.x;
 	j[CONF_KEY_MAIN_WINDOW_Y]                 = conf.mainWindowBounds.y;
 	j[CONF_KEY_MAIN_WINDOW_W]                 = conf.mainWindowBounds.w;
@@ -190,6 +194,7 @@ Conf deserialize()
 	conf.buffersize                 = j.value(CONF_KEY_BUFFER_SIZE, conf.buffersize);
 	conf.limitOutput                = j.value(CONF_KEY_LIMIT_OUTPUT, conf.limitOutput);
 	conf.rsmpQuality                = j.value(CONF_KEY_RESAMPLE_QUALITY, conf.rsmpQuality);
+	conf.renderThreads              = j.value(CONF_KEY_RENDER_THREADS, conf.renderThreads);
 	conf.midiSystem                 = j.value(CONF_KEY_MIDI_SYSTEM, conf.midiSystem);
 	conf.midiPortOut                = j.value(CONF_KEY_MIDI_PORT_OUT, conf.midiPortOut);
 	conf.midiPortIn                 = j.value(CONF_KEY_MIDI_PORT_IN, conf.midiPortIn);
@@ -198,11 +203,14 @@ Conf deserialize()
 	conf.midiTCfps                  = j.value(CONF_KEY_MIDI_TC_FPS, conf.midiTCfps);
 	conf.chansStopOnSeqHalt         = j.value(CONF_KEY_CHANS_STOP_ON_SEQ_HALT, conf.chansStopOnSeqHalt);
 	conf.treatRecsAsLoops           = j.value(CONF_KEY_TREAT_RECS_AS_LOOPS, conf.treatRecsAsLoops);
+	conf.liveRecsCapacity           = j.value(CONF_KEY_LIVE_RECS_CAPACITY, conf.liveRecsCapacity);
 	conf.inputMonitorDefaultOn      = j.value(CONF_KEY_INPUT_MONITOR_DEFAULT_ON, conf.inputMonitorDefaultOn);
 	conf.overdubProtectionDefaultOn = j.value(CONF_KEY_OVERDUB_PROTECTION_DEFAULT_ON, conf.overdubProtectionDefaultOn);
 	conf.pluginPath                 = j.value(CONF_KEY_PLUGINS_PATH, conf.pluginPath);
 	conf.patchPath                  = j.value(CONF_KEY_PATCHES_PATH, conf.patchPath);
 	conf.samplePath                 = j.value(CONF_KEY_SAMPLES_PATH, conf.samplePath);
+	conf.compressSamples            = j.value(CONF_KEY_COMPRESS_SAMPLES, conf.compressSamples);
+	conf.preloadMaxMemory           = j.value(CONF_KEY_PRELOAD_MAX_MEMORY, conf.preloadMaxMemory);
 	conf.mainWindowBounds.x         = j.value(CONF_KEY_MAIN_WINDOW_X, conf.mainWindowBounds.x);
 	conf.mainWindowBounds.y         = j.value(CONF_KEY_MAIN_WINDOW_Y, conf.mainWindowBounds.y);
 	conf.mainWindowBounds.w         = j.value(CONF_KEY_MAIN_WINDOW_W, conf.mainWindowBounds.w);
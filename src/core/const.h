@@ -58,26 +58,17 @@ constexpr int  G_VERSION_PATCH = 0;
 
 constexpr auto G_CONF_FILENAME = "giada.conf";
 
-/* -- Engine ---------------------------------------------------------------- */
-/* G_EVENT_DISPATCHER_RATE_MS
-The amount of sleep between each Event Dispatcher cycle. It should be lower
-than the audio thread sleep time. Note: this value will obviously increase the 
-live input latency, keep it small! */
-constexpr int G_EVENT_DISPATCHER_RATE_MS = 5;
-
-/* G_KERNEL_MIDI_OUTPUT_RATE_MS
-The rate at which KernelMidi spits out MIDI events. Note: this value will 
-obviously increase the MIDI output latency, keep it small!*/
-constexpr int G_KERNEL_MIDI_OUTPUT_RATE_MS = 3;
-
 /* -- GUI ------------------------------------------------------------------- */
-constexpr int   G_GUI_FPS            = 30;
-constexpr float G_GUI_REFRESH_RATE   = 1 / static_cast<float>(G_GUI_FPS);
-constexpr int   G_GUI_FONT_SIZE_BASE = 12;
-constexpr int   G_GUI_INNER_MARGIN   = 4;
-constexpr int   G_GUI_OUTER_MARGIN   = 8;
-constexpr int   G_GUI_UNIT           = 20; // base unit for elements
-constexpr int   G_GUI_ZOOM_FACTOR    = 2;
+constexpr int   G_GUI_FPS               = 30;
+constexpr float G_GUI_REFRESH_RATE      = 1 / static_cast<float>(G_GUI_FPS);
+constexpr int   G_GUI_IDLE_FPS          = 8; // when nothing moves on screen
+constexpr float G_GUI_IDLE_REFRESH_RATE = 1 / static_cast<float>(G_GUI_IDLE_FPS);
+constexpr int   G_GUI_MAX_NOTIFICATIONS = 1024; // Distinct (notification, target) keys
+constexpr int   G_GUI_FONT_SIZE_BASE    = 12;
+constexpr int   G_GUI_INNER_MARGIN      = 4;
+constexpr int   G_GUI_OUTER_MARGIN      = 8;
+constexpr int   G_GUI_UNIT              = 20; // base unit for elements
+constexpr int   G_GUI_ZOOM_FACTOR       = 2;
 
 #define G_COLOR_RED fl_rgb_color(28, 32, 80)
 #define G_COLOR_BLUE fl_rgb_color(113, 31, 31)
@@ -110,6 +101,12 @@ constexpr int   G_MAX_VELOCITY          = 0x7F;
 constexpr int   G_MAX_MIDI_CHANS        = 16;
 constexpr int   G_MAX_DISPATCHER_EVENTS = 32;
 constexpr int   G_MAX_SEQUENCER_EVENTS  = 128;  // Per block
+constexpr int   G_MAX_SEQUENCER_ACTIONS = 1024; // Per block
+constexpr int   G_MAX_RENDER_COMMANDS   = 16;   // Per channel, per block
+constexpr int   G_MAX_PARAM_CHANGES     = 64;   // Plug-in automation, per channel, per block
+constexpr int   G_MAX_RENDER_THREADS    = 4;    // Render-ahead workers
+constexpr int   G_RENDER_AHEAD_BLOCKS   = 4;    // Blocks rendered ahead, per channel
+constexpr int   G_MAX_WAVE_HISTORY      = 32;   // Undo steps per Wave
 constexpr float G_MIN_UI_SCALING        = 0.0f; // Auto: FLTK will figure it out
 constexpr float G_MAX_UI_SCALING        = 4.0f;
 
@@ -140,6 +137,8 @@ constexpr int          G_DEFAULT_SUBWINDOW_W         = 640;
 constexpr int          G_DEFAULT_SUBWINDOW_H         = 480;
 constexpr int          G_DEFAULT_VST_MIDIBUFFER_SIZE = 1024; // TODO - not 100% sure about this size
 constexpr float        G_DEFAULT_UI_SCALING          = G_MIN_UI_SCALING;
+constexpr int          G_DEFAULT_LIVE_RECS_CAPACITY  = 4096; // Live actions not yet consolidated
+constexpr int          G_DEFAULT_RENDER_THREADS      = 2;
 
 /* -- responses and return codes -------------------------------------------- */
 constexpr int G_RES_ERR_PROCESSING    = -6;
@@ -183,8 +182,14 @@ constexpr int G_FILE_INVALID       = 0;
 constexpr int G_FILE_OK            = 1;
 
 /* -- File system ----------------------------------------------------------- */
-constexpr auto G_PATCH_EXT   = ".gptc";
-constexpr auto G_PROJECT_EXT = ".gprj";
+constexpr auto G_PATCH_EXT     = ".gptc";
+constexpr auto G_PATCH_BIN_EXT = ".gptb"; // Binary patch
+constexpr auto G_PROJECT_EXT   = ".gprj";
+constexpr auto G_STATE_EXT     = ".gstate"; // Binary plug-in state
+
+/* -- Plug-in scanning ------------------------------------------------------ */
+constexpr auto G_PLUGIN_SCAN_ARG     = "--scan-plugin"; // Worker process mode
+constexpr int  G_PLUGIN_SCAN_TIMEOUT = 60000;           // ms, per plug-in file
 
 /* -- MIDI in parameters (for MIDI learning) -------------------------------- */
 constexpr int G_MIDI_IN_ENABLED      = 1;
@@ -303,16 +308,28 @@ constexpr auto PATCH_KEY_PLUGIN_PATH                  = "path";
 constexpr auto PATCH_KEY_PLUGIN_BYPASS                = "bypass";
 constexpr auto PATCH_KEY_PLUGIN_PARAMS                = "params";
 constexpr auto PATCH_KEY_PLUGIN_STATE                 = "state";
+constexpr auto PATCH_KEY_PLUGIN_STATE_PATH            = "state_path";
 constexpr auto PATCH_KEY_PLUGIN_MIDI_IN_PARAMS        = "midi_in_params";
 constexpr auto PATCH_KEY_COLUMN_ID                    = "id";
 constexpr auto PATCH_KEY_COLUMN_WIDTH                 = "width";
 constexpr auto PATCH_KEY_COLUMN_CHANNELS              = "channels";
+constexpr auto PATCH_KEY_SCENES                       = "scenes";
+constexpr auto PATCH_KEY_SCENE_ID                     = "id";
+constexpr auto PATCH_KEY_SCENE_NAME                   = "name";
+constexpr auto PATCH_KEY_SCENE_CHANNELS               = "channels";
+constexpr auto PATCH_KEY_SCENE_CHANNEL_ID             = "id";
+constexpr auto PATCH_KEY_SCENE_CHANNEL_PLAYING        = "playing";
+constexpr auto PATCH_KEY_SCENE_CHANNEL_MUTE           = "mute";
+constexpr auto PATCH_KEY_SCENE_CHANNEL_VOLUME         = "volume";
 constexpr auto G_PATCH_KEY_ACTION_ID                  = "id";
 constexpr auto G_PATCH_KEY_ACTION_CHANNEL             = "channel";
 constexpr auto G_PATCH_KEY_ACTION_FRAME               = "frame";
 constexpr auto G_PATCH_KEY_ACTION_EVENT               = "event";
 constexpr auto G_PATCH_KEY_ACTION_PREV                = "prev";
 constexpr auto G_PATCH_KEY_ACTION_NEXT                = "next";
+constexpr auto G_PATCH_KEY_ACTION_PLUGIN_ID           = "plugin_id";
+constexpr auto G_PATCH_KEY_ACTION_PLUGIN_PARAM        = "plugin_param";
+constexpr auto G_PATCH_KEY_ACTION_VALUE               = "value";
 
 /* JSON config keys */
 
@@ -332,6 +349,7 @@ constexpr auto CONF_KEY_BUFFER_SIZE                   = "buffer_size";
 constexpr auto CONF_KEY_DELAY_COMPENSATION            = "delay_compensation";
 constexpr auto CONF_KEY_LIMIT_OUTPUT                  = "limit_output";
 constexpr auto CONF_KEY_RESAMPLE_QUALITY              = "resample_quality";
+constexpr auto CONF_KEY_RENDER_THREADS                = "render_threads";
 constexpr auto CONF_KEY_MIDI_SYSTEM                   = "midi_system";
 constexpr auto CONF_KEY_MIDI_PORT_OUT                 = "midi_port_out";
 constexpr auto CONF_KEY_MIDI_PORT_IN                  = "midi_port_in";
@@ -352,11 +370,14 @@ constexpr auto CONF_KEY_MIDI_IN_BEAT_DOUBLE           = "midi_in_beat_doble";
 constexpr auto CONF_KEY_MIDI_IN_BEAT_HALF             = "midi_in_beat_half";
 constexpr auto CONF_KEY_CHANS_STOP_ON_SEQ_HALT        = "chans_stop_on_seq_halt";
 constexpr auto CONF_KEY_TREAT_RECS_AS_LOOPS           = "treat_recs_as_loops";
+constexpr auto CONF_KEY_LIVE_RECS_CAPACITY            = "live_recs_capacity";
 constexpr auto CONF_KEY_INPUT_MONITOR_DEFAULT_ON      = "input_monitor_default_on";
 constexpr auto CONF_KEY_OVERDUB_PROTECTION_DEFAULT_ON = "overdub_protection_default_on";
 constexpr auto CONF_KEY_PLUGINS_PATH                  = "plugins_path";
 constexpr auto CONF_KEY_PATCHES_PATH                  = "patches_path";
 constexpr auto CONF_KEY_SAMPLES_PATH                  = "samples_path";
+constexpr auto CONF_KEY_COMPRESS_SAMPLES              = "compress_samples";
+constexpr auto CONF_KEY_PRELOAD_MAX_MEMORY            = "preload_max_memory";
 constexpr auto CONF_KEY_MAIN_WINDOW_X                 = "main_window_x";
 constexpr auto CONF_KEY_MAIN_WINDOW_Y                 = "main_window_y";
 constexpr auto CONF_KEY_MAIN_WINDOW_W                 = "main_window_w";
@@ -40,25 +40,29 @@ Engine::Engine()
 : onMidiReceived(nullptr)
 , onMidiSent(nullptr)
 , onModelSwap(nullptr)
+, onProjectSwitched(nullptr)
 , m_kernelAudio(m_model)
-, m_kernelMidi(m_model)
+, m_kernelMidi(m_model, m_midiOutScheduler)
 , m_midiMapper(m_kernelMidi)
+, m_midiLightingService(m_midiMapper, m_scheduler)
 , m_pluginHost(m_model)
 , m_midiSynchronizer(m_kernelMidi)
 , m_sequencer(m_model, m_midiSynchronizer, m_jackTransport)
 , m_mixer(m_model)
 , m_channelManager(m_model)
-, m_actionRecorder(m_model)
+, m_actionRecorder(m_model, m_scheduler)
 , m_recorder(m_sequencer, m_channelManager, m_mixer, m_actionRecorder)
+, m_eventDispatcher(m_scheduler)
 , m_midiDispatcher(m_model)
-, m_mainApi(m_kernelAudio, m_mixer, m_sequencer, m_midiSynchronizer, m_channelManager, m_recorder)
+, m_mainApi(m_model, m_kernelAudio, m_mixer, m_sequencer, m_channelManager, m_recorder)
 , m_channelsApi(m_model, m_kernelAudio, m_mixer, m_sequencer, m_channelManager, m_recorder, m_actionRecorder, m_pluginHost, m_pluginManager)
-, m_pluginsApi(m_kernelAudio, m_pluginManager, m_pluginHost, m_model)
-, m_sampleEditorApi(m_kernelAudio, m_model, m_channelManager)
+, m_pluginsApi(m_kernelAudio, m_pluginManager, m_pluginHost, m_sequencer, m_recorder, m_actionRecorder, m_model)
+, m_sampleEditorApi(m_kernelAudio, m_model, m_channelManager, m_peakCache)
 , m_actionEditorApi(*this, m_sequencer, m_actionRecorder)
 , m_ioApi(m_model, m_midiDispatcher)
-, m_storageApi(*this, m_model, m_pluginManager, m_midiSynchronizer, m_mixer, m_channelManager, m_kernelAudio, m_sequencer, m_actionRecorder)
-, m_configApi(m_model, m_kernelAudio, m_kernelMidi, m_midiMapper, m_midiSynchronizer)
+, m_storageApi(*this, m_model, m_pluginManager, m_midiSynchronizer, m_mixer, m_channelManager, m_kernelAudio, m_sequencer, m_actionRecorder, m_peakCache)
+, m_configApi(m_model, m_kernelAudio, m_kernelMidi, m_midiMapper, m_midiLightingService, m_midiSynchronizer)
+, m_switchNotified(false)
 {
 	m_kernelAudio.onAudioCallback = [this](mcl::AudioBuffer& out, const mcl::AudioBuffer& in) {
 		return audioCallback(out, in);
@@ -85,7 +89,7 @@ Engine::Engine()
 
 		registerThread(Thread::MIDI, /*realtime=*/false);
 		m_midiDispatcher.dispatch(e);
-		m_midiSynchronizer.receive(e, m_sequencer.getBeats());
+		m_midiSynchronizer.receive(e, m_model.get().sequencer);
 		onMidiReceived();
 	};
 	m_kernelMidi.onMidiSent = [this]() {
@@ -93,6 +97,20 @@ Engine::Engine()
 		onMidiSent();
 	};
 
+	m_midiLightingService.onUpdate = [this]() {
+		registerThread(Thread::EVENTS, /*realtime=*/false);
+
+		const model::LayoutLock lock   = m_model.get_RT();
+		const model::Layout&    layout = lock.get();
+
+		std::vector<MidiLightingService<KernelMidi>::ChannelState> states;
+		for (const Channel& ch : layout.channels.getAll())
+			states.push_back({&ch.midiLighter, ch.shared->playStatus.load(),
+			    ch.isAudible(layout.mixer.hasSolos), ch.isMuted(), ch.isSoloed()});
+
+		m_midiLightingService.update(states);
+	};
+
 	m_midiDispatcher.onEventReceived = [this]() {
 		m_recorder.startActionRecOnCallback();
 	};
@@ -103,6 +121,9 @@ Engine::Engine()
 	m_midiSynchronizer.onChangeBpm = [this](float bpm) {
 		m_mainApi.setBpm(bpm);
 	};
+	m_midiSynchronizer.onShiftPosition = [this](Frame delta) {
+		m_sequencer.shiftPosition(delta);
+	};
 	m_midiSynchronizer.onStart = [this]() {
 		m_mainApi.startSequencer();
 	};
@@ -118,43 +139,66 @@ Engine::Engine()
 
 #ifdef WITH_AUDIO_JACK
 	m_jackSynchronizer.onJackRewind = [this]() {
-		m_eventDispatcher.pumpEvent([this]() {
-			registerThread(Thread::EVENTS, /*realtime=*/false);
-			m_sequencer.jack_rewind();
-		});
+		m_eventDispatcher.pumpEvent({EventDispatcher::Event::Type::JACK_REWIND});
 	};
 	m_jackSynchronizer.onJackChangeBpm = [this](float bpm) {
-		m_eventDispatcher.pumpEvent([this, bpm]() {
-			registerThread(Thread::EVENTS, /*realtime=*/false);
-			m_sequencer.jack_setBpm(bpm, m_kernelAudio.getSampleRate());
-		});
+		m_eventDispatcher.pumpEvent({EventDispatcher::Event::Type::JACK_CHANGE_BPM, bpm});
 	};
 	m_jackSynchronizer.onJackStart = [this]() {
-		m_eventDispatcher.pumpEvent([this]() {
-			registerThread(Thread::EVENTS, /*realtime=*/false);
-			m_sequencer.jack_start();
-		});
+		m_eventDispatcher.pumpEvent({EventDispatcher::Event::Type::JACK_START});
 	};
 	m_jackSynchronizer.onJackStop = [this]() {
-		m_eventDispatcher.pumpEvent([this]() {
-			registerThread(Thread::EVENTS, /*realtime=*/false);
-			m_sequencer.jack_stop();
-		});
+		m_eventDispatcher.pumpEvent({EventDispatcher::Event::Type::JACK_STOP});
 	};
 #endif
 
 	m_mixer.onSignalTresholdReached = [this]() {
-		m_eventDispatcher.pumpEvent([this]() {
-			registerThread(Thread::EVENTS, /*realtime=*/false);
-			m_recorder.startInputRecOnCallback();
-		});
+		m_eventDispatcher.pumpEvent({EventDispatcher::Event::Type::SIGNAL_TRESHOLD_REACHED});
 	};
 	m_mixer.onEndOfRecording = [this]() {
 		if (m_mixer.isRecordingInput())
-			m_eventDispatcher.pumpEvent([this]() {
-				registerThread(Thread::EVENTS, /*realtime=*/false);
-				m_recorder.stopInputRec(m_kernelAudio.getSampleRate());
-			});
+			m_eventDispatcher.pumpEvent({EventDispatcher::Event::Type::END_OF_RECORDING});
+	};
+
+	/* Cue points are set only to switch to a preloaded project, whose layout is
+	ready: flip to it. It starts from its first frame on the next block. */
+
+	m_sequencer.onCue = [this]() {
+		if (m_model.flip_RT())
+			m_model.getFlipped_RT().sequencer.a_setCurrentFrame(0, /*sampleRate=*/0); // No need for sampleRate, it's just 0
+	};
+
+	m_eventDispatcher.onEvent = [this](const EventDispatcher::Event& e) {
+		registerThread(Thread::EVENTS, /*realtime=*/false);
+		switch (e.type)
+		{
+#ifdef WITH_AUDIO_JACK
+		case EventDispatcher::Event::Type::JACK_REWIND:
+			m_sequencer.jack_rewind();
+			break;
+		case EventDispatcher::Event::Type::JACK_CHANGE_BPM:
+			m_sequencer.jack_setBpm(std::get<float>(e.data), m_kernelAudio.getSampleRate());
+			break;
+		case EventDispatcher::Event::Type::JACK_START:
+			m_sequencer.jack_start();
+			break;
+		case EventDispatcher::Event::Type::JACK_STOP:
+			m_sequencer.jack_stop();
+			break;
+#endif
+		case EventDispatcher::Event::Type::SIGNAL_TRESHOLD_REACHED:
+			m_recorder.startInputRecOnCallback();
+			break;
+		case EventDispatcher::Event::Type::END_OF_RECORDING:
+			m_recorder.stopInputRec(m_kernelAudio.getSampleRate());
+			break;
+		case EventDispatcher::Event::Type::PROJECT_SWITCHED:
+			if (onProjectSwitched != nullptr)
+				onProjectSwitched();
+			break;
+		default:
+			break;
+		}
 	};
 
 	m_channelManager.onChannelsAltered = [this]() {
@@ -164,6 +208,12 @@ Engine::Engine()
 	m_channelManager.onChannelRecorded = [this](Frame recordedFrames) {
 		return waveFactory::createEmpty(recordedFrames, G_MAX_IO_CHANS, m_kernelAudio.getSampleRate(), "TAKE");
 	};
+	m_channelManager.onWaveLoaded = [this](const Wave& wave) {
+		m_peakCache.request(wave);
+	};
+	m_channelManager.onWaveRemoved = [this](const Wave& wave) {
+		m_peakCache.remove(wave.id);
+	};
 
 	m_sequencer.onAboutStart = [this](SeqStatus status) {
 		/* TODO move this logic to Recorder */
@@ -184,9 +234,10 @@ Engine::Engine()
 		m_actionRecorder.updateBpm(oldVal / newVal, quantizerStep);
 	};
 
-	m_model.onSwap = [this](model::SwapType t) {
+	m_model.onSwap = [this](model::SwapType t, model::Change c) {
 		assert(onModelSwap != nullptr);
-		onModelSwap(t);
+		onModelSwap(t, c);
+		m_midiLightingService.notify(); // Mute, solo or MIDI learning might have changed
 	};
 }
 
@@ -215,19 +266,22 @@ void Engine::init(const Conf& conf)
 	m_sequencer.reset(m_kernelAudio.getSampleRate());
 	m_pluginHost.reset(m_kernelAudio.getBufferSize());
 	m_pluginManager.reset(conf.pluginSortMethod);
+	m_actionRecorder.init(conf.liveRecsCapacity);
+	m_mixer.setRenderThreads(conf.renderThreads);
 
 	m_mixer.enable();
 	m_kernelAudio.startStream();
 
 	m_kernelMidi.init();
-	m_kernelMidi.start();
 
 	m_midiMapper.init();
 	m_midiMapper.read(layout.kernelMidi.midiMapPath);
 	m_midiMapper.sendInitMessages();
+	m_midiLightingService.notify();
 
-	m_eventDispatcher.start();
-	m_midiSynchronizer.startSendClock(G_DEFAULT_BPM);
+	m_scheduler.start();
+	m_midiOutScheduler.start();
+	m_midiSynchronizer.startSendClock();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -246,6 +300,7 @@ void Engine::reset(PluginManager::SortMethod pluginSortMethod)
 	const int bufferSize = m_kernelAudio.getBufferSize();
 
 	m_model.reset();
+	m_peakCache.clear();
 	m_mixer.reset(m_sequencer.getMaxFramesInLoop(sampleRate), bufferSize);
 	m_channelManager.reset(bufferSize);
 	m_sequencer.reset(sampleRate);
@@ -262,9 +317,15 @@ void Engine::shutdown(Conf& conf)
 		m_kernelAudio.shutdown();
 		u::log::print("[Engine::shutdown] KernelAudio closed\n");
 		m_mixer.disable();
+		m_mixer.setRenderThreads(0);
 		u::log::print("[Engine::shutdown] Mixer closed\n");
 	}
 
+	m_scheduler.stop();
+	m_midiOutScheduler.stop();
+	m_storageApi.waitForSave();
+	m_storageApi.discardPreloadedProject();
+
 	m_model.store(conf);
 
 	/* Currently the Engine is global/static, and so are all of its sub-components,
@@ -291,14 +352,26 @@ int Engine::audioCallback(mcl::AudioBuffer& out, const mcl::AudioBuffer& in) con
 	Layout is locked for realtime rendering by the audio thread. Rendering
 	functions must access the realtime layout coming from layoutLock.get(). */
 
+	/* Right after a switch to a preloaded project, render the new layout until
+	the main thread makes it the current one. Check this before locking the
+	regular layout: if the switch is completed in between, the lock gets the new
+	one already. */
+
+	const bool                switched    = m_model.isFlipped_RT();
 	const model::LayoutLock   layoutLock  = m_model.get_RT();
-	const model::Layout&      layout_RT   = layoutLock.get();
+	const model::Layout&      layout_RT   = switched ? m_model.getFlipped_RT() : layoutLock.get();
 	const model::KernelAudio& kernelAudio = layout_RT.kernelAudio;
 	const model::Mixer&       mixer       = layout_RT.mixer;
 	const model::Sequencer&   sequencer   = layout_RT.sequencer;
-	const model::Channels&    channels    = layout_RT.channels;
 	const model::Actions&     actions     = layout_RT.actions;
 
+	/* Tell the main thread about the switch, until it gets the message. */
+
+	if (!switched)
+		m_switchNotified = false;
+	else if (!m_switchNotified)
+		m_switchNotified = m_eventDispatcher.pumpEvent({EventDispatcher::Event::Type::PROJECT_SWITCHED});
+
 	/* Mixer disabled or Kernel Audio not ready: nothing to do here. */
 
 	if (!mixer.a_isActive())
@@ -314,6 +387,17 @@ int Engine::audioCallback(mcl::AudioBuffer& out, const mcl::AudioBuffer& in) con
 	layout is not locked: another thread might altering channel's data in the
 	meantime (e.g. Plugins or Waves). */
 
+	/* Take the reference time for this block, so that MIDI messages generated
+	while advancing the sequencer can be scheduled at their exact frame. */
+
+	m_kernelMidi.beginBlock(kernelAudio.samplerate);
+
+	/* Emit MIDI clock pulses for this block, if in MASTER mode, and publish the
+	sequencer position for SLAVE mode. Must be done before advancing the 
+	sequencer, which moves the current frame forward. */
+
+	m_midiSynchronizer.advance(sequencer, out.countFrames(), kernelAudio.samplerate);
+
 	if (sequencer.isRunning())
 	{
 		const Frame        currentFrame  = sequencer.a_getCurrentFrame();
@@ -324,7 +408,7 @@ int Engine::audioCallback(mcl::AudioBuffer& out, const mcl::AudioBuffer& in) con
 		const Sequencer::EventBuffer& events = m_sequencer.advance(sequencer, bufferSize, kernelAudio.samplerate, actions);
 		m_sequencer.render(out);
 		if (!layout_RT.locked)
-			m_mixer.advanceChannels(events, channels, renderRange, quantizerStep);
+			m_mixer.advanceChannels(events, layout_RT, renderRange, quantizerStep);
 	}
 
 	/* Then render Mixer: render channels, process I/O. */
@@ -353,6 +437,48 @@ void Engine::resume()
 void Engine::debug()
 {
 	m_model.debug();
+
+	const KernelMidi::OutputStats midiStats = m_kernelMidi.getOutputStats();
+
+	puts("KernelMidi output");
+	fmt::print("\tsent={} dropped={} jitter avg={:.1f}us max={:.1f}us last={:.1f}us\n",
+	    midiStats.sent, midiStats.dropped, midiStats.avgJitterUs, midiStats.maxJitterUs,
+	    midiStats.lastJitterUs);
+
+	puts("Sequencer");
+	fmt::print("\tdropped actions={}\n", m_sequencer.countDroppedActions());
+
+	uint64_t droppedRenders = 0;
+	for (const std::unique_ptr<ChannelShared>& shared : m_model.getAllChannelsShared())
+		droppedRenders += shared->droppedRenders.load();
+
+	puts("Channels");
+	fmt::print("\tdropped render commands={}\n", droppedRenders);
+
+	const EventDispatcher::Stats eventStats = m_eventDispatcher.getStats();
+
+	puts("EventDispatcher");
+	fmt::print("\tpumped={} dropped={}\n", eventStats.pumped, eventStats.dropped);
+
+	const MidiLightingService<KernelMidi>::Stats lightingStats = m_midiLightingService.getStats();
+
+	puts("MidiLightingService");
+	fmt::print("\tsent={} skipped={}\n", lightingStats.sent, lightingStats.skipped);
+
+	const ActionRecorder::LiveStats liveStats = m_actionRecorder.getLiveStats();
+
+	puts("ActionRecorder live");
+	fmt::print("\trecorded={} dropped={}\n", liveStats.recorded, liveStats.dropped);
+
+	for (const Scheduler* scheduler : {&m_scheduler, &m_midiOutScheduler})
+	{
+		const Scheduler::Stats schedulerStats = scheduler->getStats();
+
+		fmt::print("Scheduler - wakeups={}\n", schedulerStats.wakeups);
+		for (const Scheduler::TaskStats& task : schedulerStats.tasks)
+			fmt::print("\t{}: runs={} latency avg={:.1f}us max={:.1f}us\n",
+			    task.name, task.runs, task.avgLatencyUs, task.maxLatencyUs);
+	}
 }
 #endif
 
@@ -380,8 +506,9 @@ ConfigApi&       Engine::getConfigApi() { return m_configApi; }
 
 /* -------------------------------------------------------------------------- */
 
-KernelMidi&             Engine::getKernelMidi() { return m_kernelMidi; }
-ActionRecorder&         Engine::getActionRecorder() { return m_actionRecorder; }
-PluginHost&             Engine::getPluginHost() { return m_pluginHost; }
-MidiMapper<KernelMidi>& Engine::getMidiMapper() { return m_midiMapper; }
+KernelMidi&                      Engine::getKernelMidi() { return m_kernelMidi; }
+ActionRecorder&                  Engine::getActionRecorder() { return m_actionRecorder; }
+PluginHost&                      Engine::getPluginHost() { return m_pluginHost; }
+MidiMapper<KernelMidi>&          Engine::getMidiMapper() { return m_midiMapper; }
+MidiLightingService<KernelMidi>& Engine::getMidiLightingService() { return m_midiLightingService; }
 } // namespace giada::m
@@ -44,13 +44,16 @@
 #include "core/kernelAudio.h"
 #include "core/kernelMidi.h"
 #include "core/midiDispatcher.h"
+#include "core/midiLightingService.h"
 #include "core/midiMapper.h"
 #include "core/midiSynchronizer.h"
 #include "core/mixer.h"
 #include "core/model/model.h"
+#include "core/peakCache.h"
 #include "core/plugins/pluginHost.h"
 #include "core/plugins/pluginManager.h"
 #include "core/recorder.h"
+#include "core/scheduler.h"
 #include "core/sequencer.h"
 #include "core/waveFactory.h"
 #ifdef WITH_AUDIO_JACK
@@ -111,10 +114,11 @@ public:
 	Returns a reference to an internal. TODO - these methods will be removed with
 	new Channel rendering architecture */
 
-	KernelMidi&             getKernelMidi();
-	ActionRecorder&         getActionRecorder();
-	PluginHost&             getPluginHost();
-	MidiMapper<KernelMidi>& getMidiMapper();
+	KernelMidi&                      getKernelMidi();
+	ActionRecorder&                  getActionRecorder();
+	PluginHost&                      getPluginHost();
+	MidiMapper<KernelMidi>&          getMidiMapper();
+	MidiLightingService<KernelMidi>& getMidiLightingService();
 
 	/* onMidi[Received|Sent]
 	Callback fired when the engine has received or sent a MIDI event. */
@@ -123,29 +127,41 @@ public:
 	std::function<void()> onMidiSent;
 
 	/* onModelSwap
-	Callback fired when the model gets swapped. */
+	Callback fired when the model gets swapped, along with a description of
+	what has changed. */
 
-	std::function<void(model::SwapType)> onModelSwap;
+	std::function<void(model::SwapType, model::Change)> onModelSwap;
+
+	/* onProjectSwitched
+	Callback fired from a non-main thread when the audio thread has switched to
+	a preloaded project. It must call StorageApi::completeSwitch() from the main
+	thread. */
+
+	std::function<void()> onProjectSwitched;
 
 private:
 	int  audioCallback(mcl::AudioBuffer& out, const mcl::AudioBuffer& in) const;
 	void registerThread(Thread, bool isRealtime) const;
 
-	model::Model           m_model;
-	KernelAudio            m_kernelAudio;
-	KernelMidi             m_kernelMidi;
-	MidiMapper<KernelMidi> m_midiMapper;
-	PluginHost             m_pluginHost;
-	JackTransport          m_jackTransport;
-	MidiSynchronizer       m_midiSynchronizer;
-	Sequencer              m_sequencer;
-	Mixer                  m_mixer;
-	ChannelManager         m_channelManager;
-	ActionRecorder         m_actionRecorder;
-	Recorder               m_recorder;
-	PluginManager          m_pluginManager;
-	EventDispatcher        m_eventDispatcher;
-	MidiDispatcher         m_midiDispatcher;
+	model::Model                    m_model;
+	Scheduler                       m_scheduler;
+	Scheduler                       m_midiOutScheduler;
+	KernelAudio                     m_kernelAudio;
+	KernelMidi                      m_kernelMidi;
+	MidiMapper<KernelMidi>          m_midiMapper;
+	MidiLightingService<KernelMidi> m_midiLightingService;
+	PluginHost                      m_pluginHost;
+	JackTransport                   m_jackTransport;
+	MidiSynchronizer                m_midiSynchronizer;
+	Sequencer                       m_sequencer;
+	Mixer                           m_mixer;
+	ChannelManager                  m_channelManager;
+	ActionRecorder                  m_actionRecorder;
+	Recorder                        m_recorder;
+	PluginManager                   m_pluginManager;
+	EventDispatcher                 m_eventDispatcher;
+	MidiDispatcher                  m_midiDispatcher;
+	PeakCache                       m_peakCache;
 #ifdef WITH_AUDIO_JACK
 	JackSynchronizer m_jackSynchronizer;
 #endif
@@ -158,6 +174,12 @@ private:
 	IOApi           m_ioApi;
 	StorageApi      m_storageApi;
 	ConfigApi       m_configApi;
+
+	/* m_switchNotified
+	Whether the main thread has been told about the last switch to a preloaded
+	project. Audio thread only. */
+
+	mutable bool m_switchNotified;
 };
 } // namespace giada::m
 
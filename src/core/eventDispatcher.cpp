@@ -25,37 +25,48 @@
  * -------------------------------------------------------------------------- */
 
 #include "core/eventDispatcher.h"
-#include "core/const.h"
 #include <cassert>
 
 namespace giada::m
 {
-EventDispatcher::EventDispatcher()
-: m_worker(G_EVENT_DISPATCHER_RATE_MS)
-, m_eventQueue(G_MAX_DISPATCHER_EVENTS)
+EventDispatcher::EventDispatcher(Scheduler& s)
+: onEvent(nullptr)
+, m_scheduler(s)
+, m_pumped(0)
+, m_dropped(0)
 {
+	m_taskId = m_scheduler.addTask("EventDispatcher", [this]() { process(); });
 }
 
 /* -------------------------------------------------------------------------- */
 
-void EventDispatcher::start()
+bool EventDispatcher::pumpEvent(const Event& e) const
 {
-	m_worker.start([this]() { process(); });
+	if (!m_eventQueue.push(e))
+	{
+		m_dropped.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+	m_pumped.fetch_add(1, std::memory_order_relaxed);
+	m_scheduler.notify(m_taskId);
+	return true;
 }
 
 /* -------------------------------------------------------------------------- */
 
-bool EventDispatcher::pumpEvent(const std::function<void()>& f)
+EventDispatcher::Stats EventDispatcher::getStats() const
 {
-	return m_eventQueue.try_enqueue(f);
+	return {m_pumped.load(), m_dropped.load()};
 }
 
 /* -------------------------------------------------------------------------- */
 
 void EventDispatcher::process()
 {
+	assert(onEvent != nullptr);
+
 	Event e;
-	while (m_eventQueue.try_dequeue(e))
-		e();
+	while (m_eventQueue.pop(e))
+		onEvent(e);
 }
-} // namespace giada::m
\ No newline at end of file
+} // namespace giada::m
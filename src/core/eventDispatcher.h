@@ -27,13 +27,19 @@
 #ifndef G_EVENT_DISPATCHER_H
 #define G_EVENT_DISPATCHER_H
 
-#include "core/worker.h"
-#include "deps/concurrentqueue/concurrentqueue.h"
+#include "core/const.h"
+#include "core/queue.h"
+#include "core/scheduler.h"
+#include <atomic>
+#include <cstdint>
 #include <functional>
+#include <variant>
 
 /* giada::m::EventDispatcher
-Performs Events (a.k.a. function callbacks) in a separate worker thread. Used by
-the realtime thread (via Engine) to talk to other non-realtime threads. */
+Performs Events on the Scheduler thread. Used by the realtime thread (via Engine)
+to talk to other non-realtime threads. Events are plain values stored in a 
+preallocated queue and the Scheduler is woken up by pumpEvent(), so the realtime
+side never allocates nor waits for a polling cycle. */
 
 namespace giada::m
 {
@@ -41,35 +47,66 @@ class EventDispatcher
 {
 public:
 	/* Event
-	Alias for a std::function type. All events are just functions to be performed
-	by the EventDispatcher. */
+	Tagged union describing what has to be performed. The actual job is done by 
+	the onEvent callback, on the EventDispatcher thread. */
+
+	struct Event
+	{
+		enum class Type
+		{
+			NONE,
+			JACK_REWIND,
+			JACK_CHANGE_BPM,
+			JACK_START,
+			JACK_STOP,
+			SIGNAL_TRESHOLD_REACHED,
+			END_OF_RECORDING,
+			PROJECT_SWITCHED
+		};
+
+		Type                               type = Type::NONE;
+		std::variant<std::monostate, float> data = {};
+	};
+
+	struct Stats
+	{
+		uint64_t pumped  = 0;
+		uint64_t dropped = 0;
+	};
+
+	EventDispatcher(Scheduler&);
 
-	using Event = std::function<void()>;
+	/* pumpEvent
+	Inserts a new event in the event queue and wakes up the Scheduler. 
+	Returns false if the queue is full. Realtime-safe, single producer only: it
+	must always be called from the same thread (i.e. the realtime one). */
 
-	EventDispatcher();
+	bool pumpEvent(const Event&) const;
 
-	/* start
-	Starts the internal worker on a separate thread. Call this on startup. */
+	/* getStats
+	Returns the number of events pumped and dropped so far because of a full 
+	queue. */
 
-	void start();
+	Stats getStats() const;
 
-	/* pumpEvent
-	Inserts a new event in the event queue. Returns false if the queue is full. */
+	/* onEvent
+	Callback fired on the Scheduler thread for each Event received. */
 
-	bool pumpEvent(const Event&);
+	std::function<void(const Event&)> onEvent;
 
 private:
 	void process();
 
-	/* m_worker
-	A separate thread responsible for the event processing. */
-
-	Worker m_worker;
+	Scheduler&        m_scheduler;
+	Scheduler::TaskId m_taskId;
 
 	/* m_eventQueue
-	Collects events coming from the UI or MIDI devices. */
+	Collects events coming from the realtime thread. */
+
+	mutable Queue<Event, G_MAX_DISPATCHER_EVENTS> m_eventQueue;
 
-	moodycamel::ConcurrentQueue<Event> m_eventQueue;
+	mutable std::atomic<uint64_t> m_pumped;
+	mutable std::atomic<uint64_t> m_dropped;
 };
 } // namespace giada::m
 
@@ -33,12 +33,28 @@ IdManager::IdManager()
 {
 }
 
+IdManager::IdManager(const IdManager& o)
+: m_id(o.m_id.load())
+{
+}
+
+/* -------------------------------------------------------------------------- */
+
+IdManager& IdManager::operator=(const IdManager& o)
+{
+	m_id.store(o.m_id.load());
+	return *this;
+}
+
 /* -------------------------------------------------------------------------- */
 
 void IdManager::set(ID id)
 {
-	if (id != 0 && id > m_id)
-		m_id = id;
+	if (id == 0)
+		return;
+	ID curr = m_id.load();
+	while (id > curr && !m_id.compare_exchange_weak(curr, id))
+		;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -47,7 +63,7 @@ ID IdManager::generate(ID id)
 {
 	if (id != 0)
 	{
-		m_id = id;
+		set(id);
 		return id;
 	}
 	return ++m_id;
@@ -57,13 +73,13 @@ ID IdManager::generate(ID id)
 
 ID IdManager::get() const
 {
-	return m_id;
+	return m_id.load();
 }
 
 /* -------------------------------------------------------------------------- */
 
 ID IdManager::getNext() const
 {
-	return m_id + 1;
+	return m_id.load() + 1;
 }
 } // namespace giada::m
@@ -28,13 +28,20 @@
 #define G_ID_MANAGER_H
 
 #include "core/types.h"
+#include <atomic>
 
 namespace giada::m
 {
+/* IdManager
+Thread-safe ID generator: projects can be loaded in background while new items
+are being created on the main thread. */
+
 class IdManager
 {
 public:
 	IdManager();
+	IdManager(const IdManager&);
+	IdManager& operator=(const IdManager&);
 
 	/* set
 	Stores a new id, only if != 0 (valid) and greater than current id (unique). */
@@ -43,8 +50,9 @@ public:
 
 	/* generate
 	Generates a new unique id. If 'id' parameter is passed in is valid, it just 
-	returns it with no unique id generation. Useful when loading things from the 
-	model that already have their own id. */
+	returns it with no unique id generation (the current id is raised as in 
+	set()). Useful when loading things from the model that already have their 
+	own id. */
 
 	ID generate(ID id = 0);
 
@@ -60,7 +68,7 @@ public:
 	ID getNext() const;
 
 private:
-	ID m_id;
+	std::atomic<ID> m_id;
 };
 } // namespace giada::m
 
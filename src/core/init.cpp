@@ -36,15 +36,26 @@
 #include "utils/ver.h"
 #ifdef WITH_TESTS
 #define CATCH_CONFIG_RUNNER
+#include "tests/actionIndex.cpp"
 #include "tests/actionRecorder.cpp"
 #include "tests/channelFactory.cpp"
+#include "tests/channelManager.cpp"
+#include "tests/coalescingMap.cpp"
 #include "tests/midiEvent.cpp"
 #include "tests/midiLighter.cpp"
+#include "tests/midiLightingService.cpp"
+#include "tests/model.cpp"
+#include "tests/patchFactory.cpp"
+#include "tests/pluginFactory.cpp"
+#include "tests/renderLane.cpp"
 #include "tests/samplePlayer.cpp"
+#include "tests/sequencer.cpp"
+#include "tests/tempoTracker.cpp"
 #include "tests/utils.cpp"
 #include "tests/wave.cpp"
 #include "tests/waveFactory.cpp"
 #include "tests/waveFx.cpp"
+#include "tests/wavePeaks.cpp"
 #include "tests/waveReader.cpp"
 #include <catch2/catch.hpp>
 #include <string>
@@ -52,8 +63,8 @@
 #endif
 #include <FL/Fl.H>
 
-extern giada::m::Engine g_engine;
-extern giada::v::Ui     g_ui;
+extern giada::m::Engine& g_engine;
+extern giada::v::Ui&     g_ui;
 
 namespace giada::m::init
 {
@@ -104,6 +115,22 @@ int tests(int argc, char** argv)
 
 /* -------------------------------------------------------------------------- */
 
+int scanPlugin(int argc, char** argv)
+{
+	/* Usage: giada --scan-plugin [format] [file or identifier] [output file] */
+
+	if (argc != 5 || strcmp(argv[1], G_PLUGIN_SCAN_ARG) != 0)
+		return -1;
+
+	juce::initialiseJuce_GUI();
+	const int ret = PluginManager::scanWorker(argv[2], argv[3], argv[4]);
+	juce::shutdownJuce_GUI();
+
+	return ret;
+}
+
+/* -------------------------------------------------------------------------- */
+
 void startup(int argc, char** argv)
 {
 	g_ui.dispatcher.onEventOccured = []() {
@@ -111,20 +138,26 @@ void startup(int argc, char** argv)
 	};
 
 	g_engine.onMidiReceived = []() {
-		g_ui.pumpEvent([] { g_ui.mainWindow->mainIO->setMidiInActivity(); });
+		g_ui.notify(v::Updater::Notification::MIDI_IN_ACTIVITY);
 	};
 
 	g_engine.onMidiSent = []() {
-		g_ui.pumpEvent([] { g_ui.mainWindow->mainIO->setMidiOutActivity(); });
+		g_ui.notify(v::Updater::Notification::MIDI_OUT_ACTIVITY);
 	};
 
-	g_engine.onModelSwap = [](model::SwapType type) {
+	g_engine.onModelSwap = [](model::SwapType type, model::Change change) {
 		/* Rebuild or refresh the UI accoring to the swap type. Note: the onSwap
 		callback might be performed by a non-main thread, which must talk to the 
 		UI (main thread) through the UI queue by pumping an event in it. */
 		if (type == model::SwapType::NONE)
 			return;
-		g_ui.pumpEvent([type]() { type == model::SwapType::HARD ? g_ui.rebuild() : g_ui.refresh(); });
+		g_ui.pumpEvent([type, change]() { type == model::SwapType::HARD ? g_ui.rebuild(change) : g_ui.refresh(); });
+	};
+
+	g_engine.onProjectSwitched = []() {
+		/* The audio thread is playing the new project already: the main thread
+		just makes it the current one and gets rid of the old one. */
+		g_ui.pumpEvent([]() { g_engine.getStorageApi().completeSwitch(); });
 	};
 
 	Conf conf = confFactory::deserialize();
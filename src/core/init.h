@@ -35,6 +35,12 @@ Performs tests, if requested. Returns -1 if no tests are available or the
 
 int tests(int argc, char** argv);
 
+/* scanPlugin
+Runs as a plug-in scanner worker process, if `--scan-plugin` has been passed in.
+Returns -1 otherwise. */
+
+int scanPlugin(int argc, char** argv);
+
 void startup(int argc, char** argv);
 void run();
 void shutdown();
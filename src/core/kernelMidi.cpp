@@ -40,22 +40,31 @@ namespace
 {
 constexpr auto OUTPUT_NAME       = "Giada MIDI output";
 constexpr auto INPUT_NAME        = "Giada MIDI input";
-constexpr int  MAX_RTMIDI_EVENTS = 8;
-constexpr int  MAX_NUM_PRODUCERS = 2; // Real-time thread and MIDI sync thread
+constexpr int  MAX_RTMIDI_EVENTS = G_MAX_SEQUENCER_EVENTS;
+constexpr int  MAX_NUM_PRODUCERS = 4; // Real-time, main, Scheduler (MIDI lighting, events) and MIDI input threads
 } // namespace
 
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
-KernelMidi::KernelMidi(model::Model& m)
+KernelMidi::KernelMidi(model::Model& m, Scheduler& s)
 : onMidiReceived(nullptr)
 , onMidiSent(nullptr)
 , m_model(m)
-, m_worker(G_KERNEL_MIDI_OUTPUT_RATE_MS)
+, m_scheduler(s)
 , m_midiQueue(MAX_RTMIDI_EVENTS, 0, MAX_NUM_PRODUCERS) // See https://github.com/cameron314/concurrentqueue#preallocation-correctly-using-try_enqueue
+, m_blockTime(Clock::now())
+, m_blockSampleRate(G_DEFAULT_SAMPLERATE)
+, m_order(0)
+, m_dropped(0)
+, m_sent(0)
+, m_jitterSumUs(0.0)
+, m_maxJitterUs(0.0)
+, m_lastJitterUs(0.0)
 , m_elpsedTime(0.0)
 {
+	m_outputTask = m_scheduler.addTask("KernelMidi output", [this]() { processOutput(); });
 }
 
 /* -------------------------------------------------------------------------- */
@@ -119,15 +128,39 @@ KernelMidi::Result KernelMidi::openInPort(int port)
 
 /* -------------------------------------------------------------------------- */
 
-void KernelMidi::start()
+void KernelMidi::processOutput()
 {
 	if (m_midiOut == nullptr)
 		return;
-	m_worker.start([this]() {
-		RtMidiMessage msg;
-		while (m_midiQueue.try_dequeue(msg))
-			m_midiOut->sendMessage(&msg);
-	});
+
+	OutMessage msg;
+	while (m_midiQueue.try_dequeue(msg))
+		m_pendingOut.push(msg);
+
+	while (!m_pendingOut.empty() && m_pendingOut.top().time <= Clock::now())
+	{
+		const OutMessage& next = m_pendingOut.top();
+		m_midiOut->sendMessage(next.bytes.data(), next.numBytes);
+		updateStats(Clock::now() - next.time);
+		m_pendingOut.pop();
+	}
+
+	if (!m_pendingOut.empty())
+		m_scheduler.notifyAt(m_outputTask, m_pendingOut.top().time);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void KernelMidi::updateStats(Clock::duration jitter)
+{
+	const double jitterUs = std::chrono::duration<double, std::micro>(jitter).count();
+
+	/* Single writer (the Scheduler thread): plain load/store pairs are enough. */
+
+	m_sent.store(m_sent.load() + 1);
+	m_jitterSumUs.store(m_jitterSumUs.load() + jitterUs);
+	m_maxJitterUs.store(std::max(m_maxJitterUs.load(), jitterUs));
+	m_lastJitterUs.store(jitterUs);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -237,6 +270,31 @@ std::vector<std::string> KernelMidi::getInPorts() const
 /* -------------------------------------------------------------------------- */
 
 bool KernelMidi::send(const MidiEvent& event) const
+{
+	return enqueue(event, Clock::now());
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool KernelMidi::sendAtFrame(const MidiEvent& event, Frame delta) const
+{
+	assert(m_blockSampleRate > 0);
+
+	const auto offset = std::chrono::duration<double>(delta / static_cast<double>(m_blockSampleRate));
+	return enqueue(event, m_blockTime + std::chrono::duration_cast<Clock::duration>(offset));
+}
+
+/* -------------------------------------------------------------------------- */
+
+void KernelMidi::beginBlock(int sampleRate) const
+{
+	m_blockTime       = Clock::now();
+	m_blockSampleRate = sampleRate;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool KernelMidi::enqueue(const MidiEvent& event, Clock::time_point time) const
 {
 	if (!canSend())
 		return false;
@@ -244,19 +302,46 @@ bool KernelMidi::send(const MidiEvent& event) const
 	assert(event.getNumBytes() > 0 && event.getNumBytes() <= 3);
 	assert(onMidiSent != nullptr);
 
-	RtMidiMessage msg;
-	if (event.getNumBytes() == 1)
-		msg = {event.getByte1()};
-	else if (event.getNumBytes() == 2)
-		msg = {event.getByte1(), event.getByte2()};
-	else
-		msg = {event.getByte1(), event.getByte2(), event.getByte3()};
+	const OutMessage msg = {
+	    {event.getByte1(), event.getByte2(), event.getByte3()},
+	    static_cast<std::size_t>(event.getNumBytes()),
+	    time,
+	    m_order.fetch_add(1)};
 
 	G_DEBUG("Send MIDI msg=0x{:0X}", event.getRaw());
 
 	onMidiSent();
 
-	return m_midiQueue.try_enqueue(msg);
+	if (!m_midiQueue.try_enqueue(msg))
+	{
+		m_dropped.fetch_add(1);
+		return false;
+	}
+
+	m_scheduler.notify(m_outputTask);
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+KernelMidi::OutputStats KernelMidi::getOutputStats() const
+{
+	const uint64_t sent = m_sent.load();
+	return {
+	    sent,
+	    m_dropped.load(),
+	    sent > 0 ? m_jitterSumUs.load() / sent : 0.0,
+	    m_maxJitterUs.load(),
+	    m_lastJitterUs.load()};
+}
+
+void KernelMidi::resetOutputStats()
+{
+	m_sent.store(0);
+	m_dropped.store(0);
+	m_jitterSumUs.store(0.0);
+	m_maxJitterUs.store(0.0);
+	m_lastJitterUs.store(0.0);
 }
 
 /* -------------------------------------------------------------------------- */
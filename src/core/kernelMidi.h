@@ -28,13 +28,18 @@
 #define G_KERNELMIDI_H
 
 #include "core/model/model.h"
-#include "core/worker.h"
+#include "core/scheduler.h"
+#include "core/types.h"
 #include "deps/concurrentqueue/concurrentqueue.h"
 #include "midiMapper.h"
 #include <RtMidi.h>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <queue>
 #include <string>
 
 namespace giada::m
@@ -53,7 +58,21 @@ public:
 		std::string message;
 	};
 
-	KernelMidi(model::Model&);
+	/* OutputStats
+	Timing statistics of the MIDI output. Jitter is the distance, in
+	microseconds, between the scheduled time of a message and the time it has
+	been actually handed over to the MIDI device. */
+
+	struct OutputStats
+	{
+		uint64_t sent         = 0;
+		uint64_t dropped      = 0;
+		double   avgJitterUs  = 0.0;
+		double   maxJitterUs  = 0.0;
+		double   lastJitterUs = 0.0;
+	};
+
+	KernelMidi(model::Model&, Scheduler&);
 
 	static void logCompiledAPIs();
 
@@ -100,21 +119,48 @@ public:
 	bool canSyncSlave() const;
 
 	/* send
-    Sends a MIDI message to the outside world. Returns false if MIDI out is not
-	enabled or the internal queue is full. */
+    Sends a MIDI message to the outside world as soon as possible. Returns false
+	if MIDI out is not enabled or the internal queue is full. */
 
 	bool send(const MidiEvent&) const;
 
-	/* start
-	Starts the internal worker on a separate thread. Call this on startup. */
+	/* sendAtFrame
+	Schedules a MIDI message to be sent 'delta' frames after the beginning of 
+	the current audio block (see beginBlock()). Audio thread only. */
+
+	bool sendAtFrame(const MidiEvent&, Frame delta) const;
+
+	/* beginBlock
+	Marks the beginning of a new audio block: takes the reference time used by 
+	sendAtFrame() to turn frame offsets into timestamps. Audio thread only. */
 
-	void start();
+	void beginBlock(int sampleRate) const;
+
+	/* getOutputStats, resetOutputStats
+	Returns or clears the timing statistics of the MIDI output. */
+
+	OutputStats getOutputStats() const;
+	void        resetOutputStats();
 
 	std::function<void(const MidiEvent&)> onMidiReceived;
 	std::function<void()>                 onMidiSent;
 
 private:
 	using RtMidiMessage = std::vector<unsigned char>;
+	using Clock         = std::chrono::steady_clock;
+
+	/* OutMessage
+	A MIDI message waiting to be sent, stamped with its scheduled time. Trivially
+	copyable, so that it can be enqueued by the realtime thread without 
+	allocating. 'order' keeps messages with the same time in FIFO order. */
+
+	struct OutMessage
+	{
+		std::array<unsigned char, 3> bytes;
+		std::size_t                  numBytes;
+		Clock::time_point            time;
+		uint64_t                     order;
+	};
 
 	static void s_callback(double, RtMidiMessage*, void*);
 	void        callback(double, RtMidiMessage*);
@@ -133,20 +179,60 @@ private:
 	Result openInPort_(int port);
 	Result openPort(RtMidi&, int port);
 
+	bool enqueue(const MidiEvent&, Clock::time_point) const;
+
+	/* processOutput
+	Scheduler task, run when a new message is enqueued or the earliest pending 
+	message is due. Sends all due messages and sets a timer for the next one. */
+
+	void processOutput();
+	void updateStats(Clock::duration jitter);
+
 	model::Model&              m_model;
 	std::unique_ptr<RtMidiOut> m_midiOut;
 	std::unique_ptr<RtMidiIn>  m_midiIn;
 
-	/* m_worker
-	A separate thread responsible for the MIDI output, so that multiple threads
-	can access the output device simultaneously. */
+	/* m_scheduler, m_outputTask
+	MIDI output is performed by a Scheduler task, so that multiple threads can 
+	access the output device simultaneously. The Scheduler must be dedicated to
+	MIDI output: timestamped messages (e.g. MIDI clock) can't wait behind 
+	other, slower tasks. */
 
-	Worker m_worker;
+	Scheduler&        m_scheduler;
+	Scheduler::TaskId m_outputTask;
 
 	/* m_midiQueue
 	Collects MIDI messages to be sent to the outside world. */
 
-	mutable moodycamel::ConcurrentQueue<RtMidiMessage> m_midiQueue;
+	mutable moodycamel::ConcurrentQueue<OutMessage> m_midiQueue;
+
+	/* m_pendingOut
+	Messages already dequeued but not due yet, sorted by scheduled time (and by
+	arrival order for messages with the same time). Scheduler thread only. */
+
+	struct Later
+	{
+		bool operator()(const OutMessage& a, const OutMessage& b) const
+		{
+			return a.time != b.time ? a.time > b.time : a.order > b.order;
+		}
+	};
+
+	std::priority_queue<OutMessage, std::vector<OutMessage>, Later> m_pendingOut;
+
+	/* m_blockTime, m_blockSampleRate
+	Reference time and sample rate of the current audio block. Written and read
+	by the audio thread only. */
+
+	mutable Clock::time_point m_blockTime;
+	mutable int               m_blockSampleRate;
+
+	mutable std::atomic<uint64_t> m_order;
+	mutable std::atomic<uint64_t> m_dropped;
+	std::atomic<uint64_t>         m_sent;
+	std::atomic<double>           m_jitterSumUs;
+	std::atomic<double>           m_maxJitterUs;
+	std::atomic<double>           m_lastJitterUs;
 
 	/* m_elpsedTime
 	Time elapsed on received MIDI events. Used to compute the absolute timestamp
@@ -0,0 +1,152 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#include "core/midiLightingService.h"
+#include "core/kernelMidi.h"
+#include <cassert>
+#ifdef WITH_TESTS
+#include "tests/mocks/kernelMidiMock.h"
+#endif
+
+namespace giada::m
+{
+template <typename KernelMidiI>
+MidiLightingService<KernelMidiI>::MidiLightingService(MidiMapper<KernelMidiI>& m, Scheduler& s)
+: onUpdate(nullptr)
+, m_midiMapper(m)
+, m_scheduler(s)
+, m_dirty(false)
+, m_resetRequested(false)
+, m_sentCount(0)
+, m_skippedCount(0)
+{
+	m_taskId = m_scheduler.addTask("MidiLightingService", [this]() { process(); });
+}
+
+/* -------------------------------------------------------------------------- */
+
+template <typename KernelMidiI>
+void MidiLightingService<KernelMidiI>::notify()
+{
+	m_dirty.store(true);
+	m_scheduler.notify(m_taskId);
+}
+
+/* -------------------------------------------------------------------------- */
+
+template <typename KernelMidiI>
+void MidiLightingService<KernelMidiI>::reset()
+{
+	m_resetRequested.store(true);
+	notify();
+}
+
+/* -------------------------------------------------------------------------- */
+
+template <typename KernelMidiI>
+void MidiLightingService<KernelMidiI>::update(const std::vector<ChannelState>& states)
+{
+	if (m_resetRequested.exchange(false))
+		m_sent.clear();
+
+	for (const ChannelState& state : states)
+	{
+		const MidiLighter<KernelMidiI>& lighter = *state.lighter;
+
+		bool sent = false;
+		sent |= send(lighter.playing.getValue(), lighter.getStatusMessage(state.status, state.audible));
+		sent |= send(lighter.mute.getValue(), lighter.getMuteMessage(state.muted));
+		sent |= send(lighter.solo.getValue(), lighter.getSoloMessage(state.soloed));
+
+		if (sent && lighter.onSend != nullptr)
+			lighter.onSend();
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+template <typename KernelMidiI>
+typename MidiLightingService<KernelMidiI>::Stats MidiLightingService<KernelMidiI>::getStats() const
+{
+	return {m_sentCount.load(), m_skippedCount.load()};
+}
+
+/* -------------------------------------------------------------------------- */
+
+template <typename KernelMidiI>
+void MidiLightingService<KernelMidiI>::process()
+{
+	/* Changes notified too close to the previous update are postponed, so that
+	a burst of them ends up in a single update. */
+
+	const Scheduler::Clock::time_point now = Scheduler::Clock::now();
+	if (now < m_nextUpdate)
+	{
+		m_scheduler.notifyAt(m_taskId, m_nextUpdate);
+		return;
+	}
+
+	if (!m_dirty.exchange(false))
+		return;
+
+	assert(onUpdate != nullptr);
+
+	m_nextUpdate = now + MIN_INTERVAL;
+	onUpdate();
+}
+
+/* -------------------------------------------------------------------------- */
+
+template <typename KernelMidiI>
+bool MidiLightingService<KernelMidiI>::send(uint32_t learnt, const MidiMap::Message* msg)
+{
+	if (learnt == 0x0 || msg == nullptr)
+		return false;
+
+	const uint32_t raw = m_midiMapper.getMidiLightning(learnt, *msg);
+	if (raw == 0x0)
+		return false;
+
+	auto it = m_sent.find(learnt);
+	if (it != m_sent.end() && it->second == raw)
+	{
+		m_skippedCount.fetch_add(1);
+		return false;
+	}
+
+	m_sent[learnt] = raw;
+	m_midiMapper.sendMidiLightning(learnt, *msg);
+	m_sentCount.fetch_add(1);
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+template class MidiLightingService<KernelMidi>;
+#ifdef WITH_TESTS
+template class MidiLightingService<KernelMidiMock>;
+#endif
+} // namespace giada::m
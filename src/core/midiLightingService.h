@@ -0,0 +1,144 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef G_MIDI_LIGHTING_SERVICE_H
+#define G_MIDI_LIGHTING_SERVICE_H
+
+#include "core/channels/midiLighter.h"
+#include "core/midiMapper.h"
+#include "core/scheduler.h"
+#include "core/types.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace giada::m
+{
+/* MidiLightingService
+Sends MIDI lighting feedback to the connected controllers, on the Scheduler 
+thread. Channels only raise a flag when their state changes: the service then 
+computes the message each target (i.e. each learnt pad) should display, sends 
+only those that differ from what has been sent already and never updates more
+often than once every MIN_INTERVAL. */
+
+template <typename KernelMidiI>
+class MidiLightingService final
+{
+public:
+	static constexpr auto MIN_INTERVAL = std::chrono::milliseconds(20);
+
+	/* ChannelState
+	What a channel should display on the controller. */
+
+	struct ChannelState
+	{
+		const MidiLighter<KernelMidiI>* lighter;
+		ChannelStatus                   status;
+		bool                            audible;
+		bool                            muted;
+		bool                            soloed;
+	};
+
+	/* Stats
+	Number of messages sent so far and of those skipped because the target was
+	already displaying them. */
+
+	struct Stats
+	{
+		uint64_t sent    = 0;
+		uint64_t skipped = 0;
+	};
+
+	MidiLightingService(MidiMapper<KernelMidiI>&, Scheduler&);
+
+	/* notify
+	Tells the service that some channel state has changed. Realtime-safe: it 
+	just raises a flag and wakes up the Scheduler task. */
+
+	void notify();
+
+	/* reset
+	Forgets what has been sent so far, so that all targets are sent again on the
+	next update. Call this when the midimap changes. */
+
+	void reset();
+
+	/* update
+	Sends the messages needed to display the given channel states, skipping the
+	targets that already display the right one. Scheduler thread only, usually
+	from within the onUpdate callback. */
+
+	void update(const std::vector<ChannelState>&);
+
+	Stats getStats() const;
+
+	/* onUpdate
+	Callback fired on the Scheduler thread when an update is due. It must 
+	collect the current channel states and pass them to update(). */
+
+	std::function<void()> onUpdate;
+
+private:
+	void process();
+
+	/* send
+	Sends 'msg' to 'learnt' if not already there. Returns whether the message 
+	has been sent. */
+
+	bool send(uint32_t learnt, const MidiMap::Message* msg);
+
+	MidiMapper<KernelMidiI>& m_midiMapper;
+	Scheduler&               m_scheduler;
+	Scheduler::TaskId        m_taskId;
+
+	std::atomic<bool> m_dirty;
+	std::atomic<bool> m_resetRequested;
+
+	/* m_sent
+	Last raw message sent to each target, keyed by the learnt message of the 
+	target. Scheduler thread only. */
+
+	std::unordered_map<uint32_t, uint32_t> m_sent;
+
+	/* m_nextUpdate
+	Earliest time the next update is allowed to run. Scheduler thread only. */
+
+	Scheduler::Clock::time_point m_nextUpdate;
+
+	std::atomic<uint64_t> m_sentCount;
+	std::atomic<uint64_t> m_skippedCount;
+};
+
+extern template class MidiLightingService<KernelMidi>;
+#ifdef WITH_TESTS
+extern template class MidiLightingService<KernelMidiMock>;
+#endif
+} // namespace giada::m
+
+#endif
@@ -139,6 +139,24 @@ void MidiMapper<KernelMidiI>::sendInitMessages() const
 
 /* -------------------------------------------------------------------------- */
 
+template <typename KernelMidiI>
+uint32_t MidiMapper<KernelMidiI>::getMidiLightning(uint32_t learnt, const MidiMap::Message& m) const
+{
+	if (!isMessageDefined(m))
+		return 0x0;
+
+	/* Isolate 'channel' from learnt message and offset it as requested by 'nn' in 
+	the midiMap configuration file. */
+
+	uint32_t out = ((learnt & 0x00FF0000) >> 16) << m.offset;
+
+	/* Merge the previously prepared channel into final message. */
+
+	return out | m.value | (m.channel << 24);
+}
+
+/* -------------------------------------------------------------------------- */
+
 template <typename KernelMidiI>
 void MidiMapper<KernelMidiI>::sendMidiLightning(uint32_t learnt, const MidiMap::Message& m) const
 {
@@ -153,17 +171,7 @@ void MidiMapper<KernelMidiI>::sendMidiLightning(uint32_t learnt, const MidiMap::
 	u::log::print("[MidiMapper::sendMidiLightning] learnt={:#x}, chan={}, msg={:#x}, offset={}\n",
 	    learnt, m.channel, m.value, m.offset);
 
-	/* Isolate 'channel' from learnt message and offset it as requested by 'nn' in 
-	the midiMap configuration file. */
-
-	uint32_t out = ((learnt & 0x00FF0000) >> 16) << m.offset;
-
-	/* Merge the previously prepared channel into final message, and finally send 
-	it. */
-
-	out |= m.value | (m.channel << 24);
-
-	m_kernelMidi.send(MidiEvent::makeFromRaw(out, /*numBytes=*/3));
+	m_kernelMidi.send(MidiEvent::makeFromRaw(getMidiLightning(learnt, m), /*numBytes=*/3));
 }
 
 /* -------------------------------------------------------------------------- */
@@ -95,6 +95,13 @@ public:
 
 	void sendInitMessages() const;
 
+	/* getMidiLightning
+	Returns the raw MIDI lightning message defined by 'msg', to be sent to the
+	device that generated 'learnt'. Returns 0x0 if 'msg' is not defined in the
+	current midimap. */
+
+	uint32_t getMidiLightning(uint32_t learnt, const MidiMap::Message& msg) const;
+
 	/* sendMidiLightning
 	Sends a MIDI lightning message defined by 'msg'. */
 
@@ -30,28 +30,75 @@
 #include "core/midiEvent.h"
 #include "core/model/sequencer.h"
 #include "utils/log.h"
-#include "utils/time.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <numeric>
 
 namespace giada::m
 {
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+constexpr int MIDI_CLOCK_PPQ = 24;
+
+/* MIDI_BEAT_PULSES
+Each MIDI Beat (the unit of the Song Position Pointer) spans 6 MIDI Clocks. */
+
+constexpr int MIDI_BEAT_PULSES = 6;
+
+/* BPM_RESOLUTION, BPM_HYSTERESIS
+The tempo estimate is rounded to 1/BPM_RESOLUTION and committed only if it 
+differs from the current tempo by at least BPM_HYSTERESIS. */
+
+constexpr double BPM_RESOLUTION = 10.0;
+constexpr double BPM_HYSTERESIS = 0.2;
+
+/* PHASE_SMOOTHNESS, PHASE_TOLERANCE
+Smooth factor for the phase error (1.0 == no smoothing) and maximum phase error
+tolerated before correcting the sequencer position, in seconds. */
+
+constexpr double PHASE_SMOOTHNESS = 0.1;
+constexpr double PHASE_TOLERANCE  = 0.001;
+
+/* getPulse_
+Returns the index of the MIDI clock pulse (0 to MIDI_CLOCK_PPQ - 1) the frame 
+'f' belongs to. Integer math, so that pulses are computed at sample resolution 
+without accumulating rounding errors. */
+
+int getPulse_(Frame f, Frame framesInBeat)
+{
+	return static_cast<int>((static_cast<int64_t>(f % framesInBeat) * MIDI_CLOCK_PPQ) / framesInBeat);
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
 MidiSynchronizer::MidiSynchronizer(KernelMidi& k)
 : onChangePosition(nullptr)
 , onChangeBpm(nullptr)
+, onShiftPosition(nullptr)
 , onStart(nullptr)
 , onStop(nullptr)
 , m_kernelMidi(k)
-, m_worker(1000) // Default sleep time, will be reset anyway on startSendClock()
-, m_timeElapsed(0.0)
-, m_lastTimestamp(0.0)
-, m_lastDelta(0.0)
-, m_lastBpm(G_DEFAULT_BPM)
+, m_sendClock(false)
+, m_clockPosition(0)
+, m_blockVersion(0)
+, m_blockFrame(0)
+, m_blockTime(0)
+, m_blockSampleRate(0)
+, m_beatPulse(0)
+, m_phaseError(0.0)
+, m_phasePulses(0)
 {
 }
 
 /* -------------------------------------------------------------------------- */
 
-void MidiSynchronizer::receive(const MidiEvent& e, int numBeatsInLoop)
+void MidiSynchronizer::receive(const MidiEvent& e, const model::Sequencer& sequencer)
 {
 	assert(onStart != nullptr);
 	assert(onStop != nullptr);
@@ -70,10 +117,13 @@ void MidiSynchronizer::receive(const MidiEvent& e, int numBeatsInLoop)
 	switch (e.getByte1())
 	{
 	case MidiEvent::SYSTEM_CLOCK:
-		computeClock(e.getTimestamp());
+		computeClock(e.getTimestamp(), sequencer);
 		break;
 
 	case MidiEvent::SYSTEM_START:
+		m_beatPulse   = 0;
+		m_phaseError  = 0.0;
+		m_phasePulses = 0;
 		onStart();
 		break;
 
@@ -82,7 +132,7 @@ void MidiSynchronizer::receive(const MidiEvent& e, int numBeatsInLoop)
 		break;
 
 	case MidiEvent::SYSTEM_SPP:
-		computePosition(e.getSppPosition(), numBeatsInLoop);
+		computePosition(e.getSppPosition(), sequencer.beats);
 		break;
 
 	default:
@@ -92,31 +142,52 @@ void MidiSynchronizer::receive(const MidiEvent& e, int numBeatsInLoop)
 
 /* -------------------------------------------------------------------------- */
 
-void MidiSynchronizer::startSendClock(float bpm)
+void MidiSynchronizer::startSendClock()
 {
-	if (!m_kernelMidi.canSyncMaster())
-		return;
-
-	setClockBpm(bpm);
-	const MidiEvent clockEvent = MidiEvent::makeFrom1Byte(MidiEvent::SYSTEM_CLOCK);
-
-	m_worker.start([this, clockEvent]() {
-		if (!m_kernelMidi.send(clockEvent))
-			G_DEBUG("Can't send MIDI out message!", );
-	});
+	m_sendClock.store(m_kernelMidi.canSyncMaster());
 }
 
-void MidiSynchronizer::stopSendClock() const
+void MidiSynchronizer::stopSendClock()
 {
-	m_worker.stop();
+	m_sendClock.store(false);
 }
 
 /* -------------------------------------------------------------------------- */
 
-void MidiSynchronizer::setClockBpm(float bpm)
+void MidiSynchronizer::advance(const model::Sequencer& sequencer, Frame bufferSize, int sampleRate) const
 {
-	const float rateMs = 60000.0 / (24.0 * bpm);
-	m_worker.setSleep(rateMs);
+	/* Publish the position snapshot for the MIDI thread. Sequence lock: the 
+	version is odd while writing, so readers can detect torn snapshots. */
+
+	const int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+
+	m_blockVersion.fetch_add(1);
+	m_blockFrame.store(sequencer.a_getCurrentFrame());
+	m_blockTime.store(now);
+	m_blockSampleRate.store(sampleRate);
+	m_blockVersion.fetch_add(1);
+
+	const Frame framesInBeat = sequencer.framesInBeat;
+
+	if (!m_sendClock.load() || framesInBeat < MIDI_CLOCK_PPQ)
+		return;
+
+	const Frame start = sequencer.isRunning() ? sequencer.a_getCurrentFrame() : m_clockPosition;
+
+	/* A pulse starts on each frame whose pulse index differs from the previous
+	frame's one. The loop length is a multiple of the beat length, so this also
+	holds across the loop boundary. */
+
+	int prevPulse = getPulse_(start + framesInBeat - 1, framesInBeat);
+	for (Frame local = 0; local < bufferSize; local++)
+	{
+		const int pulse = getPulse_(start + local, framesInBeat);
+		if (pulse != prevPulse)
+			m_kernelMidi.sendAtFrame(MidiEvent::makeFrom1Byte(MidiEvent::SYSTEM_CLOCK), local);
+		prevPulse = pulse;
+	}
+
+	m_clockPosition = (start + bufferSize) % framesInBeat;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -145,58 +216,97 @@ void MidiSynchronizer::sendStop()
 
 /* -------------------------------------------------------------------------- */
 
-void MidiSynchronizer::computeClock(double timestamp)
+void MidiSynchronizer::computeClock(double timestamp, const model::Sequencer& sequencer)
 {
 	assert(onChangeBpm != nullptr);
 
 	/* A MIDI clock event (SYSTEM_CLOCK) is sent 24 times per quarter note, that 
 	is 24 times per beat. This is tempo-relative, since the tempo defines the 
 	length of a quarter note (aka frames in beat) and so the duration of each 
-	pulse. Faster tempo -> faster SYSTEM_CLOCK events stream. Here we are
-	interpreting that rate and converting into a BPM value. */
+	pulse. Faster tempo -> faster SYSTEM_CLOCK events stream. The tempo tracker
+	interprets that rate and converts it into a BPM value. */
 
-	/* SMOOTHNESS
-	Smooth factor for delta and bpm. The smaller the value, the stronger the
-	effect. SMOOTHNESS == 1.0 means no smooth effect. */
+	m_tempoTracker.process(timestamp);
 
-	constexpr double SMOOTHNESS = 0.1;
+	if (sequencer.isRunning())
+		computePhase(sequencer);
 
-	/* BPM_CHANGE_FREQ
-	How fast the bpm is changed, in seconds. */
+	m_beatPulse = (m_beatPulse + 1) % MIDI_CLOCK_PPQ;
 
-	constexpr double BPM_CHANGE_FREQ = 1.0;
+	if (!m_tempoTracker.isStable())
+		return;
 
-	/* Skip the very first iteration where the last timestamp does not exist
-	yet. It would screw up BPM computation otherwise. */
+	/* Commit the new tempo only if it differs enough from the current one. 
+	Changing bpm is expensive (all actions get rescaled), so small deviations 
+	are left to phase correction. */
 
-	if (m_lastTimestamp == 0.0)
-	{
-		m_lastTimestamp = timestamp;
+	const double bpm = std::round(m_tempoTracker.getBpm() * BPM_RESOLUTION) / BPM_RESOLUTION;
+
+	if (std::abs(bpm - sequencer.bpm) >= BPM_HYSTERESIS)
+		onChangeBpm(static_cast<float>(bpm));
+}
+
+/* -------------------------------------------------------------------------- */
+
+void MidiSynchronizer::computePhase(const model::Sequencer& sequencer)
+{
+	assert(onShiftPosition != nullptr);
+
+	const Frame framesInBeat = sequencer.framesInBeat;
+
+	if (framesInBeat < MIDI_CLOCK_PPQ || m_blockSampleRate.load() == 0)
 		return;
-	}
 
-	/* Compute a raw timestamp delta (rawDelta) and then smooth it out with the
-	previous one (m_lastDelta) by a SMOOTHNESS factor. */
+	/* Compare positions within the beat only: the beat itself is governed by
+	START and SPP messages. The error is wrapped around to the shortest 
+	distance, i.e. [-framesInBeat/2, framesInBeat/2). */
 
-	const double rawDelta = timestamp - m_lastTimestamp;
-	m_lastDelta           = (rawDelta * SMOOTHNESS) + (m_lastDelta * (1.0 - SMOOTHNESS));
+	const double expected = (m_beatPulse * static_cast<double>(framesInBeat)) / MIDI_CLOCK_PPQ;
+	const double actual   = std::fmod(getCurrentFrame(), framesInBeat);
+	const double error    = std::remainder(expected - actual, framesInBeat);
 
-	/* Do the same as delta for the BPM value. The raw bpm formula is a simplified
-	version of 
-		rawBpm = ((1.0 / m_lastDelta) / MIDI_CLOCK_PPQ) * 60.0;
-	where MIDI_CLOCK_PPQ == 24.0 */
+	m_phaseError = (error * PHASE_SMOOTHNESS) + (m_phaseError * (1.0 - PHASE_SMOOTHNESS));
+	m_phasePulses++;
 
-	const double rawBpm = 2.5 / m_lastDelta;
-	m_lastBpm           = (rawBpm * SMOOTHNESS) + (m_lastBpm * (1.0 - SMOOTHNESS));
+	/* Correct once per beat at most, so that the previous correction has been
+	applied and measured in the meantime. Never shift by more than one pulse
+	at a time. */
 
-	m_lastTimestamp = timestamp;
-	m_timeElapsed   = m_timeElapsed + m_lastDelta;
+	const double tolerance = m_blockSampleRate.load() * PHASE_TOLERANCE;
 
-	if (m_timeElapsed > BPM_CHANGE_FREQ)
+	if (m_phasePulses < MIDI_CLOCK_PPQ || std::abs(m_phaseError) < tolerance)
+		return;
+
+	const double maxShift = framesInBeat / static_cast<double>(MIDI_CLOCK_PPQ);
+	const Frame  shift    = static_cast<Frame>(std::round(std::clamp(m_phaseError, -maxShift, maxShift)));
+
+	onShiftPosition(shift);
+
+	m_phaseError -= shift;
+	m_phasePulses = 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+double MidiSynchronizer::getCurrentFrame() const
+{
+	uint32_t version;
+	Frame    frame;
+	int64_t  time;
+	int      sampleRate;
+
+	do
 	{
-		onChangeBpm(m_lastBpm);
-		m_timeElapsed = 0;
-	}
+		version    = m_blockVersion.load();
+		frame      = m_blockFrame.load();
+		time       = m_blockTime.load();
+		sampleRate = m_blockSampleRate.load();
+	} while ((version & 1) != 0 || version != m_blockVersion.load());
+
+	const int64_t now     = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+	const double  elapsed = (now - time) / 1e9;
+
+	return frame + (elapsed * sampleRate);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -213,6 +323,10 @@ void MidiSynchronizer::computePosition(int sppPosition, int numBeatsInLoop)
 
 	const int beat = (sppPosition / 4) % numBeatsInLoop;
 
+	m_beatPulse   = (sppPosition * MIDI_BEAT_PULSES) % MIDI_CLOCK_PPQ;
+	m_phaseError  = 0.0;
+	m_phasePulses = 0;
+
 	onChangePosition(beat);
 }
 } // namespace giada::m
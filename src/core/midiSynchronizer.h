@@ -27,8 +27,16 @@
 #ifndef G_MIDI_SYNCHRONIZER_H
 #define G_MIDI_SYNCHRONIZER_H
 
+#include "core/tempoTracker.h"
 #include "core/types.h"
-#include "core/worker.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+
+namespace giada::m::model
+{
+class Sequencer;
+}
 
 namespace giada::m
 {
@@ -42,32 +50,57 @@ public:
 	/* receive
 	Receives a MidiEvent and reacts accordingly. Valid only when in SLAVE mode. */
 
-	void receive(const MidiEvent&, int numBeatsInLoop);
+	void receive(const MidiEvent&, const model::Sequencer&);
 
 	/* startSendClock, stopSendClock
-	Sends MIDI clock data for synchronization with other MIDI devices. Valid only
-	when in MASTER mode. */
+	Enables or disables the MIDI clock output for synchronization with other 
+	MIDI devices. Valid only when in MASTER mode. */
+
+	void startSendClock();
+	void stopSendClock();
 
-	void startSendClock(float bpm);
-	void stopSendClock() const;
+	/* advance
+	Sends the MIDI clock pulses (24 per beat) that fall in the current audio 
+	block, each one scheduled at its own frame. Pulses are derived from the 
+	sequencer position when running, so they are phase-locked to the audio and
+	don't drift; a free-running position is used when the sequencer is stopped.
+	Also takes a snapshot of the sequencer position, used in SLAVE mode for
+	phase correction. Call this on each new audio block, before advancing the
+	sequencer. */
+
+	void advance(const model::Sequencer&, Frame bufferSize, int sampleRate) const;
 
 	void sendRewind();
 	void sendStart();
 	void sendStop();
 
-	void setClockBpm(float);
-
 	std::function<void(int)>   onChangePosition;
 	std::function<void(float)> onChangeBpm;
+	std::function<void(Frame)> onShiftPosition;
 	std::function<void()>      onStart;
 	std::function<void()>      onStop;
 
 private:
 	/* computeClock
-	Computes the current bpm value and sends the corresponding event to the
-	engine when necessary. */
+	Feeds the tempo tracker with a new clock pulse. Commits a new bpm value to
+	the engine only when the estimate is stable and far enough from the current
+	one (hysteresis), then corrects the sequencer phase. */
+
+	void computeClock(double timestamp, const model::Sequencer&);
+
+	/* computePhase
+	Compares the sequencer position with the one expected by the incoming clock
+	pulses and asks the engine to shift the sequencer when the (smoothed) 
+	difference is too large. Small tempo deviations are absorbed here, without
+	changing the bpm. */
+
+	void computePhase(const model::Sequencer&);
+
+	/* getCurrentFrame
+	Returns the sequencer frame at this very moment, extrapolated from the
+	snapshot taken by the audio thread at the beginning of the last block. */
 
-	void computeClock(double timestamp);
+	double getCurrentFrame() const;
 
 	/* computePosition 
 	Given a SPP (Song Position Pointer), it jumps to the right beat. */
@@ -76,15 +109,41 @@ private:
 
 	KernelMidi& m_kernelMidi;
 
-	/* m_worker
-	A separate thread responsible for the MIDI Clock output. */
+	/* m_sendClock
+	Whether the audio thread should emit MIDI clock pulses or not. */
+
+	std::atomic<bool> m_sendClock;
+
+	/* m_clockPosition
+	Position within the beat, in frames, to continue from when the sequencer is
+	not running. Audio thread only. */
+
+	mutable Frame m_clockPosition;
+
+	/* m_block[...]
+	Snapshot of the sequencer position at the beginning of the last audio 
+	block, written by the audio thread. m_blockVersion is odd while the 
+	snapshot is being written (sequence lock). */
+
+	mutable std::atomic<uint32_t> m_blockVersion;
+	mutable std::atomic<Frame>    m_blockFrame;
+	mutable std::atomic<int64_t>  m_blockTime;
+	mutable std::atomic<int>      m_blockSampleRate;
+
+	TempoTracker m_tempoTracker;
+
+	/* m_beatPulse
+	Index of the next expected clock pulse within the beat (0 to 23), counted 
+	from the last START or SPP message. */
+
+	int m_beatPulse;
 
-	Worker m_worker;
+	/* m_phaseError, m_phasePulses
+	Smoothed distance, in frames, between the expected and the actual sequencer
+	position and number of pulses since the last correction. */
 
-	double m_timeElapsed;
-	double m_lastTimestamp;
-	double m_lastDelta;
-	double m_lastBpm;
+	double m_phaseError;
+	int    m_phasePulses;
 };
 } // namespace giada::m
 
@@ -29,6 +29,9 @@
 #include "core/model/model.h"
 #include "utils/log.h"
 #include "utils/math.h"
+#include <algorithm>
+#include <cassert>
+#include <thread>
 
 namespace giada::m
 {
@@ -51,6 +54,8 @@ Mixer::Mixer(model::Model& m)
 , m_model(m)
 , m_signalCbFired(false)
 , m_endOfRecCbFired(false)
+, m_sceneRecall(0)
+, m_renderAhead(m)
 {
 }
 
@@ -72,12 +77,14 @@ void Mixer::reset(int maxFramesInLoop, int framesInBuffer)
 
 void Mixer::enable()
 {
+	m_renderAhead.resume();
 	m_model.get().mixer.a_setActive(true);
 	u::log::print("[mixer::enable] enabled\n");
 }
 
 void Mixer::disable()
 {
+	m_renderAhead.suspend();
 	m_model.get().mixer.a_setActive(false);
 	while (m_model.isLocked())
 		;
@@ -86,6 +93,23 @@ void Mixer::disable()
 
 /* -------------------------------------------------------------------------- */
 
+void Mixer::setRenderThreads(int numThreads)
+{
+	assert(!m_model.get().mixer.a_isActive());
+
+	/* Leave a core to the audio thread: workers run at its same priority. */
+
+	const int maxThreads = std::max(static_cast<int>(std::thread::hardware_concurrency()) - 1, 0);
+	numThreads           = std::clamp(numThreads, 0, std::min(maxThreads, G_MAX_RENDER_THREADS));
+
+	m_renderAhead.stop();
+	m_renderAhead.start(numThreads);
+
+	u::log::print("[mixer::setRenderThreads] render threads={}\n", numThreads);
+}
+
+/* -------------------------------------------------------------------------- */
+
 void Mixer::allocRecBuffer(int frames)
 {
 	m_model.get().mixer.getRecBuffer().alloc(frames, G_MAX_IO_CHANS);
@@ -104,10 +128,35 @@ const mcl::AudioBuffer& Mixer::getRecBuffer()
 /* -------------------------------------------------------------------------- */
 
 void Mixer::advanceChannels(const Sequencer::EventBuffer& events,
-    const model::Channels& channels, Range<Frame> block, int quantizerStep) const
+    const model::Layout& layout_RT, Range<Frame> block, int quantizerStep) const
 {
-	for (const Channel& c : channels.getAll())
-		if (!c.isInternal())
+	const model::Sequencer& sequencer = layout_RT.sequencer;
+
+	/* Blocks rendered ahead assume that the sequencer moves forward linearly:
+	no rewinds nor position corrections in the current block. */
+
+	const bool steady = sequencer.framesInLoop > 0 &&
+	                    sequencer.a_getCurrentFrame() == block.getEnd() % sequencer.framesInLoop &&
+	                    !events.has(Sequencer::EventType::REWIND);
+
+	/* Recall the play state of the last scene launched, if any, on the first 
+	bar: all channels in one go, before they react to the bar itself. Blocks
+	rendered ahead get invalidated by the new state. */
+
+	const model::Scenes::Recall& recall = layout_RT.scenes.getRecall();
+
+	if (recall.serial != m_sceneRecall &&
+	    (events.has(Sequencer::EventType::FIRST_BEAT) || events.has(Sequencer::EventType::BAR)))
+	{
+		for (const model::Scene::Channel& sc : recall.channels)
+			for (const Channel& c : layout_RT.channels.getAll())
+				if (c.id == sc.channelId)
+					c.recallPlayState(sc.playing);
+		m_sceneRecall = recall.serial;
+	}
+
+	for (const Channel& c : layout_RT.channels.getAll())
+		if (!c.isInternal() && !m_renderAhead.consume(c, block.getBegin(), layout_RT, steady))
 			c.advance(events, block, quantizerStep);
 }
 
@@ -189,7 +238,7 @@ void Mixer::render(mcl::AudioBuffer& out, const mcl::AudioBuffer& in, const mode
 	changing data (e.g. Plugins or Waves). */
 
 	if (!layout_RT.locked)
-		renderChannels(channels.getAll(), out, mixer.getInBuffer(), hasSolos, seqIsRunning);
+		renderChannels(layout_RT, out, mixer.getInBuffer(), hasSolos, seqIsRunning);
 
 	/* Render remaining internal channels. */
 
@@ -344,12 +393,37 @@ void Mixer::processLineIn(const model::Mixer& mixer, const mcl::AudioBuffer& inB
 
 /* -------------------------------------------------------------------------- */
 
-void Mixer::renderChannels(const std::vector<Channel>& channels, mcl::AudioBuffer& out,
+void Mixer::renderChannels(const model::Layout& layout_RT, mcl::AudioBuffer& out,
     mcl::AudioBuffer& in, bool hasSolos, bool seqIsRunning) const
 {
+	const std::vector<Channel>& channels  = layout_RT.channels.getAll();
+	const Frame                 nextFrame = layout_RT.sequencer.a_getCurrentFrame();
+
+	/* Channels whose block has been rendered ahead of time are ready to be
+	mixed. The others are processed here, after taking them back from workers.
+	A worker that doesn't give a channel back in time leaves it silent for this
+	block, rather than blocking the callback. Then, if the sequencer is 
+	running, workers can take over again from the next block. */
+
+	for (const Channel& c : channels)
+	{
+		if (c.isInternal() || m_renderAhead.takeRendered(c))
+			continue;
+		if (!m_renderAhead.reclaim(c))
+		{
+			c.shared->audioBuffer.clear();
+			continue;
+		}
+		c.process(in, seqIsRunning);
+		if (seqIsRunning)
+			m_renderAhead.handOver(c, nextFrame, layout_RT);
+	}
+
 	for (const Channel& c : channels)
 		if (!c.isInternal())
-			c.render(&out, &in, hasSolos, seqIsRunning);
+			c.mix(out, hasSolos);
+
+	m_renderAhead.endBlock();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -29,6 +29,7 @@
 
 #include "core/midiEvent.h"
 #include "core/queue.h"
+#include "core/renderAhead.h"
 #include "core/ringBuffer.h"
 #include "core/sequencer.h"
 #include "core/types.h"
@@ -103,6 +104,13 @@ public:
 	void enable();
 	void disable();
 
+	/* setRenderThreads
+	Sets the number of worker threads that render Sample Channels ahead of the
+	audio thread, while the sequencer is running. 0 = render everything on the
+	audio thread. Must be called only when mixer is disabled. */
+
+	void setRenderThreads(int);
+
 	/* allocRecBuffer
 	Allocates new memory for the virtual input channel. */
 
@@ -131,10 +139,11 @@ public:
 
 	/* advanceChannels
 	Processes Channels' static events (e.g. pre-recorded actions or sequencer 
-	events) in the current audio block. Called by the main audio thread when the 
-	sequencer is running. */
+	events) in the current audio block, or takes the block rendered ahead of 
+	time, if any. Called by the main audio thread when the sequencer is 
+	running. */
 
-	void advanceChannels(const Sequencer::EventBuffer&, const model::Channels&,
+	void advanceChannels(const Sequencer::EventBuffer&, const model::Layout&,
 	    Range<Frame>, int quantizerStep) const;
 
 	/* updateSoloCount
@@ -189,8 +198,8 @@ private:
 	void processLineIn(const model::Mixer& mixer, const mcl::AudioBuffer& inBuf,
 	    float inVol, float recTriggerLevel, bool isSeqActive) const;
 
-	void renderChannels(const std::vector<Channel>& channels, mcl::AudioBuffer& out,
-	    mcl::AudioBuffer& in, bool hasSolos, bool seqIsRunning) const;
+	void renderChannels(const model::Layout&, mcl::AudioBuffer& out, mcl::AudioBuffer& in,
+	    bool hasSolos, bool seqIsRunning) const;
 	void renderMasterIn(const Channel&, mcl::AudioBuffer& in, bool seqIsRunning) const;
 	void renderMasterOut(const Channel&, mcl::AudioBuffer& out, bool seqIsRunning) const;
 	void renderPreview(const Channel&, mcl::AudioBuffer& out, bool seqIsRunning) const;
@@ -215,6 +224,17 @@ private:
 
 	mutable bool m_signalCbFired;
 	mutable bool m_endOfRecCbFired;
+
+	/* m_sceneRecall
+	Serial number of the last scene recall applied. Audio thread only. */
+
+	mutable int m_sceneRecall;
+
+	/* m_renderAhead
+	Worker threads that render channels ahead of time. Mutable: driven by the
+	audio thread from the const render path. */
+
+	mutable RenderAhead m_renderAhead;
 };
 } // namespace giada::m
 
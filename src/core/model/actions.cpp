@@ -28,6 +28,7 @@
 #include "core/actions/actionFactory.h"
 #include "utils/log.h"
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <memory>
 #ifdef G_DEBUG_MODE
@@ -36,9 +37,32 @@
 
 namespace giada::m::model
 {
+namespace
+{
+/* revision_
+Source of revisions, shared by all Actions objects: a revision number identifies
+a specific content, even across different projects. */
+
+std::atomic<int> revision_ = 0;
+
+int nextRevision_() { return revision_.fetch_add(1) + 1; }
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+Actions::Actions()
+: m_revision(nextRevision_())
+{
+}
+
+/* -------------------------------------------------------------------------- */
+
 void Actions::clearAll()
 {
 	m_actions.clear();
+	m_revision = nextRevision_();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -53,7 +77,7 @@ void Actions::clearChannel(ID channelId)
 void Actions::clearActions(ID channelId, int type)
 {
 	removeIf([=](const Action& a) {
-		return a.channelId == channelId && a.event.getStatus() == type;
+		return a.channelId == channelId && a.event.getStatus() == type && a.pluginId == -1;
 	});
 }
 
@@ -92,7 +116,8 @@ void Actions::updateKeyFrames(std::function<Frame(Frame old)> f)
 
 	updateMapPointers(temp);
 
-	m_actions = std::move(temp);
+	m_actions  = std::move(temp);
+	m_revision = nextRevision_();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -100,6 +125,7 @@ void Actions::updateKeyFrames(std::function<Frame(Frame old)> f)
 void Actions::updateEvent(ID id, MidiEvent e)
 {
 	findAction(m_actions, id)->event = e;
+	m_revision                       = nextRevision_();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -125,6 +151,8 @@ void Actions::updateSiblings(ID id, ID prevId, ID nextId)
 		pnext->prev   = pcurr;
 		pnext->prevId = pcurr->id;
 	}
+
+	m_revision = nextRevision_();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -133,15 +161,21 @@ bool Actions::hasActions(ID channelId, int type) const
 {
 	for (const auto& [frame, actions] : m_actions)
 		for (const Action& a : actions)
-			if (a.channelId == channelId && (type == 0 || type == a.event.getStatus()))
+			if (a.channelId == channelId && (type == 0 || (type == a.event.getStatus() && a.pluginId == -1)))
 				return true;
 	return false;
 }
 
 /* -------------------------------------------------------------------------- */
 
-Actions::Map&       Actions::getAll() { return m_actions; }
 const Actions::Map& Actions::getAll() const { return m_actions; }
+int                 Actions::getRevision() const { return m_revision; }
+
+Actions::Map& Actions::getAll()
+{
+	m_revision = nextRevision_(); // Assume the caller is about to write
+	return m_actions;
+}
 
 /* -------------------------------------------------------------------------- */
 
@@ -178,6 +212,7 @@ Action Actions::rec(ID channelId, Frame frame, MidiEvent event)
 
 	m_actions[frame].push_back(a);
 	updateMapPointers(m_actions);
+	m_revision = nextRevision_();
 
 	return a;
 }
@@ -193,6 +228,7 @@ void Actions::rec(std::vector<Action>& actions)
 		if (!exists(a.channelId, a.frame, a.event, m_actions))
 			m_actions[a.frame].push_back(a);
 	updateMapPointers(m_actions);
+	m_revision = nextRevision_();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -208,6 +244,7 @@ void Actions::rec(ID channelId, Frame f1, Frame f2, MidiEvent e1, MidiEvent e2)
 	a2->prevId = a1->id;
 
 	updateMapPointers(m_actions);
+	m_revision = nextRevision_();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -225,7 +262,7 @@ Action Actions::getClosestAction(ID channelId, Frame f, int type) const
 {
 	Action out = {};
 	forEachAction([&](const Action& a) {
-		if (a.event.getStatus() != type || a.channelId != channelId)
+		if (a.event.getStatus() != type || a.channelId != channelId || a.pluginId != -1)
 			return;
 		if (!out.isValid() || (a.frame <= f && a.frame > out.frame))
 			out = a;
@@ -298,6 +335,7 @@ void Actions::removeIf(std::function<bool(const Action&)> f)
 		actions.erase(std::remove_if(actions.begin(), actions.end(), f), actions.end());
 	optimize(m_actions);
 	updateMapPointers(m_actions);
+	m_revision = nextRevision_();
 }
 
 /* -------------------------------------------------------------------------- */
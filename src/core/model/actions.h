@@ -42,6 +42,8 @@ class Actions
 public:
 	using Map = std::map<Frame, std::vector<Action>>;
 
+	Actions();
+
 	/* forEachAction
     Applies a read-only callback on each action recorded. NEVER do anything
     inside the callback that might alter the ActionMap. */
@@ -54,7 +56,8 @@ public:
 	std::vector<Action> getActionsOnChannel(ID channelId) const;
 
 	/* getClosestAction
-    Given a frame 'f' returns the closest action. */
+    Given a frame 'f' returns the closest action. Plug-in automation actions 
+    never match a 'type' filter. */
 
 	Action getClosestAction(ID channelId, Frame f, int type) const;
 
@@ -65,7 +68,8 @@ public:
 	const std::vector<Action>* getActionsOnFrame(Frame f) const;
 
 	/* hasActions
-    Checks if the channel has at least one action recorded. */
+    Checks if the channel has at least one action recorded. Plug-in automation
+    actions never match a 'type' filter. */
 
 	bool hasActions(ID channelId, int type = 0) const;
 
@@ -75,6 +79,12 @@ public:
 	Map&       getAll();
 	const Map& getAll() const;
 
+	/* getRevision
+    Returns a number that changes each time actions are modified, unique across
+    all Actions objects. */
+
+	int getRevision() const;
+
 #ifdef G_DEBUG_MODE
 	void debug() const;
 #endif
@@ -90,7 +100,8 @@ public:
 	void clearChannel(ID channelId);
 
 	/* clearActions
-    Clears the actions by type from a channel. */
+    Clears the actions by type from a channel. Plug-in automation actions never
+    match a 'type' filter. */
 
 	void clearActions(ID channelId, int type);
 
@@ -159,6 +170,7 @@ private:
 	void removeIf(std::function<bool(const Action&)> f);
 
 	Actions::Map m_actions;
+	int          m_revision;
 };
 } // namespace giada::m::model
 
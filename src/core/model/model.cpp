@@ -30,10 +30,15 @@
 #include "core/plugins/pluginFactory.h"
 #include "core/plugins/pluginManager.h"
 #include "core/waveFactory.h"
+#include "utils/fs.h"
 #include "utils/log.h"
 #include "utils/string.h"
+#include <algorithm>
 #include <cassert>
 #include <memory>
+#include <thread>
+#include <unordered_set>
+#include <utility>
 #ifdef G_DEBUG_MODE
 #include <fmt/core.h>
 #endif
@@ -62,6 +67,21 @@ auto* get_(S& source, ID id)
 
 /* -------------------------------------------------------------------------- */
 
+template <typename T>
+std::vector<T*> getAll_(const std::vector<std::unique_ptr<T>>& source, const std::vector<ID>& ids)
+{
+	std::vector<T*> out;
+	for (ID id : ids)
+	{
+		T* item = get_(source, id);
+		if (item != nullptr)
+			out.push_back(item);
+	}
+	return out;
+}
+
+/* -------------------------------------------------------------------------- */
+
 template <typename T>
 typename T::element_type& add_(std::vector<T>& dest, T obj, Model& model)
 {
@@ -108,18 +128,60 @@ void Layout::debug() const
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
-DataLock::DataLock(Model& m, SwapType t)
+Change::Change(Scope s, ID channelId)
+: scope(s)
+, channelId(channelId)
+{
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+DataLock::DataLock(Model& m, SwapType t, Change c)
 : m_model(m)
 , m_swapType(t)
+, m_change(c)
 {
+	std::unique_lock lock(m_model.m_transactionMutex);
 	m_model.get().locked = true;
-	m_model.swap(SwapType::NONE);
+	m_model.publish(SwapType::NONE, {}, lock);
 }
 
 DataLock::~DataLock()
 {
+	std::unique_lock lock(m_model.m_transactionMutex);
 	m_model.get().locked = false;
-	m_model.swap(m_swapType);
+	m_model.publish(m_swapType, m_change, lock);
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+Transaction::Transaction(Model& m)
+: m_model(m)
+{
+	assert(m_model.isMainThread());
+
+	std::scoped_lock lock(m_model.m_transactionMutex);
+	m_model.m_transactionDepth++;
+}
+
+Transaction::~Transaction()
+{
+	assert(m_model.isMainThread());
+
+	std::unique_lock lock(m_model.m_transactionMutex);
+	if (--m_model.m_transactionDepth > 0 || !m_model.m_pending)
+		return;
+
+	const SwapType t = m_model.m_pendingSwapType;
+	const Change   c = m_model.m_pendingChange;
+
+	m_model.m_pending       = false;
+	m_model.m_pendingChange = {};
+	m_model.publish(t, c, lock);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -135,8 +197,32 @@ bool LoadState::isGood() const
 /* -------------------------------------------------------------------------- */
 /* -------------------------------------------------------------------------- */
 
+std::size_t StagedProject::getAudioMemory() const
+{
+	/* Sliced Waves share their audio data: count each buffer once. Read-only
+	access, so that no shared buffer gets detached (copied) while counting. */
+
+	std::vector<const mcl::AudioBuffer*> buffers;
+	std::size_t                          bytes = 0;
+
+	for (const std::unique_ptr<Wave>& w : waves)
+	{
+		const mcl::AudioBuffer& buffer = std::as_const(*w).getBuffer();
+		if (std::find(buffers.begin(), buffers.end(), &buffer) != buffers.end())
+			continue;
+		buffers.push_back(&buffer);
+		bytes += static_cast<std::size_t>(buffer.countSamples()) * sizeof(float);
+	}
+	return bytes;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
 Model::Model()
 : onSwap(nullptr)
+, m_mainThreadId(std::this_thread::get_id())
 {
 }
 
@@ -166,6 +252,7 @@ void Model::reset()
 	layout.mixer            = {};
 	layout.mixer.shared     = &m_shared.mixerShared;
 	layout.channels         = {};
+	layout.scenes           = {};
 
 	swap(SwapType::NONE);
 }
@@ -222,64 +309,194 @@ void Model::load(const Conf& conf)
 
 LoadState Model::load(const Patch& patch, PluginManager& pluginManager, int sampleRate, int bufferSize, Resampler::Quality rsmpQuality)
 {
-	const float sampleRateRatio = sampleRate / static_cast<float>(patch.samplerate);
+	std::unique_ptr<StagedProject> project = stage(patch, sampleRate, rsmpQuality, /*memoryBudget=*/0);
+	finishStage(*project, pluginManager, sampleRate, bufferSize, rsmpQuality);
 
-	/* Lock the shared data. Real-time thread can't read from it until this method
-	goes out of scope. */
+	/* Lock the shared data. Real-time thread can't read from it until 'lock'
+	goes out of scope, where the swap is performed. */
 
-	DataLock  lock   = lockData(SwapType::NONE);
-	Layout&   layout = get();
-	LoadState state{patch};
+	{
+		DataLock lock = lockData(SwapType::NONE);
+		exchange(*project);
+	}
 
-	/* Clear and re-initialize stuff first. */
+	return project->state;
+}
 
-	layout.channels = {};
-	getAllChannelsShared().clear();
-	getAllPlugins().clear();
-	getAllWaves().clear();
+/* -------------------------------------------------------------------------- */
 
-	/* Load external data first: plug-ins and waves. */
+std::unique_ptr<StagedProject> Model::stage(const Patch& patch, int sampleRate,
+    Resampler::Quality rsmpQuality, std::size_t memoryBudget)
+{
+	std::unique_ptr<StagedProject> project = std::make_unique<StagedProject>();
+	project->state                         = {patch};
 
-	for (const Patch::Plugin& pplugin : patch.plugins)
-	{
-		std::unique_ptr<juce::AudioPluginInstance> pi = pluginManager.makeJucePlugin(pplugin.path, sampleRate, bufferSize);
-		std::unique_ptr<Plugin>                    p  = pluginFactory::deserializePlugin(pplugin, std::move(pi), layout.sequencer, sampleRate, bufferSize);
-		if (!p->valid)
-			state.missingPlugins.push_back(pplugin.path);
-		getAllPlugins().push_back(std::move(p));
-	}
+	/* Load external data first. The memory budget is checked as soon as each 
+	Wave is in, to give up early. */
 
 	for (const Patch::Wave& pwave : patch.waves)
 	{
 		std::unique_ptr<Wave> w = waveFactory::deserializeWave(pwave, sampleRate, rsmpQuality);
-		if (w != nullptr)
-			getAllWaves().push_back(std::move(w));
-		else
-			state.missingWaves.push_back(pwave.path);
+		if (w == nullptr)
+		{
+			project->state.missingWaves.push_back(pwave.path);
+			continue;
+		}
+		project->waves.push_back(std::move(w));
+
+		if (memoryBudget > 0 && project->getAudioMemory() > memoryBudget)
+		{
+			u::log::print("[Model::stage] project exceeds memory budget ({} bytes)\n", memoryBudget);
+			return nullptr;
+		}
+	}
+
+	/* Then load up actions and global properties. */
+
+	project->actions.getAll() = actionFactory::deserializeActions(patch.actions);
+
+	for (const Patch::Scene& pscene : patch.scenes)
+	{
+		Scene scene{pscene.id, pscene.name, {}};
+		for (const Patch::Scene::Channel& c : pscene.channels)
+			scene.channels.push_back({c.channelId, c.playing, c.mute, c.volume});
+		project->scenes.getAll().push_back(scene);
 	}
 
-	/* Then load up channels, actions and global properties. */
+	project->sequencer.status   = SeqStatus::STOPPED;
+	project->sequencer.bars     = patch.bars;
+	project->sequencer.beats    = patch.beats;
+	project->sequencer.bpm      = patch.bpm;
+	project->sequencer.quantize = patch.quantize;
+
+	return project;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Model::finishStage(StagedProject& project, PluginManager& pluginManager, int sampleRate,
+    int bufferSize, Resampler::Quality rsmpQuality)
+{
+	assert(!project.finished);
+
+	const Patch& patch           = project.state.patch;
+	const float  sampleRateRatio = sampleRate / static_cast<float>(patch.samplerate);
+
+	for (const Patch::Plugin& pplugin : patch.plugins)
+	{
+		std::unique_ptr<juce::AudioPluginInstance> pi = pluginManager.makeJucePlugin(pplugin.path, sampleRate, bufferSize);
+		std::unique_ptr<Plugin>                    p  = pluginFactory::deserializePlugin(pplugin, std::move(pi), get().sequencer, sampleRate, bufferSize);
+		if (!p->valid)
+			project.state.missingPlugins.push_back(pplugin.path);
+		project.plugins.push_back(std::move(p));
+	}
+
+	/* Channels come last, as they refer to both Waves and plug-ins. */
 
 	for (const Patch::Channel& pchannel : patch.channels)
 	{
-		Wave*                wave    = findWave(pchannel.waveId);
-		std::vector<Plugin*> plugins = findPlugins(pchannel.pluginIds);
+		Wave*                wave    = get_(project.waves, pchannel.waveId);
+		std::vector<Plugin*> plugins = getAll_(project.plugins, pchannel.pluginIds);
 		channelFactory::Data data    = channelFactory::deserializeChannel(pchannel, sampleRateRatio, bufferSize, rsmpQuality, wave, plugins);
-		layout.channels.add(data.channel);
-		getAllChannelsShared().push_back(std::move(data.shared));
+		project.hasSolos             = project.hasSolos || (!data.channel.isInternal() && data.channel.isSoloed());
+		project.channels.add(data.channel);
+		project.channelsShared.push_back(std::move(data.shared));
 	}
 
-	layout.actions.getAll() = actionFactory::deserializeActions(patch.actions);
+	project.finished = true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::unique_ptr<StagedProject> Model::switchTo(std::unique_ptr<StagedProject> project)
+{
+	assert(project != nullptr);
+	assert(project->finished);
+
+	project->sequencer.status = get().sequencer.status;
+
+	exchange(*project);
+	swap(SwapType::HARD);
+
+	return project;
+}
+
+/* -------------------------------------------------------------------------- */
 
-	layout.sequencer.status   = SeqStatus::STOPPED;
-	layout.sequencer.bars     = patch.bars;
-	layout.sequencer.beats    = patch.beats;
-	layout.sequencer.bpm      = patch.bpm;
-	layout.sequencer.quantize = patch.quantize;
+void Model::armSwitch(const StagedProject& project)
+{
+	assert(m_switchState.load() == SwitchState::IDLE);
+	assert(project.finished);
+
+	/* The realtime thread might be still rendering the layout of the previous
+	switch: wait for the current block to be over, as it won't look at it 
+	anymore from the next one. */
+
+	while (isLocked())
+		;
+
+	/* Everything not belonging to the project (e.g. KernelAudio, MIDI, mixer
+	settings) is taken from the current layout. The sequencer position lives in
+	the shared data and must keep running. */
+
+	m_switchLayout                  = get();
+	m_switchLayout.channels         = project.channels;
+	m_switchLayout.actions          = project.actions;
+	m_switchLayout.scenes           = project.scenes;
+	m_switchLayout.mixer.hasSolos   = project.hasSolos;
+	m_switchLayout.sequencer        = project.sequencer;
+	m_switchLayout.sequencer.shared = get().sequencer.shared;
+	m_switchLayout.sequencer.status = get().sequencer.status;
+
+	m_switchState.store(SwitchState::ARMED);
+}
 
-	return state;
+/* -------------------------------------------------------------------------- */
 
-	// Swap is performed when 'lock' goes out of scope
+bool Model::disarmSwitch()
+{
+	SwitchState expected = SwitchState::ARMED;
+	return m_switchState.compare_exchange_strong(expected, SwitchState::IDLE) ||
+	       expected == SwitchState::IDLE;
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::unique_ptr<StagedProject> Model::completeSwitch(std::unique_ptr<StagedProject> project)
+{
+	assert(project != nullptr);
+	assert(m_switchState.load() == SwitchState::FLIPPED);
+
+	/* Same content of the layout in use by the realtime thread, except for the
+	sequencer status that might have been changed in the meantime. Swap it in,
+	then let the realtime thread go back to the regular layout. */
+
+	project->sequencer.status = get().sequencer.status;
+
+	exchange(*project);
+	swap(SwapType::HARD);
+
+	m_switchState.store(SwitchState::IDLE);
+
+	return project;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool Model::flip_RT() const
+{
+	SwitchState expected = SwitchState::ARMED;
+	return m_switchState.compare_exchange_strong(expected, SwitchState::FLIPPED);
+}
+
+bool Model::isFlipped_RT() const
+{
+	return m_switchState.load() == SwitchState::FLIPPED;
+}
+
+const Layout& Model::getFlipped_RT() const
+{
+	return m_switchLayout;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -330,11 +547,23 @@ void Model::store(Conf& conf) const
 
 /* -------------------------------------------------------------------------- */
 
-void Model::store(Patch& patch, const std::string& projectPath)
+SaveRequests Model::store(Patch& patch, const std::string& projectPath, bool compressWaves)
 {
+	/* Find out which Waves can be compressed before locking anything, as it 
+	takes opening their source files. Waves are changed by the main thread 
+	only, so the result holds until the lock below. Waves coming from outside 
+	the project are the only candidates for compression. */
+
+	std::unordered_set<ID> compressible;
+	if (compressWaves)
+		for (const auto& w : getAllWaves())
+			if (u::fs::dirname(w->getPath()) != projectPath && waveFactory::canCompress(*w))
+				compressible.insert(w->id);
+
 	/* Lock the shared data. Real-time thread can't read from it until this method
-	goes out of scope. Even if it's mostly a read-only operation, some Wave
-	objects need to be updated at some point. */
+	goes out of scope. Even if it's mostly a read-only operation, Wave paths need
+	to be updated at some point. Wave flags are left alone: they are cleared by
+	the caller once the Waves have actually been written. */
 
 	DataLock lock = lockData(SwapType::NONE);
 
@@ -345,8 +574,10 @@ void Model::store(Patch& patch, const std::string& projectPath)
 	patch.bpm      = layout.sequencer.bpm;
 	patch.quantize = layout.sequencer.quantize;
 
+	SaveRequests requests;
+
 	for (const auto& p : getAllPlugins())
-		patch.plugins.push_back(pluginFactory::serializePlugin(*p));
+		patch.plugins.push_back(pluginFactory::serializePlugin(*p, requests.states));
 
 	patch.actions = actionFactory::serializeActions(layout.actions.getAll());
 
@@ -355,14 +586,37 @@ void Model::store(Patch& patch, const std::string& projectPath)
 		/* Update all existing file paths in Waves, so that they point to the 
 		project folder they belong to. */
 
-		w->setPath(waveFactory::makeUniqueWavePath(projectPath, *w, getAllWaves()));
-		waveFactory::save(*w, w->getPath()); // TODO - error checking
+		const std::string source   = w->getPath();
+		const bool        compress = compressible.count(w->id) > 0;
+		const std::string path     = waveFactory::makeUniqueWavePath(projectPath, *w, getAllWaves(), compress ? ".flac" : "");
+
+		const bool isDirty = w->isLogical() || w->isEdited() || path != source || !u::fs::fileExists(path);
+
+		w->setPath(path);
+
+		if (isDirty)
+		{
+			/* Copying a Wave is cheap: audio data is shared, and never modified 
+			in place while shared (copy-on-write). */
+
+			requests.waves.push_back({*w, compress ? source : ""});
+		}
 
 		patch.waves.push_back(waveFactory::serializeWave(*w));
 	}
 
 	for (const Channel& c : layout.channels.getAll())
 		patch.channels.push_back(channelFactory::serializeChannel(c));
+
+	for (const Scene& scene : layout.scenes.getAll())
+	{
+		Patch::Scene pscene{scene.id, scene.name, {}};
+		for (const Scene::Channel& c : scene.channels)
+			pscene.channels.push_back({c.channelId, c.playing, c.mute, c.volume});
+		patch.scenes.push_back(pscene);
+	}
+
+	return requests;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -380,18 +634,80 @@ LayoutLock    Model::get_RT() const { return LayoutLock(m_swapper); }
 
 /* -------------------------------------------------------------------------- */
 
-void Model::swap(SwapType t)
+void Model::swap(SwapType t, Change c)
+{
+	/* Other threads (e.g. MIDI input) must wait for the transaction too: the
+	layout being edited is the same for everybody. The lock is held until the
+	swap is done, so that no transaction can start in the meantime. */
+
+	std::unique_lock lock(m_transactionMutex);
+
+	if (m_transactionDepth > 0)
+		defer(t, c);
+	else
+		publish(t, c, lock);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Model::publish(SwapType t, Change c, std::unique_lock<std::mutex>& lock)
 {
+	assert(lock.owns_lock());
+
 	m_swapper.swap();
+
+	if (m_transactionDepth > 0)
+	{
+		defer(t, c);
+		return;
+	}
+
+	lock.unlock();
+
 	if (onSwap != nullptr)
-		onSwap(t);
+		onSwap(t, c);
 }
 
 /* -------------------------------------------------------------------------- */
 
-DataLock Model::lockData(SwapType t)
+void Model::defer(SwapType t, Change c)
 {
-	return DataLock(*this, t);
+	/* SwapType values are sorted by weight: HARD wins over SOFT, SOFT over NONE.
+	Changes are relevant to HARD swaps only. Different ones widen the scope. */
+
+	if (t == SwapType::HARD)
+	{
+		if (!m_pending || m_pendingSwapType != SwapType::HARD)
+			m_pendingChange = c;
+		else if (m_pendingChange.scope != c.scope)
+			m_pendingChange = {};
+		else if (m_pendingChange.channelId != c.channelId)
+			m_pendingChange.channelId = 0;
+	}
+
+	m_pendingSwapType = m_pending ? std::min(m_pendingSwapType, t) : t;
+	m_pending         = true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool Model::isMainThread() const
+{
+	return std::this_thread::get_id() == m_mainThreadId;
+}
+
+/* -------------------------------------------------------------------------- */
+
+DataLock Model::lockData(SwapType t, Change c)
+{
+	return DataLock(*this, t, c);
+}
+
+/* -------------------------------------------------------------------------- */
+
+Transaction Model::beginTransaction()
+{
+	return Transaction(*this);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -432,14 +748,28 @@ void Model::clearWaves() { clear_(m_shared.waves, *this); }
 
 std::vector<Plugin*> Model::findPlugins(std::vector<ID> pluginIds)
 {
-	std::vector<Plugin*> out;
-	for (ID id : pluginIds)
-	{
-		Plugin* plugin = findPlugin(id);
-		if (plugin != nullptr)
-			out.push_back(plugin);
-	}
-	return out;
+	return getAll_(m_shared.plugins, pluginIds);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Model::exchange(StagedProject& project)
+{
+	Layout& layout = get();
+
+	std::swap(layout.channels, project.channels);
+	std::swap(layout.actions, project.actions);
+	std::swap(layout.scenes, project.scenes);
+	std::swap(layout.mixer.hasSolos, project.hasSolos);
+
+	/* The sequencer position lives in the shared data and must keep running. */
+
+	std::swap(layout.sequencer, project.sequencer);
+	std::swap(layout.sequencer.shared, project.sequencer.shared);
+
+	std::swap(m_shared.channelsShared, project.channelsShared);
+	std::swap(m_shared.waves, project.waves);
+	std::swap(m_shared.plugins, project.plugins);
 }
 
 /* -------------------------------------------------------------------------- */
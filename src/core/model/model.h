@@ -36,13 +36,19 @@
 #include "core/model/kernelMidi.h"
 #include "core/model/midiIn.h"
 #include "core/model/mixer.h"
+#include "core/model/scenes.h"
 #include "core/model/sequencer.h"
 #include "core/plugins/plugin.h"
+#include "core/plugins/pluginFactory.h"
 #include "core/wave.h"
+#include "core/waveFactory.h"
 #include "deps/mcl-atomic-swapper/src/atomic-swapper.hpp"
 #include "deps/mcl-audio-buffer/src/audioBuffer.hpp"
 #include "utils/vector.h"
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <thread>
 
 namespace giada::m::model
 {
@@ -65,6 +71,7 @@ struct Layout
 	MidiIn      midiIn;
 	Channels    channels;
 	Actions     actions;
+	Scenes      scenes;
 	Behaviors   behaviors;
 };
 
@@ -72,7 +79,7 @@ struct Layout
 Alias for a REALTIME scoped lock provided by the Swapper class. Use this in the
 real-time thread to lock the Layout. */
 
-using AtomicSwapper = mcl::AtomicSwapper<Layout, /*size=*/6>;
+using AtomicSwapper = mcl::AtomicSwapper<Layout, /*size=*/6 + G_MAX_RENDER_THREADS>;
 using LayoutLock    = AtomicSwapper::RtLock;
 
 /* SwapType
@@ -90,6 +97,29 @@ enum class SwapType
 	NONE
 };
 
+/* Change
+Describes which part of the Layout a HARD swap has changed, so that listeners
+can update only what is affected instead of everything. 'channelId' is the
+channel involved, or 0 if unknown or more than one. The default value means
+that anything might have changed. */
+
+struct Change
+{
+	enum Scope
+	{
+		ALL,
+		CHANNELS,
+		ACTIONS,
+		PLUGINS,
+		SEQUENCER
+	};
+
+	Change(Scope s = ALL, ID channelId = 0);
+
+	Scope scope;
+	ID    channelId;
+};
+
 /* -------------------------------------------------------------------------- */
 
 /* LoadState
@@ -106,7 +136,46 @@ struct LoadState
 
 /* -------------------------------------------------------------------------- */
 
+/* SaveRequests
+Files to be written to disk once a project has been stored into a Patch. */
+
+struct SaveRequests
+{
+	std::vector<waveFactory::SaveRequest>   waves;
+	std::vector<pluginFactory::SaveRequest> states;
+};
+
+/* -------------------------------------------------------------------------- */
+
+/* StagedProject
+A project loaded next to the current one without touching it, ready to replace
+it with Model::switchTo(). It owns its shared data (waves, plug-ins, channel
+buffers) until then. */
+
+struct StagedProject
+{
+	/* getAudioMemory
+	Returns how many bytes of audio data the staged Waves take. */
+
+	std::size_t getAudioMemory() const;
+
+	LoadState state;
+	Channels  channels;
+	Actions   actions;
+	Scenes    scenes;
+	Sequencer sequencer;
+	bool      hasSolos = false;
+	bool      finished = false; // Plug-ins and channels loaded, see Model::finishStage()
+
+	std::vector<std::unique_ptr<ChannelShared>> channelsShared;
+	std::vector<std::unique_ptr<Wave>>          waves;
+	std::vector<std::unique_ptr<Plugin>>        plugins;
+};
+
+/* -------------------------------------------------------------------------- */
+
 class DataLock;
+class Transaction;
 class Model
 {
 public:
@@ -118,7 +187,18 @@ public:
 	Returns a scoped locker DataLock object. Use this when you want to lock
 	the model: a locked model won't be processed by Mixer. */
 
-	[[nodiscard]] DataLock lockData(SwapType t = SwapType::HARD);
+	[[nodiscard]] DataLock lockData(SwapType t = SwapType::HARD, Change c = {});
+
+	/* beginTransaction
+	Returns a scoped Transaction object. Swaps requested while a transaction is
+	open are merged into a single one, performed when the outermost transaction
+	goes out of scope. This holds for swaps requested by other threads (e.g. 
+	MIDI input) too, which would publish the transaction's edits half-applied
+	otherwise. Exception: a DataLock taken inside a transaction publishes the 
+	layout as it is, edits made so far included, as the realtime thread must 
+	see the lock right away. Main thread only. */
+
+	[[nodiscard]] Transaction beginTransaction();
 
 	/* init
 	Initializes the internal layout. All values go back to default. */
@@ -141,15 +221,77 @@ public:
 
 	LoadState load(const Patch&, PluginManager&, int sampleRate, int bufferSize, Resampler::Quality);
 
+	/* stage
+	Loads data from a Patch object into a new StagedProject, leaving the current
+	layout untouched. Plug-ins and channels are left out: call finishStage() 
+	for them. Can be called from any non-realtime thread. Returns nullptr if 
+	Waves take more than 'memoryBudget' bytes (0 = no limit). */
+
+	std::unique_ptr<StagedProject> stage(const Patch&, int sampleRate, Resampler::Quality,
+	    std::size_t memoryBudget);
+
+	/* finishStage
+	Loads plug-ins and channels into a StagedProject coming from stage(). Main
+	thread only: some plug-ins can't be created anywhere else. */
+
+	void finishStage(StagedProject&, PluginManager&, int sampleRate, int bufferSize, Resampler::Quality);
+
+	/* switchTo
+	Replaces the current project with a staged one in a single swap, keeping the
+	sequencer status. Returns the old project, no longer in use by the realtime 
+	thread: the caller is in charge of freeing it. */
+
+	std::unique_ptr<StagedProject> switchTo(std::unique_ptr<StagedProject>);
+
+	/* armSwitch
+	Prepares a layout for the staged project, for the realtime thread to flip
+	to with flip_RT() while playing. Nothing changes until then.
+	'project' must stay alive until completeSwitch() or disarmSwitch(). Main 
+	thread only. */
+
+	void armSwitch(const StagedProject&);
+
+	/* disarmSwitch
+	Cancels an armed switch. Returns false if it's too late: the realtime thread
+	has flipped already and completeSwitch() must be called instead. Main thread
+	only. */
+
+	bool disarmSwitch();
+
+	/* completeSwitch
+	Makes the project the realtime thread has flipped to the current one, by
+	swapping it in for good. Returns the old project, no longer in use by the 
+	realtime thread: the caller is in charge of freeing it. Main thread only. */
+
+	std::unique_ptr<StagedProject> completeSwitch(std::unique_ptr<StagedProject>);
+
+	/* flip_RT
+	Makes the realtime thread render the layout prepared by armSwitch(), from 
+	the next block on. Returns false if no switch is armed. */
+
+	bool flip_RT() const;
+
+	/* isFlipped_RT, getFlipped_RT
+	Tell whether the realtime thread has flipped to a new project which is not
+	current yet and return its layout. Check isFlipped_RT() before calling 
+	get_RT(): the layout returned by the LayoutLock might be still the old 
+	one. */
+
+	bool          isFlipped_RT() const;
+	const Layout& getFlipped_RT() const;
+
 	/* store
 	Stores data into a Conf object. */
 
 	void store(Conf&) const;
 
 	/* store
-	Stores data into a Patch object. */
+	Stores data into a Patch object. Nothing is written to disk here: returns
+	snapshots of the new or modified Waves and the plug-in states, to be saved by
+	the caller. Unmodified Waves already in 'projectPath' are left untouched. If
+	'compressWaves' is true, new Waves are stored as FLAC where lossless. */
 
-	void store(Patch&, const std::string& projectPath);
+	SaveRequests store(Patch&, const std::string& projectPath, bool compressWaves);
 
 	bool registerThread(Thread, bool realtime) const;
 
@@ -166,9 +308,11 @@ public:
 	const Layout& get() const;
 
 	/* swap
-	Swap non-rt layout with the rt one. See 'SwapType' notes above. */
+	Swap non-rt layout with the rt one. See 'SwapType' and 'Change' notes 
+	above. Deferred if called from the main thread while a Transaction is open.
+	Swaps from other threads never join a Transaction. */
 
-	void swap(SwapType t);
+	void swap(SwapType t, Change c = {});
 
 	/* getAll[*] */
 
@@ -205,9 +349,12 @@ public:
 	Callbacks fired when the layout has been swapped. Useful for listening to 
 	model changes. */
 
-	std::function<void(SwapType)> onSwap;
+	std::function<void(SwapType, Change)> onSwap;
 
 private:
+	friend class DataLock;
+	friend class Transaction;
+
 	struct Shared
 	{
 		Sequencer::Shared                           sequencerShared;
@@ -220,8 +367,59 @@ private:
 
 	std::vector<Plugin*> findPlugins(std::vector<ID> pluginIds);
 
-	AtomicSwapper m_swapper;
-	Shared        m_shared;
+	/* exchange
+	Swaps the content of a StagedProject with the current layout and shared 
+	data. Doesn't swap the layout. */
+
+	void exchange(StagedProject&);
+
+	/* publish
+	Swaps right away, even if a Transaction is open: used by DataLock, which
+	can't wait. Listeners are notified when the Transaction ends, though. 
+	'lock' must hold 'm_transactionMutex': it is released before notifying. */
+
+	void publish(SwapType, Change, std::unique_lock<std::mutex>& lock);
+
+	/* defer
+	Merges a swap request into the pending one of the open Transaction. Call it
+	with 'm_transactionMutex' held. */
+
+	void defer(SwapType, Change);
+
+	/* isMainThread
+	True if called from the thread that created this Model. */
+
+	bool isMainThread() const;
+
+	AtomicSwapper   m_swapper;
+	Shared          m_shared;
+	std::thread::id m_mainThreadId;
+
+	/* m_transactionDepth, m_pending[*], m_transactionMutex
+	Number of open Transactions and the swap they have merged so far, if any.
+	Transactions are opened by the main thread only, but any thread can swap:
+	guarded by 'm_transactionMutex', held by swaps too. */
+
+	int        m_transactionDepth = 0;
+	bool       m_pending          = false;
+	SwapType   m_pendingSwapType  = SwapType::NONE;
+	Change     m_pendingChange    = {};
+	std::mutex m_transactionMutex;
+
+	/* m_switchLayout, m_switchState
+	Layout of the project to switch to, prepared by the main thread and read
+	by the realtime thread once flipped. Left untouched until the next switch
+	is armed. */
+
+	enum class SwitchState
+	{
+		IDLE,
+		ARMED,
+		FLIPPED
+	};
+
+	Layout                           m_switchLayout;
+	mutable std::atomic<SwitchState> m_switchState = SwitchState::IDLE;
 };
 
 /* -------------------------------------------------------------------------- */
@@ -229,12 +427,29 @@ private:
 class DataLock
 {
 public:
-	DataLock(Model&, SwapType t);
+	DataLock(Model&, SwapType t, Change c);
 	~DataLock();
 
 private:
 	Model&   m_model;
 	SwapType m_swapType;
+	Change   m_change;
+};
+
+/* -------------------------------------------------------------------------- */
+
+class Transaction
+{
+public:
+	Transaction(Model&);
+	Transaction(const Transaction&)            = delete;
+	Transaction(Transaction&&)                 = delete;
+	Transaction& operator=(const Transaction&) = delete;
+	Transaction& operator=(Transaction&&)      = delete;
+	~Transaction();
+
+private:
+	Model& m_model;
 };
 } // namespace giada::m::model
 
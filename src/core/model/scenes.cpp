@@ -0,0 +1,118 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#include "core/model/scenes.h"
+#include "utils/vector.h"
+#include <algorithm>
+
+namespace giada::m::model
+{
+namespace
+{
+/* nextRecallSerial_
+Serial number of the next recall, unique across all Scenes objects. Main thread
+only. */
+
+int nextRecallSerial_ = 1;
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+const Scene* Scenes::find(ID id) const
+{
+	auto it = u::vector::findIf(m_scenes, [id](const Scene& s) { return s.id == id; });
+	return it == m_scenes.end() ? nullptr : &*it;
+}
+
+/* -------------------------------------------------------------------------- */
+
+const std::vector<Scene>& Scenes::getAll() const
+{
+	return m_scenes;
+}
+
+std::vector<Scene>& Scenes::getAll()
+{
+	return m_scenes;
+}
+
+/* -------------------------------------------------------------------------- */
+
+const Scene& Scenes::add(const std::string& name, std::vector<Scene::Channel> channels)
+{
+	ID id = 0;
+	for (const Scene& s : m_scenes)
+		id = std::max(id, s.id);
+
+	m_scenes.push_back({id + 1, name, std::move(channels)});
+	return m_scenes.back();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Scenes::rename(ID id, const std::string& name)
+{
+	for (Scene& s : m_scenes)
+		if (s.id == id)
+			s.name = name;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Scenes::remove(ID id)
+{
+	u::vector::removeIf(m_scenes, [id](const Scene& s) { return s.id == id; });
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Scenes::removeChannel(ID channelId)
+{
+	for (Scene& s : m_scenes)
+		u::vector::removeIf(s.channels, [channelId](const Scene::Channel& c) { return c.channelId == channelId; });
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Scenes::clear()
+{
+	m_scenes.clear();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Scenes::stageRecall(std::vector<Scene::Channel> channels)
+{
+	m_recall = {nextRecallSerial_++, std::move(channels)};
+}
+
+const Scenes::Recall& Scenes::getRecall() const
+{
+	return m_recall;
+}
+} // namespace giada::m::model
@@ -0,0 +1,109 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef G_MODEL_SCENES_H
+#define G_MODEL_SCENES_H
+
+#include "core/types.h"
+#include <string>
+#include <vector>
+
+namespace giada::m::model
+{
+/* Scene
+A named snapshot of the state of a set of channels, to be recalled all at once. */
+
+struct Scene
+{
+	struct Channel
+	{
+		ID    channelId;
+		bool  playing;
+		bool  mute;
+		float volume;
+	};
+
+	ID                   id;
+	std::string          name;
+	std::vector<Channel> channels;
+};
+
+/* -------------------------------------------------------------------------- */
+
+class Scenes
+{
+public:
+	/* find
+	Returns the scene with the given ID, or nullptr if not found. */
+
+	const Scene* find(ID) const;
+
+	const std::vector<Scene>& getAll() const;
+	std::vector<Scene>&       getAll();
+
+	/* add
+	Adds a new scene, giving it a unique ID. Returns a reference to it. */
+
+	const Scene& add(const std::string& name, std::vector<Scene::Channel>);
+
+	void rename(ID, const std::string& name);
+	void remove(ID);
+
+	/* removeChannel
+	Removes a channel from all the scenes it belongs to. */
+
+	void removeChannel(ID channelId);
+
+	/* clear
+	Removes all the scenes. */
+
+	void clear();
+
+	/* Recall
+	Play state the loop and MIDI channels of a launched scene must reach. 
+	'serial' tells recalls apart, so that each one is applied only once. */
+
+	struct Recall
+	{
+		int                         serial = 0;
+		std::vector<Scene::Channel> channels;
+	};
+
+	/* stageRecall
+	Replaces the pending recall, if any. The audio thread applies it to all 
+	channels at once on the next bar, see Mixer::advanceChannels(). */
+
+	void stageRecall(std::vector<Scene::Channel>);
+
+	const Recall& getRecall() const;
+
+private:
+	std::vector<Scene> m_scenes;
+	Recall             m_recall;
+};
+} // namespace giada::m::model
+
+#endif
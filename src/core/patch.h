@@ -108,6 +108,9 @@ struct Patch
 		uint32_t event;
 		ID       prevId;
 		ID       nextId;
+		ID       pluginId    = -1;
+		int      pluginParam = -1;
+		float    value       = 0.0f; // Plug-in parameter value
 	};
 
 	struct Wave
@@ -122,10 +125,26 @@ struct Patch
 		std::string           path;
 		bool                  bypass;
 		std::vector<float>    params; // TODO - to be removed in 0.18.0
-		std::string           state;
+		std::string           state;     // Base64, legacy or fallback
+		std::string           statePath; // Binary sidecar file in the project folder
 		std::vector<uint32_t> midiInParams;
 	};
 
+	struct Scene
+	{
+		struct Channel
+		{
+			ID    channelId;
+			bool  playing;
+			bool  mute;
+			float volume;
+		};
+
+		ID                   id;
+		std::string          name;
+		std::vector<Channel> channels;
+	};
+
 	Version     version;
 	int         status     = G_FILE_INVALID;
 	std::string name       = G_DEFAULT_PATCH_NAME;
@@ -141,6 +160,7 @@ struct Patch
 	std::vector<Action>  actions;
 	std::vector<Wave>    waves;
 	std::vector<Plugin>  plugins;
+	std::vector<Scene>   scenes;
 };
 } // namespace giada::m
 
@@ -29,8 +29,11 @@
 #include "core/mixer.h"
 #include "utils/fs.h"
 #include "utils/log.h"
+#include <cstring>
 #include <fstream>
+#include <juce_core/juce_core.h>
 #include <nlohmann/json.hpp>
+#include <type_traits>
 
 namespace giada::m::patchFactory
 {
@@ -63,7 +66,7 @@ void readColumns_(Patch& patch, const nlohmann::json& j)
 
 /* -------------------------------------------------------------------------- */
 
-void readPlugins_(Patch& patch, const nlohmann::json& j)
+void readPlugins_(Patch& patch, const nlohmann::json& j, const std::string& basePath)
 {
 	if (!j.contains(PATCH_KEY_PLUGINS))
 		return;
@@ -82,6 +85,9 @@ void readPlugins_(Patch& patch, const nlohmann::json& j)
 		else
 			p.state = jplugin.value(PATCH_KEY_PLUGIN_STATE, "");
 
+		if (jplugin.contains(PATCH_KEY_PLUGIN_STATE_PATH))
+			p.statePath = u::fs::join(basePath, jplugin[PATCH_KEY_PLUGIN_STATE_PATH]);
+
 		for (const auto& jmidiParam : jplugin[PATCH_KEY_PLUGIN_MIDI_IN_PARAMS])
 			p.midiInParams.push_back(jmidiParam);
 
@@ -117,12 +123,15 @@ void readActions_(Patch& patch, const nlohmann::json& j)
 	for (const auto& jaction : j[PATCH_KEY_ACTIONS])
 	{
 		Patch::Action a;
-		a.id        = jaction.value(G_PATCH_KEY_ACTION_ID, ++id);
-		a.channelId = jaction.value(G_PATCH_KEY_ACTION_CHANNEL, 0);
-		a.frame     = jaction.value(G_PATCH_KEY_ACTION_FRAME, 0);
-		a.event     = jaction.value(G_PATCH_KEY_ACTION_EVENT, 0);
-		a.prevId    = jaction.value(G_PATCH_KEY_ACTION_PREV, 0);
-		a.nextId    = jaction.value(G_PATCH_KEY_ACTION_NEXT, 0);
+		a.id          = jaction.value(G_PATCH_KEY_ACTION_ID, ++id);
+		a.channelId   = jaction.value(G_PATCH_KEY_ACTION_CHANNEL, 0);
+		a.frame       = jaction.value(G_PATCH_KEY_ACTION_FRAME, 0);
+		a.event       = jaction.value(G_PATCH_KEY_ACTION_EVENT, 0);
+		a.prevId      = jaction.value(G_PATCH_KEY_ACTION_PREV, 0);
+		a.nextId      = jaction.value(G_PATCH_KEY_ACTION_NEXT, 0);
+		a.pluginId    = jaction.value(G_PATCH_KEY_ACTION_PLUGIN_ID, -1);
+		a.pluginParam = jaction.value(G_PATCH_KEY_ACTION_PLUGIN_PARAM, -1);
+		a.value       = jaction.value(G_PATCH_KEY_ACTION_VALUE, 0.0f);
 		patch.actions.push_back(a);
 	}
 }
@@ -190,6 +199,34 @@ void readChannels_(Patch& patch, const nlohmann::json& j)
 
 /* -------------------------------------------------------------------------- */
 
+void readScenes_(Patch& patch, const nlohmann::json& j)
+{
+	if (!j.contains(PATCH_KEY_SCENES))
+		return;
+
+	ID id = 0;
+	for (const auto& jscene : j[PATCH_KEY_SCENES])
+	{
+		Patch::Scene s;
+		s.id   = jscene.value(PATCH_KEY_SCENE_ID, ++id);
+		s.name = jscene.value(PATCH_KEY_SCENE_NAME, "");
+
+		for (const auto& jchannel : jscene[PATCH_KEY_SCENE_CHANNELS])
+		{
+			Patch::Scene::Channel c;
+			c.channelId = jchannel.value(PATCH_KEY_SCENE_CHANNEL_ID, 0);
+			c.playing   = jchannel.value(PATCH_KEY_SCENE_CHANNEL_PLAYING, false);
+			c.mute      = jchannel.value(PATCH_KEY_SCENE_CHANNEL_MUTE, false);
+			c.volume    = jchannel.value(PATCH_KEY_SCENE_CHANNEL_VOLUME, G_DEFAULT_VOL);
+			s.channels.push_back(c);
+		}
+
+		patch.scenes.push_back(s);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
 void writePlugins_(const Patch& patch, nlohmann::json& j)
 {
 	j[PATCH_KEY_PLUGINS] = nlohmann::json::array();
@@ -201,7 +238,11 @@ void writePlugins_(const Patch& patch, nlohmann::json& j)
 		jplugin[PATCH_KEY_PLUGIN_ID]     = p.id;
 		jplugin[PATCH_KEY_PLUGIN_PATH]   = p.path;
 		jplugin[PATCH_KEY_PLUGIN_BYPASS] = p.bypass;
-		jplugin[PATCH_KEY_PLUGIN_STATE]  = p.state;
+
+		if (!p.statePath.empty())
+			jplugin[PATCH_KEY_PLUGIN_STATE_PATH] = p.statePath;
+		else
+			jplugin[PATCH_KEY_PLUGIN_STATE] = p.state;
 
 		jplugin[PATCH_KEY_PLUGIN_MIDI_IN_PARAMS] = nlohmann::json::array();
 		for (uint32_t param : p.midiInParams)
@@ -241,6 +282,12 @@ void writeActions_(const Patch& patch, nlohmann::json& j)
 		jaction[G_PATCH_KEY_ACTION_EVENT]   = a.event;
 		jaction[G_PATCH_KEY_ACTION_PREV]    = a.prevId;
 		jaction[G_PATCH_KEY_ACTION_NEXT]    = a.nextId;
+		if (a.pluginId != -1)
+		{
+			jaction[G_PATCH_KEY_ACTION_PLUGIN_ID]    = a.pluginId;
+			jaction[G_PATCH_KEY_ACTION_PLUGIN_PARAM] = a.pluginParam;
+			jaction[G_PATCH_KEY_ACTION_VALUE]        = a.value;
+		}
 		j[PATCH_KEY_ACTIONS].push_back(jaction);
 	}
 }
@@ -263,6 +310,33 @@ void writeWaves_(const Patch& patch, nlohmann::json& j)
 
 /* -------------------------------------------------------------------------- */
 
+void writeScenes_(const Patch& patch, nlohmann::json& j)
+{
+	j[PATCH_KEY_SCENES] = nlohmann::json::array();
+
+	for (const Patch::Scene& s : patch.scenes)
+	{
+		nlohmann::json jscene;
+		jscene[PATCH_KEY_SCENE_ID]       = s.id;
+		jscene[PATCH_KEY_SCENE_NAME]     = s.name;
+		jscene[PATCH_KEY_SCENE_CHANNELS] = nlohmann::json::array();
+
+		for (const Patch::Scene::Channel& c : s.channels)
+		{
+			nlohmann::json jchannel;
+			jchannel[PATCH_KEY_SCENE_CHANNEL_ID]      = c.channelId;
+			jchannel[PATCH_KEY_SCENE_CHANNEL_PLAYING] = c.playing;
+			jchannel[PATCH_KEY_SCENE_CHANNEL_MUTE]    = c.mute;
+			jchannel[PATCH_KEY_SCENE_CHANNEL_VOLUME]  = c.volume;
+			jscene[PATCH_KEY_SCENE_CHANNELS].push_back(jchannel);
+		}
+
+		j[PATCH_KEY_SCENES].push_back(jscene);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
 void writeCommons_(const Patch& patch, nlohmann::json& j)
 {
 	j[PATCH_KEY_HEADER]        = "GIADAPTC";
@@ -371,6 +445,356 @@ void modernize_(Patch& patch)
 			c.position = position++;
 	}
 }
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+/* Binary format. Native byte order, fixed-size fields only. Layout:
+
+	header   | magic, binary version, byte order mark, Giada version
+	commons  | name, bars, beats, bpm, quantize, sample rate, metronome
+	columns  | table of Patch::Column
+	channels | table of ChannelRecord_, then name and plug-in IDs of each one
+	actions  | table of Patch::Action
+	waves    | ID and relative path of each one
+	plugins  | ID, path, bypass, state, state path and MIDI params of each one
+	scenes   | ID, name and table of SceneChannelRecord_ of each one
+
+Tables are a uint32_t count followed by raw records, so that they can be copied
+in bulk straight from the mapped file. */
+
+constexpr char     BINARY_MAGIC[8]   = {'G', 'I', 'A', 'D', 'A', 'P', 'T', 'B'};
+constexpr uint32_t BINARY_BYTE_ORDER = 0x01020304;
+
+static_assert(std::is_trivially_copyable_v<Patch::Action> && sizeof(Patch::Action) == 36);
+static_assert(std::is_trivially_copyable_v<Patch::Column> && sizeof(Patch::Column) == 8);
+
+/* ChannelRecord_
+Fixed-size part of a Patch::Channel. All fields are 32 bits wide: no padding,
+no surprises across compilers. */
+
+struct ChannelRecord_
+{
+	int32_t  id;
+	int32_t  type;
+	int32_t  height;
+	int32_t  columnId;
+	int32_t  position;
+	int32_t  key;
+	uint32_t mute;
+	uint32_t solo;
+	float    volume;
+	float    pan;
+	uint32_t hasActions;
+	uint32_t armed;
+	uint32_t midiIn;
+	uint32_t midiInKeyPress;
+	uint32_t midiInKeyRel;
+	uint32_t midiInKill;
+	uint32_t midiInArm;
+	uint32_t midiInVolume;
+	uint32_t midiInMute;
+	uint32_t midiInSolo;
+	int32_t  midiInFilter;
+	uint32_t midiOutL;
+	uint32_t midiOutLplaying;
+	uint32_t midiOutLmute;
+	uint32_t midiOutLsolo;
+	int32_t  waveId;
+	int32_t  mode;
+	int32_t  begin;
+	int32_t  end;
+	int32_t  shift;
+	uint32_t readActions;
+	float    pitch;
+	uint32_t inputMonitor;
+	uint32_t overdubProtection;
+	uint32_t midiInVeloAsVol;
+	uint32_t midiInReadActions;
+	uint32_t midiInPitch;
+	uint32_t midiOut;
+	int32_t  midiOutChan;
+};
+
+static_assert(sizeof(ChannelRecord_) == 39 * 4);
+
+/* SceneChannelRecord_
+Fixed-size part of a Patch::Scene::Channel, same rules as ChannelRecord_. */
+
+struct SceneChannelRecord_
+{
+	int32_t  channelId;
+	uint32_t playing;
+	uint32_t mute;
+	float    volume;
+};
+
+static_assert(sizeof(SceneChannelRecord_) == 4 * 4);
+
+/* -------------------------------------------------------------------------- */
+
+ChannelRecord_ toRecord_(const Patch::Channel& c)
+{
+	return {
+	    c.id, static_cast<int32_t>(c.type), c.height, c.columnId, c.position, c.key,
+	    c.mute, c.solo, c.volume, c.pan, c.hasActions, c.armed, c.midiIn,
+	    c.midiInKeyPress, c.midiInKeyRel, c.midiInKill, c.midiInArm, c.midiInVolume,
+	    c.midiInMute, c.midiInSolo, c.midiInFilter, c.midiOutL, c.midiOutLplaying,
+	    c.midiOutLmute, c.midiOutLsolo, c.waveId, static_cast<int32_t>(c.mode),
+	    c.begin, c.end, c.shift, c.readActions, c.pitch, c.inputMonitor,
+	    c.overdubProtection, c.midiInVeloAsVol, c.midiInReadActions, c.midiInPitch,
+	    c.midiOut, c.midiOutChan};
+}
+
+/* -------------------------------------------------------------------------- */
+
+Patch::Channel fromRecord_(const ChannelRecord_& r)
+{
+	Patch::Channel c;
+	c.id                = r.id;
+	c.type              = static_cast<ChannelType>(r.type);
+	c.height            = r.height;
+	c.columnId          = r.columnId;
+	c.position          = r.position;
+	c.key               = r.key;
+	c.mute              = r.mute;
+	c.solo              = r.solo;
+	c.volume            = r.volume;
+	c.pan               = r.pan;
+	c.hasActions        = r.hasActions;
+	c.armed             = r.armed;
+	c.midiIn            = r.midiIn;
+	c.midiInKeyPress    = r.midiInKeyPress;
+	c.midiInKeyRel      = r.midiInKeyRel;
+	c.midiInKill        = r.midiInKill;
+	c.midiInArm         = r.midiInArm;
+	c.midiInVolume      = r.midiInVolume;
+	c.midiInMute        = r.midiInMute;
+	c.midiInSolo        = r.midiInSolo;
+	c.midiInFilter      = r.midiInFilter;
+	c.midiOutL          = r.midiOutL;
+	c.midiOutLplaying   = r.midiOutLplaying;
+	c.midiOutLmute      = r.midiOutLmute;
+	c.midiOutLsolo      = r.midiOutLsolo;
+	c.waveId            = r.waveId;
+	c.mode              = static_cast<SamplePlayerMode>(r.mode);
+	c.begin             = r.begin;
+	c.end               = r.end;
+	c.shift             = r.shift;
+	c.readActions       = r.readActions;
+	c.pitch             = r.pitch;
+	c.inputMonitor      = r.inputMonitor;
+	c.overdubProtection = r.overdubProtection;
+	c.midiInVeloAsVol   = r.midiInVeloAsVol;
+	c.midiInReadActions = r.midiInReadActions;
+	c.midiInPitch       = r.midiInPitch;
+	c.midiOut           = r.midiOut;
+	c.midiOutChan       = r.midiOutChan;
+	return c;
+}
+
+/* -------------------------------------------------------------------------- */
+
+template <typename T>
+void write_(std::ostream& os, const T& value)
+{
+	static_assert(std::is_trivially_copyable_v<T>);
+	os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void writeString_(std::ostream& os, const std::string& s)
+{
+	write_(os, static_cast<uint32_t>(s.size()));
+	os.write(s.data(), s.size());
+}
+
+template <typename T>
+void writeTable_(std::ostream& os, const std::vector<T>& table)
+{
+	static_assert(std::is_trivially_copyable_v<T>);
+	write_(os, static_cast<uint32_t>(table.size()));
+	os.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(T));
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* BinaryReader_
+Bounds-checked cursor over a memory region. Reading past the end invalidates
+the reader and returns empty values from then on. */
+
+class BinaryReader_
+{
+public:
+	BinaryReader_(const void* data, std::size_t size)
+	: m_cur(static_cast<const char*>(data))
+	, m_end(m_cur + size)
+	, m_valid(data != nullptr)
+	{
+	}
+
+	bool isValid() const { return m_valid; }
+
+	bool readRaw(void* dest, std::size_t size)
+	{
+		if (!m_valid || static_cast<std::size_t>(m_end - m_cur) < size)
+			return m_valid = false;
+		std::memcpy(dest, m_cur, size);
+		m_cur += size;
+		return true;
+	}
+
+	template <typename T>
+	T read()
+	{
+		static_assert(std::is_trivially_copyable_v<T>);
+		T value{};
+		readRaw(&value, sizeof(T));
+		return value;
+	}
+
+	std::string readString()
+	{
+		std::string s(readCount(1), '\0');
+		readRaw(s.data(), s.size());
+		return s;
+	}
+
+	template <typename T>
+	std::vector<T> readTable()
+	{
+		std::vector<T> table(readCount(sizeof(T)));
+		readRaw(table.data(), table.size() * sizeof(T));
+		return table;
+	}
+
+private:
+	/* readCount
+	Reads an element count, making sure the remaining data can hold that many
+	elements of the given size. Protects from huge allocations on corrupted 
+	files. */
+
+	std::size_t readCount(std::size_t elemSize)
+	{
+		const std::size_t count = read<uint32_t>();
+		if (count * elemSize > static_cast<std::size_t>(m_end - m_cur))
+		{
+			m_valid = false;
+			return 0;
+		}
+		return count;
+	}
+
+	const char* m_cur;
+	const char* m_end;
+	bool        m_valid;
+};
+
+/* -------------------------------------------------------------------------- */
+
+Patch deserializeBinary_(const std::string& filePath)
+{
+	Patch patch;
+
+	const juce::MemoryMappedFile file(juce::File(filePath), juce::MemoryMappedFile::readOnly);
+	if (file.getData() == nullptr)
+	{
+		patch.status = G_FILE_UNREADABLE;
+		return patch;
+	}
+
+	BinaryReader_ r(file.getData(), file.getSize());
+
+	char magic[sizeof(BINARY_MAGIC)];
+	r.readRaw(magic, sizeof(magic));
+	if (!r.isValid() || std::memcmp(magic, BINARY_MAGIC, sizeof(magic)) != 0)
+	{
+		patch.status = G_FILE_INVALID;
+		return patch;
+	}
+
+	if (r.read<uint32_t>() != BINARY_VERSION || r.read<uint32_t>() != BINARY_BYTE_ORDER)
+	{
+		patch.status = G_FILE_UNSUPPORTED;
+		return patch;
+	}
+
+	patch.version.major = r.read<int32_t>();
+	patch.version.minor = r.read<int32_t>();
+	patch.version.patch = r.read<int32_t>();
+
+	const std::string basePath = u::fs::dirname(filePath);
+
+	/* Commons. */
+
+	patch.name       = r.readString();
+	patch.bars       = r.read<int32_t>();
+	patch.beats      = r.read<int32_t>();
+	patch.bpm        = r.read<float>();
+	patch.quantize   = r.read<uint8_t>();
+	patch.samplerate = r.read<int32_t>();
+	patch.metronome  = r.read<uint8_t>();
+
+	/* Columns, channels and actions: bulk copies. */
+
+	patch.columns = r.readTable<Patch::Column>();
+
+	for (const ChannelRecord_& record : r.readTable<ChannelRecord_>())
+		patch.channels.push_back(fromRecord_(record));
+	for (Patch::Channel& c : patch.channels)
+	{
+		c.name      = r.readString();
+		c.pluginIds = r.readTable<ID>();
+	}
+
+	patch.actions = r.readTable<Patch::Action>();
+
+	/* Waves and plug-ins. Paths are relative to the project folder. */
+
+	for (uint32_t i = 0, count = r.read<uint32_t>(); i < count && r.isValid(); i++)
+	{
+		Patch::Wave w;
+		w.id   = r.read<int32_t>();
+		w.path = u::fs::join(basePath, r.readString());
+		patch.waves.push_back(w);
+	}
+
+	for (uint32_t i = 0, count = r.read<uint32_t>(); i < count && r.isValid(); i++)
+	{
+		Patch::Plugin p;
+		p.id        = r.read<int32_t>();
+		p.path      = r.readString();
+		p.bypass    = r.read<uint8_t>();
+		p.state     = r.readString();
+		p.statePath = r.readString();
+		if (!p.statePath.empty())
+			p.statePath = u::fs::join(basePath, p.statePath);
+		p.midiInParams = r.readTable<uint32_t>();
+		patch.plugins.push_back(p);
+	}
+
+	for (uint32_t i = 0, count = r.read<uint32_t>(); i < count && r.isValid(); i++)
+	{
+		Patch::Scene s;
+		s.id   = r.read<int32_t>();
+		s.name = r.readString();
+		for (const SceneChannelRecord_& c : r.readTable<SceneChannelRecord_>())
+			s.channels.push_back({c.channelId, c.playing != 0, c.mute != 0, c.volume});
+		patch.scenes.push_back(s);
+	}
+
+	if (!r.isValid())
+	{
+		u::log::print("[patchFactory::deserialize] Binary patch {} is truncated or corrupted\n", filePath);
+		patch.status = G_FILE_INVALID;
+		return patch;
+	}
+
+	modernize_(patch);
+
+	patch.status = G_FILE_OK;
+	return patch;
+}
 } // namespace
 
 /* -------------------------------------------------------------------------- */
@@ -387,6 +811,7 @@ bool serialize(const Patch& patch, const std::string& filePath)
 	writeActions_(patch, j);
 	writeWaves_(patch, j);
 	writePlugins_(patch, j);
+	writeScenes_(patch, j);
 
 	std::ofstream ofs(filePath);
 	if (!ofs.good())
@@ -398,8 +823,81 @@ bool serialize(const Patch& patch, const std::string& filePath)
 
 /* -------------------------------------------------------------------------- */
 
+bool serializeBinary(const Patch& patch, const std::string& filePath)
+{
+	std::ofstream ofs(filePath, std::ios::binary);
+	if (!ofs.good())
+		return false;
+
+	ofs.write(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+	write_(ofs, BINARY_VERSION);
+	write_(ofs, BINARY_BYTE_ORDER);
+	write_(ofs, static_cast<int32_t>(G_VERSION_MAJOR));
+	write_(ofs, static_cast<int32_t>(G_VERSION_MINOR));
+	write_(ofs, static_cast<int32_t>(G_VERSION_PATCH));
+
+	writeString_(ofs, patch.name);
+	write_(ofs, static_cast<int32_t>(patch.bars));
+	write_(ofs, static_cast<int32_t>(patch.beats));
+	write_(ofs, patch.bpm);
+	write_(ofs, static_cast<uint8_t>(patch.quantize));
+	write_(ofs, static_cast<int32_t>(patch.samplerate));
+	write_(ofs, static_cast<uint8_t>(patch.metronome));
+
+	writeTable_(ofs, patch.columns);
+
+	std::vector<ChannelRecord_> channels;
+	for (const Patch::Channel& c : patch.channels)
+		channels.push_back(toRecord_(c));
+	writeTable_(ofs, channels);
+	for (const Patch::Channel& c : patch.channels)
+	{
+		writeString_(ofs, c.name);
+		writeTable_(ofs, c.pluginIds);
+	}
+
+	writeTable_(ofs, patch.actions);
+
+	write_(ofs, static_cast<uint32_t>(patch.waves.size()));
+	for (const Patch::Wave& w : patch.waves)
+	{
+		write_(ofs, static_cast<int32_t>(w.id));
+		writeString_(ofs, w.path);
+	}
+
+	write_(ofs, static_cast<uint32_t>(patch.plugins.size()));
+	for (const Patch::Plugin& p : patch.plugins)
+	{
+		write_(ofs, static_cast<int32_t>(p.id));
+		writeString_(ofs, p.path);
+		write_(ofs, static_cast<uint8_t>(p.bypass));
+		writeString_(ofs, p.state);
+		writeString_(ofs, p.statePath);
+		writeTable_(ofs, p.midiInParams);
+	}
+
+	write_(ofs, static_cast<uint32_t>(patch.scenes.size()));
+	for (const Patch::Scene& s : patch.scenes)
+	{
+		std::vector<SceneChannelRecord_> channels;
+		for (const Patch::Scene::Channel& c : s.channels)
+			channels.push_back({c.channelId, c.playing, c.mute, c.volume});
+
+		write_(ofs, static_cast<int32_t>(s.id));
+		writeString_(ofs, s.name);
+		writeTable_(ofs, channels);
+	}
+
+	return ofs.good();
+}
+
+/* -------------------------------------------------------------------------- */
+
 Patch deserialize(const std::string& filePath)
 {
+	if (u::fs::getExt(filePath) == G_PATCH_BIN_EXT)
+		return deserializeBinary_(filePath);
+
 	Patch patch;
 
 	std::ifstream ifs(filePath);
@@ -431,10 +929,11 @@ Patch deserialize(const std::string& filePath)
 	{
 		readCommons_(patch, j);
 		readColumns_(patch, j);
-		readPlugins_(patch, j);
+		readPlugins_(patch, j, u::fs::dirname(filePath));
 		readWaves_(patch, j, u::fs::dirname(filePath));
 		readActions_(patch, j);
 		readChannels_(patch, j);
+		readScenes_(patch, j);
 		modernize_(patch);
 	}
 	catch (nlohmann::json::exception& e)
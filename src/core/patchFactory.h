@@ -28,17 +28,32 @@
 #define G_PATCH_FACTORY_H
 
 #include "core/patch.h"
+#include <cstdint>
 
 namespace giada::m::patchFactory
 {
+/* BINARY_VERSION
+Version of the binary patch layout. Bump it on any change to the binary 
+format: older binary patches will be refused, so that the JSON one is loaded
+instead. */
+
+constexpr uint32_t BINARY_VERSION = 2;
+
 /* serialize 
 Writes Patch to disk. The 'filePath' parameter refers to the .gptc file. */
 
 bool serialize(const Patch&, const std::string& filePath);
 
+/* serializeBinary
+Writes Patch to disk in the compact binary format. The 'filePath' parameter 
+refers to the .gptb file. Actions and channels are stored as flat tables. */
+
+bool serializeBinary(const Patch&, const std::string& filePath);
+
 /* deserialize 
 Reads data from disk into a new Patch object. The 'filePath' parameter refers to
-the .gptc file. */
+either the .gptc (JSON) or the .gptb (binary) file. Binary patches are memory
+mapped. */
 
 Patch deserialize(const std::string& filePath);
 } // namespace giada::m::patchFactory
@@ -0,0 +1,136 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#include "core/peakCache.h"
+#include "core/wave.h"
+#include "utils/log.h"
+
+namespace giada::m
+{
+PeakCache::PeakCache()
+: m_running(true)
+{
+	m_thread = std::thread([this]() { run(); });
+}
+
+/* -------------------------------------------------------------------------- */
+
+PeakCache::~PeakCache()
+{
+	{
+		std::scoped_lock lock(m_mutex);
+		m_running = false;
+	}
+	m_cond.notify_one();
+	m_thread.join();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void PeakCache::request(const Wave& w)
+{
+	{
+		std::scoped_lock lock(m_mutex);
+
+		Entry& entry = m_entries[w.id];
+		if (entry.revision == w.getRevision() || entry.requested == w.getRevision())
+			return;
+		entry.requested = w.getRevision();
+		m_queue.push_back(std::make_unique<Wave>(w));
+	}
+	m_cond.notify_one();
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::shared_ptr<const WavePeaks> PeakCache::get(const Wave& w)
+{
+	{
+		std::scoped_lock lock(m_mutex);
+
+		const auto it = m_entries.find(w.id);
+		if (it != m_entries.end() && it->second.revision == w.getRevision())
+			return it->second.peaks;
+	}
+	request(w);
+	return nullptr;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void PeakCache::remove(ID waveId)
+{
+	std::scoped_lock lock(m_mutex);
+	m_entries.erase(waveId);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void PeakCache::clear()
+{
+	std::scoped_lock lock(m_mutex);
+	m_entries.clear();
+	m_queue.clear();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void PeakCache::run()
+{
+	while (true)
+	{
+		std::unique_ptr<Wave> wave;
+		{
+			std::unique_lock lock(m_mutex);
+			m_cond.wait(lock, [this]() { return !m_running || !m_queue.empty(); });
+			if (!m_running)
+				return;
+			wave = std::move(m_queue.front());
+			m_queue.pop_front();
+
+			/* A newer revision has been requested in the meantime, or the Wave 
+			has been removed: this one would be thrown away anyway. */
+
+			const auto it = m_entries.find(wave->id);
+			if (it == m_entries.end() || it->second.requested != wave->getRevision())
+				continue;
+		}
+
+		auto peaks = std::make_shared<const WavePeaks>(*wave);
+
+		u::log::print("[PeakCache::run] peaks computed for Wave {}, {} frames\n",
+		    wave->id, peaks->countFrames());
+
+		std::scoped_lock lock(m_mutex);
+
+		const auto it = m_entries.find(wave->id);
+		if (it == m_entries.end() || it->second.requested != wave->getRevision())
+			continue;
+		it->second.revision = wave->getRevision();
+		it->second.peaks    = std::move(peaks);
+	}
+}
+} // namespace giada::m
@@ -0,0 +1,95 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef G_PEAK_CACHE_H
+#define G_PEAK_CACHE_H
+
+#include "core/types.h"
+#include "core/wavePeaks.h"
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace giada::m
+{
+class Wave;
+
+/* PeakCache
+Keeps the WavePeaks of each Wave, computing them on a background thread when a
+Wave is loaded or changed. */
+
+class PeakCache final
+{
+public:
+	PeakCache();
+	~PeakCache();
+
+	/* request
+	Schedules the computation of peaks for Wave 'w', unless already up to date
+	or scheduled. Works on a snapshot of 'w': audio data is shared with it, not
+	copied. Thread-safe. */
+
+	void request(const Wave& w);
+
+	/* get
+	Returns the peaks of Wave 'w' if ready and up to date, nullptr otherwise. 
+	In the latter case peaks are requested. Thread-safe. */
+
+	std::shared_ptr<const WavePeaks> get(const Wave& w);
+
+	/* remove
+	Drops the peaks of Wave 'waveId', when the Wave is deleted. Thread-safe. */
+
+	void remove(ID waveId);
+
+	/* clear
+	Drops all peaks, e.g. when a new project is loaded. Thread-safe. */
+
+	void clear();
+
+private:
+	struct Entry
+	{
+		int                              revision  = -1; // Revision of 'peaks'
+		int                              requested = -1; // Latest revision requested
+		std::shared_ptr<const WavePeaks> peaks;
+	};
+
+	void run();
+
+	std::unordered_map<ID, Entry>     m_entries;
+	std::deque<std::unique_ptr<Wave>> m_queue;
+	std::mutex                        m_mutex;
+	std::condition_variable           m_cond;
+	bool                              m_running;
+	std::thread                       m_thread;
+};
+} // namespace giada::m
+
+#endif
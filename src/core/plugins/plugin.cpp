@@ -39,6 +39,7 @@ Plugin::Plugin(ID id, const std::string& UID)
 , valid(false)
 , onEditorResize(nullptr)
 , m_plugin(nullptr)
+, m_revision(0)
 , m_UID(UID)
 , m_hasEditor(false)
 {
@@ -54,6 +55,7 @@ Plugin::Plugin(ID id, std::unique_ptr<juce::AudioPluginInstance> plugin,
 , m_plugin(std::move(plugin))
 , m_playHead(std::move(playHead))
 , m_bypass(false)
+, m_revision(0)
 , m_hasEditor(m_plugin->hasEditor())
 {
 	/* (1) Initialize midiInParams vector, where midiInParams.size == number of 
@@ -82,6 +84,10 @@ Plugin::Plugin(ID id, std::unique_ptr<juce::AudioPluginInstance> plugin,
 
 	m_plugin->prepareToPlay(samplerate, buffersize);
 
+	/* Listen to changes made from the plug-in editor. */
+
+	m_plugin->addListener(this);
+
 	u::log::print("[Plugin] plugin initialized and ready. MIDI input params: {}\n",
 	    midiInParams.size());
 }
@@ -97,6 +103,8 @@ Plugin::~Plugin()
 	if (e != nullptr)
 		e->removeComponentListener(this);
 
+	m_plugin->removeListener(this);
+
 	m_plugin->suspendProcessing(true);
 	m_plugin->releaseResources();
 }
@@ -113,6 +121,18 @@ void Plugin::componentMovedOrResized(juce::Component& c, bool moved, bool /* res
 
 /* -------------------------------------------------------------------------- */
 
+void Plugin::audioProcessorParameterChanged(juce::AudioProcessor*, int /*index*/, float /*value*/)
+{
+	m_revision++;
+}
+
+void Plugin::audioProcessorChanged(juce::AudioProcessor*, const juce::AudioProcessorListener::ChangeDetails&)
+{
+	m_revision++;
+}
+
+/* -------------------------------------------------------------------------- */
+
 juce::AudioProcessor::Bus* Plugin::getMainBus(BusType b) const
 {
 	const bool isInput = static_cast<bool>(b);
@@ -165,6 +185,12 @@ float Plugin::getParameter(int paramIndex) const
 /* -------------------------------------------------------------------------- */
 
 void Plugin::setParameter(int paramIndex, float value) const
+{
+	m_plugin->getParameters()[paramIndex]->setValue(value);
+	m_revision++;
+}
+
+void Plugin::automateParameter(int paramIndex, float value) const
 {
 	m_plugin->getParameters()[paramIndex]->setValue(value);
 }
@@ -210,7 +236,13 @@ PluginState Plugin::getState() const
 /* -------------------------------------------------------------------------- */
 
 bool Plugin::isBypassed() const { return m_bypass.load(); }
-void Plugin::setBypass(bool b) { m_bypass.store(b); }
+int  Plugin::getRevision() const { return m_revision.load(); }
+
+void Plugin::setBypass(bool b)
+{
+	m_bypass.store(b);
+	m_revision++;
+}
 
 /* -------------------------------------------------------------------------- */
 
@@ -218,9 +250,14 @@ const Plugin::Buffer& Plugin::process(const Plugin::Buffer& out, juce::MidiBuffe
 {
 	/* Copy the incoming buffer data into the temporary one. This way FXes will 
 	process	existing audio data on the private buffer. This is needed later on
-	when merging it back into the incoming buffer. */
-
-	m_buffer = out;
+	when merging it back into the incoming buffer. The incoming buffer might be
+	a sub-block (see PluginHost::processSegments()): resize without 
+	reallocating, the private buffer is already large enough. */
+
+	m_buffer.setSize(out.getNumChannels(), out.getNumSamples(), /*keepExistingContent=*/false,
+	    /*clearExtraSpace=*/false, /*avoidReallocating=*/true);
+	for (int i = 0; i < out.getNumChannels(); i++)
+		m_buffer.copyFrom(i, 0, out, i, 0, out.getNumSamples());
 	m_plugin->processBlock(m_buffer, m);
 	return m_buffer;
 }
@@ -230,6 +267,7 @@ const Plugin::Buffer& Plugin::process(const Plugin::Buffer& out, juce::MidiBuffe
 void Plugin::setState(PluginState state)
 {
 	m_plugin->setStateInformation(state.getData(), state.getSize());
+	m_revision++;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -254,8 +292,10 @@ int Plugin::getCurrentProgram() const
 
 void Plugin::setCurrentProgram(int index) const
 {
-	if (valid)
-		m_plugin->setCurrentProgram(index);
+	if (!valid)
+		return;
+	m_plugin->setCurrentProgram(index);
+	m_revision++;
 }
 
 /* -------------------------------------------------------------------------- */
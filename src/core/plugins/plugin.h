@@ -39,6 +39,7 @@
 namespace giada::m
 {
 class Plugin : private juce::ComponentListener
+    , private juce::AudioProcessorListener
 {
 public:
 	using Buffer = juce::AudioBuffer<float>;
@@ -83,6 +84,19 @@ public:
 	PluginState                 getState() const;
 	juce::AudioProcessorEditor* createEditor() const;
 
+	/* getRevision
+	Changes each time the plug-in is modified from the outside: parameters set 
+	from the UI, the plug-in editor or MIDI learn, program, bypass and state. 
+	Automation doesn't count. */
+
+	int getRevision() const;
+
+	/* automateParameter
+	Same as setParameter(), for automation played back while rendering: the
+	revision is left untouched. */
+
+	void automateParameter(int index, float value) const;
+
 	/* countMainOutChannels
 	Returns the current channel layout for the main output bus. */
 
@@ -134,6 +148,8 @@ private:
 	/* JUCE overrides. */
 
 	void componentMovedOrResized(juce::Component& c, bool moved, bool resized) override;
+	void audioProcessorParameterChanged(juce::AudioProcessor*, int index, float value) override;
+	void audioProcessorChanged(juce::AudioProcessor*, const juce::AudioProcessorListener::ChangeDetails&) override;
 
 	juce::AudioProcessor::Bus* getMainBus(BusType b) const;
 
@@ -143,6 +159,11 @@ private:
 
 	std::atomic<bool> m_bypass;
 
+	/* m_revision
+	See getRevision(). Mutable: bumped by const setters too. */
+
+	mutable std::atomic<int> m_revision;
+
 	/* UID
 	The original UID, used for missing plugins. */
 
@@ -28,12 +28,48 @@
 #include "core/idManager.h"
 #include "core/plugins/plugin.h"
 #include "core/plugins/pluginHost.h"
+#include "utils/fs.h"
+#include "utils/log.h"
+#include <algorithm>
+#include <cstring>
 
 namespace giada::m::pluginFactory
 {
 namespace
 {
 IdManager pluginId_;
+
+/* -------------------------------------------------------------------------- */
+
+PluginState loadState_(const std::string& path)
+{
+	PluginState state{juce::File(path)};
+	if (state.getData() == nullptr)
+		u::log::print("[pluginFactory::loadState_] unable to read state file {}\n", path);
+	return state;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool saveState_(const PluginState& state, const std::string& path)
+{
+	/* The file name comes from the content hash, so an existing file is most
+	likely identical: skip the write only if its bytes actually match, to never
+	keep a truncated or foreign file around. */
+
+	const juce::File file(path);
+	if (file.getSize() == static_cast<juce::int64>(state.getSize()))
+	{
+		const PluginState existing{file};
+		if (existing.getData() != nullptr && std::memcmp(existing.getData(), state.getData(), state.getSize()) == 0)
+			return true;
+	}
+
+	/* replaceWithData() writes a temporary file first and then moves it over
+	the old one, so a failed write never leaves a half-written state behind. */
+
+	return file.replaceWithData(state.getData(), state.getSize());
+}
 } // namespace
 
 /* -------------------------------------------------------------------------- */
@@ -79,7 +115,7 @@ std::unique_ptr<Plugin> deserializePlugin(const Patch::Plugin& pplugin, std::uni
 	std::unique_ptr<Plugin> plugin = create(pplugin.id, pplugin.path, std::move(pi), sequencer, sampleRate, bufferSize);
 
 	plugin->setBypass(pplugin.bypass);
-	plugin->setState(PluginState(pplugin.state));
+	plugin->setState(pplugin.statePath.empty() ? PluginState(pplugin.state) : loadState_(pplugin.statePath));
 
 	/* Fill plug-in MidiIn parameters. Don't fill Plugin::midiInParam if 
 	Patch::midiInParams are zero: it would wipe out the current default 0x0
@@ -98,17 +134,51 @@ std::unique_ptr<Plugin> deserializePlugin(const Patch::Plugin& pplugin, std::uni
 
 /* -------------------------------------------------------------------------- */
 
-Patch::Plugin serializePlugin(const Plugin& p)
+Patch::Plugin serializePlugin(const Plugin& p, std::vector<SaveRequest>& requests)
 {
 	Patch::Plugin pp;
 	pp.id     = p.id;
 	pp.path   = p.getUniqueId();
 	pp.bypass = p.isBypassed();
-	pp.state  = p.getState().asBase64();
+
+	PluginState state = p.getState();
+
+	if (state.getSize() > 0)
+	{
+		const std::string fileName = state.getHash() + G_STATE_EXT;
+		const auto        isSame   = [&fileName](const SaveRequest& r) { return r.fileName == fileName; };
+
+		if (std::none_of(requests.begin(), requests.end(), isSame))
+			requests.push_back({std::move(state), fileName});
+		pp.statePath = fileName;
+	}
 
 	for (const MidiLearnParam& param : p.midiInParams)
 		pp.midiInParams.push_back(param.getValue());
 
 	return pp;
 }
+
+/* -------------------------------------------------------------------------- */
+
+bool saveState(const std::string& projectPath, const SaveRequest& req)
+{
+	return saveState_(req.state, u::fs::join(projectPath, req.fileName));
+}
+
+/* -------------------------------------------------------------------------- */
+
+void removeUnusedStates(const std::string& projectPath, const std::vector<Patch::Plugin>& plugins)
+{
+	const juce::File dir(projectPath);
+
+	for (const juce::File& file : dir.findChildFiles(juce::File::findFiles, /*searchRecursively=*/false, juce::String("*") + G_STATE_EXT))
+	{
+		const std::string fileName = file.getFileName().toStdString();
+		const auto        isUsed   = [&fileName](const Patch::Plugin& p) { return p.statePath == fileName; };
+
+		if (std::none_of(plugins.begin(), plugins.end(), isUsed))
+			file.deleteFile();
+	}
+}
 } // namespace giada::m::pluginFactory
@@ -28,10 +28,12 @@
 #define G_PLUGIN_FACTORY_H
 
 #include "core/patch.h"
+#include "core/plugins/pluginState.h"
 #include "core/types.h"
 #include <juce_audio_processors/juce_audio_processors.h>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace giada::m
 {
@@ -45,6 +47,16 @@ class Sequencer;
 
 namespace giada::m::pluginFactory
 {
+/* SaveRequest
+A plug-in state to be written to disk as 'fileName', relative to the project
+folder. */
+
+struct SaveRequest
+{
+	PluginState state;
+	std::string fileName;
+};
+
 /* reset
 Resets internal ID generator. */
 
@@ -54,10 +66,31 @@ std::unique_ptr<Plugin> createInvalid(ID id, const std::string& pid);
 std::unique_ptr<Plugin> create(ID id, const std::string& pid, std::unique_ptr<juce::AudioPluginInstance>,
     const model::Sequencer&, int sampleRate, int bufferSize);
 
+/* deserializePlugin
+Creates a Plugin from a Patch::Plugin. Its state comes from the binary sidecar
+file, if any, mapped in memory and read lazily by the plug-in itself, or from
+the legacy base64 string. */
+
 std::unique_ptr<Plugin> deserializePlugin(const Patch::Plugin&, std::unique_ptr<juce::AudioPluginInstance>,
     const model::Sequencer&, int sampleRate, int bufferSize);
 
-Patch::Plugin serializePlugin(const Plugin&);
+/* serializePlugin
+Turns a Plugin into a Patch::Plugin. The plug-in state is not written here: it
+goes into 'requests' as a binary sidecar file named after its content, so that
+identical states share the same file. */
+
+Patch::Plugin serializePlugin(const Plugin&, std::vector<SaveRequest>& requests);
+
+/* saveState
+Writes a state file into 'projectPath'. Returns false on failure. */
+
+bool saveState(const std::string& projectPath, const SaveRequest&);
+
+/* removeUnusedStates
+Deletes state files in 'projectPath' no longer referenced by any plug-in. Call
+it only once the patch referencing them has been written. */
+
+void removeUnusedStates(const std::string& projectPath, const std::vector<Patch::Plugin>&);
 } // namespace giada::m::pluginFactory
 
 #endif
@@ -39,6 +39,18 @@
 
 namespace giada::m
 {
+namespace
+{
+/* renderFrame_
+Position override for the blocks rendered by this thread, if any. */
+
+thread_local Frame renderFrame_ = -1;
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
 PluginHost::Info::Info(const model::Sequencer& s, int sampleRate)
 : m_sequencer(s)
 , m_sampleRate(sampleRate)
@@ -47,13 +59,22 @@ PluginHost::Info::Info(const model::Sequencer& s, int sampleRate)
 
 /* -------------------------------------------------------------------------- */
 
+void PluginHost::Info::setRenderFrame(Frame f)
+{
+	renderFrame_ = f;
+}
+
+/* -------------------------------------------------------------------------- */
+
 juce::Optional<juce::AudioPlayHead::PositionInfo> PluginHost::Info::getPosition() const
 {
 	juce::AudioPlayHead::PositionInfo info;
 
+	const Frame frame = renderFrame_ != -1 ? renderFrame_ : m_sequencer.a_getCurrentFrame();
+
 	info.setBpm(m_sequencer.bpm);
-	info.setTimeInSamples(m_sequencer.a_getCurrentFrame());
-	info.setTimeInSeconds(m_sequencer.a_getCurrentSecond(m_sampleRate));
+	info.setTimeInSamples(frame);
+	info.setTimeInSeconds(frame / static_cast<double>(m_sampleRate));
 	info.setIsPlaying(m_sequencer.isRunning());
 
 	return {info};
@@ -87,27 +108,39 @@ void PluginHost::reset(int bufferSize)
 
 void PluginHost::setBufferSize(int bufferSize)
 {
-	m_audioBuffer.setSize(G_MAX_IO_CHANS, bufferSize);
+	/* Preallocate MIDI events too: processSegments() fills them on the audio 
+	thread. clear() keeps the allocated memory. */
+
+	for (Scratch& scratch : m_scratch)
+	{
+		scratch.audioBuffer.setSize(G_MAX_IO_CHANS, bufferSize);
+		scratch.segmentEvents.ensureSize(G_DEFAULT_VST_MIDIBUFFER_SIZE);
+	}
 }
 
 /* -------------------------------------------------------------------------- */
 
 void PluginHost::processStack(mcl::AudioBuffer& outBuf, const std::vector<Plugin*>& plugins,
-    juce::MidiBuffer* events)
+    juce::MidiBuffer* events, std::span<const ParamChange> paramChanges, int renderSlot)
 {
-	assert(outBuf.countFrames() == m_audioBuffer.getNumSamples());
+	assert(renderSlot >= 0 && renderSlot < static_cast<int>(m_scratch.size()));
 
-	giadaToJuceTempBuf(outBuf);
+	Scratch& scratch = m_scratch[renderSlot];
 
-	if (events == nullptr)
-	{
-		juce::MidiBuffer dummyEvents; // empty
-		processPlugins(plugins, dummyEvents);
-	}
+	assert(outBuf.countFrames() == scratch.audioBuffer.getNumSamples());
+
+	giadaToJuceTempBuf(outBuf, scratch);
+
+	juce::MidiBuffer  dummyEvents; // empty
+	juce::MidiBuffer& midiEvents = events != nullptr ? *events : dummyEvents;
+
+	if (paramChanges.empty())
+		processPlugins(plugins, scratch.audioBuffer, midiEvents);
 	else
-		processPlugins(plugins, *events);
+		processSegments(plugins, midiEvents, paramChanges, scratch);
+	midiEvents.clear();
 
-	juceToGiadaOutBuf(outBuf);
+	juceToGiadaOutBuf(outBuf, scratch);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -170,56 +203,99 @@ void PluginHost::toggleBypass(ID pluginId)
 
 /* -------------------------------------------------------------------------- */
 
-void PluginHost::giadaToJuceTempBuf(const mcl::AudioBuffer& outBuf)
+void PluginHost::giadaToJuceTempBuf(const mcl::AudioBuffer& outBuf, Scratch& scratch)
 {
-	assert(outBuf.countChannels() == m_audioBuffer.getNumChannels());
+	juce::AudioBuffer<float>& audioBuffer = scratch.audioBuffer;
+
+	assert(outBuf.countChannels() == audioBuffer.getNumChannels());
 
 	using namespace juce;
 	using Format = AudioData::Format<AudioData::Float32, AudioData::BigEndian>;
 
 	AudioData::deinterleaveSamples(
 	    AudioData::InterleavedSource<Format>{outBuf[0], outBuf.countChannels()},
-	    AudioData::NonInterleavedDest<Format>{m_audioBuffer.getArrayOfWritePointers(), m_audioBuffer.getNumChannels()},
+	    AudioData::NonInterleavedDest<Format>{audioBuffer.getArrayOfWritePointers(), audioBuffer.getNumChannels()},
 	    outBuf.countFrames());
 }
 
-void PluginHost::juceToGiadaOutBuf(mcl::AudioBuffer& outBuf) const
+void PluginHost::juceToGiadaOutBuf(mcl::AudioBuffer& outBuf, const Scratch& scratch) const
 {
-	assert(outBuf.countChannels() == m_audioBuffer.getNumChannels());
+	const juce::AudioBuffer<float>& audioBuffer = scratch.audioBuffer;
+
+	assert(outBuf.countChannels() == audioBuffer.getNumChannels());
 
 	using namespace juce;
 	using Format = AudioData::Format<AudioData::Float32, AudioData::BigEndian>;
 
 	AudioData::interleaveSamples(
-	    AudioData::NonInterleavedSource<Format>{m_audioBuffer.getArrayOfReadPointers(), m_audioBuffer.getNumChannels()},
+	    AudioData::NonInterleavedSource<Format>{audioBuffer.getArrayOfReadPointers(), audioBuffer.getNumChannels()},
 	    AudioData::InterleavedDest<Format>{outBuf[0], outBuf.countChannels()},
 	    outBuf.countFrames());
 }
 
 /* -------------------------------------------------------------------------- */
 
-void PluginHost::processPlugins(const std::vector<Plugin*>& plugins, juce::MidiBuffer& events)
+void PluginHost::processSegments(const std::vector<Plugin*>& plugins,
+    const juce::MidiBuffer& events, std::span<const ParamChange> paramChanges, Scratch& scratch)
+{
+	const int   numFrames = scratch.audioBuffer.getNumSamples();
+	std::size_t next      = 0;
+
+	for (int begin = 0; begin < numFrames;)
+	{
+		/* Apply all changes landing at the beginning of this sub-block, then 
+		process it up to the next change point. */
+
+		for (; next < paramChanges.size() && paramChanges[next].delta <= begin; next++)
+			applyParamChange(plugins, paramChanges[next]);
+
+		const int end = next < paramChanges.size()
+		                    ? std::min(static_cast<int>(paramChanges[next].delta), numFrames)
+		                    : numFrames;
+
+		/* A non-owning view over the sub-block: no allocations here. */
+
+		juce::AudioBuffer<float> segment(scratch.audioBuffer.getArrayOfWritePointers(),
+		    scratch.audioBuffer.getNumChannels(), begin, end - begin);
+
+		scratch.segmentEvents.clear();
+		scratch.segmentEvents.addEvents(events, begin, end - begin, -begin);
+
+		processPlugins(plugins, segment, scratch.segmentEvents);
+
+		begin = end;
+	}
+
+	/* Changes beyond the end of the block, if any, are applied anyway. */
+
+	for (; next < paramChanges.size(); next++)
+		applyParamChange(plugins, paramChanges[next]);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void PluginHost::processPlugins(const std::vector<Plugin*>& plugins, juce::AudioBuffer<float>& buffer,
+    const juce::MidiBuffer& events)
 {
 	for (Plugin* p : plugins)
 	{
 		if (!p->valid || p->isSuspended() || p->isBypassed())
 			continue;
-		processPlugin(p, events);
+		processPlugin(p, buffer, events);
 	}
-	events.clear();
 }
 
 /* -------------------------------------------------------------------------- */
 
-void PluginHost::processPlugin(Plugin* p, const juce::MidiBuffer& events)
+void PluginHost::processPlugin(Plugin* p, juce::AudioBuffer<float>& buffer, const juce::MidiBuffer& events)
 {
-	const Plugin::Buffer& pluginBuffer = p->process(m_audioBuffer, events);
+	const Plugin::Buffer& pluginBuffer = p->process(buffer, events);
 	const bool            isInstrument = p->isInstrument();
 
 	/* Merge the plugin buffer back into the local one. Special care is needed
 	if audio channels mismatch. */
 
-	for (int i = 0, j = 0; i < m_audioBuffer.getNumChannels(); i++)
+	for (int i = 0, j = 0; i < buffer.getNumChannels(); i++)
 	{
 		/* If instrument (i.e. a plug-in that accepts MIDI and produces audio 
 		out of it), SUM the local working buffer to the main one. This allows
@@ -228,11 +304,20 @@ void PluginHost::processPlugin(Plugin* p, const juce::MidiBuffer& events)
 		working buffer is simply copied over the main one. */
 
 		if (isInstrument)
-			m_audioBuffer.addFrom(i, 0, pluginBuffer, j, 0, pluginBuffer.getNumSamples());
+			buffer.addFrom(i, 0, pluginBuffer, j, 0, pluginBuffer.getNumSamples());
 		else
-			m_audioBuffer.copyFrom(i, 0, pluginBuffer, j, 0, pluginBuffer.getNumSamples());
+			buffer.copyFrom(i, 0, pluginBuffer, j, 0, pluginBuffer.getNumSamples());
 		if (i < p->countMainOutChannels() - 1)
 			j++;
 	}
 }
+
+/* -------------------------------------------------------------------------- */
+
+void PluginHost::applyParamChange(const std::vector<Plugin*>& plugins, const ParamChange& change) const
+{
+	for (const Plugin* p : plugins)
+		if (p->id == change.pluginId && p->valid && change.paramIndex < p->getNumParameters())
+			p->automateParameter(change.paramIndex, change.value);
+}
 } // namespace giada::m
\ No newline at end of file
@@ -27,11 +27,14 @@
 #ifndef G_PLUGIN_HOST_H
 #define G_PLUGIN_HOST_H
 
+#include "core/const.h"
 #include "core/types.h"
+#include <array>
 #include <functional>
 #include <juce_audio_basics/juce_audio_basics.h>
 #include <juce_gui_basics/juce_gui_basics.h>
 #include <memory>
+#include <span>
 
 namespace mcl
 {
@@ -59,6 +62,13 @@ public:
 	public:
 		Info(const model::Sequencer&, int sampleRate);
 
+		/* setRenderFrame
+		Overrides the position reported to plug-ins processed by the calling 
+		thread with frame 'f' (-1 = the sequencer's current frame). Used when
+		rendering blocks ahead of time. */
+
+		static void setRenderFrame(Frame f);
+
 		juce::Optional<juce::AudioPlayHead::PositionInfo> getPosition() const override;
 		bool                                              canControlTransport() override;
 
@@ -67,6 +77,18 @@ public:
 		int                     m_sampleRate;
 	};
 
+	/* ParamChange
+	A plug-in parameter change that takes place 'delta' frames after the 
+	beginning of the current block. Used for parameter automation. */
+
+	struct ParamChange
+	{
+		ID    pluginId   = 0;
+		int   paramIndex = 0;
+		float value      = 0.0f;
+		Frame delta      = 0;
+	};
+
 	PluginHost(model::Model&);
 
 	/* reset
@@ -87,10 +109,14 @@ public:
 	const Plugin& addPlugin(std::unique_ptr<Plugin> p);
 
 	/* processStack
-	Applies the fx list to the buffer. */
+	Applies the fx list to the buffer. Parameter changes in 'paramChanges', 
+	sorted by delta, are applied with sample accuracy by splitting the block at
+	each change point. Stacks can be processed in parallel, as long as each
+	thread uses its own 'renderSlot' (see RenderAhead). */
 
 	void processStack(mcl::AudioBuffer& outBuf, const std::vector<Plugin*>& plugins,
-	    juce::MidiBuffer* events = nullptr);
+	    juce::MidiBuffer* events = nullptr, std::span<const ParamChange> paramChanges = {},
+	    int renderSlot = 0);
 
 	/* swapPlugin 
 	Swaps plug-in 1 with plug-in 2 in the plug-in vector. */
@@ -117,24 +143,50 @@ public:
 	void toggleBypass(ID pluginId);
 
 private:
+	/* Scratch
+	Working memory for processing a plug-in stack. One for each render slot. */
+
+	struct Scratch
+	{
+		juce::AudioBuffer<float> audioBuffer;
+
+		/* segmentEvents
+		MIDI events of the sub-block being processed by processSegments(), 
+		with timestamps relative to the sub-block itself. */
+
+		juce::MidiBuffer segmentEvents;
+	};
+
 	/* giadaToJuceTempBuf
-	Copies the Giada buffer 'outBuf' to the private JUCE buffer for local
+	Copies the Giada buffer 'outBuf' to the scratch JUCE buffer for local
 	processing. */
 
-	void giadaToJuceTempBuf(const mcl::AudioBuffer& outBuf);
+	void giadaToJuceTempBuf(const mcl::AudioBuffer& outBuf, Scratch&);
 
 	/* juceToGiadaOutBuf
-	Copies the private JUCE buffer to Giada buffer 'outBuf'. */
+	Copies the scratch JUCE buffer to Giada buffer 'outBuf'. */
 
-	void juceToGiadaOutBuf(mcl::AudioBuffer& outBuf) const;
+	void juceToGiadaOutBuf(mcl::AudioBuffer& outBuf, const Scratch&) const;
 
-	void processPlugins(const std::vector<Plugin*>&, juce::MidiBuffer& events);
+	/* processSegments
+	Processes the plug-in stack in sub-blocks, applying parameter changes at 
+	the beginning of each sub-block. */
 
-	void processPlugin(Plugin*, const juce::MidiBuffer& events);
+	void processSegments(const std::vector<Plugin*>&, const juce::MidiBuffer& events,
+	    std::span<const ParamChange>, Scratch&);
+
+	void processPlugins(const std::vector<Plugin*>&, juce::AudioBuffer<float>&, const juce::MidiBuffer& events);
+
+	void processPlugin(Plugin*, juce::AudioBuffer<float>&, const juce::MidiBuffer& events);
+
+	void applyParamChange(const std::vector<Plugin*>&, const ParamChange&) const;
 
 	model::Model& m_model;
 
-	juce::AudioBuffer<float> m_audioBuffer;
+	/* m_scratch
+	Slot 0 is for the audio thread, the others for the render-ahead workers. */
+
+	std::array<Scratch, G_MAX_RENDER_THREADS + 1> m_scratch;
 };
 } // namespace giada::m
 
@@ -33,17 +33,105 @@
 #include "utils/fs.h"
 #include "utils/log.h"
 #include "utils/string.h"
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cstddef>
 #include <memory>
+#include <thread>
 
 namespace giada::m
 {
+namespace
+{
+constexpr auto SKIPPED_TAG = "GIADA_SKIPPED";
+
+struct ScanJob
+{
+	juce::AudioPluginFormat*             format;
+	juce::String                         fileOrId;
+	juce::int64                          modTime;
+	std::vector<juce::PluginDescription> result;
+};
+
+/* -------------------------------------------------------------------------- */
+
+juce::int64 getModTime_(const juce::String& fileOrId)
+{
+	/* Some formats (e.g. AU) use identifiers instead of file paths. */
+
+	if (!juce::File::isAbsolutePath(fileOrId))
+		return 0;
+	const juce::File file(fileOrId);
+	return file.exists() ? file.getLastModificationTime().toMilliseconds() : 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* runWorker_
+Spawns a worker process that scans a single plug-in file. Descriptions found 
+are stored in the job's result. A crash, a timeout or a non-zero exit code 
+leave the result empty. */
+
+void runWorker_(ScanJob& job)
+{
+	const juce::String        exe = juce::File::getSpecialLocation(juce::File::currentExecutableFile).getFullPathName();
+	const juce::TemporaryFile out(".xml");
+
+	juce::StringArray args;
+	args.add(exe);
+	args.add(G_PLUGIN_SCAN_ARG);
+	args.add(job.format->getName());
+	args.add(job.fileOrId);
+	args.add(out.getFile().getFullPathName());
+
+	juce::ChildProcess worker;
+	if (!worker.start(args, /*streamFlags=*/0))
+	{
+		u::log::print("[pluginManager::scanDirs] unable to start worker for '{}'\n", job.fileOrId.toStdString());
+		return;
+	}
+
+	if (!worker.waitForProcessToFinish(G_PLUGIN_SCAN_TIMEOUT))
+	{
+		u::log::print("[pluginManager::scanDirs] '{}' timed out, skipped\n", job.fileOrId.toStdString());
+		worker.kill();
+		return;
+	}
+
+	if (worker.getExitCode() != 0)
+	{
+		u::log::print("[pluginManager::scanDirs] '{}' crashed or failed, skipped\n", job.fileOrId.toStdString());
+		return;
+	}
+
+	std::unique_ptr<juce::XmlElement> xml = juce::XmlDocument::parse(out.getFile());
+	if (xml == nullptr)
+		return;
+
+	for (const juce::XmlElement* e = xml->getFirstChildElement(); e != nullptr; e = e->getNextElement())
+	{
+		juce::PluginDescription pd;
+		if (pd.loadFromXml(*e))
+			job.result.push_back(pd);
+	}
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
 void PluginManager::reset(SortMethod sortMethod)
 {
 	pluginFactory::reset();
 
-	m_unknownPluginList.clear();
+	{
+		std::scoped_lock lock(m_unknownPluginListMutex);
+		m_unknownPluginList.clear();
+	}
+
 	if (m_formatManager.getNumFormats() == 0) // Must be called only once
 		m_formatManager.addDefaultFormats();
 
@@ -58,36 +146,143 @@ int PluginManager::scanDirs(const std::string& dirs, const std::function<void(fl
 	u::log::print("[pluginManager::scanDir] requested directories: '{}'\n", dirs);
 	u::log::print("[pluginManager::scanDir] currently known plug-ins: {}\n", m_knownPluginList.getNumTypes());
 
-	m_knownPluginList.clear(); // clear up previous plugins
-
 	std::vector<std::string> dirVec = u::string::split(dirs, ";");
 
 	juce::FileSearchPath searchPath;
 	for (const std::string& dir : dirVec)
 		searchPath.add(juce::File(dir));
 
+	/* Collect plug-in files from all formats. Files already known and not 
+	modified since the last scan are left untouched, the others become a job
+	for a worker process. */
+
+	std::vector<ScanJob> jobs;
+	juce::StringArray    found;
+
 	for (int i = 0; i < m_formatManager.getNumFormats(); i++)
 	{
-		juce::PluginDirectoryScanner scanner(m_knownPluginList, *m_formatManager.getFormat(i), searchPath,
-		    /*recursive=*/true, juce::File());
+		juce::AudioPluginFormat& format = *m_formatManager.getFormat(i);
+
+		for (const juce::String& fileOrId : format.searchPathsForPlugins(searchPath, /*recursive=*/true, /*allowAsync=*/false))
+		{
+			found.add(fileOrId);
+
+			const juce::int64 modTime = getModTime_(fileOrId);
+			const auto        skipped = m_skippedFiles.find(fileOrId.toStdString());
+
+			if (m_knownPluginList.isListingUpToDate(fileOrId, format))
+				continue;
+			if (skipped != m_skippedFiles.end() && skipped->second == modTime)
+				continue;
+
+			jobs.push_back({&format, fileOrId, modTime, {}});
+		}
+	}
+
+	/* Forget plug-ins that no longer exist in the requested directories. */
+
+	for (const juce::PluginDescription& pd : m_knownPluginList.getTypes())
+		if (!found.contains(pd.fileOrIdentifier))
+			m_knownPluginList.removeType(pd);
+	std::erase_if(m_skippedFiles, [&found](const auto& f) { return !found.contains(juce::String(f.first)); });
+
+	u::log::print("[pluginManager::scanDir] {} new or modified file(s) to scan\n", jobs.size());
+
+	/* Run jobs in parallel, one worker process at a time per thread. Progress
+	is reported from the calling thread. */
+
+	const std::size_t        numThreads = std::clamp<std::size_t>(std::thread::hardware_concurrency(), 1, std::max<std::size_t>(jobs.size(), 1));
+	std::atomic<std::size_t> next       = 0;
+	std::atomic<std::size_t> done       = 0;
+	std::vector<std::thread> threads;
+
+	for (std::size_t i = 0; i < numThreads; i++)
+		threads.emplace_back([&jobs, &next, &done]() {
+			for (std::size_t j = next++; j < jobs.size(); j = next++)
+			{
+				runWorker_(jobs[j]);
+				done++;
+			}
+		});
+
+	while (done < jobs.size())
+	{
+		cb(done / static_cast<float>(jobs.size()));
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+	}
+
+	for (std::thread& t : threads)
+		t.join();
+
+	/* Merge results. Stale descriptions of rescanned files are replaced. */
+
+	for (const ScanJob& job : jobs)
+	{
+		for (const juce::PluginDescription& pd : m_knownPluginList.getTypes())
+			if (pd.fileOrIdentifier == job.fileOrId)
+				m_knownPluginList.removeType(pd);
+
+		if (job.result.empty())
+		{
+			m_skippedFiles[job.fileOrId.toStdString()] = job.modTime;
+			continue;
+		}
 
-		juce::String name;
-		while (scanner.scanNextFile(false, name))
+		m_skippedFiles.erase(job.fileOrId.toStdString());
+		for (const juce::PluginDescription& pd : job.result)
 		{
-			u::log::print("[pluginManager::scanDir]   scanning '{}'\n", name.toRawUTF8());
-			cb(scanner.getProgress());
+			u::log::print("[pluginManager::scanDir]   found '{}'\n", pd.name.toStdString());
+			m_knownPluginList.addType(pd);
 		}
 	}
 
+	cb(1.0f);
+
 	u::log::print("[pluginManager::scanDir] {} plugin(s) found\n", m_knownPluginList.getNumTypes());
 	return m_knownPluginList.getNumTypes();
 }
 
 /* -------------------------------------------------------------------------- */
 
+int PluginManager::scanWorker(const std::string& formatName, const std::string& fileOrId,
+    const std::string& outFile)
+{
+	juce::AudioPluginFormatManager formatManager;
+	formatManager.addDefaultFormats();
+
+	for (int i = 0; i < formatManager.getNumFormats(); i++)
+	{
+		juce::AudioPluginFormat& format = *formatManager.getFormat(i);
+		if (format.getName() != juce::String(formatName))
+			continue;
+
+		juce::OwnedArray<juce::PluginDescription> found;
+		format.findAllTypesForFile(found, fileOrId);
+
+		juce::KnownPluginList list;
+		for (const juce::PluginDescription* pd : found)
+			list.addType(*pd);
+
+		return list.createXml()->writeTo(juce::File(outFile)) ? 0 : 1;
+	}
+
+	return 1;
+}
+
+/* -------------------------------------------------------------------------- */
+
 bool PluginManager::saveList(const std::string& filepath) const
 {
-	bool out = m_knownPluginList.createXml()->writeTo(juce::File(filepath));
+	std::unique_ptr<juce::XmlElement> elem = m_knownPluginList.createXml();
+
+	for (const auto& [file, modTime] : m_skippedFiles)
+	{
+		juce::XmlElement* skipped = elem->createNewChildElement(SKIPPED_TAG);
+		skipped->setAttribute("file", juce::String(file));
+		skipped->setAttribute("time", juce::String(modTime));
+	}
+
+	bool out = elem->writeTo(juce::File(filepath));
 	if (!out)
 		u::log::print("[pluginManager::saveList] unable to save plugin list to {}\n", filepath);
 	return out;
@@ -101,6 +296,11 @@ bool PluginManager::loadList(const std::string& filepath)
 	if (elem == nullptr)
 		return false;
 	m_knownPluginList.recreateFromXml(*elem);
+
+	m_skippedFiles.clear();
+	for (const juce::XmlElement* e = elem->getChildByName(SKIPPED_TAG); e != nullptr; e = e->getNextElementWithTagName(SKIPPED_TAG))
+		m_skippedFiles[e->getStringAttribute("file").toStdString()] = e->getStringAttribute("time").getLargeIntValue();
+
 	return true;
 }
 
@@ -183,6 +383,7 @@ std::vector<PluginManager::PluginInfo> PluginManager::getPluginsInfo() const
 		out.push_back(pi);
 	}
 
+	std::scoped_lock lock(m_unknownPluginListMutex);
 	for (const std::string& uid : m_unknownPluginList)
 	{
 		PluginInfo pi;
@@ -200,6 +401,7 @@ std::vector<PluginManager::PluginInfo> PluginManager::getPluginsInfo() const
 
 bool PluginManager::hasMissingPlugins() const
 {
+	std::scoped_lock lock(m_unknownPluginListMutex);
 	return !m_unknownPluginList.empty();
 }
 
@@ -232,6 +434,7 @@ std::unique_ptr<juce::AudioPluginInstance> PluginManager::makeJucePlugin(const s
 	if (pd == nullptr)
 	{
 		u::log::print("[pluginManager::makeJucePlugin] no plugin found with pid={}!\n", pid);
+		std::scoped_lock lock(m_unknownPluginListMutex);
 		m_unknownPluginList.push_back(pid);
 		return nullptr;
 	}
@@ -242,6 +445,7 @@ std::unique_ptr<juce::AudioPluginInstance> PluginManager::makeJucePlugin(const s
 	{
 		u::log::print("[pluginManager::makeJucePlugin] unable to create instance with pid={}! Error: {}\n",
 		    pid, error.toStdString());
+		std::scoped_lock lock(m_unknownPluginListMutex);
 		m_unknownPluginList.push_back(pid);
 		return nullptr;
 	}
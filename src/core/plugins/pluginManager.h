@@ -29,7 +29,9 @@
 
 #include "core/patch.h"
 #include "plugin.h"
+#include <map>
 #include <memory>
+#include <mutex>
 
 namespace giada::m::patch
 {
@@ -91,13 +93,25 @@ public:
 
 	/* scanDirs
 	Parses plugin directories (semicolon-separated) and store list in 
-	knownPluginList. The callback is called on each plugin found. Used to update
-	the main window from the GUI thread. */
+	knownPluginList. Only new or modified plug-in files are probed, each one in
+	a separate worker process so that a crashing plug-in can't take Giada down.
+	Workers run in parallel. The callback is called with the overall progress
+	from the calling thread. Used to update the main window from the GUI 
+	thread. */
 
 	int scanDirs(const std::string& paths, const std::function<void(float)>& cb);
 
+	/* scanWorker
+	Entry point of the worker process spawned by scanDirs(). Probes a single
+	plug-in file with the given format and writes the plug-ins found to 
+	'outFile' as XML. Returns the process exit code. */
+
+	static int scanWorker(const std::string& format, const std::string& fileOrId,
+	    const std::string& outFile);
+
 	/* (save|load)List
-	(Save|Load) knownPluginList (in|from) an XML file. */
+	(Save|Load) knownPluginList (in|from) an XML file, together with the list
+	of skipped files. */
 
 	bool saveList(const std::string& path) const;
 	bool loadList(const std::string& path);
@@ -129,9 +143,18 @@ private:
 	juce::KnownPluginList m_knownPluginList;
 
 	/* unknownPluginList
-	List of unrecognized plugins found in a patch. */
+	List of unrecognized plugins found in a patch. Guarded by a mutex, as 
+	patches can be loaded in background. */
 
 	std::vector<std::string> m_unknownPluginList;
+	mutable std::mutex       m_unknownPluginListMutex;
+
+	/* m_skippedFiles
+	Plug-in files that didn't produce any plug-in when scanned (crashed, timed
+	out or just empty), with their modification time. They won't be probed 
+	again until they change. */
+
+	std::map<std::string, juce::int64> m_skippedFiles;
 };
 } // namespace giada::m
 
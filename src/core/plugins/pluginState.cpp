@@ -28,6 +28,8 @@
 #include "core/const.h"
 #include "utils/log.h"
 #include <cstddef>
+#include <cstdint>
+#include <fmt/core.h>
 
 namespace giada::m
 {
@@ -47,20 +49,48 @@ PluginState::PluginState(const std::string& base64)
 
 /* -------------------------------------------------------------------------- */
 
+PluginState::PluginState(const juce::File& file)
+: m_file(std::make_shared<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly))
+{
+	if (m_file->getData() == nullptr)
+		G_DEBUG("Error while mapping plug-in state file!", );
+}
+
+/* -------------------------------------------------------------------------- */
+
 std::string PluginState::asBase64() const
 {
+	if (m_file != nullptr)
+		return juce::MemoryBlock(getData(), getSize()).toBase64Encoding().toStdString();
 	return m_data.toBase64Encoding().toStdString();
 }
 
 /* -------------------------------------------------------------------------- */
 
+std::string PluginState::getHash() const
+{
+	/* 64-bit FNV-1a, plus the size to make collisions even less likely. */
+
+	uint64_t       hash = 0xcbf29ce484222325;
+	const uint8_t* data = static_cast<const uint8_t*>(getData());
+
+	for (size_t i = 0; i < getSize(); i++)
+		hash = (hash ^ data[i]) * 0x100000001b3;
+
+	return fmt::format("{:016x}-{}", hash, getSize());
+}
+
+/* -------------------------------------------------------------------------- */
+
 const void* PluginState::getData() const
 {
-	return m_data.getData();
+	return m_file != nullptr ? m_file->getData() : m_data.getData();
 }
 
 size_t PluginState::getSize() const
 {
+	if (m_file != nullptr)
+		return m_file->getData() != nullptr ? m_file->getSize() : 0;
 	return m_data.getSize();
 }
 } // namespace giada::m
\ No newline at end of file
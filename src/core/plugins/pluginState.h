@@ -29,6 +29,7 @@
 
 #include <cstddef>
 #include <juce_core/juce_core.h>
+#include <memory>
 #include <string>
 
 namespace giada::m
@@ -40,12 +41,26 @@ public:
 	PluginState(juce::MemoryBlock&& data);
 	PluginState(const std::string& base64);
 
+	/* PluginState
+	Maps a binary state file in memory. Nothing is read upfront: pages are
+	loaded from disk on demand, as the plug-in goes through the data. */
+
+	PluginState(const juce::File&);
+
 	std::string asBase64() const;
+
+	/* getHash
+	Returns a hex digest of the state content. Identical states share the same
+	hash. */
+
+	std::string getHash() const;
+
 	const void* getData() const;
 	size_t      getSize() const;
 
 private:
-	juce::MemoryBlock m_data;
+	juce::MemoryBlock                       m_data;
+	std::shared_ptr<juce::MemoryMappedFile> m_file;
 };
 } // namespace giada::m
 
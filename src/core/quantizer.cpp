@@ -45,7 +45,7 @@ void Quantizer::schedule(int id, std::function<void(Frame delta)> f)
 
 /* -------------------------------------------------------------------------- */
 
-void Quantizer::advance(Range<Frame> block, Frame quantizerStep) const
+void Quantizer::advance(Range<Frame> block, Frame quantizerStep, Frame bufferSize) const
 {
 	/* Nothing to do if there's no action to perform. */
 
@@ -56,13 +56,17 @@ void Quantizer::advance(Range<Frame> block, Frame quantizerStep) const
 
 	assert(m_callbacks.count(pid) > 0);
 
-	for (Frame global = block.getBegin(), local = 0; global < block.getEnd(); global++, local++)
+	const Frame length = block.getLength();
+	if (bufferSize == 0)
+		bufferSize = length;
+
+	for (Frame global = block.getBegin(), i = 0; global < block.getEnd(); global++, i++)
 	{
 
 		if (global % quantizerStep != 0) // Skip if it's not on a quantization unit.
 			continue;
 
-		m_callbacks.at(pid)(local);
+		m_callbacks.at(pid)(i * bufferSize / length);
 		m_performId.store(-1);
 		return;
 	}
@@ -54,9 +54,11 @@ public:
 	/* advance
 	Computes the internal state. Wants a range of frames [currentFrame, 
 	currentFrame + bufferSize) and a quantization step. Call this function
-	on each block. */
+	on each block. If the range is longer or shorter than the audio block (the
+	sequencer is catching up or slowing down), pass the actual 'bufferSize': 
+	offsets given to callbacks are scaled so that they stay inside the block. */
 
-	void advance(Range<Frame> block, Frame quantizerStep) const;
+	void advance(Range<Frame> block, Frame quantizerStep, Frame bufferSize = 0) const;
 
 	/* clear
 	Disables quantized operations in progress, if any. */
@@ -62,6 +62,11 @@ public:
 		return true;
 	}
 
+	bool isEmpty() const
+	{
+		return m_head.load() == m_tail.load();
+	}
+
 	bool push(const T& item)
 	{
 		std::size_t curr = m_tail.load();
@@ -0,0 +1,503 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#include "core/renderAhead.h"
+#include "core/channels/channel.h"
+#include "core/channels/channelShared.h"
+#include "core/const.h"
+#include "core/model/model.h"
+#include "core/plugins/plugin.h"
+#include "core/plugins/pluginHost.h"
+#include "core/sequencer.h"
+#include "core/wave.h"
+#include "utils/log.h"
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <utility>
+#if defined(G_OS_WINDOWS)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace giada::m
+{
+namespace
+{
+/* HOLD_BLOCKS
+Number of blocks a channel is rendered in the callback after its lane has been
+invalidated, before handing it over to workers again. Keeps channels played 
+live from bouncing between the callback and the workers. */
+
+constexpr int HOLD_BLOCKS = 32;
+
+/* -------------------------------------------------------------------------- */
+
+/* hash_
+FNV-1a over the 8 bytes of 'v'. */
+
+uint64_t hash_(uint64_t h, uint64_t v)
+{
+	for (int i = 0; i < 8; i++)
+	{
+		h ^= (v >> (i * 8)) & 0xFF;
+		h *= 1099511628211ULL;
+	}
+	return h;
+}
+
+template <typename T>
+uint64_t bits_(T v)
+{
+	static_assert(sizeof(T) <= sizeof(uint64_t));
+	uint64_t out = 0;
+	std::memcpy(&out, &v, sizeof(T));
+	return out;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* makeKey_
+Fingerprint of everything a block rendered ahead depends on, besides the 
+channel state: wave, player settings, plug-ins, sequencer and actions. */
+
+uint64_t makeKey_(const Channel& ch, const model::Layout& layout)
+{
+	const SamplePlayer&     player    = *ch.samplePlayer;
+	const model::Sequencer& sequencer = layout.sequencer;
+	const Wave*             wave      = player.getWave();
+
+	uint64_t key = 14695981039346656037ULL;
+
+	key = hash_(key, bits_(wave));
+	key = hash_(key, bits_(wave->getRevision()));
+	key = hash_(key, bits_(player.pitch));
+	key = hash_(key, bits_(player.mode));
+	key = hash_(key, bits_(player.begin));
+	key = hash_(key, bits_(player.end));
+	key = hash_(key, bits_(player.shift));
+	for (const Plugin* p : ch.plugins)
+	{
+		key = hash_(key, bits_(p));
+		key = hash_(key, bits_(p->getRevision()));
+	}
+	key = hash_(key, bits_(sequencer.framesInLoop));
+	key = hash_(key, bits_(sequencer.framesInBar));
+	key = hash_(key, bits_(sequencer.framesInBeat));
+	key = hash_(key, bits_(sequencer.bpm));
+	key = hash_(key, bits_(layout.actions.getRevision()));
+	key = hash_(key, bits_(ch.shared->audioBuffer.countFrames()));
+
+	return key;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* isEligible_
+Channels that react to something other than the sequencer (input audio, live
+commands) are always rendered in the callback. */
+
+bool isEligible_(const Channel& ch, const model::Layout& layout)
+{
+	return ch.type == ChannelType::SAMPLE &&
+	       ch.shared->renderLane &&
+	       ch.hasWave() &&
+	       !ch.armed &&
+	       !(ch.audioReceiver && ch.audioReceiver->inputMonitor) &&
+	       layout.sequencer.framesInLoop > ch.shared->audioBuffer.countFrames();
+}
+
+/* -------------------------------------------------------------------------- */
+
+RenderLane::State getState_(const ChannelShared& s)
+{
+	return {s.tracker.load(), s.playStatus.load(), s.recStatus.load(), s.readActions.load()};
+}
+
+/* setState_
+Writes the state that differs from 'prev' only, so that listeners are not 
+notified for nothing. The tracker moves on every block anyway. */
+
+void setState_(ChannelShared& s, const RenderLane::State& state, const RenderLane::State& prev)
+{
+	s.tracker.store(state.tracker);
+	if (state.playStatus != prev.playStatus)
+		s.playStatus.store(state.playStatus);
+	if (state.recStatus != prev.recStatus)
+		s.recStatus.store(state.recStatus);
+	if (state.readActions != prev.readActions)
+		s.readActions.store(state.readActions);
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+struct RenderAhead::Scratch
+{
+	Sequencer::EventBuffer         events;
+	std::unique_ptr<ChannelShared> shadow;
+	mcl::AudioBuffer               in;
+};
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+RenderAhead::RenderAhead(model::Model& m)
+: m_model(m)
+, m_running(false)
+, m_suspended(false)
+, m_signaled(false)
+, m_busy(0)
+, m_policy(0)
+, m_priority(0)
+, m_priorityRevision(0)
+, m_priorityPending(false)
+, m_work(false)
+, m_handedOver(false)
+{
+}
+
+/* -------------------------------------------------------------------------- */
+
+RenderAhead::~RenderAhead()
+{
+	stop();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void RenderAhead::start(int numWorkers)
+{
+	assert(m_workers.empty());
+
+	m_running.store(true);
+	m_priorityPending.store(true);
+	for (int slot = 1; slot <= numWorkers; slot++)
+		m_workers.emplace_back([this, slot]() { work(slot); });
+}
+
+/* -------------------------------------------------------------------------- */
+
+void RenderAhead::stop()
+{
+	m_running.store(false);
+	for (std::size_t i = 0; i < m_workers.size(); i++)
+		m_wake.release();
+	for (std::thread& t : m_workers)
+		t.join();
+	m_workers.clear();
+}
+
+/* -------------------------------------------------------------------------- */
+
+int RenderAhead::countWorkers() const
+{
+	return static_cast<int>(m_workers.size());
+}
+
+/* -------------------------------------------------------------------------- */
+
+void RenderAhead::suspend()
+{
+	m_suspended.store(true);
+	while (m_busy.load() > 0)
+		std::this_thread::yield();
+}
+
+void RenderAhead::resume()
+{
+	m_priorityPending.store(true);
+	m_suspended.store(false);
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool RenderAhead::consume(const Channel& ch, Frame blockStart, const model::Layout& layout, bool steady)
+{
+	if (!ch.shared->renderLane)
+		return false;
+
+	ChannelShared& shared = *ch.shared;
+	RenderLane&    lane   = *shared.renderLane;
+
+	if (lane.getOwner() == RenderLane::Owner::AUDIO)
+		return false;
+
+	m_work = true;
+
+	/* The lane is empty: a worker might be busy with this very block. If it
+	doesn't finish in time, neither the lane nor the channel can be touched: 
+	see renderChannels() in Mixer. */
+
+	const RenderLane::Block* block = lane.front();
+	if (block == nullptr)
+	{
+		if (!lane.wait())
+			return false;
+		block = lane.front();
+	}
+
+	/* Check the renderQueue before the state: live commands change the state
+	first, then push their render command. */
+
+	const bool valid = block != nullptr &&
+	                   steady &&
+	                   block->frame == blockStart &&
+	                   shared.renderQueue->isEmpty() &&
+	                   !(shared.quantizer && shared.quantizer->hasBeenTriggered()) &&
+	                   block->begin == getState_(shared) &&
+	                   isEligible_(ch, layout) &&
+	                   block->key == makeKey_(ch, layout);
+
+	if (!valid)
+	{
+		/* A lane found empty is just late, not invalid: take it back for this
+		block and hand it over again right away. */
+
+		if (block != nullptr)
+			lane.hold = HOLD_BLOCKS;
+		if (lane.reclaim())
+			lane.flush();
+		return false;
+	}
+
+	shared.audioBuffer.set(block->audio, /*gain=*/1.0f);
+	setState_(shared, block->end, block->begin);
+	lane.pop();
+	lane.rendered = true;
+
+	/* No need to advance the quantizer: it has nothing to fire (see above). 
+	Anything triggered from now on invalidates the next block. */
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool RenderAhead::takeRendered(const Channel& ch) const
+{
+	if (!ch.shared->renderLane)
+		return false;
+	return std::exchange(ch.shared->renderLane->rendered, false);
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool RenderAhead::reclaim(const Channel& ch) const
+{
+	return !ch.shared->renderLane || ch.shared->renderLane->reclaim();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void RenderAhead::handOver(const Channel& ch, Frame nextFrame, const model::Layout& layout)
+{
+	if (m_workers.empty() || !ch.shared->renderLane)
+		return;
+
+	RenderLane& lane = *ch.shared->renderLane;
+
+	if (lane.getOwner() != RenderLane::Owner::AUDIO)
+		return;
+	if (lane.hold > 0)
+	{
+		lane.hold--;
+		return;
+	}
+
+	/* Hand over one lane per block: workers start from an empty lane and need
+	some time to catch up. */
+
+	if (m_handedOver || !isEligible_(ch, layout))
+		return;
+
+	lane.handOver({nextFrame, getState_(*ch.shared)});
+	m_handedOver = true;
+	m_work       = true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void RenderAhead::endBlock()
+{
+	if (m_priorityPending.exchange(false))
+		inheritPriority();
+
+	/* Wake up workers once, until one of them has seen the signal. */
+
+	if (m_work && !m_signaled.exchange(true))
+		for (std::size_t i = 0; i < m_workers.size(); i++)
+			m_wake.release();
+
+	m_work       = false;
+	m_handedOver = false;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void RenderAhead::work(int slot)
+{
+	if (!m_model.registerThread(Thread::RENDER, /*realtime=*/true))
+	{
+		u::log::print("[RenderAhead::work] Can't register render thread {}!\n", slot);
+		return;
+	}
+
+	Scratch scratch;
+	int     priorityRevision = 0;
+
+	while (true)
+	{
+		m_wake.acquire();
+		m_signaled.store(false);
+
+		if (m_running.load() == false)
+			return;
+
+		if (const int r = m_priorityRevision.load(); r != priorityRevision)
+		{
+			applyPriority();
+			priorityRevision = r;
+		}
+
+		m_busy.fetch_add(1);
+		while (!m_suspended.load() && m_running.load() && renderPass(slot, scratch))
+			;
+		m_busy.fetch_sub(1);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool RenderAhead::renderPass(int slot, Scratch& scratch)
+{
+	bool rendered = false;
+
+	/* Lock the layout once per channel, so that the main thread never waits 
+	for a whole pass when swapping it. */
+
+	for (std::size_t i = 0;; i++)
+	{
+		const model::LayoutLock lock   = m_model.get_RT();
+		const model::Layout&    layout = lock.get();
+
+		const std::vector<Channel>& channels = layout.channels.getAll();
+		if (i >= channels.size())
+			break;
+		if (layout.locked || !layout.sequencer.isRunning())
+			return false;
+
+		const Channel& ch = channels[i];
+		if (!ch.shared->renderLane || ch.shared->renderLane->isFull())
+			continue;
+
+		RenderLane& lane = *ch.shared->renderLane;
+		if (!lane.tryAcquire())
+			continue;
+
+		if (!isEligible_(ch, layout))
+		{
+			lane.release();
+			continue;
+		}
+
+		/* Render one block on the shadow state, then publish it. */
+
+		const Frame bufferSize = ch.shared->audioBuffer.countFrames();
+
+		if (scratch.shadow == nullptr || scratch.shadow->audioBuffer.countFrames() != bufferSize)
+		{
+			scratch.shadow = std::make_unique<ChannelShared>(bufferSize);
+			scratch.shadow->renderQueue.emplace();
+		}
+
+		ChannelShared&           shadow = *scratch.shadow;
+		RenderLane::Block&       block  = lane.back();
+		const RenderLane::Cursor cursor = lane.cursor;
+
+		shadow.tracker.store(cursor.state.tracker);
+		shadow.playStatus.store(cursor.state.playStatus);
+		shadow.recStatus.store(cursor.state.recStatus);
+		shadow.readActions.store(cursor.state.readActions);
+
+		Sequencer::collectEvents(scratch.events, layout.sequencer, layout.actions, cursor.frame, bufferSize);
+
+		ch.advance(shadow, scratch.events, {cursor.frame, cursor.frame + bufferSize}, /*quantizerStep=*/0);
+		PluginHost::Info::setRenderFrame(cursor.frame);
+		ch.process(shadow, scratch.in, /*seqIsRunning=*/true, slot);
+		PluginHost::Info::setRenderFrame(-1);
+
+		block.frame = cursor.frame;
+		block.key   = makeKey_(ch, layout);
+		block.begin = cursor.state;
+		block.end   = getState_(shadow);
+		block.audio.set(shadow.audioBuffer, /*gain=*/1.0f);
+
+		lane.cursor = {(cursor.frame + bufferSize) % layout.sequencer.framesInLoop, block.end};
+		lane.push();
+		lane.release();
+
+		rendered = true;
+	}
+
+	return rendered;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void RenderAhead::inheritPriority()
+{
+#if defined(G_OS_WINDOWS)
+	m_priority.store(GetThreadPriority(GetCurrentThread()));
+#else
+	int         policy;
+	sched_param param;
+	if (pthread_getschedparam(pthread_self(), &policy, &param) != 0)
+		return;
+	m_policy.store(policy);
+	m_priority.store(param.sched_priority);
+#endif
+	m_priorityRevision.fetch_add(1);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void RenderAhead::applyPriority()
+{
+#if defined(G_OS_WINDOWS)
+	SetThreadPriority(GetCurrentThread(), m_priority.load());
+#else
+	sched_param param{};
+	param.sched_priority = m_priority.load();
+	pthread_setschedparam(pthread_self(), m_policy.load(), &param);
+#endif
+}
+} // namespace giada::m
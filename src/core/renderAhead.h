@@ -0,0 +1,166 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef G_RENDER_AHEAD_H
+#define G_RENDER_AHEAD_H
+
+#include "core/semaphore.h"
+#include "core/types.h"
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace giada::m::model
+{
+class Model;
+struct Layout;
+} // namespace giada::m::model
+
+namespace giada::m
+{
+class Channel;
+class RenderAhead
+{
+public:
+	RenderAhead(model::Model&);
+	~RenderAhead();
+
+	RenderAhead(const RenderAhead&)            = delete;
+	RenderAhead(RenderAhead&&)                 = delete;
+	RenderAhead& operator=(const RenderAhead&) = delete;
+	RenderAhead& operator=(RenderAhead&&)      = delete;
+
+	/* start, stop
+	Spawns or joins the worker threads. Not realtime-safe: call them only when
+	the mixer is disabled. */
+
+	void start(int numWorkers);
+	void stop();
+
+	int countWorkers() const;
+
+	/* suspend, resume
+	Stop and restart rendering ahead. suspend() returns when no worker is busy
+	anymore. Call them from the main thread when disabling and enabling the 
+	mixer. */
+
+	void suspend();
+	void resume();
+
+	/* consume [audio thread]
+	Takes the block starting on 'blockStart' from the channel lane, if there is
+	one and it's still valid: it has been rendered with the current settings and
+	the channel has received no live commands in the meantime. The block 
+	replaces the advance() and process() calls for this channel. 'steady' 
+	tells whether the sequencer has moved forward linearly in this block. 
+	Returns false if the channel must be rendered in the callback as usual. */
+
+	bool consume(const Channel&, Frame blockStart, const model::Layout&, bool steady);
+
+	/* takeRendered [audio thread]
+	Returns true if the current block of the channel has already been taken 
+	from the lane by consume(). Resets the flag for the next block. */
+
+	bool takeRendered(const Channel&) const;
+
+	/* reclaim [audio thread]
+	Takes the lane back from workers, before the channel is rendered in the 
+	callback. Returns false if a worker is still busy with it. */
+
+	bool reclaim(const Channel&) const;
+
+	/* handOver [audio thread]
+	Lets workers render the channel ahead, starting from sequencer frame
+	'nextFrame', if the channel is eligible and hasn't been invalidated 
+	recently. */
+
+	void handOver(const Channel&, Frame nextFrame, const model::Layout&);
+
+	/* endBlock [audio thread]
+	Call this at the end of each block: wakes up workers if there's work to 
+	do. */
+
+	void endBlock();
+
+private:
+	/* Scratch
+	Working memory of a worker thread. */
+
+	struct Scratch;
+
+	/* work
+	Main loop of a worker thread. */
+
+	void work(int slot);
+
+	/* renderPass
+	Renders one block ahead for each channel that needs it. Returns false if 
+	there was nothing to render. */
+
+	bool renderPass(int slot, Scratch&);
+
+	/* inheritPriority
+	Reads the scheduling priority of the calling thread (i.e. the audio one)
+	and publishes it to workers. */
+
+	void inheritPriority();
+
+	/* applyPriority
+	Gives the calling thread (a worker) the priority inherited from the audio
+	thread. Best effort: fails silently without the required privileges. */
+
+	void applyPriority();
+
+	model::Model& m_model;
+
+	std::vector<std::thread> m_workers;
+	Semaphore                m_wake;
+	std::atomic<bool>        m_running;
+	std::atomic<bool>        m_suspended;
+	std::atomic<bool>        m_signaled;
+	std::atomic<int>         m_busy;
+
+	/* m_policy, m_priority, m_priorityRevision
+	Scheduling settings of the audio thread, read once after each start or 
+	resume, when m_priorityPending is set. Workers apply them again when
+	m_priorityRevision changes. */
+
+	std::atomic<int>  m_policy;
+	std::atomic<int>  m_priority;
+	std::atomic<int>  m_priorityRevision;
+	std::atomic<bool> m_priorityPending;
+
+	/* m_work, m_handedOver
+	Whether something has been consumed or handed over in the current block,
+	and whether a lane has been handed over already. Audio thread only. */
+
+	bool m_work;
+	bool m_handedOver;
+};
+} // namespace giada::m
+
+#endif
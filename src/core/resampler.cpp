@@ -37,6 +37,8 @@ namespace giada::m
 Resampler::Resampler()
 : m_state(nullptr)
 , m_input(nullptr)
+, m_reader(nullptr)
+, m_context(nullptr)
 , m_inputPos(0)
 , m_inputLength(0)
 , m_channels(0)
@@ -114,11 +116,6 @@ long Resampler::callback(float** audio)
 {
 	assert(audio != nullptr);
 
-	/* Move pointer properly, taking into account read data and number of 
-	channels in input data. */
-
-	*audio = m_input + (m_inputPos * m_channels);
-
 	/* Returns how many frames have been read in this callback shot. */
 
 	long frames;
@@ -130,6 +127,19 @@ long Resampler::callback(float** audio)
 	else
 		frames = m_inputLength - m_inputPos;
 
+	/* Move pointer properly, taking into account read data and number of 
+	channels in input data. With a Reader, never read past the end of the 
+	contiguous block it returns. */
+
+	if (m_reader != nullptr)
+	{
+		const Input input = m_reader(m_context, m_inputPos);
+		*audio            = const_cast<float*>(input.data);
+		frames            = std::min(frames, input.length);
+	}
+	else
+		*audio = m_input + (m_inputPos * m_channels);
+
 	m_usedFrames += frames;
 	m_inputPos += frames;
 
@@ -158,6 +168,27 @@ Resampler::Result Resampler::process(float* input, long inputPos, long inputLeng
 	assert(m_state != nullptr); // Must be initialized first!
 
 	m_input       = input;
+	m_reader      = nullptr;
+	m_inputPos    = inputPos;
+	m_inputLength = inputLength;
+	m_usedFrames  = 0;
+
+	long generated = src_callback_read(m_state, 1 / ratio, outputLength, output);
+
+	return {m_usedFrames, generated};
+}
+
+/* -------------------------------------------------------------------------- */
+
+Resampler::Result Resampler::process(Reader reader, const void* context, long inputPos,
+    long inputLength, float* output, long outputLength, float ratio)
+{
+	assert(m_state != nullptr); // Must be initialized first!
+	assert(reader != nullptr);
+
+	m_input       = nullptr;
+	m_reader      = reader;
+	m_context     = context;
 	m_inputPos    = inputPos;
 	m_inputLength = inputLength;
 	m_usedFrames  = 0;
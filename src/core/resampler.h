@@ -53,6 +53,21 @@ public:
 		long used, generated;
 	};
 
+	/* Input
+	A contiguous block of interleaved input frames, as returned by a Reader. */
+
+	struct Input
+	{
+		const float* data;
+		long         length;
+	};
+
+	/* Reader
+	Function that returns the contiguous block of input frames starting at 
+	'pos'. Allows reading input data scattered across multiple buffers. */
+
+	using Reader = Input (*)(const void* context, long pos);
+
 	Resampler(); // Invalid
 	Resampler(Quality quality, int channels);
 	Resampler(const Resampler& o);
@@ -68,6 +83,12 @@ public:
 	Result process(float* input, long inputPos, long inputLength, float* output,
 	    long outputLength, float ratio);
 
+	/* process (2)
+	Same as above, with input data provided by 'reader' instead. */
+
+	Result process(Reader reader, const void* context, long inputPos, long inputLength,
+	    float* output, long outputLength, float ratio);
+
 	/* last
 	Call this when you are about to process the last chunk of data. */
 
@@ -84,13 +105,15 @@ private:
 
 	static constexpr int CHUNK_LEN = 256;
 
-	SRC_STATE* m_state;
-	Quality    m_quality;
-	float*     m_input;       // Pointer to input data
-	long       m_inputPos;    // Where to read from input
-	long       m_inputLength; // Total number of frames in input data
-	int        m_channels;    // Number of channels
-	long       m_usedFrames;  // How many frames have been read from input with a process() call
+	SRC_STATE*  m_state;
+	Quality     m_quality;
+	float*      m_input;       // Pointer to input data
+	Reader      m_reader;      // Input data reader, alternative to m_input
+	const void* m_context;     // Context passed to m_reader
+	long        m_inputPos;    // Where to read from input
+	long        m_inputLength; // Total number of frames in input data
+	int         m_channels;    // Number of channels
+	long        m_usedFrames;  // How many frames have been read from input with a process() call
 };
 } // namespace giada::m
 
@@ -0,0 +1,244 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#include "core/scheduler.h"
+#include <algorithm>
+#include <cassert>
+
+namespace giada
+{
+namespace
+{
+int64_t toNanos_(Scheduler::Clock::time_point t)
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+Scheduler::Task::Task(std::string name, std::function<void()> func)
+: name(name)
+, func(func)
+, pending(false)
+, notifiedAt(0)
+, deadline(Clock::time_point::max())
+, runs(0)
+, latencySumUs(0.0)
+, maxLatencyUs(0.0)
+{
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+Scheduler::Scheduler()
+: m_running(false)
+, m_wakeups(0)
+{
+}
+
+/* -------------------------------------------------------------------------- */
+
+Scheduler::~Scheduler()
+{
+	stop();
+}
+
+/* -------------------------------------------------------------------------- */
+
+Scheduler::TaskId Scheduler::addTask(std::string name, std::function<void()> f)
+{
+	assert(m_running.load() == false);
+
+	m_tasks.push_back(std::make_unique<Task>(name, f));
+	return m_tasks.size() - 1;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Scheduler::start()
+{
+	if (m_running.load() == true)
+		return;
+	m_running.store(true);
+	m_thread = std::thread([this]() { process(); });
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Scheduler::stop()
+{
+	m_running.store(false);
+	m_signal.release();
+	if (m_thread.joinable())
+		m_thread.join();
+
+	m_timers = {};
+	for (std::unique_ptr<Task>& task : m_tasks)
+	{
+		task->pending.store(false);
+		task->notifiedAt.store(0);
+		task->deadline = Clock::time_point::max();
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Scheduler::notify(TaskId id)
+{
+	assert(id < m_tasks.size());
+
+	Task& task = *m_tasks[id];
+
+	/* Only the first notification since the last run is timestamped, so that
+	the latency is measured from the oldest request. */
+
+	int64_t none = 0;
+	task.notifiedAt.compare_exchange_strong(none, toNanos_(Clock::now()));
+	task.pending.store(true);
+	m_signal.release();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Scheduler::notifyAt(TaskId id, Clock::time_point time)
+{
+	assert(id < m_tasks.size());
+	assert(std::this_thread::get_id() == m_thread.get_id());
+
+	Task& task = *m_tasks[id];
+	if (time >= task.deadline)
+		return;
+	task.deadline = time;
+	m_timers.push({time, id});
+}
+
+/* -------------------------------------------------------------------------- */
+
+Scheduler::Stats Scheduler::getStats() const
+{
+	Stats stats;
+	stats.wakeups = m_wakeups.load();
+	for (const std::unique_ptr<Task>& task : m_tasks)
+	{
+		const uint64_t runs = task->runs.load();
+		stats.tasks.push_back({
+		    task->name,
+		    runs,
+		    runs > 0 ? task->latencySumUs.load() / runs : 0.0,
+		    task->maxLatencyUs.load()});
+	}
+	return stats;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Scheduler::process()
+{
+	while (true)
+	{
+		wait();
+		if (m_running.load() == false)
+			return;
+		m_wakeups.fetch_add(1, std::memory_order_relaxed);
+		runTimers();
+		runNotified();
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Scheduler::wait()
+{
+	/* Get rid of stale timers first, so that a superseded deadline doesn't
+	cause a useless wakeup. */
+
+	while (!m_timers.empty() && m_timers.top().time != m_tasks[m_timers.top().taskId]->deadline)
+		m_timers.pop();
+
+	if (m_timers.empty())
+	{
+		m_signal.acquire();
+		return;
+	}
+
+	const Clock::duration timeout = m_timers.top().time - Clock::now();
+	if (timeout > Clock::duration::zero())
+		m_signal.tryAcquireFor(std::chrono::ceil<std::chrono::microseconds>(timeout));
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Scheduler::runTimers()
+{
+	const Clock::time_point now = Clock::now();
+
+	while (!m_timers.empty() && m_timers.top().time <= now)
+	{
+		const Timer timer = m_timers.top();
+		m_timers.pop();
+
+		Task& task = *m_tasks[timer.taskId];
+		if (task.deadline != timer.time) // Stale
+			continue;
+		task.deadline = Clock::time_point::max();
+		run(task, Clock::now() - timer.time);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Scheduler::runNotified()
+{
+	for (std::unique_ptr<Task>& task : m_tasks)
+	{
+		if (!task->pending.exchange(false))
+			continue;
+		const int64_t notifiedAt = task->notifiedAt.exchange(0);
+		const int64_t latency    = notifiedAt > 0 ? toNanos_(Clock::now()) - notifiedAt : 0;
+		run(*task, std::chrono::nanoseconds(latency));
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Scheduler::run(Task& task, Clock::duration latency)
+{
+	task.func();
+
+	const double latencyUs = std::chrono::duration<double, std::micro>(latency).count();
+
+	/* Single writer (the scheduler thread): plain load/store pairs are enough. */
+
+	task.runs.store(task.runs.load() + 1);
+	task.latencySumUs.store(task.latencySumUs.load() + latencyUs);
+	task.maxLatencyUs.store(std::max(task.maxLatencyUs.load(), latencyUs));
+}
+} // namespace giada
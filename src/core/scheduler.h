@@ -0,0 +1,159 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef G_SCHEDULER_H
+#define G_SCHEDULER_H
+
+#include "core/semaphore.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace giada
+{
+/* Scheduler
+Single thread shared by all the non-realtime engine services that used to spin 
+in their own polling loop. Services register a task once and then either wake 
+it up on demand with notify() or schedule it for a later time with notifyAt(). 
+The thread sleeps on a semaphore in between, so an idle engine doesn't wake up
+at all. */
+
+class Scheduler
+{
+public:
+	using TaskId = std::size_t;
+	using Clock  = std::chrono::steady_clock;
+
+	/* TaskStats
+	Latency is the distance, in microseconds, between the moment a task has been
+	notified (or its deadline) and the moment it actually started running. */
+
+	struct TaskStats
+	{
+		std::string name;
+		uint64_t    runs         = 0;
+		double      avgLatencyUs = 0.0;
+		double      maxLatencyUs = 0.0;
+	};
+
+	struct Stats
+	{
+		uint64_t               wakeups = 0;
+		std::vector<TaskStats> tasks;
+	};
+
+	Scheduler();
+	~Scheduler();
+
+	/* addTask
+	Registers a new task and returns its id. Must be called before start(). */
+
+	TaskId addTask(std::string name, std::function<void()>);
+
+	/* start, stop
+	Starts or stops the internal thread. Pending notifications and timers are 
+	discarded on stop. */
+
+	void start();
+	void stop();
+
+	/* notify
+	Asks the scheduler to run the task as soon as possible. Multiple 
+	notifications before the task runs are merged into a single run. 
+	Realtime-safe. */
+
+	void notify(TaskId);
+
+	/* notifyAt
+	Asks the scheduler to run the task at the given time. Only the earliest 
+	timer per task is kept. Call this from within a task, i.e. on the scheduler 
+	thread. */
+
+	void notifyAt(TaskId, Clock::time_point);
+
+	Stats getStats() const;
+
+private:
+	struct Task
+	{
+		Task(std::string name, std::function<void()>);
+
+		std::string           name;
+		std::function<void()> func;
+
+		/* pending, notifiedAt
+		Set by notify(). 'notifiedAt' holds the time of the first notification
+		not yet served, in nanoseconds since the clock epoch. */
+
+		std::atomic<bool>    pending;
+		std::atomic<int64_t> notifiedAt;
+
+		/* deadline
+		Earliest timer set with notifyAt(). Scheduler thread only. */
+
+		Clock::time_point deadline;
+
+		std::atomic<uint64_t> runs;
+		std::atomic<double>   latencySumUs;
+		std::atomic<double>   maxLatencyUs;
+	};
+
+	struct Timer
+	{
+		Clock::time_point time;
+		TaskId            taskId;
+
+		bool operator>(const Timer& o) const { return time > o.time; }
+	};
+
+	void process();
+	void wait();
+	void runTimers();
+	void runNotified();
+	void run(Task&, Clock::duration latency);
+
+	std::vector<std::unique_ptr<Task>> m_tasks;
+
+	/* m_timers
+	Deadline-ordered timers. Stale entries (i.e. superseded by an earlier 
+	notifyAt() on the same task) are skipped when popped. */
+
+	std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> m_timers;
+
+	std::thread           m_thread;
+	std::atomic<bool>     m_running;
+	Semaphore             m_signal;
+	std::atomic<uint64_t> m_wakeups;
+};
+} // namespace giada
+
+#endif
@@ -0,0 +1,191 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#include "core/semaphore.h"
+#include "core/const.h"
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#if defined(G_OS_WINDOWS)
+#include <windows.h>
+#include <timeapi.h>
+#elif defined(G_OS_MAC)
+#include <dispatch/dispatch.h>
+#else
+#include <cerrno>
+#include <ctime>
+#include <semaphore.h>
+#endif
+
+namespace giada
+{
+#if defined(G_OS_WINDOWS)
+
+/* Timed waits are rounded to the system timer resolution, ~15.6 ms by default:
+ask for 1 ms while at least one Semaphore is alive. Calls are reference 
+counted by the OS. */
+
+Semaphore::Semaphore()
+: m_handle(CreateSemaphore(nullptr, 0, LONG_MAX, nullptr))
+{
+	assert(m_handle != nullptr);
+	timeBeginPeriod(1);
+}
+
+Semaphore::~Semaphore()
+{
+	CloseHandle(m_handle);
+	timeEndPeriod(1);
+}
+
+void Semaphore::release() { ReleaseSemaphore(m_handle, 1, nullptr); }
+void Semaphore::acquire() { WaitForSingleObject(m_handle, INFINITE); }
+
+bool Semaphore::tryAcquireFor(std::chrono::microseconds timeout)
+{
+	/* WaitForSingleObject works with milliseconds: round up, so that the 
+	deadline is never anticipated. */
+
+	const auto ms = std::chrono::ceil<std::chrono::milliseconds>(timeout);
+	return WaitForSingleObject(m_handle, static_cast<DWORD>(ms.count())) == WAIT_OBJECT_0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+#elif defined(G_OS_MAC)
+
+Semaphore::Semaphore()
+: m_handle(dispatch_semaphore_create(0))
+{
+	assert(m_handle != nullptr);
+}
+
+Semaphore::~Semaphore() { dispatch_release(static_cast<dispatch_semaphore_t>(m_handle)); }
+void Semaphore::release() { dispatch_semaphore_signal(static_cast<dispatch_semaphore_t>(m_handle)); }
+void Semaphore::acquire() { dispatch_semaphore_wait(static_cast<dispatch_semaphore_t>(m_handle), DISPATCH_TIME_FOREVER); }
+
+bool Semaphore::tryAcquireFor(std::chrono::microseconds timeout)
+{
+	const dispatch_time_t deadline = dispatch_time(DISPATCH_TIME_NOW,
+	    std::chrono::duration_cast<std::chrono::nanoseconds>(timeout).count());
+	return dispatch_semaphore_wait(static_cast<dispatch_semaphore_t>(m_handle), deadline) == 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+#else // Linux, FreeBSD
+
+namespace
+{
+/* makeDeadline_
+Returns the absolute time 'timeout' from now, measured on clock 'clock'. */
+
+timespec makeDeadline_(clockid_t clock, std::chrono::microseconds timeout)
+{
+	timespec ts;
+	clock_gettime(clock, &ts);
+
+	const auto secs = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+	const auto nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(timeout - secs);
+
+	ts.tv_sec += secs.count();
+	ts.tv_nsec += nsec.count();
+	if (ts.tv_nsec >= 1000000000L)
+	{
+		ts.tv_sec += 1;
+		ts.tv_nsec -= 1000000000L;
+	}
+	return ts;
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+
+Semaphore::Semaphore()
+: m_handle(new sem_t)
+{
+	[[maybe_unused]] const int res = sem_init(static_cast<sem_t*>(m_handle), /*pshared=*/0, /*value=*/0);
+	assert(res == 0);
+}
+
+Semaphore::~Semaphore()
+{
+	sem_destroy(static_cast<sem_t*>(m_handle));
+	delete static_cast<sem_t*>(m_handle);
+}
+
+void Semaphore::release() { sem_post(static_cast<sem_t*>(m_handle)); }
+
+void Semaphore::acquire()
+{
+	while (sem_wait(static_cast<sem_t*>(m_handle)) == -1 && errno == EINTR)
+		;
+}
+
+bool Semaphore::tryAcquireFor(std::chrono::microseconds timeout)
+{
+	sem_t* sem = static_cast<sem_t*>(m_handle);
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 30))
+
+	/* Absolute deadline on the monotonic clock: changes to the system time 
+	can't stretch or cut the wait. */
+
+	const timespec deadline = makeDeadline_(CLOCK_MONOTONIC, timeout);
+
+	int res;
+	while ((res = sem_clockwait(sem, CLOCK_MONOTONIC, &deadline)) == -1 && errno == EINTR)
+		;
+	return res == 0;
+
+#else
+
+	/* No sem_clockwait() here: sem_timedwait() only knows about the system wall
+	clock, which might jump. Wait in short slices against a deadline on the 
+	monotonic clock, so that a jump can stretch the wait by one slice at most. */
+
+	constexpr auto MAX_SLICE = std::chrono::milliseconds(10);
+
+	const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+	while (true)
+	{
+		const auto left = std::chrono::duration_cast<std::chrono::microseconds>(deadline - std::chrono::steady_clock::now());
+		if (left.count() <= 0)
+			return sem_trywait(sem) == 0;
+
+		const timespec slice = makeDeadline_(CLOCK_REALTIME, std::min<std::chrono::microseconds>(left, MAX_SLICE));
+		if (sem_timedwait(sem, &slice) == 0)
+			return true;
+		if (errno != EINTR && errno != ETIMEDOUT)
+			return false;
+	}
+
+#endif
+}
+
+#endif
+} // namespace giada
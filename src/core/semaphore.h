@@ -24,30 +24,49 @@
  *
  * -------------------------------------------------------------------------- */
 
-#ifndef G_WORKER_H
-#define G_WORKER_H
+#ifndef G_SEMAPHORE_H
+#define G_SEMAPHORE_H
 
-#include <atomic>
-#include <functional>
-#include <thread>
+#include <chrono>
 
 namespace giada
 {
-class Worker
+/* Semaphore
+Counting semaphore backed by the native OS primitive. Unlike a mutex + condition
+variable pair, release() never blocks nor takes a lock, so it can be safely
+called from the realtime thread to wake up a sleeping worker. */
+
+class Semaphore
 {
 public:
-	Worker(int sleep);
-	~Worker();
+	Semaphore();
+	~Semaphore();
+
+	Semaphore(const Semaphore&)            = delete;
+	Semaphore(Semaphore&&)                 = delete;
+	Semaphore& operator=(const Semaphore&) = delete;
+	Semaphore& operator=(Semaphore&&)      = delete;
+
+	/* release
+	Increments the internal counter, waking up a waiting thread (if any). 
+	Realtime-safe. */
+
+	void release();
+
+	/* acquire
+	Blocks until the internal counter is greater than zero, then decrements it. */
+
+	void acquire();
+
+	/* tryAcquireFor
+	Same as acquire(), but gives up after 'timeout' has elapsed. Returns true if
+	the semaphore has been acquired. */
 
-	void start(std::function<void()>) const;
-	void stop() const;
-	void setSleep(int sleep);
+	bool tryAcquireFor(std::chrono::microseconds timeout);
 
 private:
-	mutable std::thread       m_thread;
-	mutable std::atomic<bool> m_running;
-	int                       m_sleep;
+	void* m_handle;
 };
 } // namespace giada
 
-#endif
\ No newline at end of file
+#endif
@@ -35,12 +35,27 @@
 #include "utils/log.h"
 #include "utils/math.h"
 #include "utils/time.h"
+#include <algorithm>
+#include <utility>
 
 namespace giada::m
 {
 namespace
 {
 constexpr int Q_ACTION_REWIND = 0;
+constexpr int MAX_SHIFT_RATIO = 8; // Position correction: max 1/8 of a block
+
+/* ChannelIdCompare_
+Orders bucketed action events by the ID of the channel they are addressed to. */
+
+struct ChannelIdCompare_
+{
+	template <typename T>
+	bool operator()(const T& ce, ID id) const { return ce.event.action->channelId < id; }
+
+	template <typename T>
+	bool operator()(ID id, const T& ce) const { return id < ce.event.action->channelId; }
+};
 } // namespace
 
 /* -------------------------------------------------------------------------- */
@@ -54,6 +69,8 @@ Sequencer::Sequencer(model::Model& m, MidiSynchronizer& s, JackTransport& j)
 , m_midiSynchronizer(s)
 , m_jackTransport(j)
 , m_quantizerStep(1)
+, m_positionShift(0)
+, m_cueBar(-1)
 {
 	m_quantizer.schedule(Q_ACTION_REWIND, [this](Frame delta) { rawRewind(delta); });
 }
@@ -109,6 +126,7 @@ void Sequencer::reset(int sampleRate)
 	s.quantize = G_DEFAULT_QUANTIZE;
 	recomputeFrames(sampleRate); // Model swap is done here, no need to call it twice
 	rewind();
+	cancelCue();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -120,33 +138,133 @@ void Sequencer::setSampleRate(int sampleRate)
 
 /* -------------------------------------------------------------------------- */
 
+std::size_t Sequencer::EventBuffer::countGlobals() const { return m_globalsSize; }
+std::size_t Sequencer::EventBuffer::countActions() const { return m_actionsSize; }
+uint64_t    Sequencer::EventBuffer::countDropped() const { return m_dropped.load(); }
+
+/* -------------------------------------------------------------------------- */
+
+bool Sequencer::EventBuffer::has(EventType type) const
+{
+	for (std::size_t i = 0; i < m_globalsSize; i++)
+		if (m_globals[i].type == type)
+			return true;
+	return false;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Sequencer::EventBuffer::clear()
+{
+	m_globalsSize = 0;
+	m_actionsSize = 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Sequencer::EventBuffer::pushGlobal(Event e)
+{
+	if (m_globalsSize < m_globals.size())
+		m_globals[m_globalsSize++] = e;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Sequencer::EventBuffer::pushActions(const std::vector<Action>& as, Frame global, Frame delta)
+{
+	const std::size_t room = m_actions.size() - m_actionsSize;
+	if (as.size() > room)
+		m_dropped.fetch_add(as.size() - room);
+
+	for (std::size_t i = 0; i < as.size() && m_actionsSize < m_actions.size(); i++, m_actionsSize++)
+		m_actions[m_actionsSize] = {{EventType::ACTIONS, global, delta, &as[i]}, m_globalsSize, m_actionsSize};
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Sequencer::EventBuffer::sort()
+{
+	/* Events are pushed in time order: sorting by channel and then by 
+	insertion order keeps each bucket sorted by time. std::sort is in-place and
+	doesn't allocate, unlike std::stable_sort. */
+
+	std::sort(m_actions.begin(), m_actions.begin() + m_actionsSize, [](const ChannelEvent& a, const ChannelEvent& b) {
+		const ID ca = a.event.action->channelId;
+		const ID cb = b.event.action->channelId;
+		return ca != cb ? ca < cb : a.order < b.order;
+	});
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::pair<const Sequencer::EventBuffer::ChannelEvent*, const Sequencer::EventBuffer::ChannelEvent*>
+Sequencer::EventBuffer::getChannelSpan(ID channelId) const
+{
+	const ChannelEvent* begin = m_actions.data();
+	const ChannelEvent* end   = begin + m_actionsSize;
+	return std::equal_range(begin, end, channelId, ChannelIdCompare_{});
+}
+
+/* -------------------------------------------------------------------------- */
+
 const Sequencer::EventBuffer& Sequencer::advance(const model::Sequencer& sequencer,
     Frame bufferSize, int sampleRate, const model::Actions& actions) const
 {
 	m_eventBuffer.clear();
 
-	const Frame start        = sequencer.a_getCurrentFrame();
-	const Frame end          = start + bufferSize;
 	const Frame framesInLoop = sequencer.framesInLoop;
 	const Frame framesInBar  = sequencer.framesInBar;
 	const Frame framesInBeat = sequencer.framesInBeat;
-	const Frame nextFrame    = end % framesInLoop;
 
-	/* Process events in the current block. */
+	/* Apply any pending position correction by scanning more (or less) 
+	sequencer frames in this block. Frames are never skipped, so no events are 
+	lost when moving forward. The correction is spread over several blocks, a 
+	fraction of a block each: what's left is put back for the next ones. */
+
+	const Frame pending  = m_positionShift.exchange(0);
+	const Frame maxShift = std::max<Frame>(bufferSize / MAX_SHIFT_RATIO, 1);
+	const Frame shift    = std::clamp(pending, -maxShift, maxShift);
+	if (pending != shift)
+		m_positionShift.fetch_add(pending - shift);
 
-	for (Frame i = start, local = 0; i < end; i++, local++)
+	const Frame start     = sequencer.a_getCurrentFrame();
+	const Frame end       = start + bufferSize + shift;
+	const Frame length    = end - start;
+	const Frame nextFrame = end % framesInLoop;
+	const int   cueBar    = m_cueBar.load();
+
+	/* Process events in the current block. Scanned frames are mapped linearly
+	onto the audio block, so that offsets never fall outside of it. */
+
+	for (Frame i = start; i < end; i++)
 	{
+		const Frame local  = (i - start) * bufferSize / length;
+		const Frame global = i % framesInLoop; // wraps around 'framesInLoop'
+
+		/* Cue point reached: stop scanning, so that none of its events are
+		played, and let 'onCue' take over. The sequencer restarts from here on 
+		the next block, unless moved elsewhere by 'onCue'. */
 
-		Frame global = i % framesInLoop; // wraps around 'framesInLoop'
+		if (cueBar >= 0 && global % framesInBar == 0 && global / framesInBar == cueBar)
+		{
+			m_cueBar.store(-1);
+			sequencer.a_setCurrentFrame(global, sampleRate);
+			if (i > start)
+				m_quantizer.advance(Range<Frame>(start, i), getQuantizerStep(), std::max<Frame>(local, 1));
+			if (onCue != nullptr)
+				onCue();
+			m_eventBuffer.sort();
+			return m_eventBuffer;
+		}
 
 		if (global == 0)
 		{
-			m_eventBuffer.push_back({EventType::FIRST_BEAT, global, local});
+			m_eventBuffer.pushGlobal({EventType::FIRST_BEAT, global, local});
 			m_metronome.trigger(Metronome::Click::BEAT, local);
 		}
 		else if (global % framesInBar == 0)
 		{
-			m_eventBuffer.push_back({EventType::BAR, global, local});
+			m_eventBuffer.pushGlobal({EventType::BAR, global, local});
 			m_metronome.trigger(Metronome::Click::BAR, local);
 		}
 		else if (global % framesInBeat == 0)
@@ -156,19 +274,62 @@ const Sequencer::EventBuffer& Sequencer::advance(const model::Sequencer& sequenc
 
 		const std::vector<Action>* as = actions.getActionsOnFrame(global);
 		if (as != nullptr)
-			m_eventBuffer.push_back({EventType::ACTIONS, global, local, as});
+			m_eventBuffer.pushActions(*as, global, local);
 	}
 
+	m_eventBuffer.sort();
+
 	/* Advance this and quantizer after the event parsing. */
 
 	sequencer.a_setCurrentFrame(nextFrame, sampleRate);
-	m_quantizer.advance(Range<Frame>(start, end), getQuantizerStep());
+	m_quantizer.advance(Range<Frame>(start, end), getQuantizerStep(), bufferSize);
 
 	return m_eventBuffer;
 }
 
 /* -------------------------------------------------------------------------- */
 
+void Sequencer::collectEvents(EventBuffer& events, const model::Sequencer& sequencer,
+    const model::Actions& actions, Frame start, Frame bufferSize)
+{
+	const Frame framesInLoop = sequencer.framesInLoop;
+	const Frame framesInBar  = sequencer.framesInBar;
+
+	/* Walk the action map alongside the frames, instead of looking up each 
+	frame: this runs for each channel rendered ahead. */
+
+	const model::Actions::Map&          map = actions.getAll();
+	model::Actions::Map::const_iterator it  = map.lower_bound(start % framesInLoop);
+
+	events.clear();
+
+	for (Frame i = start; i < start + bufferSize; i++)
+	{
+		const Frame local  = i - start;
+		const Frame global = i % framesInLoop;
+
+		if (global == 0)
+		{
+			events.pushGlobal({EventType::FIRST_BEAT, global, local});
+			it = map.begin();
+		}
+		else if (global % framesInBar == 0)
+		{
+			events.pushGlobal({EventType::BAR, global, local});
+		}
+
+		if (it != map.end() && it->first == global)
+		{
+			events.pushActions(it->second, global, local);
+			++it;
+		}
+	}
+
+	events.sort();
+}
+
+/* -------------------------------------------------------------------------- */
+
 void Sequencer::render(mcl::AudioBuffer& outBuf) const
 {
 	if (m_metronome.running)
@@ -213,7 +374,7 @@ void Sequencer::rawStop()
 void Sequencer::rawRewind(Frame delta)
 {
 	rewindForced();
-	m_eventBuffer.push_back({EventType::REWIND, 0, delta});
+	m_eventBuffer.pushGlobal({EventType::REWIND, 0, delta});
 }
 
 /* -------------------------------------------------------------------------- */
@@ -261,10 +422,7 @@ void Sequencer::recomputeFrames(int sampleRate)
 {
 	model::Sequencer& s = m_model.get().sequencer;
 
-	s.framesInBeat = u::time::beatToFrame(1, sampleRate, s.bpm);
-	s.framesInLoop = s.framesInBeat * s.beats;
-	s.framesInBar  = s.framesInLoop / (float)s.bars;
-	s.framesInSeq  = s.framesInBeat * G_MAX_BEATS;
+	recomputeFrames(s, sampleRate);
 
 	if (s.quantize != 0)
 		m_quantizerStep = s.framesInBeat / s.quantize;
@@ -274,6 +432,16 @@ void Sequencer::recomputeFrames(int sampleRate)
 
 /* -------------------------------------------------------------------------- */
 
+void Sequencer::recomputeFrames(model::Sequencer& s, int sampleRate)
+{
+	s.framesInBeat = u::time::beatToFrame(1, sampleRate, s.bpm);
+	s.framesInLoop = s.framesInBeat * s.beats;
+	s.framesInBar  = s.framesInLoop / (float)s.bars;
+	s.framesInSeq  = s.framesInBeat * G_MAX_BEATS;
+}
+
+/* -------------------------------------------------------------------------- */
+
 void Sequencer::setBpm(float b, int sampleRate)
 {
 	b = std::clamp(b, G_MIN_BPM, G_MAX_BPM);
@@ -293,7 +461,7 @@ void Sequencer::rawSetBpm(float v, int sampleRate)
 	const float newVal = std::clamp(v, G_MIN_BPM, G_MAX_BPM);
 
 	m_model.get().sequencer.bpm = newVal;
-	m_model.swap(model::SwapType::HARD);
+	m_model.swap(model::SwapType::HARD, model::Change::SEQUENCER);
 
 	recomputeFrames(sampleRate);
 
@@ -311,7 +479,7 @@ void Sequencer::setBeats(int newBeats, int newBars, int sampleRate)
 
 	m_model.get().sequencer.beats = newBeats;
 	m_model.get().sequencer.bars  = newBars;
-	m_model.swap(model::SwapType::HARD);
+	m_model.swap(model::SwapType::HARD, model::Change::SEQUENCER);
 
 	recomputeFrames(sampleRate);
 }
@@ -329,7 +497,7 @@ void Sequencer::rawGoToBeat(int beat, int sampleRate)
 void Sequencer::setQuantize(int q, int sampleRate)
 {
 	m_model.get().sequencer.quantize = q;
-	m_model.swap(model::SwapType::HARD);
+	m_model.swap(model::SwapType::HARD, model::Change::SEQUENCER);
 
 	recomputeFrames(sampleRate);
 }
@@ -362,6 +530,34 @@ void Sequencer::setStatus(SeqStatus s)
 
 /* -------------------------------------------------------------------------- */
 
+void Sequencer::shiftPosition(Frame delta)
+{
+	m_positionShift.fetch_add(delta);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Sequencer::cue(int bar)
+{
+	m_cueBar.store(std::clamp(bar, 0, getBars() - 1));
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Sequencer::cancelCue()
+{
+	m_cueBar.store(-1);
+}
+
+/* -------------------------------------------------------------------------- */
+
+uint64_t Sequencer::countDroppedActions() const
+{
+	return m_eventBuffer.countDropped();
+}
+
+/* -------------------------------------------------------------------------- */
+
 void Sequencer::goToBeat(int beat, int sampleRate)
 {
 	const float bpm   = m_model.get().sequencer.bpm;
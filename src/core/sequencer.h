@@ -31,7 +31,9 @@
 #include "core/eventDispatcher.h"
 #include "core/metronome.h"
 #include "core/quantizer.h"
-#include "core/ringBuffer.h"
+#include <array>
+#include <atomic>
+#include <utility>
 #include <vector>
 
 namespace mcl
@@ -63,15 +65,93 @@ public:
 		ACTIONS
 	};
 
+	/* Event
+	A sequencer event. ACTIONS events carry exactly one action, addressed to 
+	the channel that receives the event. */
+
 	struct Event
 	{
-		EventType                  type    = EventType::NONE;
-		Frame                      global  = 0;
-		Frame                      delta   = 0;
-		const std::vector<Action>* actions = nullptr;
+		EventType     type   = EventType::NONE;
+		Frame         global = 0;
+		Frame         delta  = 0;
+		const Action* action = nullptr;
 	};
 
-	using EventBuffer = RingBuffer<Event, G_MAX_SEQUENCER_EVENTS>;
+	/* EventBuffer
+	Events found in a block. Global events (first beat, bar, rewind) are sent to
+	every channel, while action events are stored in a flat buffer bucketed by 
+	channel ID, so that each channel only walks the span of actions addressed 
+	to it. Non-allocating: meant to be filled and read on the audio thread. */
+
+	class EventBuffer
+	{
+	public:
+		/* forEach
+		Calls 'f' on every event addressed to channel 'channelId', global ones
+		included, in the same order in which they occur in the block. */
+
+		template <typename F>
+		void forEach(ID channelId, F&& f) const
+		{
+			const auto [first, last] = getChannelSpan(channelId);
+			std::size_t g            = 0;
+			for (const ChannelEvent* it = first; it != last; ++it)
+			{
+				for (; g < it->globalsBefore; g++)
+					f(m_globals[g]);
+				f(it->event);
+			}
+			for (; g < m_globalsSize; g++)
+				f(m_globals[g]);
+		}
+
+		std::size_t countGlobals() const;
+		std::size_t countActions() const;
+
+		/* has
+		Tells whether the buffer contains a global event of type 'type'. */
+
+		bool has(EventType type) const;
+
+		/* countDropped
+		Returns the number of actions dropped so far because the buffer was 
+		full. Never reset. Thread-safe. */
+
+		uint64_t countDropped() const;
+
+		void clear();
+		void pushGlobal(Event);
+
+		/* pushActions
+		Adds one ACTIONS event for each action in 'as'. Actions beyond 
+		G_MAX_SEQUENCER_ACTIONS are dropped and counted. Call sort() when 
+		done. */
+
+		void pushActions(const std::vector<Action>& as, Frame global, Frame delta);
+
+		/* sort
+		Buckets action events by channel ID, keeping the time order within 
+		each bucket. Must be called after the last pushActions() and before 
+		forEach(). */
+
+		void sort();
+
+	private:
+		struct ChannelEvent
+		{
+			Event       event;
+			std::size_t globalsBefore = 0; // Global events that precede this one
+			std::size_t order         = 0; // Insertion order, i.e. time order
+		};
+
+		std::pair<const ChannelEvent*, const ChannelEvent*> getChannelSpan(ID) const;
+
+		std::array<Event, G_MAX_SEQUENCER_EVENTS>         m_globals;
+		std::array<ChannelEvent, G_MAX_SEQUENCER_ACTIONS> m_actions;
+		std::size_t                                       m_globalsSize = 0;
+		std::size_t                                       m_actionsSize = 0;
+		std::atomic<uint64_t>                             m_dropped     = 0;
+	};
 
 	Sequencer(model::Model&, MidiSynchronizer&, JackTransport&);
 
@@ -142,6 +222,15 @@ public:
 	const EventBuffer& advance(const model::Sequencer&, Frame bufferSize, int sampleRate,
 	    const model::Actions&) const;
 
+	/* collectEvents
+	Fills 'events' with the events found in a block of 'bufferSize' frames that
+	starts on frame 'start', just like advance() does in a regular block: no 
+	position corrections, cues or rewinds. Used to render blocks ahead of 
+	time. Thread-safe. */
+
+	static void collectEvents(EventBuffer& events, const model::Sequencer&,
+	    const model::Actions&, Frame start, Frame bufferSize);
+
 	/* render
 	Renders audio coming out from the sequencer: that is, the metronome! */
 
@@ -159,6 +248,31 @@ public:
 	void setStatus(SeqStatus);
 	void goToBeat(int beat, int sampleRate);
 
+	/* shiftPosition
+	Moves the current position by 'delta' frames (positive: forward) on the 
+	next audio block, without skipping any event. Used for phase correction 
+	when following an external clock. Thread-safe. */
+
+	void shiftPosition(Frame delta);
+
+	/* cue
+	Fires 'onCue' from the audio thread on the first frame of bar 'bar', next
+	time the sequencer gets there, before processing any of its events. The 
+	rest of the block is left with no events. Thread-safe. */
+
+	void cue(int bar);
+
+	/* cancelCue
+	Cancels a pending cue(). Thread-safe. */
+
+	void cancelCue();
+
+	/* countDroppedActions
+	Returns the number of actions dropped so far because a block contained 
+	more than G_MAX_SEQUENCER_ACTIONS of them. Thread-safe. */
+
+	uint64_t countDroppedActions() const;
+
 #ifdef WITH_AUDIO_JACK
 	void jack_start();
 	void jack_stop();
@@ -166,14 +280,21 @@ public:
 	void jack_setBpm(float b, int sampleRate);
 #endif
 
-	/* recomputeFrames
+	/* recomputeFrames (1)
     Updates bpm, frames, beats and so on. */
 
 	void recomputeFrames(int sampleRate);
 
+	/* recomputeFrames (2)
+	Same as above, on a sequencer not in the layout (e.g. a staged project's 
+	one). The quantizer is left untouched. */
+
+	static void recomputeFrames(model::Sequencer&, int sampleRate);
+
 	std::function<void(SeqStatus)>         onAboutStart;
 	std::function<void()>                  onAboutStop;
 	std::function<void(float, float, int)> onBpmChange;
+	std::function<void()>                  onCue;
 
 private:
 	/* raw[*]
@@ -193,7 +314,7 @@ private:
 
 	/* m_eventBuffer
 	Buffer of events found in each block sent to channels for event parsing. 
-	This is filled during react(). */
+	This is filled during advance(). */
 
 	mutable EventBuffer m_eventBuffer;
 
@@ -204,6 +325,16 @@ private:
     Tells how many frames to wait to perform a quantized action. */
 
 	int m_quantizerStep;
+
+	/* m_positionShift
+	Pending position correction, consumed by the audio thread in advance(). */
+
+	mutable std::atomic<Frame> m_positionShift;
+
+	/* m_cueBar
+	Bar to fire 'onCue' on (-1 = none). */
+
+	mutable std::atomic<int> m_cueBar;
 };
 } // namespace giada::m
 
@@ -0,0 +1,172 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#include "core/tempoTracker.h"
+#include <cassert>
+#include <cmath>
+#include <numbers>
+
+namespace giada::m
+{
+namespace
+{
+/* MIDI_CLOCK_PPQ
+Number of MIDI clock pulses per quarter note (i.e. per beat). */
+
+constexpr double MIDI_CLOCK_PPQ = 24.0;
+
+/* LOCK_PULSES
+Number of pulses required before the estimate is considered reliable. */
+
+constexpr int LOCK_PULSES = 24;
+
+/* STABLE_PULSES, STABLE_TOLERANCE_BPM
+The estimate is stable when it stays within STABLE_TOLERANCE_BPM for 
+STABLE_PULSES consecutive pulses (i.e. two beats). */
+
+constexpr int    STABLE_PULSES        = 48;
+constexpr double STABLE_TOLERANCE_BPM = 0.1;
+
+/* MAX_PULSE_GAP
+A gap between two pulses longer than this (in seconds) means the clock stream 
+has been interrupted: restart the loop. Corresponds to 2.5 BPM. */
+
+constexpr double MAX_PULSE_GAP = 1.0;
+
+double periodToBpm_(double period)
+{
+	return 60.0 / (period * MIDI_CLOCK_PPQ);
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+TempoTracker::TempoTracker(double bandwidth)
+: m_bandwidth(bandwidth)
+{
+	reset();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void TempoTracker::reset()
+{
+	m_t1           = 0.0;
+	m_e2           = 0.0;
+	m_pulses       = 0;
+	m_anchorBpm    = 0.0;
+	m_stablePulses = 0;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void TempoTracker::process(double timestamp)
+{
+	/* The very first pulse just starts the loop. The second one provides the
+	initial period estimate. */
+
+	if (m_pulses == 0)
+	{
+		m_t1 = timestamp;
+		m_pulses++;
+		return;
+	}
+
+	if (m_pulses == 1)
+	{
+		m_e2 = timestamp - m_t1;
+		m_t1 = timestamp + m_e2;
+		m_pulses++;
+		if (m_e2 <= 0.0 || m_e2 > MAX_PULSE_GAP)
+			reset();
+		return;
+	}
+
+	/* Loop error: the distance between the actual pulse time and the 
+	predicted one. Restart on gaps, i.e. the clock has stopped and resumed. */
+
+	const double e = timestamp - m_t1;
+
+	if (e > MAX_PULSE_GAP)
+	{
+		reset();
+		process(timestamp);
+		return;
+	}
+
+	/* Second-order loop coefficients, computed from the bandwidth and the 
+	current period estimate (critically damped). */
+
+	const double omega = 2.0 * std::numbers::pi * m_bandwidth * m_e2;
+	const double b     = std::sqrt(2.0) * omega;
+	const double c     = omega * omega;
+
+	m_t1 += b * e + m_e2;
+	m_e2 += c * e;
+
+	assert(m_e2 > 0.0);
+
+	m_pulses++;
+
+	/* Stability check: count how many pulses the estimate has stayed close to
+	the anchor tempo, moving the anchor when it drifts away. */
+
+	const double bpm = getBpm();
+	if (std::abs(bpm - m_anchorBpm) <= STABLE_TOLERANCE_BPM)
+		m_stablePulses++;
+	else
+	{
+		m_anchorBpm    = bpm;
+		m_stablePulses = 0;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool TempoTracker::isLocked() const
+{
+	return m_pulses >= LOCK_PULSES;
+}
+
+bool TempoTracker::isStable() const
+{
+	return isLocked() && m_stablePulses >= STABLE_PULSES;
+}
+
+/* -------------------------------------------------------------------------- */
+
+double TempoTracker::getBpm() const
+{
+	return m_e2 > 0.0 ? periodToBpm_(m_e2) : 0.0;
+}
+
+double TempoTracker::getPeriod() const
+{
+	return m_e2;
+}
+} // namespace giada::m
@@ -0,0 +1,103 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef G_TEMPO_TRACKER_H
+#define G_TEMPO_TRACKER_H
+
+namespace giada::m
+{
+/* TempoTracker
+Estimates the tempo of an incoming MIDI clock stream with a second-order 
+delay-locked loop (DLL). The loop filters out the timing jitter of single 
+pulses, while still following real tempo changes. A tempo is reported as stable
+only when the estimate has settled for a while, so that callers can commit it
+without chasing every small fluctuation. */
+
+class TempoTracker
+{
+public:
+	/* TempoTracker
+	'bandwidth' is the DLL bandwidth in Hz: the lower, the smoother (and 
+	slower to react) the estimate. */
+
+	TempoTracker(double bandwidth = 0.2);
+
+	/* reset
+	Brings the loop back to the unlocked state. Call this when the clock stream
+	stops or restarts. */
+
+	void reset();
+
+	/* process
+	Feeds the loop with the timestamp (in seconds) of a new MIDI clock pulse. */
+
+	void process(double timestamp);
+
+	/* isLocked
+	True if the loop has received enough pulses to provide a tempo estimate. */
+
+	bool isLocked() const;
+
+	/* isStable
+	True if the tempo estimate hasn't moved more than a small tolerance during 
+	the last pulses. */
+
+	bool isStable() const;
+
+	/* getBpm
+	Returns the current tempo estimate, in beats per minute. */
+
+	double getBpm() const;
+
+	/* getPeriod
+	Returns the current estimate of the time between two pulses, in seconds. */
+
+	double getPeriod() const;
+
+private:
+	double m_bandwidth;
+
+	/* m_t1, m_e2
+	DLL state: predicted time of the next pulse and filtered pulse period. */
+
+	double m_t1;
+	double m_e2;
+
+	/* m_pulses
+	Number of pulses received since the last reset. */
+
+	int m_pulses;
+
+	/* m_anchorBpm, m_stablePulses
+	Tempo the estimate is being compared to for stability and number of 
+	consecutive pulses the estimate has stayed close to it. */
+
+	double m_anchorBpm;
+	int    m_stablePulses;
+};
+} // namespace giada::m
+
+#endif
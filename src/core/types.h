@@ -38,7 +38,8 @@ enum class Thread
 	MAIN,
 	MIDI,
 	AUDIO,
-	EVENTS
+	EVENTS,
+	RENDER
 };
 
 /* Windows fix */
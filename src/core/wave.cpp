@@ -27,17 +27,37 @@
 #include "wave.h"
 #include "const.h"
 #include "utils/fs.h"
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <fmt/core.h>
 
 namespace giada::m
 {
+namespace
+{
+/* revision_
+Source of Wave revisions, shared by all Waves: a revision number identifies a
+specific content of a specific Wave, even across Wave IDs reused after a 
+project load. */
+
+std::atomic<int> revision_ = 0;
+
+int nextRevision_() { return revision_.fetch_add(1) + 1; }
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
 Wave::Wave(ID id)
 : id(id)
+, m_buffer(std::make_shared<mcl::AudioBuffer>())
 , m_rate(0)
 , m_bits(0)
 , m_logical(false)
 , m_edited(false)
+, m_revision(nextRevision_())
 {
 }
 
@@ -45,11 +65,14 @@ Wave::Wave(ID id)
 
 Wave::Wave(const Wave& other)
 : id(other.id)
-, m_buffer(other.getBuffer())
+, m_buffer(other.m_buffer)
+, m_segments(other.m_segments)
+, m_starts(other.m_starts)
 , m_rate(other.m_rate)
 , m_bits(other.m_bits)
 , m_logical(false)
 , m_edited(false)
+, m_revision(other.m_revision)
 , m_path(other.m_path)
 {
 }
@@ -58,10 +81,15 @@ Wave::Wave(const Wave& other)
 
 void Wave::alloc(Frame size, int channels, int rate, int bits, const std::string& path)
 {
-	m_buffer.alloc(size, channels);
+	m_buffer = std::make_shared<mcl::AudioBuffer>(size, channels);
+	m_segments.clear();
+	m_starts.clear();
+	m_undo.clear();
+	m_redo.clear();
 	m_rate = rate;
 	m_bits = bits;
 	m_path = path;
+	m_revision = nextRevision_();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -78,17 +106,78 @@ std::string Wave::getPath() const { return m_path; }
 int         Wave::getBits() const { return m_bits; }
 bool        Wave::isLogical() const { return m_logical; }
 bool        Wave::isEdited() const { return m_edited; }
+bool        Wave::isConsolidated() const { return m_segments.empty(); }
+bool        Wave::canUndo() const { return !m_undo.empty(); }
+bool        Wave::canRedo() const { return !m_redo.empty(); }
+int         Wave::getRevision() const { return m_revision; }
 
 /* -------------------------------------------------------------------------- */
 
-mcl::AudioBuffer&       Wave::getBuffer() { return m_buffer; }
-const mcl::AudioBuffer& Wave::getBuffer() const { return m_buffer; }
+Frame Wave::countFrames() const
+{
+	if (isConsolidated())
+		return m_buffer->countFrames();
+	return m_starts.back() + m_segments.back().length;
+}
+
+/* -------------------------------------------------------------------------- */
+
+int Wave::countChannels() const
+{
+	if (isConsolidated())
+		return m_buffer->countChannels();
+	return m_segments.front().source->countChannels();
+}
+
+/* -------------------------------------------------------------------------- */
+
+mcl::AudioBuffer& Wave::getBuffer()
+{
+	assert(isConsolidated());
+
+	/* Copy-on-write: someone else (another Wave, a slice, the editing history)
+	is referencing the same data. Make a private copy before handing out a 
+	mutable reference. */
+
+	if (m_buffer.use_count() > 1)
+		m_buffer = std::make_shared<mcl::AudioBuffer>(*m_buffer);
+	m_revision = nextRevision_(); // Assume the caller is about to write
+	return *m_buffer;
+}
+
+const mcl::AudioBuffer& Wave::getBuffer() const
+{
+	assert(isConsolidated());
+	return *m_buffer;
+}
+
+/* -------------------------------------------------------------------------- */
+
+Wave::Data Wave::getSharedBuffer() const
+{
+	assert(isConsolidated());
+	return m_buffer;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Wave::setSharedBuffer(Data data)
+{
+	assert(data != nullptr);
+
+	m_buffer = std::move(data);
+	m_segments.clear();
+	m_starts.clear();
+	m_undo.clear();
+	m_redo.clear();
+	m_revision = nextRevision_();
+}
 
 /* -------------------------------------------------------------------------- */
 
 int Wave::getDuration() const
 {
-	return m_buffer.countFrames() / m_rate;
+	return countFrames() / m_rate;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -101,6 +190,7 @@ std::string Wave::getExtension() const
 /* -------------------------------------------------------------------------- */
 
 void Wave::setRate(int v) { m_rate = v; }
+void Wave::setBits(int v) { m_bits = v; }
 void Wave::setLogical(bool l) { m_logical = l; }
 void Wave::setEdited(bool e) { m_edited = e; }
 
@@ -118,6 +208,257 @@ void Wave::setPath(const std::string& p, int wid)
 
 void Wave::replaceData(mcl::AudioBuffer&& b)
 {
-	m_buffer = std::move(b);
+	/* Not an edit: the history refers to the old data (e.g. before resampling)
+	and is no longer meaningful. */
+
+	setSharedBuffer(std::make_shared<mcl::AudioBuffer>(std::move(b)));
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Wave::makeSlice(const Wave& src, Frame a, Frame b)
+{
+	assert(a >= 0 && a <= b && b <= src.countFrames());
+
+	m_rate = src.m_rate;
+	m_bits = src.m_bits;
+
+	/* A consolidated Wave taken as a whole is shared as-is, so that the slice
+	stays consolidated too. */
+
+	if (src.isConsolidated() && a == 0 && b == src.countFrames())
+		setSharedBuffer(src.m_buffer);
+	else
+	{
+		setSharedBuffer(std::make_shared<mcl::AudioBuffer>());
+		setSegments(src.getSegments(a, b));
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+Wave::Chunk Wave::getChunk(Frame frame) const
+{
+	assert(frame >= 0);
+
+	if (isConsolidated())
+	{
+		if (frame >= m_buffer->countFrames())
+			return {nullptr, 0};
+		return {(*m_buffer)[frame], m_buffer->countFrames() - frame};
+	}
+
+	/* Find the last segment starting at or before 'frame'. */
+
+	const auto  it    = std::upper_bound(m_starts.begin(), m_starts.end(), frame) - 1;
+	const auto  index = std::distance(m_starts.begin(), it);
+	const Frame local = frame - *it;
+
+	const Segment& segment = m_segments[index];
+	if (local >= segment.length)
+		return {nullptr, 0};
+	return {(*segment.source)[segment.offset + local], segment.length - local};
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Wave::copyTo(mcl::AudioBuffer& dest, Frame start, Frame count, Frame destOffset) const
+{
+	assert(dest.countChannels() == countChannels());
+	assert(start + count <= countFrames());
+	assert(destOffset + count <= dest.countFrames());
+
+	const int channels = countChannels();
+
+	while (count > 0)
+	{
+		const Chunk chunk  = getChunk(start);
+		const Frame frames = std::min(chunk.length, count);
+
+		std::copy_n(chunk.data, frames * channels, dest[destOffset]);
+
+		start += frames;
+		destOffset += frames;
+		count -= frames;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+mcl::AudioBuffer Wave::render(Frame a, Frame b) const
+{
+	mcl::AudioBuffer out(b - a, countChannels());
+	copyTo(out, a, b - a, 0);
+	return out;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Wave::cut(Frame a, Frame b)
+{
+	assert(a >= 0 && a <= b && b <= countFrames());
+
+	pushHistory();
+
+	Segments out = slice(m_segments, 0, a);
+	Segments end = slice(m_segments, b, countFrames());
+	out.insert(out.end(), end.begin(), end.end());
+
+	setSegments(std::move(out));
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Wave::trim(Frame a, Frame b)
+{
+	assert(a >= 0 && a <= b && b <= countFrames());
+
+	pushHistory();
+	setSegments(slice(m_segments, a, b));
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Wave::paste(std::shared_ptr<const mcl::AudioBuffer> src, Frame a)
+{
+	assert(src != nullptr);
+	assert(src->countChannels() == countChannels());
+	assert(a >= 0 && a <= countFrames());
+
+	pushHistory();
+
+	Segments out = slice(m_segments, 0, a);
+	Segments end = slice(m_segments, a, countFrames());
+	out.push_back({src, 0, src->countFrames()});
+	out.insert(out.end(), end.begin(), end.end());
+
+	setSegments(std::move(out));
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Wave::edit(mcl::AudioBuffer&& b)
+{
+	pushHistory();
+
+	m_buffer = std::make_shared<mcl::AudioBuffer>(std::move(b));
+	m_segments.clear();
+	m_starts.clear();
+	m_revision = nextRevision_();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Wave::undo()
+{
+	if (m_undo.empty())
+		return;
+
+	makeSegments();
+	m_redo.push_back(m_segments);
+	setSegments(std::move(m_undo.back()));
+	m_undo.pop_back();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Wave::redo()
+{
+	if (m_redo.empty())
+		return;
+
+	makeSegments();
+	m_undo.push_back(m_segments);
+	setSegments(std::move(m_redo.back()));
+	m_redo.pop_back();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Wave::consolidate()
+{
+	if (!isConsolidated())
+		m_buffer = std::make_shared<mcl::AudioBuffer>(render(0, countFrames()));
+	m_segments.clear();
+	m_starts.clear();
+	m_undo.clear();
+	m_redo.clear();
+}
+
+/* -------------------------------------------------------------------------- */
+
+Wave::Segments Wave::slice(const Segments& segments, Frame a, Frame b)
+{
+	Segments out;
+	Frame    start = 0;
+
+	for (const Segment& segment : segments)
+	{
+		const Frame end  = start + segment.length;
+		const Frame from = std::max(a, start);
+		const Frame to   = std::min(b, end);
+
+		if (from < to)
+			out.push_back({segment.source, segment.offset + (from - start), to - from});
+
+		start = end;
+		if (start >= b)
+			break;
+	}
+
+	return out;
+}
+
+/* -------------------------------------------------------------------------- */
+
+Wave::Segments Wave::getSegments(Frame a, Frame b) const
+{
+	if (!isConsolidated())
+		return slice(m_segments, a, b);
+	if (!m_buffer->isAllocd())
+		return {};
+	return slice({{m_buffer, 0, m_buffer->countFrames()}}, a, b);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Wave::makeSegments()
+{
+	if (!isConsolidated() || !m_buffer->isAllocd())
+		return;
+
+	/* The buffer becomes a shared source: nothing is copied. */
+
+	setSegments(getSegments(0, countFrames()));
+	m_buffer = std::make_shared<mcl::AudioBuffer>();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Wave::setSegments(Segments segments)
+{
+	m_segments = std::move(segments);
+	m_starts.clear();
+
+	Frame start = 0;
+	for (const Segment& segment : m_segments)
+	{
+		m_starts.push_back(start);
+		start += segment.length;
+	}
+
+	m_revision = nextRevision_();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Wave::pushHistory()
+{
+	makeSegments();
+
+	m_undo.push_back(m_segments);
+	m_redo.clear();
+	if (m_undo.size() > static_cast<std::size_t>(G_MAX_WAVE_HISTORY))
+		m_undo.pop_front();
 }
 } // namespace giada::m
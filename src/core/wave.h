@@ -29,13 +29,43 @@
 
 #include "core/types.h"
 #include "deps/mcl-audio-buffer/src/audioBuffer.hpp"
+#include <deque>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace giada::m
 {
 class Wave
 {
 public:
+	/* Segment
+	A portion of an immutable source buffer. An edited Wave is a list of 
+	Segments, played back one after another. */
+
+	struct Segment
+	{
+		std::shared_ptr<const mcl::AudioBuffer> source;
+		Frame                                   offset;
+		Frame                                   length;
+	};
+
+	/* Chunk
+	Pointer to the audio data of a frame, plus the number of frames that can be
+	read contiguously from there. */
+
+	struct Chunk
+	{
+		const float* data;
+		Frame        length;
+	};
+
+	/* Data
+	Audio buffer shared across Waves. Never modified while shared: a Wave makes 
+	its own copy before writing to it (copy-on-write). */
+
+	using Data = std::shared_ptr<mcl::AudioBuffer>;
+
 	Wave(ID id);
 	Wave(const Wave& o);
 	Wave(Wave&& o) = default;
@@ -50,9 +80,29 @@ public:
 	int         getDuration() const;
 	bool        isLogical() const;
 	bool        isEdited() const;
+	Frame       countFrames() const;
+	int         countChannels() const;
+	bool        canUndo() const;
+	bool        canRedo() const;
+
+	/* getRevision
+	Returns a number that changes every time audio data is modified. Useful 
+	to tell whether data derived from it (e.g. peaks) is out of date. Unique 
+	across all Waves: never reused, not even by a Wave with a different 
+	content and the same ID. */
+
+	int getRevision() const;
+
+	/* isConsolidated
+	True if audio data lives in a single contiguous buffer, i.e. there are no 
+	pending segment edits. */
+
+	bool isConsolidated() const;
 
 	/* getBuffer
-	Returns a (non-)const reference to the underlying audio buffer. */
+	Returns a (non-)const reference to the underlying audio buffer. The Wave 
+	must be consolidated first. The non-const version detaches the buffer if 
+	shared with other Waves. */
 
 	mcl::AudioBuffer&       getBuffer();
 	const mcl::AudioBuffer& getBuffer() const;
@@ -64,6 +114,7 @@ public:
 	void setPath(const std::string& p, int id = -1);
 
 	void setRate(int v);
+	void setBits(int v);
 	void setLogical(bool l);
 	void setEdited(bool e);
 
@@ -72,17 +123,106 @@ public:
 
 	void replaceData(mcl::AudioBuffer&& b);
 
+	/* getSharedBuffer, setSharedBuffer
+	Get or set the underlying audio buffer without copying it. The Wave must be
+	consolidated. Set is not an edit, like replaceData() above. */
+
+	Data getSharedBuffer() const;
+	void setSharedBuffer(Data);
+
+	/* makeSlice
+	Makes this Wave a view of frames [a, b) of 'src', referencing its audio data
+	instead of copying it. Takes rate and bit depth from 'src' too. */
+
+	void makeSlice(const Wave& src, Frame a, Frame b);
+
+	/* getChunk
+	Returns the contiguous block of audio data starting at 'frame', whatever
+	the internal representation is. Realtime-safe. */
+
+	Chunk getChunk(Frame frame) const;
+
+	/* copyTo
+	Copies 'count' frames starting at 'start' into 'dest' at 'destOffset'. */
+
+	void copyTo(mcl::AudioBuffer& dest, Frame start, Frame count, Frame destOffset) const;
+
+	/* render
+	Returns a new contiguous buffer with frames in range [a, b). */
+
+	mcl::AudioBuffer render(Frame a, Frame b) const;
+
+	/* cut, trim, paste
+	Non-destructive editing: these functions only rewrite the segment list, 
+	without touching audio data. Each one can be undone. */
+
+	void cut(Frame a, Frame b);
+	void trim(Frame a, Frame b);
+	void paste(std::shared_ptr<const mcl::AudioBuffer> src, Frame a);
+
+	/* edit
+	Replaces audio data with 'b' as an undoable operation. Used by destructive
+	effects that compute a whole new buffer. */
+
+	void edit(mcl::AudioBuffer&& b);
+
+	/* undo, redo
+	Move back and forth in the editing history, up to G_MAX_WAVE_HISTORY steps. */
+
+	void undo();
+	void redo();
+
+	/* consolidate
+	Renders the segment list into a single contiguous buffer and clears the 
+	editing history. */
+
+	void consolidate();
+
 	void alloc(Frame size, int channels, int rate, int bits, const std::string& path);
 
 	ID id;
 
 private:
-	mcl::AudioBuffer m_buffer;
-	int              m_rate;
-	int              m_bits;
-	bool             m_logical; // memory only (a take)
-	bool             m_edited;  // edited via editor
-	std::string      m_path;    // E.g. /path/to/my/sample.wav
+	using Segments = std::vector<Segment>;
+
+	/* slice
+	Returns the portion of 'segments' in range [a, b). */
+
+	static Segments slice(const Segments& segments, Frame a, Frame b);
+
+	/* getSegments
+	Returns the current content in range [a, b) as a list of Segments, whatever
+	the internal representation is. */
+
+	Segments getSegments(Frame a, Frame b) const;
+
+	/* makeSegments
+	Turns the contiguous buffer, if any, into a single Segment. No audio data 
+	is copied. */
+
+	void makeSegments();
+
+	/* setSegments
+	Sets the current segment list, recomputing segment start frames. */
+
+	void setSegments(Segments segments);
+
+	/* pushHistory
+	Saves the current state into the undo history and clears the redo one. */
+
+	void pushHistory();
+
+	Data                 m_buffer;   // Audio data, when consolidated
+	Segments             m_segments; // Audio data, when not consolidated
+	std::vector<Frame>   m_starts;   // Start frame of each segment
+	std::deque<Segments> m_undo;
+	std::deque<Segments> m_redo;
+	int                  m_rate;
+	int                  m_bits;
+	bool                 m_logical; // memory only (a take)
+	bool                 m_edited;  // edited via editor
+	int                  m_revision;
+	std::string          m_path;    // E.g. /path/to/my/sample.wav
 };
 } // namespace giada::m
 
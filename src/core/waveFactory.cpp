@@ -34,10 +34,16 @@
 #include "wave.h"
 #include "waveFx.h"
 #include <cmath>
+#include <filesystem>
 #include <fmt/core.h>
 #include <memory>
+#include <mutex>
 #include <samplerate.h>
 #include <sndfile.h>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace giada::m::waveFactory
 {
@@ -45,6 +51,26 @@ namespace
 {
 IdManager waveId_;
 
+/* pool_
+Audio data of Waves loaded from file, keyed by content hash. Identical samples
+share the same buffer. Entries are weak: data goes away with its last Wave. */
+
+std::unordered_map<std::size_t, std::weak_ptr<mcl::AudioBuffer>> pool_;
+
+/* files_
+Content hash and bit depth of each file decoded so far, keyed by file path, 
+modification time and conversion settings. Loading the same file again skips
+decoding altogether. */
+
+struct File
+{
+	std::size_t hash;
+	int         bits;
+};
+
+std::unordered_map<std::string, File> files_;
+std::mutex                            poolMutex_;
+
 /* -------------------------------------------------------------------------- */
 
 int getBits_(const SF_INFO& header)
@@ -68,9 +94,92 @@ int getBits_(const SF_INFO& header)
 
 /* -------------------------------------------------------------------------- */
 
-std::string makeWavePath_(const std::string& base, const m::Wave& w, int k)
+std::size_t hash_(const mcl::AudioBuffer& data)
+{
+	const std::size_t bytes = static_cast<std::size_t>(data.countFrames()) * data.countChannels() * sizeof(float);
+	const std::size_t h     = std::hash<std::string_view>{}({reinterpret_cast<const char*>(data[0]), bytes});
+	return h ^ (static_cast<std::size_t>(data.countChannels()) << 1);
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool equal_(const mcl::AudioBuffer& a, const mcl::AudioBuffer& b)
+{
+	if (a.countFrames() != b.countFrames() || a.countChannels() != b.countChannels())
+		return false;
+	return std::equal(a[0], a[0] + a.countFrames() * a.countChannels(), b[0]);
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::string makeFileKey_(const std::string& path, int samplerate, Resampler::Quality quality)
 {
-	return u::fs::join(base, fmt::format("{}-{}{}", w.getBasename(/*ext=*/false), k, w.getExtension()));
+	std::error_code ec;
+	const auto      time = std::filesystem::last_write_time(path, ec);
+	return fmt::format("{}:{}:{}:{}", path, ec ? 0 : time.time_since_epoch().count(),
+	    samplerate, static_cast<int>(quality));
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* purge_
+Removes pool entries whose data is no longer referenced by any Wave. */
+
+void purge_()
+{
+	for (auto it = pool_.begin(); it != pool_.end();)
+		it = it->second.expired() ? pool_.erase(it) : std::next(it);
+	for (auto it = files_.begin(); it != files_.end();)
+		it = pool_.count(it->second.hash) == 0 ? files_.erase(it) : std::next(it);
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* findFile_
+Returns the shared data of a file already loaded with 'key', if still alive. */
+
+std::pair<Wave::Data, int> findFile_(const std::string& key)
+{
+	std::scoped_lock lock(poolMutex_);
+
+	const auto file = files_.find(key);
+	if (file == files_.end())
+		return {nullptr, 0};
+	const auto data = pool_.find(file->second.hash);
+	if (data == pool_.end())
+		return {nullptr, 0};
+	return {data->second.lock(), file->second.bits};
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* share_
+Returns the pooled buffer with the same content as 'data', if any. Adds 'data'
+to the pool otherwise. */
+
+Wave::Data share_(Wave::Data data, const std::string& key, int bits)
+{
+	const std::size_t hash = hash_(*data);
+
+	std::scoped_lock lock(poolMutex_);
+
+	purge_();
+
+	if (const auto it = pool_.find(hash); it != pool_.end())
+		if (Wave::Data pooled = it->second.lock(); pooled != nullptr && equal_(*pooled, *data))
+			data = pooled;
+
+	pool_[hash] = data;
+	files_[key] = {hash, bits};
+
+	return data;
+}
+
+/* -------------------------------------------------------------------------- */
+
+std::string makeWavePath_(const std::string& base, const m::Wave& w, const std::string& ext, int k)
+{
+	return u::fs::join(base, fmt::format("{}-{}{}", w.getBasename(/*ext=*/false), k, ext));
 }
 
 /* -------------------------------------------------------------------------- */
@@ -90,17 +199,19 @@ bool isWavePathUnique_(const m::Wave& skip, const std::string& path,
 /* -------------------------------------------------------------------------- */
 
 std::string makeUniqueWavePath(const std::string& base, const m::Wave& w,
-    const std::vector<std::unique_ptr<Wave>>& waves)
+    const std::vector<std::unique_ptr<Wave>>& waves, const std::string& ext)
 {
-	std::string path = u::fs::join(base, w.getBasename(/*ext=*/true));
+	const std::string extension = ext.empty() ? w.getExtension() : ext;
+
+	std::string path = u::fs::join(base, w.getBasename(/*ext=*/false) + extension);
 	if (isWavePathUnique_(w, path, waves))
 		return path;
 
 	// TODO - just use a timestamp. e.g. makeWavePath_(..., ..., getTimeStamp())
 	int k = 0;
-	path  = makeWavePath_(base, w, k);
+	path  = makeWavePath_(base, w, extension, k);
 	while (!isWavePathUnique_(w, path, waves))
-		path = makeWavePath_(base, w, k++);
+		path = makeWavePath_(base, w, extension, k++);
 
 	return path;
 }
@@ -112,6 +223,10 @@ std::string makeUniqueWavePath(const std::string& base, const m::Wave& w,
 void reset()
 {
 	waveId_ = IdManager();
+
+	std::scoped_lock lock(poolMutex_);
+	pool_.clear();
+	files_.clear();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -127,6 +242,27 @@ Result createFromFile(const std::string& path, ID id, int samplerate, Resampler:
 	if (path.size() > FILENAME_MAX)
 		return {G_RES_ERR_PATH_TOO_LONG};
 
+	waveId_.set(id);
+
+	/* Same file already in memory, with the same conversion settings: share 
+	its data instead of decoding it again. */
+
+	const std::string fileKey      = makeFileKey_(path, samplerate, quality);
+	const auto        [data, bits] = findFile_(fileKey);
+
+	if (data != nullptr)
+	{
+		std::unique_ptr<Wave> wave = std::make_unique<Wave>(waveId_.generate(id));
+		wave->setSharedBuffer(data);
+		wave->setRate(samplerate);
+		wave->setBits(bits);
+		wave->setPath(path);
+
+		u::log::print("[waveManager::create] new Wave created, sharing {} frames\n", wave->countFrames());
+
+		return {G_RES_OK, std::move(wave)};
+	}
+
 	SF_INFO  header;
 	SNDFILE* fileIn = sf_open(path.c_str(), SFM_READ, &header);
 
@@ -142,8 +278,6 @@ Result createFromFile(const std::string& path, ID id, int samplerate, Resampler:
 		return {G_RES_ERR_WRONG_DATA};
 	}
 
-	waveId_.set(id);
-
 	std::unique_ptr<Wave> wave = std::make_unique<Wave>(waveId_.generate(id));
 	wave->alloc(header.frames, header.channels, header.samplerate, getBits_(header), path);
 
@@ -163,7 +297,11 @@ Result createFromFile(const std::string& path, ID id, int samplerate, Resampler:
 			return {G_RES_ERR_PROCESSING};
 	}
 
-	u::log::print("[waveManager::create] new Wave created, {} frames\n", wave->getBuffer().countFrames());
+	/* Identical content might come from a different file: share it anyway. */
+
+	wave->setSharedBuffer(share_(wave->getSharedBuffer(), fileKey, wave->getBits()));
+
+	u::log::print("[waveManager::create] new Wave created, {} frames\n", wave->countFrames());
 
 	return {G_RES_OK, std::move(wave)};
 }
@@ -188,17 +326,14 @@ std::unique_ptr<Wave> createEmpty(int frames, int channels, int samplerate,
 std::unique_ptr<Wave> createFromWave(const Wave& src, int a, int b)
 {
 	a = a == -1 ? 0 : a;
-	b = b == -1 ? src.getBuffer().countFrames() : b;
-
-	const int channels = src.getBuffer().countChannels();
-	const int frames   = b - a;
+	b = b == -1 ? src.countFrames() : b;
 
 	std::unique_ptr<Wave> wave = std::make_unique<Wave>(waveId_.generate());
-	wave->alloc(frames, channels, src.getRate(), src.getBits(), src.getPath());
-	wave->getBuffer().set(src.getBuffer(), frames);
+	wave->makeSlice(src, a, b);
+	wave->setPath(src.getPath());
 	wave->setLogical(true);
 
-	u::log::print("[waveManager::createFromWave] new Wave created, {} frames\n", frames);
+	u::log::print("[waveManager::createFromWave] new Wave created, {} frames (shared)\n", b - a);
 
 	return wave;
 }
@@ -219,22 +354,26 @@ const Patch::Wave serializeWave(const Wave& w)
 
 int resample(Wave& w, Resampler::Quality quality, int samplerate)
 {
+	w.consolidate();
+
+	const mcl::AudioBuffer& data = std::as_const(w).getBuffer();
+
 	float ratio         = samplerate / (float)w.getRate();
-	int   newSizeFrames = static_cast<int>(ceil(w.getBuffer().countFrames() * ratio));
+	int   newSizeFrames = static_cast<int>(ceil(data.countFrames() * ratio));
 
 	mcl::AudioBuffer newData;
-	newData.alloc(newSizeFrames, w.getBuffer().countChannels());
+	newData.alloc(newSizeFrames, data.countChannels());
 
 	SRC_DATA src_data;
-	src_data.data_in       = w.getBuffer()[0];
-	src_data.input_frames  = w.getBuffer().countFrames();
+	src_data.data_in       = data[0];
+	src_data.input_frames  = data.countFrames();
 	src_data.data_out      = newData[0];
 	src_data.output_frames = newSizeFrames;
 	src_data.src_ratio     = ratio;
 
 	u::log::print("[waveManager::resample] resampling: new size={} frames\n", newSizeFrames);
 
-	int ret = src_simple(&src_data, static_cast<int>(quality), w.getBuffer().countChannels());
+	int ret = src_simple(&src_data, static_cast<int>(quality), data.countChannels());
 	if (ret != 0)
 	{
 		u::log::print("[waveManager::resample] resampling error: {}\n", src_strerror(ret));
@@ -253,7 +392,7 @@ int save(const Wave& w, const std::string& path)
 {
 	SF_INFO header;
 	header.samplerate = w.getRate();
-	header.channels   = w.getBuffer().countChannels();
+	header.channels   = w.countChannels();
 	header.format     = SF_FORMAT_WAV | SF_FORMAT_FLOAT;
 
 	SNDFILE* file = sf_open(path.c_str(), SFM_WRITE, &header);
@@ -264,11 +403,102 @@ int save(const Wave& w, const std::string& path)
 		return G_RES_ERR_IO;
 	}
 
-	if (sf_writef_float(file, w.getBuffer()[0], w.getBuffer().countFrames()) != w.getBuffer().countFrames())
+	/* Edited Waves are written as they sound, i.e. rendering their segments. */
+
+	const mcl::AudioBuffer  rendered = w.isConsolidated() ? mcl::AudioBuffer() : w.render(0, w.countFrames());
+	const mcl::AudioBuffer& data     = w.isConsolidated() ? w.getBuffer() : rendered;
+
+	if (sf_writef_float(file, data[0], data.countFrames()) != data.countFrames())
 		u::log::print("[waveManager::save] warning: incomplete write!\n");
 
 	sf_close(file);
 
 	return G_RES_OK;
 }
+/* -------------------------------------------------------------------------- */
+
+int save(const SaveRequest& req)
+{
+	if (req.sourcePath.empty())
+		return save(req.wave, req.wave.getPath());
+
+	/* Lossless transcoding to FLAC. Samples are moved around as integers, so 
+	that no float conversion can alter them. */
+
+	SF_INFO  headerIn{};
+	SNDFILE* fileIn = sf_open(req.sourcePath.c_str(), SFM_READ, &headerIn);
+	if (fileIn == nullptr)
+	{
+		u::log::print("[waveManager::save] unable to read {}: {}\n", req.sourcePath, sf_strerror(fileIn));
+		return G_RES_ERR_IO;
+	}
+
+	const int subtype = headerIn.format & SF_FORMAT_SUBMASK;
+
+	SF_INFO headerOut{};
+	headerOut.samplerate = headerIn.samplerate;
+	headerOut.channels   = headerIn.channels;
+	headerOut.format     = SF_FORMAT_FLAC | (subtype == SF_FORMAT_PCM_U8 ? SF_FORMAT_PCM_S8 : subtype);
+
+	SNDFILE* fileOut = sf_open(req.wave.getPath().c_str(), SFM_WRITE, &headerOut);
+	if (fileOut == nullptr)
+	{
+		u::log::print("[waveManager::save] unable to open {} for exporting: {}\n",
+		    req.wave.getPath(), sf_strerror(fileOut));
+		sf_close(fileIn);
+		return G_RES_ERR_IO;
+	}
+
+	constexpr sf_count_t CHUNK_FRAMES = 65536;
+
+	std::vector<int> chunk(CHUNK_FRAMES * headerIn.channels);
+	sf_count_t       read = 0;
+	int              res  = G_RES_OK;
+
+	while ((read = sf_readf_int(fileIn, chunk.data(), CHUNK_FRAMES)) > 0)
+		if (sf_writef_int(fileOut, chunk.data(), read) != read)
+		{
+			u::log::print("[waveManager::save] warning: incomplete write!\n");
+			res = G_RES_ERR_IO;
+			break;
+		}
+
+	sf_close(fileIn);
+	sf_close(fileOut);
+
+	return res;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool canCompress(const Wave& w)
+{
+	if (w.isLogical() || w.isEdited())
+		return false;
+
+	SF_INFO  header{};
+	SNDFILE* file = sf_open(w.getPath().c_str(), SFM_READ, &header);
+	if (file == nullptr)
+		return false;
+	sf_close(file);
+
+	/* Data must match the file content: no resampling, same length. Mono files
+	are fine too, as they get converted to stereo again when loaded. */
+
+	if (header.samplerate != w.getRate() || header.frames != w.countFrames())
+		return false;
+	if (header.channels != w.countChannels() && header.channels != 1)
+		return false;
+
+	switch (header.format & SF_FORMAT_SUBMASK)
+	{
+	case SF_FORMAT_PCM_S8:
+	case SF_FORMAT_PCM_U8:
+	case SF_FORMAT_PCM_16:
+	case SF_FORMAT_PCM_24:
+		return true;
+	default:
+		return false;
+	}
+}
 } // namespace giada::m::waveFactory
@@ -43,6 +43,18 @@ struct Result
 	std::unique_ptr<Wave> wave = nullptr;
 };
 
+/* SaveRequest
+A Wave to be written to disk, possibly from a background thread. 'wave' is a
+snapshot sharing audio data with the live Wave, already pointing to the 
+destination path. If 'sourcePath' is not empty, that file is transcoded to 
+FLAC instead of writing audio data from memory. */
+
+struct SaveRequest
+{
+	Wave        wave;
+	std::string sourcePath = "";
+};
+
 /* reset
     Resets internal ID generator. */
 
@@ -51,7 +63,9 @@ void reset();
 /* create
 	Creates a new Wave object with data read from file 'path'. Pass id = 0 to 
 	auto-generate it. The function converts the Wave sample rate if it doesn't 
-	match the desired one as specified in 'samplerate'. */
+	match the desired one as specified in 'samplerate'. Waves with identical 
+	content share the same audio data; a file already loaded is not decoded 
+	again. */
 
 Result createFromFile(const std::string& path, ID id, int samplerate, Resampler::Quality);
 
@@ -62,8 +76,9 @@ std::unique_ptr<Wave> createEmpty(int frames, int channels, int samplerate,
     const std::string& name);
 
 /* createFromWave
-	Creates a new Wave from an existing one. If specified, copying the data in 
-	range a - b. Range is [0, sr.buffer.countFrames()] otherwise. */
+	Creates a new Wave from an existing one. If specified, referencing the data 
+	in range a - b. Range is [0, src.countFrames()] otherwise. Audio data is 
+	shared, not copied: it gets duplicated only when one of the two is edited. */
 
 std::unique_ptr<Wave> createFromWave(const Wave& src, int a = -1, int b = -1);
 
@@ -84,8 +99,25 @@ int resample(Wave&, Resampler::Quality, int samplerate);
 
 int save(const Wave& w, const std::string& path);
 
+/* save (2)
+	Fulfills a SaveRequest: either writes Wave data or transcodes its source 
+	file to FLAC, bit for bit. */
+
+int save(const SaveRequest&);
+
+/* canCompress
+	True if Wave 'w' can be stored as FLAC without any loss, i.e. its audio data
+	is still the one decoded from an integer PCM file of up to 24 bits, not
+	edited nor resampled. */
+
+bool canCompress(const Wave& w);
+
+/* makeUniqueWavePath
+	Returns a path in folder 'base' for Wave 'w', not used by any other Wave. 
+	The Wave extension is replaced by 'ext', if not empty. */
+
 std::string makeUniqueWavePath(const std::string& base, const m::Wave& w,
-    const std::vector<std::unique_ptr<Wave>>& waves);
+    const std::vector<std::unique_ptr<Wave>>& waves, const std::string& ext = "");
 } // namespace giada::m::waveFactory
 
 #endif
@@ -30,8 +30,12 @@
 #include "utils/log.h"
 #include "wave.h"
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cmath>
+#include <thread>
+#include <utility>
+#include <vector>
 
 /* Windows fix */
 #ifdef _WIN32
@@ -43,26 +47,187 @@ namespace giada::m::wfx
 {
 namespace
 {
-void fadeFrame_(Wave& w, int i, float val)
+/* CHUNK_SIZE
+Number of frames processed in a row by a single thread. Big enough to amortize
+the scheduling, small enough to give a smooth progress and a quick cancel. */
+
+constexpr Frame CHUNK_SIZE = 1 << 16;
+
+/* MAX_THREADS
+Upper limit to the number of threads spawned by a single operation. */
+
+constexpr unsigned MAX_THREADS = 8;
+
+/* -------------------------------------------------------------------------- */
+
+/* forEachChunk_
+Splits range [a, b) in chunks and calls 'f(chunkA, chunkB)' on each of them,
+spreading the work across the available cores. Progress moves from 'from' to 
+'to' as chunks are completed. Stops early if the operation gets cancelled. */
+
+template <typename F>
+void forEachChunk_(Frame a, Frame b, Progress& progress, float from, float to, F f)
+{
+	if (b <= a)
+		return;
+
+	const Frame    numChunks  = (b - a + CHUNK_SIZE - 1) / CHUNK_SIZE;
+	const unsigned numThreads = std::clamp<unsigned>(std::thread::hardware_concurrency(), 1, std::min<Frame>(numChunks, MAX_THREADS));
+
+	std::atomic<Frame> next = 0;
+	std::atomic<Frame> done = 0;
+
+	const auto work = [&]() {
+		for (Frame chunk = next.fetch_add(1); chunk < numChunks; chunk = next.fetch_add(1))
+		{
+			if (progress.isCancelled())
+				return;
+			const Frame chunkA = a + (chunk * CHUNK_SIZE);
+			const Frame chunkB = std::min(chunkA + CHUNK_SIZE, b);
+			f(chunkA, chunkB);
+			progress.set(from + (to - from) * ((done.fetch_add(1) + 1) / static_cast<float>(numChunks)));
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (unsigned i = 1; i < numThreads; i++)
+		threads.emplace_back(work);
+	work(); // The calling thread does its share too
+	for (std::thread& t : threads)
+		t.join();
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* copyFrames_
+Copies 'count' frames from 'src' to 'dest'. Both buffers must have the same 
+number of channels. */
+
+void copyFrames_(const mcl::AudioBuffer& src, Frame srcFrame, mcl::AudioBuffer& dest, Frame destFrame, Frame count)
+{
+	assert(src.countChannels() == dest.countChannels());
+
+	if (count <= 0)
+		return;
+	std::copy_n(src[srcFrame], count * src.countChannels(), dest[destFrame]);
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* transform_
+Builds a buffer of the same size of 'src', where frames in range [a, b) are 
+computed by 'f(src, dest, chunkA, chunkB)' and all the others are copied as 
+they are. Everything is done in a single pass. */
+
+template <typename F>
+mcl::AudioBuffer transform_(const mcl::AudioBuffer& src, Frame a, Frame b, Progress& progress, float from, float to, F f)
+{
+	const Frame size = src.countFrames();
+
+	a = std::clamp<Frame>(a, 0, size);
+	b = std::clamp<Frame>(b, a, size);
+
+	mcl::AudioBuffer dest;
+	dest.alloc(size, src.countChannels());
+
+	forEachChunk_(0, size, progress, from, to, [&](Frame chunkA, Frame chunkB) {
+		const Frame inA = std::clamp(a, chunkA, chunkB);
+		const Frame inB = std::clamp(b, chunkA, chunkB);
+		copyFrames_(src, chunkA, dest, chunkA, inA - chunkA);
+		if (inB > inA)
+			f(src, dest, inA, inB);
+		copyFrames_(src, inB, dest, inB, chunkB - inB);
+	});
+
+	return dest;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* getPeak_
+Returns the highest absolute value in 'numSamples' samples. Partial results
+are kept in independent lanes, so that the compiler can turn the reduction 
+into SIMD instructions (a single running max would be a loop-carried 
+dependency). */
+
+float getPeak_(const float* data, std::size_t numSamples)
+{
+	constexpr std::size_t LANES = 8;
+
+	std::array<float, LANES> peaks = {};
+
+	std::size_t i = 0;
+	for (; i + LANES <= numSamples; i += LANES)
+		for (std::size_t l = 0; l < LANES; l++)
+			peaks[l] = std::max(peaks[l], std::fabs(data[i + l]));
+
+	float peak = *std::max_element(peaks.begin(), peaks.end());
+	for (; i < numSamples; i++)
+		peak = std::max(peak, std::fabs(data[i]));
+	return peak;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* getPeak_ (2)
+Returns the highest absolute value in any channel in range [a, b). */
+
+float getPeak_(const mcl::AudioBuffer& buf, Frame a, Frame b, Progress& progress, float from, float to)
+{
+	std::atomic<float> peak = 0.0f;
+
+	forEachChunk_(a, b, progress, from, to, [&](Frame chunkA, Frame chunkB) {
+		const float chunkPeak = getPeak_(buf[chunkA], (chunkB - chunkA) * buf.countChannels());
+		float       curr      = peak.load();
+		while (chunkPeak > curr && !peak.compare_exchange_weak(curr, chunkPeak))
+			;
+	});
+
+	return peak.load();
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* applyGain_
+Multiplies 'numSamples' samples from 'src' by 'gain' into 'dest'. */
+
+void applyGain_(const float* src, float* dest, std::size_t numSamples, float gain)
 {
-	for (int j = 0; j < w.getBuffer().countChannels(); j++)
-		w.getBuffer()[i][j] *= val;
+	for (std::size_t i = 0; i < numSamples; i++)
+		dest[i] = src[i] * gain;
 }
 
 /* -------------------------------------------------------------------------- */
 
-float getPeak_(const Wave& w, int a, int b)
+/* applyRamp_
+Multiplies frames in range [a, b) by a linear gain ramp that is worth 
+'startGain' on frame 'origin' and moves by 'step' on each frame. */
+
+void applyRamp_(const mcl::AudioBuffer& src, mcl::AudioBuffer& dest, Frame a, Frame b,
+    Frame origin, float startGain, float step)
 {
-	float peak = 0.0f;
-	float abs  = 0.0f;
-	for (int i = a; i < b; i++)
+	const int channels = src.countChannels();
+	for (Frame i = a; i < b; i++)
 	{
-		for (int j = 0; j < w.getBuffer().countChannels(); j++) // Find highest value in any channel
-			abs = fabs(w.getBuffer()[i][j]);
-		if (abs > peak)
-			peak = abs;
+		const float  gain = startGain + (step * (i - origin));
+		const float* in   = src[i];
+		float*       out  = dest[i];
+		for (int j = 0; j < channels; j++)
+			out[j] = in[j] * gain;
 	}
-	return peak;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* replace_
+Replaces Wave's data with the result of a buffer-based operation. */
+
+template <typename F>
+void replace_(Wave& w, F f)
+{
+	Progress progress;
+	w.replaceData(f(std::as_const(w).getBuffer(), progress));
+	w.setEdited(true);
 }
 } // namespace
 
@@ -72,33 +237,48 @@ float getPeak_(const Wave& w, int a, int b)
 
 constexpr int SMOOTH_SIZE = 32;
 
-void normalize(Wave& w, int a, int b)
+/* -------------------------------------------------------------------------- */
+
+Progress::Progress()
+: m_value(0.0f)
+, m_cancelled(false)
 {
-	float peak = getPeak_(w, a, b);
-	if (peak == 0.0f || peak > 1.0f)
-		return;
+}
 
-	for (int i = a; i < b; i++)
-	{
-		for (int j = 0; j < w.getBuffer().countChannels(); j++)
-			w.getBuffer()[i][j] = w.getBuffer()[i][j] * (1.0f / peak);
-	}
-	w.setEdited(true);
+/* -------------------------------------------------------------------------- */
+
+float Progress::get() const { return m_value.load(); }
+bool  Progress::isCancelled() const { return m_cancelled.load(); }
+
+/* -------------------------------------------------------------------------- */
+
+void Progress::set(float v) { m_value.store(v); }
+void Progress::cancel() { m_cancelled.store(true); }
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+void normalize(Wave& w, int a, int b)
+{
+	replace_(w, [a, b](const mcl::AudioBuffer& buf, Progress& p) { return normalize(buf, a, b, p); });
 }
 
 /* -------------------------------------------------------------------------- */
 
 int monoToStereo(Wave& w)
 {
-	if (w.getBuffer().countChannels() >= G_MAX_IO_CHANS)
+	const mcl::AudioBuffer& data = std::as_const(w).getBuffer();
+
+	if (data.countChannels() >= G_MAX_IO_CHANS)
 		return G_RES_OK;
 
 	mcl::AudioBuffer newData;
-	newData.alloc(w.getBuffer().countFrames(), G_MAX_IO_CHANS);
+	newData.alloc(data.countFrames(), G_MAX_IO_CHANS);
 
 	for (int i = 0; i < newData.countFrames(); i++)
 		for (int j = 0; j < newData.countChannels(); j++)
-			newData[i][j] = w.getBuffer()[i][0];
+			newData[i][j] = data[i][0];
 
 	w.replaceData(std::move(newData));
 
@@ -109,151 +289,250 @@ int monoToStereo(Wave& w)
 
 void silence(Wave& w, int a, int b)
 {
-	u::log::print("[wfx::silence] silencing from {} to {}\n", a, b);
-
-	for (int i = a; i < b; i++)
-		for (int j = 0; j < w.getBuffer().countChannels(); j++)
-			w.getBuffer()[i][j] = 0.0f;
-	w.setEdited(true);
+	replace_(w, [a, b](const mcl::AudioBuffer& buf, Progress& p) { return silence(buf, a, b, p); });
 }
 
 /* -------------------------------------------------------------------------- */
 
 void cut(Wave& w, int a, int b)
 {
-	if (a < 0)
-		a = 0;
-	if (b > w.getBuffer().countFrames())
-		b = w.getBuffer().countFrames();
+	replace_(w, [a, b](const mcl::AudioBuffer& buf, Progress& p) { return cut(buf, a, b, p); });
+}
 
-	/* Create a new temp wave and copy there the original one, skipping the a-b
-    range. */
+/* -------------------------------------------------------------------------- */
 
-	int newSize = w.getBuffer().countFrames() - (b - a);
+void trim(Wave& w, Frame a, Frame b)
+{
+	replace_(w, [a, b](const mcl::AudioBuffer& buf, Progress& p) { return trim(buf, a, b, p); });
+}
 
-	mcl::AudioBuffer newData;
-	newData.alloc(newSize, w.getBuffer().countChannels());
+/* -------------------------------------------------------------------------- */
 
-	u::log::print("[wfx::cut] cutting from {} to {}\n", a, b);
+void paste(const Wave& src, Wave& des, Frame a)
+{
+	replace_(des, [&src, a](const mcl::AudioBuffer& buf, Progress& p) { return paste(src.getBuffer(), buf, a, p); });
+}
+
+/* -------------------------------------------------------------------------- */
 
-	for (int i = 0, k = 0; i < w.getBuffer().countFrames(); i++)
+void fade(Wave& w, int a, int b, Fade type)
+{
+	replace_(w, [a, b, type](const mcl::AudioBuffer& buf, Progress& p) { return fade(buf, a, b, type, p); });
+}
+
+/* -------------------------------------------------------------------------- */
+
+void smooth(Wave& w, int a, int b)
+{
+	/* Do nothing if fade edges (both of SMOOTH_SIZE samples) are > than selected 
+	portion of wave. SMOOTH_SIZE*2 to count both edges. */
+
+	if (SMOOTH_SIZE * 2 > (b - a))
 	{
-		if (i < a || i >= b)
-		{
-			for (int j = 0; j < w.getBuffer().countChannels(); j++)
-				newData[k][j] = w.getBuffer()[i][j];
-			k++;
-		}
+		u::log::print("[wfx::smooth] selection is too small, nothing to do\n");
+		return;
 	}
 
-	w.replaceData(std::move(newData));
-	w.setEdited(true);
+	replace_(w, [a, b](const mcl::AudioBuffer& buf, Progress& p) { return smooth(buf, a, b, p); });
 }
 
 /* -------------------------------------------------------------------------- */
 
-void trim(Wave& w, Frame a, Frame b)
+void shift(Wave& w, Frame offset)
 {
-	if (a < 0)
-		a = 0;
-	if (b > w.getBuffer().countFrames())
-		b = w.getBuffer().countFrames();
+	replace_(w, [offset](const mcl::AudioBuffer& buf, Progress& p) { return shift(buf, offset, p); });
+}
 
-	Frame newSize = b - a;
+/* -------------------------------------------------------------------------- */
 
-	mcl::AudioBuffer newData;
-	newData.alloc(newSize, w.getBuffer().countChannels());
+void reverse(Wave& w, Frame a, Frame b)
+{
+	replace_(w, [a, b](const mcl::AudioBuffer& buf, Progress& p) { return reverse(buf, a, b, p); });
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
+mcl::AudioBuffer normalize(const mcl::AudioBuffer& buf, Frame a, Frame b, Progress& progress)
+{
+	a = std::clamp<Frame>(a, 0, buf.countFrames());
+	b = std::clamp<Frame>(b, a, buf.countFrames());
+
+	const float peak = getPeak_(buf, a, b, progress, 0.0f, 0.5f);
+	const float gain = peak == 0.0f || peak > 1.0f ? 1.0f : 1.0f / peak;
+
+	return transform_(buf, a, b, progress, 0.5f, 1.0f, [gain](const mcl::AudioBuffer& src, mcl::AudioBuffer& dest, Frame chunkA, Frame chunkB) {
+		applyGain_(src[chunkA], dest[chunkA], (chunkB - chunkA) * src.countChannels(), gain);
+	});
+}
+
+/* -------------------------------------------------------------------------- */
+
+mcl::AudioBuffer silence(const mcl::AudioBuffer& buf, Frame a, Frame b, Progress& progress)
+{
+	u::log::print("[wfx::silence] silencing from {} to {}\n", a, b);
+
+	return transform_(buf, a, b, progress, 0.0f, 1.0f, [](const mcl::AudioBuffer& src, mcl::AudioBuffer& dest, Frame chunkA, Frame chunkB) {
+		std::fill_n(dest[chunkA], (chunkB - chunkA) * src.countChannels(), 0.0f);
+	});
+}
+
+/* -------------------------------------------------------------------------- */
+
+mcl::AudioBuffer cut(const mcl::AudioBuffer& buf, Frame a, Frame b, Progress& progress)
+{
+	a = std::clamp<Frame>(a, 0, buf.countFrames());
+	b = std::clamp<Frame>(b, a, buf.countFrames());
+
+	u::log::print("[wfx::cut] cutting from {} to {}\n", a, b);
+
+	/* |---original data---|///cut///|---original data---|
+	         buf[0, a)                   buf[b, buf.size)	*/
+
+	mcl::AudioBuffer out;
+	out.alloc(buf.countFrames() - (b - a), buf.countChannels());
+
+	forEachChunk_(0, out.countFrames(), progress, 0.0f, 1.0f, [&](Frame chunkA, Frame chunkB) {
+		const Frame split = std::clamp(a, chunkA, chunkB);
+		copyFrames_(buf, chunkA, out, chunkA, split - chunkA);
+		copyFrames_(buf, split + (b - a), out, split, chunkB - split);
+	});
+
+	return out;
+}
+
+/* -------------------------------------------------------------------------- */
+
+mcl::AudioBuffer trim(const mcl::AudioBuffer& buf, Frame a, Frame b, Progress& progress)
+{
+	a = std::clamp<Frame>(a, 0, buf.countFrames());
+	b = std::clamp<Frame>(b, a, buf.countFrames());
 
 	u::log::print("[wfx::trim] trimming from {} to {} (area = {})\n", a, b, b - a);
 
-	for (int i = 0; i < newData.countFrames(); i++)
-		for (int j = 0; j < newData.countChannels(); j++)
-			newData[i][j] = w.getBuffer()[i + a][j];
+	mcl::AudioBuffer out;
+	out.alloc(b - a, buf.countChannels());
 
-	w.replaceData(std::move(newData));
-	w.setEdited(true);
+	forEachChunk_(0, out.countFrames(), progress, 0.0f, 1.0f, [&](Frame chunkA, Frame chunkB) {
+		copyFrames_(buf, chunkA + a, out, chunkA, chunkB - chunkA);
+	});
+
+	return out;
 }
 
 /* -------------------------------------------------------------------------- */
 
-void paste(const Wave& src, Wave& des, Frame a)
+mcl::AudioBuffer paste(const mcl::AudioBuffer& src, const mcl::AudioBuffer& dest, Frame a, Progress& progress)
 {
-	assert(src.getBuffer().countChannels() == des.getBuffer().countChannels());
+	assert(src.countChannels() == dest.countChannels());
 
-	mcl::AudioBuffer newData;
-	newData.alloc(src.getBuffer().countFrames() + des.getBuffer().countFrames(), des.getBuffer().countChannels());
+	a = std::clamp<Frame>(a, 0, dest.countFrames());
+
+	const Frame srcSize = src.countFrames();
+
+	mcl::AudioBuffer out;
+	out.alloc(srcSize + dest.countFrames(), dest.countChannels());
 
 	/* |---original data---|///paste data///|---original data---|
 	         des[0, a)      src[0, src.size)   des[a, des.size)	*/
 
-	newData.set(des.getBuffer(), a, 0);
-	newData.set(src.getBuffer(), src.getBuffer().countFrames(), a);
-	newData.set(des.getBuffer(), des.getBuffer().countFrames() - a, src.getBuffer().countFrames() + a);
+	forEachChunk_(0, out.countFrames(), progress, 0.0f, 1.0f, [&](Frame chunkA, Frame chunkB) {
+		const Frame pasteA = std::clamp(a, chunkA, chunkB);
+		const Frame pasteB = std::clamp(a + srcSize, chunkA, chunkB);
+		copyFrames_(dest, chunkA, out, chunkA, pasteA - chunkA);
+		copyFrames_(src, pasteA - a, out, pasteA, pasteB - pasteA);
+		copyFrames_(dest, pasteB - srcSize, out, pasteB, chunkB - pasteB);
+	});
 
-	des.replaceData(std::move(newData));
-	des.setEdited(true);
+	return out;
 }
 
 /* -------------------------------------------------------------------------- */
 
-void fade(Wave& w, int a, int b, Fade type)
+mcl::AudioBuffer fade(const mcl::AudioBuffer& buf, Frame a, Frame b, Fade type, Progress& progress)
 {
 	u::log::print("[wfx::fade] fade from {} to {} (range = {})\n", a, b, b - a);
 
-	float m = 0.0f;
-	float d = 1.0f / (float)(b - a);
+	/* Both edges are included in the fade: frame 'a' (fade in) or frame 'b'
+	(fade out) are fully silenced. */
 
-	if (type == Fade::IN)
-		for (int i = a; i <= b; i++, m += d)
-			fadeFrame_(w, i, m);
-	else
-		for (int i = b; i >= a; i--, m += d)
-			fadeFrame_(w, i, m);
+	const float step = 1.0f / (b - a);
 
-	w.setEdited(true);
+	return transform_(buf, a, b + 1, progress, 0.0f, 1.0f, [=](const mcl::AudioBuffer& src, mcl::AudioBuffer& dest, Frame chunkA, Frame chunkB) {
+		if (type == Fade::IN)
+			applyRamp_(src, dest, chunkA, chunkB, a, 0.0f, step);
+		else
+			applyRamp_(src, dest, chunkA, chunkB, b, 0.0f, -step);
+	});
 }
 
 /* -------------------------------------------------------------------------- */
 
-void smooth(Wave& w, int a, int b)
+mcl::AudioBuffer smooth(const mcl::AudioBuffer& buf, Frame a, Frame b, Progress& progress)
 {
-	/* Do nothing if fade edges (both of SMOOTH_SIZE samples) are > than selected 
-	portion of wave. SMOOTH_SIZE*2 to count both edges. */
-
 	if (SMOOTH_SIZE * 2 > (b - a))
 	{
 		u::log::print("[wfx::smooth] selection is too small, nothing to do\n");
-		return;
+		return buf;
 	}
 
-	fade(w, a, a + SMOOTH_SIZE, Fade::IN);
-	fade(w, b - SMOOTH_SIZE, b, Fade::OUT);
+	/* Fade in on [a, a + SMOOTH_SIZE], fade out on [b - SMOOTH_SIZE, b], copy
+	everything in between. */
+
+	const Frame fadeInEnd    = a + SMOOTH_SIZE + 1;
+	const Frame fadeOutStart = b - SMOOTH_SIZE;
+	const float step         = 1.0f / SMOOTH_SIZE;
+
+	return transform_(buf, a, b + 1, progress, 0.0f, 1.0f, [=](const mcl::AudioBuffer& src, mcl::AudioBuffer& dest, Frame chunkA, Frame chunkB) {
+		const Frame inEnd    = std::clamp(fadeInEnd, chunkA, chunkB);
+		const Frame outStart = std::clamp(fadeOutStart, inEnd, chunkB);
+		applyRamp_(src, dest, chunkA, inEnd, a, 0.0f, step);
+		copyFrames_(src, inEnd, dest, inEnd, outStart - inEnd);
+		applyRamp_(src, dest, outStart, chunkB, b, 0.0f, -step);
+	});
 }
 
 /* -------------------------------------------------------------------------- */
 
-void shift(Wave& w, Frame offset)
+mcl::AudioBuffer reverse(const mcl::AudioBuffer& buf, Frame a, Frame b, Progress& progress)
 {
-	if (offset < 0)
-		offset = (w.getBuffer().countFrames() + w.getBuffer().countChannels()) + offset;
+	a = std::clamp<Frame>(a, 0, buf.countFrames());
+	b = std::clamp<Frame>(b, a, buf.countFrames());
 
-	float* begin = w.getBuffer()[0];
-	float* end   = w.getBuffer()[0] + (w.getBuffer().countFrames() * w.getBuffer().countChannels());
+	/* Frames are reversed, while the order of channels in each frame is 
+	preserved. */
 
-	std::rotate(begin, end - (offset * w.getBuffer().countChannels()), end);
-	w.setEdited(true);
+	return transform_(buf, a, b, progress, 0.0f, 1.0f, [a, b](const mcl::AudioBuffer& src, mcl::AudioBuffer& dest, Frame chunkA, Frame chunkB) {
+		const int channels = src.countChannels();
+		for (Frame i = chunkA; i < chunkB; i++)
+			std::copy_n(src[a + b - 1 - i], channels, dest[i]);
+	});
 }
 
 /* -------------------------------------------------------------------------- */
 
-void reverse(Wave& w, Frame a, Frame b)
+mcl::AudioBuffer shift(const mcl::AudioBuffer& buf, Frame offset, Progress& progress)
 {
-	/* https://stackoverflow.com/questions/33201528/reversing-an-array-of-structures-in-c */
-	float* begin = w.getBuffer()[0] + (a * w.getBuffer().countChannels());
-	float* end   = w.getBuffer()[0] + (b * w.getBuffer().countChannels());
+	const Frame size = buf.countFrames();
+	if (size == 0)
+		return buf;
 
-	std::reverse(begin, end);
+	/* Rotate right by 'offset' frames: frame 'i' ends up in 'i + offset'. A
+	negative offset rotates left. */
 
-	w.setEdited(true);
+	offset = ((offset % size) + size) % size;
+
+	mcl::AudioBuffer out;
+	out.alloc(size, buf.countChannels());
+
+	forEachChunk_(0, size, progress, 0.0f, 1.0f, [&](Frame chunkA, Frame chunkB) {
+		const Frame srcA  = (chunkA - offset + size) % size;
+		const Frame first = std::min(chunkB - chunkA, size - srcA); // Before wrapping around
+		copyFrames_(buf, srcA, out, chunkA, first);
+		copyFrames_(buf, 0, out, chunkA + first, (chunkB - chunkA) - first);
+	});
+
+	return out;
 }
 } // namespace giada::m::wfx
@@ -28,6 +28,12 @@
 #define G_WAVE_FX_H
 
 #include "core/types.h"
+#include <atomic>
+
+namespace mcl
+{
+class AudioBuffer;
+}
 
 namespace giada::m
 {
@@ -47,6 +53,27 @@ enum class Fade
 	OUT
 };
 
+/* Progress
+State of a long-running operation, shared between the thread performing it and
+the rest of the world: completion ratio in [0.0, 1.0] plus a cancellation flag
+checked between chunks of work. */
+
+class Progress
+{
+public:
+	Progress();
+
+	float get() const;
+	bool  isCancelled() const;
+
+	void set(float);
+	void cancel();
+
+private:
+	std::atomic<float> m_value;
+	std::atomic<bool>  m_cancelled;
+};
+
 /* monoToStereo
 Converts a 1-channel Wave to a 2-channels wave. */
 
@@ -82,6 +109,25 @@ Flips Wave's data. */
 void reverse(Wave& v, Frame a, Frame b);
 
 void shift(Wave& w, Frame offset);
+
+/* -------------------------------------------------------------------------- */
+
+/* The following functions don't touch the source buffer: they return a new one
+with the operation applied instead, so that they can run on a separate thread
+while the original data is still being played. Work is split in chunks across
+all the available cores. The returned buffer is incomplete if the operation
+has been cancelled through 'Progress'. Ranges follow the same rules of the Wave
+counterparts above. */
+
+mcl::AudioBuffer normalize(const mcl::AudioBuffer&, Frame a, Frame b, Progress&);
+mcl::AudioBuffer silence(const mcl::AudioBuffer&, Frame a, Frame b, Progress&);
+mcl::AudioBuffer cut(const mcl::AudioBuffer&, Frame a, Frame b, Progress&);
+mcl::AudioBuffer trim(const mcl::AudioBuffer&, Frame a, Frame b, Progress&);
+mcl::AudioBuffer paste(const mcl::AudioBuffer& src, const mcl::AudioBuffer& dest, Frame a, Progress&);
+mcl::AudioBuffer fade(const mcl::AudioBuffer&, Frame a, Frame b, Fade, Progress&);
+mcl::AudioBuffer smooth(const mcl::AudioBuffer&, Frame a, Frame b, Progress&);
+mcl::AudioBuffer reverse(const mcl::AudioBuffer&, Frame a, Frame b, Progress&);
+mcl::AudioBuffer shift(const mcl::AudioBuffer&, Frame offset, Progress&);
 } // namespace giada::m::wfx
 
 #endif
@@ -0,0 +1,150 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#include "core/wavePeaks.h"
+#include "core/wave.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace giada::m
+{
+WavePeaks::WavePeaks(const Wave& w)
+: m_frames(w.countFrames())
+{
+	/* Level 0: scan the whole Wave. */
+
+	std::vector<Block> level;
+	level.reserve((m_frames + BLOCK_SIZE - 1) / BLOCK_SIZE);
+	for (Frame a = 0; a < m_frames; a += BLOCK_SIZE)
+		level.push_back(scan(w, a, std::min(a + BLOCK_SIZE, m_frames)));
+	m_levels.push_back(std::move(level));
+
+	/* Upper levels: merge pairs of blocks, until there's just one left. */
+
+	while (m_levels.back().size() > 1)
+	{
+		const std::vector<Block>& prev = m_levels.back();
+		std::vector<Block>        next;
+		next.reserve((prev.size() + 1) / 2);
+		for (std::size_t i = 0; i < prev.size(); i += 2)
+			next.push_back(i + 1 < prev.size() ? merge(prev[i], prev[i + 1]) : prev[i]);
+		m_levels.push_back(std::move(next));
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+WavePeaks::Peak WavePeaks::get(const Wave& w, Frame a, Frame b) const
+{
+	assert(w.countFrames() == m_frames);
+
+	a = std::clamp(a, 0, m_frames);
+	b = std::clamp(b, a, m_frames);
+
+	/* Pick the coarsest level whose blocks are still small enough compared to
+	the range (at most 1/4 of it), so that blocks straddling the range edges 
+	don't blur the result. Ranges too small for level 0 are scanned directly. */
+
+	constexpr Frame MIN_BLOCKS = 4;
+
+	if (b - a < BLOCK_SIZE * MIN_BLOCKS)
+	{
+		const Block block = scan(w, a, b);
+		return {block.min, block.max, b > a ? std::sqrt(block.sumSquares / (b - a)) : 0.0f};
+	}
+
+	std::size_t level = 0;
+	while (level + 1 < m_levels.size() && (BLOCK_SIZE << (level + 1)) * MIN_BLOCKS <= b - a)
+		level++;
+
+	const std::vector<Block>& blocks = m_levels[level];
+	const Frame               size   = BLOCK_SIZE << level;
+	const std::size_t         first  = a / size;
+	const std::size_t         last   = std::min<std::size_t>((b - 1) / size, blocks.size() - 1);
+
+	Block block = blocks[first];
+	for (std::size_t i = first + 1; i <= last; i++)
+		block = merge(block, blocks[i]);
+
+	const Frame frames = std::min<Frame>((last + 1) * size, m_frames) - first * size;
+
+	return {block.min, block.max, std::sqrt(block.sumSquares / frames)};
+}
+
+/* -------------------------------------------------------------------------- */
+
+Frame WavePeaks::countFrames() const
+{
+	return m_frames;
+}
+
+/* -------------------------------------------------------------------------- */
+
+WavePeaks::Block WavePeaks::merge(const Block& a, const Block& b)
+{
+	return {
+	    std::min(a.min, b.min),
+	    std::max(a.max, b.max),
+	    a.sumSquares + b.sumSquares};
+}
+
+/* -------------------------------------------------------------------------- */
+
+WavePeaks::Block WavePeaks::scan(const Wave& w, Frame a, Frame b)
+{
+	if (a >= b)
+		return {0.0f, 0.0f, 0.0f};
+
+	const int channels = w.countChannels();
+
+	Block block{std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest(), 0.0f};
+
+	for (Frame i = a; i < b;)
+	{
+		const Wave::Chunk chunk  = w.getChunk(i);
+		const Frame       frames = std::min(chunk.length, b - i);
+
+		for (Frame f = 0; f < frames; f++)
+		{
+			const float* frame = chunk.data + f * channels;
+
+			float avg = 0.0f;
+			for (int c = 0; c < channels; c++)
+				avg += frame[c];
+			avg /= channels;
+
+			block.min = std::min(block.min, avg);
+			block.max = std::max(block.max, avg);
+			block.sumSquares += avg * avg;
+		}
+		i += frames;
+	}
+
+	return block;
+}
+} // namespace giada::m
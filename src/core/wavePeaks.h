@@ -0,0 +1,91 @@
+/* -----------------------------------------------------------------------------
+ *
+ * Giada - Your Hardcore Loopmachine
+ *
+ * -----------------------------------------------------------------------------
+ *
+ * Copyright (C) 2010-2023 Giovanni A. Zuliani | Monocasual Laboratories
+ *
+ * This file is part of Giada - Your Hardcore Loopmachine.
+ *
+ * Giada - Your Hardcore Loopmachine is free software: you can
+ * redistribute it and/or modify it under the terms of the GNU General
+ * Public License as published by the Free Software Foundation, either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * Giada - Your Hardcore Loopmachine is distributed in the hope that it
+ * will be useful, but WITHOUT ANY WARRANTY; without even the implied
+ * warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Giada - Your Hardcore Loopmachine. If not, see
+ * <http://www.gnu.org/licenses/>.
+ *
+ * -------------------------------------------------------------------------- */
+
+#ifndef G_WAVE_PEAKS_H
+#define G_WAVE_PEAKS_H
+
+#include "core/types.h"
+#include <vector>
+
+namespace giada::m
+{
+class Wave;
+
+/* WavePeaks
+Multi-resolution summary of a Wave's audio data, used for drawing. Level 0 
+stores min, max and sum of squares of each block of BLOCK_SIZE frames; each 
+following level merges pairs of blocks of the previous one. Channels are 
+averaged together. */
+
+class WavePeaks final
+{
+public:
+	struct Peak
+	{
+		float min;
+		float max;
+		float rms;
+	};
+
+	static constexpr Frame BLOCK_SIZE = 256;
+
+	/* WavePeaks
+	Scans Wave 'w' and builds the pyramid. Takes time proportional to the size
+	of the Wave: meant to be run in background. */
+
+	explicit WavePeaks(const Wave& w);
+
+	/* get
+	Returns the peak of range [a, b). Wave 'w' must be the one used to build 
+	this object: it is read directly when the range is too small to be served
+	by the pyramid. Takes time proportional to the number of blocks involved, 
+	which is bounded regardless of the range length. */
+
+	Peak get(const Wave& w, Frame a, Frame b) const;
+
+	Frame countFrames() const;
+
+private:
+	/* Block
+	A summary of a range of frames. Sum of squares is stored instead of RMS, so
+	that blocks of different length can be merged. */
+
+	struct Block
+	{
+		float min;
+		float max;
+		float sumSquares;
+	};
+
+	static Block merge(const Block& a, const Block& b);
+	static Block scan(const Wave& w, Frame a, Frame b);
+
+	std::vector<std::vector<Block>> m_levels;
+	Frame                           m_frames;
+};
+} // namespace giada::m
+
+#endif
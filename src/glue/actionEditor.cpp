@@ -33,7 +33,7 @@
 #include "glue/main.h"
 #include <cassert>
 
-extern giada::m::Engine g_engine;
+extern giada::m::Engine& g_engine;
 
 namespace giada::c::actionEditor
 {
@@ -52,7 +52,7 @@ Data::Data(const m::Channel& c)
 , framesInBeat(g_engine.getMainApi().getFramesInBeat())
 , framesInBar(g_engine.getMainApi().getFramesInBar())
 , framesInLoop(g_engine.getMainApi().getFramesInLoop())
-, actions(g_engine.getActionEditorApi().getActionsOnChannel(c.id))
+, actions(g_engine.getActionEditorApi().getActionsOnChannel(c.id), framesInLoop)
 {
 	if (c.type == ChannelType::SAMPLE)
 		sample = std::make_optional<SampleData>(c.samplePlayer.value());
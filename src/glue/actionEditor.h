@@ -27,6 +27,7 @@
 #ifndef G_GLUE_ACTION_EDITOR_H
 #define G_GLUE_ACTION_EDITOR_H
 
+#include "core/actions/actionIndex.h"
 #include "core/types.h"
 #include <optional>
 #include <string>
@@ -34,7 +35,6 @@
 
 namespace giada::m
 {
-struct Action;
 class SamplePlayer;
 class Channel;
 } // namespace giada::m
@@ -66,7 +66,7 @@ struct Data
 	Frame                  framesInBeat;
 	Frame                  framesInBar;
 	Frame                  framesInLoop;
-	std::vector<m::Action> actions;
+	m::ActionIndex         actions;
 
 	std::optional<SampleData> sample;
 };
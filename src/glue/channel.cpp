@@ -64,8 +64,8 @@
 #include <cmath>
 #include <functional>
 
-extern giada::v::Ui     g_ui;
-extern giada::m::Engine g_engine;
+extern giada::v::Ui&     g_ui;
+extern giada::m::Engine& g_engine;
 
 namespace giada::c::channel
 {
@@ -135,6 +135,23 @@ Data::Data(const m::Channel& c)
 		midi = std::make_optional<MidiData>(c);
 }
 
+State Data::getState() const
+{
+	const m::Channel& ch   = g_engine.getChannelsApi().get(id);
+	const m::MainApi& main = g_engine.getMainApi();
+
+	return {
+	    m_playStatus->load(),
+	    m_recStatus->load(),
+	    m_readActions->load(),
+	    main.isRecordingInput(),
+	    main.isRecordingActions(),
+	    ch.isMuted(),
+	    ch.isSoloed(),
+	    ch.armed,
+	    sample ? sample->getTracker() : 0};
+}
+
 ChannelStatus Data::getPlayStatus() const { return m_playStatus->load(); }
 ChannelStatus Data::getRecStatus() const { return m_recStatus->load(); }
 bool          Data::getReadActions() const { return m_readActions->load(); }
@@ -296,7 +313,7 @@ void clearAllActions(ID channelId)
 void setCallbacks(m::Channel& ch)
 {
 	auto onSendMidiCb = [channelId = ch.id]() {
-		g_ui.pumpEvent([channelId]() { g_ui.mainWindow->keyboard->notifyMidiOut(channelId); });
+		g_ui.notify(v::Updater::Notification::CHANNEL_MIDI_OUT, channelId);
 	};
 
 	ch.midiLighter.onSend = onSendMidiCb;
@@ -332,7 +349,7 @@ float setChannelVolume(ID channelId, float v, Thread t, bool repaintMainUi)
 	notifyChannelForMidiIn(t, channelId);
 
 	if (t != Thread::MAIN || repaintMainUi)
-		g_ui.pumpEvent([channelId, v]() { g_ui.mainWindow->keyboard->setChannelVolume(channelId, v); });
+		g_ui.notify(v::Updater::Notification::CHANNEL_VOLUME, channelId, v);
 
 	return v;
 }
@@ -342,9 +359,7 @@ float setChannelVolume(ID channelId, float v, Thread t, bool repaintMainUi)
 float setChannelPitch(ID channelId, float v, Thread t)
 {
 	g_engine.getChannelsApi().setPitch(channelId, v);
-	g_ui.pumpEvent([v]() {
-		if (auto* w = sampleEditor::getWindow(); w != nullptr)
-			w->pitchTool->update(v); });
+	g_ui.notify(v::Updater::Notification::CHANNEL_PITCH, channelId, v);
 	notifyChannelForMidiIn(t, channelId);
 	return v;
 }
@@ -405,7 +420,7 @@ void sendMidiToChannel(ID channelId, m::MidiEvent e, Thread t)
 void notifyChannelForMidiIn(Thread t, ID channelId)
 {
 	if (t == Thread::MIDI)
-		g_ui.pumpEvent([channelId]() { g_ui.mainWindow->keyboard->notifyMidiIn(channelId); });
+		g_ui.notify(v::Updater::Notification::CHANNEL_MIDI_IN, channelId);
 }
 
 } // namespace giada::c::channel
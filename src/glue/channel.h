@@ -55,6 +55,8 @@ struct SampleData
 	SampleData() = delete;
 	SampleData(const m::Channel&);
 
+	bool operator==(const SampleData&) const = default;
+
 	Frame getTracker() const;
 
 	ID               waveId;
@@ -75,14 +77,44 @@ struct MidiData
 	MidiData() = delete;
 	MidiData(const m::Channel&);
 
+	bool operator==(const MidiData&) const = default;
+
 	bool isOutputEnabled;
 	int  filter;
 };
 
+/* State
+Snapshot of the channel properties that change while the UI is idle, i.e.
+without a model rebuild. Compare two States to know whether a channel widget
+needs to be repainted. */
+
+struct State
+{
+	bool operator==(const State&) const = default;
+
+	ChannelStatus playStatus;
+	ChannelStatus recStatus;
+	bool          readActions;
+	bool          recordingInput;
+	bool          recordingActions;
+	bool          muted;
+	bool          soloed;
+	bool          armed;
+	Frame         tracker;
+};
+
 struct Data
 {
 	Data(const m::Channel&);
 
+	bool operator==(const Data&) const = default;
+
+	/* getState
+	Returns the current State with a single model lookup. Prefer this to the
+	individual getters below when reading more than one property. */
+
+	State getState() const;
+
 	ChannelStatus getPlayStatus() const;
 	ChannelStatus getRecStatus() const;
 	bool          getReadActions() const;
@@ -43,8 +43,8 @@
 #include <cstddef>
 #include <fmt/core.h>
 
-extern giada::v::Ui     g_ui;
-extern giada::m::Engine g_engine;
+extern giada::v::Ui&     g_ui;
+extern giada::m::Engine& g_engine;
 
 namespace giada::c::config
 {
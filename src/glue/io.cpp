@@ -49,8 +49,8 @@
 #include "utils/math.h"
 #include <FL/Fl.H>
 
-extern giada::v::Ui     g_ui;
-extern giada::m::Engine g_engine;
+extern giada::v::Ui&     g_ui;
+extern giada::m::Engine& g_engine;
 
 namespace giada::c::io
 {
@@ -55,7 +55,7 @@
 #include "gui/dialogs/sampleEditor.h"
 #include "gui/ui.h"
 
-extern giada::v::Ui g_ui;
+extern giada::v::Ui& g_ui;
 
 namespace giada::c::layout
 {
@@ -51,8 +51,8 @@
 #include <cassert>
 #include <cmath>
 
-extern giada::v::Ui     g_ui;
-extern giada::m::Engine g_engine;
+extern giada::v::Ui&     g_ui;
+extern giada::m::Engine& g_engine;
 
 namespace giada::c::main
 {
@@ -231,7 +231,7 @@ void setMasterInVolume(float v, Thread t)
 	g_engine.getMainApi().setMasterInVolume(v);
 
 	if (t != Thread::MAIN)
-		g_ui.pumpEvent([v]() { g_ui.mainWindow->mainIO->setInVol(v); });
+		g_ui.notify(v::Updater::Notification::MASTER_IN_VOLUME, 0, v);
 }
 
 void setMasterOutVolume(float v, Thread t)
@@ -239,7 +239,7 @@ void setMasterOutVolume(float v, Thread t)
 	g_engine.getMainApi().setMasterOutVolume(v);
 
 	if (t != Thread::MAIN)
-		g_ui.pumpEvent([v]() { g_ui.mainWindow->mainIO->setOutVol(v); });
+		g_ui.notify(v::Updater::Notification::MASTER_OUT_VOLUME, 0, v);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -75,6 +75,8 @@ struct IO
 
 struct Sequencer
 {
+	bool operator==(const Sequencer&) const = default;
+
 	bool  isFreeModeInputRec;
 	bool  shouldBlink;
 	int   beats;
@@ -44,8 +44,8 @@
 #include <cassert>
 #include <memory>
 
-extern giada::v::Ui     g_ui;
-extern giada::m::Engine g_engine;
+extern giada::v::Ui&     g_ui;
+extern giada::m::Engine& g_engine;
 
 namespace giada::c::plugin
 {
@@ -198,10 +198,13 @@ void setProgram(ID pluginId, int programIndex)
 
 void setParameter(ID channelId, ID pluginId, int paramIndex, float value, Thread t)
 {
-	g_engine.getPluginsApi().setParameter(pluginId, paramIndex, value);
+	g_engine.getPluginsApi().setParameter(channelId, pluginId, paramIndex, value);
 	channel::notifyChannelForMidiIn(t, channelId);
 
-	g_ui.pumpEvent([pluginId, t]() { c::plugin::updateWindow(pluginId, t); });
+	if (t == Thread::MAIN)
+		updateWindow(pluginId, t);
+	else
+		g_ui.notify(v::Updater::Notification::PLUGIN_PARAMETERS, pluginId);
 }
 
 /* -------------------------------------------------------------------------- */
@@ -53,8 +53,8 @@
 #include <cassert>
 #include <memory>
 
-extern giada::v::Ui     g_ui;
-extern giada::m::Engine g_engine;
+extern giada::v::Ui&     g_ui;
+extern giada::m::Engine& g_engine;
 
 namespace giada::c::sampleEditor
 {
@@ -67,12 +67,13 @@ Data::Data(const m::Channel& c)
 , begin(c.samplePlayer->begin)
 , end(c.samplePlayer->end)
 , shift(c.samplePlayer->shift)
-, waveSize(c.samplePlayer->getWave()->getBuffer().countFrames())
+, waveSize(c.samplePlayer->getWave()->countFrames())
 , waveBits(c.samplePlayer->getWave()->getBits())
 , waveDuration(c.samplePlayer->getWave()->getDuration())
 , waveRate(c.samplePlayer->getWave()->getRate())
 , wavePath(c.samplePlayer->getWave()->getPath())
 , isLogical(c.samplePlayer->getWave()->isLogical())
+, peaks(g_engine.getSampleEditorApi().getPeaks(c.id))
 , m_channel(&c)
 {
 }
@@ -147,7 +148,6 @@ void copy(ID channelId, Frame a, Frame b)
 void paste(ID channelId, Frame a)
 {
 	g_engine.getSampleEditorApi().paste(channelId, a);
-	getWindow()->rebuild();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -252,4 +252,69 @@ void shift(ID channelId, Frame offset)
 {
 	g_engine.getSampleEditorApi().shift(channelId, offset);
 }
+
+/* -------------------------------------------------------------------------- */
+
+void undo(ID channelId)
+{
+	g_engine.getSampleEditorApi().undo(channelId);
+}
+
+void redo(ID channelId)
+{
+	g_engine.getSampleEditorApi().redo(channelId);
+}
+
+bool canUndo(ID channelId)
+{
+	return g_engine.getSampleEditorApi().canUndo(channelId);
+}
+
+bool canRedo(ID channelId)
+{
+	return g_engine.getSampleEditorApi().canRedo(channelId);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void consolidate(ID channelId)
+{
+	g_engine.getSampleEditorApi().consolidate(channelId);
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool arePeaksReady(ID channelId)
+{
+	return g_engine.getSampleEditorApi().getPeaks(channelId) != nullptr;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool isProcessing()
+{
+	return g_engine.getSampleEditorApi().isBusy();
+}
+
+float getProgress()
+{
+	return g_engine.getSampleEditorApi().getProgress();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void update()
+{
+	/* No need to rebuild the window here: the model swap performed when 
+	applying the result takes care of it. */
+
+	g_engine.getSampleEditorApi().update();
+}
+
+/* -------------------------------------------------------------------------- */
+
+void cancel()
+{
+	g_engine.getSampleEditorApi().cancel();
+}
 } // namespace giada::c::sampleEditor
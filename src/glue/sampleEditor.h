@@ -30,6 +30,7 @@
 #include "core/types.h"
 #include "core/waveFx.h"
 #include <functional>
+#include <memory>
 #include <string>
 
 /* giada::c::sampleEditor
@@ -38,6 +39,7 @@ Functions to interact with the Sample Editor. Only the main thread can use these
 namespace giada::m
 {
 class Wave;
+class WavePeaks;
 class Channel;
 } // namespace giada::m
 
@@ -74,6 +76,11 @@ struct Data
 	std::string wavePath;
 	bool        isLogical;
 
+	/* peaks
+	Peaks of the Wave for drawing. Null if still being computed. */
+
+	std::shared_ptr<const m::WavePeaks> peaks;
+
 private:
 	const m::Channel* m_channel;
 };
@@ -106,6 +113,42 @@ void smoothEdges(ID channelId, Frame a, Frame b);
 void shift(ID channelId, Frame offset);
 void reload(ID channelId);
 
+/* undo, redo, canUndo, canRedo
+Navigate the editing history of the sample. */
+
+void undo(ID channelId);
+void redo(ID channelId);
+bool canUndo(ID channelId);
+bool canRedo(ID channelId);
+
+/* consolidate
+Flattens all edits made so far, discarding the editing history. */
+
+void consolidate(ID channelId);
+
+/* arePeaksReady
+True if peaks of the Wave in channel 'channelId' have been computed. */
+
+bool arePeaksReady(ID channelId);
+
+/* isProcessing, getProgress
+Editing operations above run in background. These tell whether one of them is
+still in progress and how far it's gone, in [0.0, 1.0]. */
+
+bool  isProcessing();
+float getProgress();
+
+/* update
+Applies the result of a finished editing operation, if any. Call this 
+periodically, e.g. on UI refresh. */
+
+void update();
+
+/* cancel
+Stops the editing operation in progress, if any, discarding its result. */
+
+void cancel();
+
 void setLoop(bool);
 void togglePreview();
 void playPreview();
@@ -55,13 +55,20 @@
 #include "utils/string.h"
 #include <cassert>
 
-extern giada::m::Engine g_engine;
-extern giada::v::Ui     g_ui;
+extern giada::m::Engine& g_engine;
+extern giada::v::Ui&     g_ui;
 
 namespace giada::c::storage
 {
 namespace
 {
+/* preloadedPath_
+Path of the project being preloaded in set-list mode. */
+
+std::string preloadedPath_ = "";
+
+/* -------------------------------------------------------------------------- */
+
 void printLoadError_(int res)
 {
 	if (res == G_FILE_UNREADABLE)
@@ -149,7 +156,18 @@ void saveProject(void* data)
 
 	g_ui.model.projectName = projectName;
 
-	if (g_engine.getStorageApi().storeProject(projectPath, g_ui.model, engineProgress))
+	/* Files are written in background: samples are marked as saved and errors
+	are reported later on, from the main thread. */
+
+	auto onSaved = [](bool ok) {
+		g_ui.pumpEvent([ok]() {
+			g_engine.getStorageApi().commitSave();
+			if (!ok)
+				v::gdAlert(g_ui.getI18Text(v::LangMap::MESSAGE_STORAGE_SAVINGPROJECTERROR));
+		});
+	};
+
+	if (g_engine.getStorageApi().storeProject(projectPath, g_ui.model, engineProgress, onSaved))
 	{
 		g_ui.setMainWindowTitle(projectName);
 		g_ui.model.patchPath = u::fs::getUpDir(projectPath);
@@ -204,4 +222,57 @@ void saveSample(void* data)
 
 	browser->do_callback();
 }
-} // namespace giada::c::storage
\ No newline at end of file
+
+/* -------------------------------------------------------------------------- */
+
+void preloadProject(const std::string& projectPath)
+{
+	const std::size_t memoryBudget = static_cast<std::size_t>(g_ui.model.preloadMaxMemory) * 1024 * 1024;
+
+	/* The project is loaded in background: errors are reported later on, from
+	the main thread. Plug-ins must be created there too. */
+
+	auto onPreloaded = [](int res, const m::model::LoadState& state) {
+		if (res == G_RES_OK)
+		{
+			g_ui.pumpEvent([]() { g_engine.getStorageApi().finishPreload(); });
+			return;
+		}
+		g_ui.pumpEvent([res, status = state.patch.status]() {
+			if (res == G_RES_ERR_MEMORY)
+				v::gdAlert(g_ui.getI18Text(v::LangMap::MESSAGE_STORAGE_PRELOADTOOLARGE));
+			else
+				printLoadError_(status);
+		});
+	};
+
+	if (g_engine.getStorageApi().preloadProject(projectPath, memoryBudget, onPreloaded))
+		preloadedPath_ = projectPath;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void switchToPreloadedProject(int bar)
+{
+	if (!g_engine.getStorageApi().hasPreloadedProject())
+		return;
+
+	/* Close all sub-windows first, in case there are VST editors visible: the
+	current plug-ins go away with the switch. */
+
+	g_ui.closeAllSubwindows();
+
+	auto onSwitched = [](const m::model::LoadState& state) {
+		g_ui.pumpEvent([state]() {
+			g_ui.model.patchPath = u::fs::getUpDir(preloadedPath_);
+
+			if (!state.isGood())
+				layout::openMissingAssetsWindow(state);
+
+			g_ui.load(state.patch);
+		});
+	};
+
+	g_engine.getStorageApi().switchToPreloadedProject(bar, onSwitched);
+}
+} // namespace giada::c::storage
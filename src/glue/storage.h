@@ -27,6 +27,8 @@
 #ifndef G_GLUE_STORAGE_H
 #define G_GLUE_STORAGE_H
 
+#include <string>
+
 /* giada::c::storage
 Persistence functions. Only the main thread can use these! */
 
@@ -36,6 +38,18 @@ void loadProject(void* data);
 void saveProject(void* data);
 void saveSample(void* data);
 void loadSample(void* data);
+
+/* preloadProject
+Set-list mode: loads a project in background, while the current one keeps 
+playing. */
+
+void preloadProject(const std::string& projectPath);
+
+/* switchToPreloadedProject
+Replaces the current project with the preloaded one on bar 'bar', without 
+stopping the sequencer. */
+
+void switchToPreloadedProject(int bar);
 } // namespace giada::c::storage
 
 #endif
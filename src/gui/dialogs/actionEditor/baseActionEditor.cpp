@@ -28,6 +28,7 @@
 #include "core/conf.h"
 #include "glue/channel.h"
 #include "gui/drawing.h"
+#include "gui/elems/actionEditor/baseActionEditor.h"
 #include "gui/elems/actionEditor/gridTool.h"
 #include "gui/elems/actionEditor/splitScroll.h"
 #include "gui/elems/basics/choice.h"
@@ -40,11 +41,12 @@
 #include "utils/string.h"
 #include <FL/Fl.H>
 #include <FL/fl_draw.H>
+#include <algorithm>
 #include <cassert>
 #include <limits>
 #include <string>
 
-extern giada::v::Ui g_ui;
+extern giada::v::Ui& g_ui;
 
 namespace giada::v
 {
@@ -56,6 +58,7 @@ gdBaseActionEditor::gdBaseActionEditor(ID channelId, const Model& model)
 , m_zoomOutBtn(new geImageButton(graphics::minusOff, graphics::minusOn))
 , m_splitScroll(new geSplitScroll(0, 0, 0, 0))
 , m_ratio(model.actionEditorZoom)
+, m_playheadX(0)
 {
 	m_zoomInBtn->onClick = [this]() { zoomIn(); };
 	m_zoomInBtn->copy_tooltip(g_ui.getI18Text(LangMap::COMMON_ZOOMIN));
@@ -66,6 +69,15 @@ gdBaseActionEditor::gdBaseActionEditor(ID channelId, const Model& model)
 
 /* -------------------------------------------------------------------------- */
 
+bool gdBaseActionEditor::Viewport::contains(const Viewport& o) const
+{
+	return o.x1 >= x1 && o.x2 <= x2 && o.y1 >= y1 && o.y2 <= y2;
+}
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
 gdBaseActionEditor::~gdBaseActionEditor()
 {
 	g_ui.model.actionEditorBounds = getBounds();
@@ -102,6 +114,38 @@ Frame gdBaseActionEditor::pixelToFrame(Pixel p, Frame framesInBeat, bool snap) c
 
 /* -------------------------------------------------------------------------- */
 
+std::pair<Frame, Frame> gdBaseActionEditor::getViewportFrames() const
+{
+	return {pixelToFrame(std::max(0, viewport.x1), 0, /*snap=*/false),
+	    pixelToFrame(viewport.x2, 0, /*snap=*/false)};
+}
+
+/* -------------------------------------------------------------------------- */
+
+void gdBaseActionEditor::updateViewport(bool force)
+{
+	/* Never pull widgets from under the mouse while an action is being dragged
+	around: the editor that grabbed the push event is holding a pointer to
+	one of them. */
+
+	if (!force && dynamic_cast<geBaseActionEditor*>(Fl::pushed()) != nullptr)
+		return;
+
+	const Pixel scrollX = m_splitScroll->getScrollX();
+	const Pixel scrollY = m_splitScroll->getScrollY();
+	const Pixel w       = m_splitScroll->w();
+	const Pixel h       = m_splitScroll->getTopContentH();
+
+	if (!force && viewport.contains({scrollX, scrollX + w, scrollY, scrollY + h}))
+		return;
+
+	viewport = {scrollX - w, scrollX + (w * 2), scrollY - h, scrollY + (h * 2)};
+
+	rebuildEditors();
+}
+
+/* -------------------------------------------------------------------------- */
+
 void gdBaseActionEditor::zoomIn()
 {
 	// Explicit type std::max<int> to fix MINMAX macro hell on Windows
@@ -154,6 +198,13 @@ void gdBaseActionEditor::draw()
 
 /* -------------------------------------------------------------------------- */
 
+ID gdBaseActionEditor::getChannelId() const
+{
+	return channelId;
+}
+
+/* -------------------------------------------------------------------------- */
+
 void gdBaseActionEditor::zoomAbout(std::function<float()> f)
 {
 	const float ratioPrev = m_ratio;
@@ -176,11 +227,15 @@ void gdBaseActionEditor::zoomAbout(std::function<float()> f)
 	const int mpre = getMouseOverContent();
 	const int mnow = mpre / (m_ratio / ratioPrev);
 
-	/* 2. Rebuild everything and adjust scrolling given the change occurred in
-	the x-position. This effectively centers the view on the mouse cursor. */
+	/* 2. Adjust scrolling given the change occurred in the x-position. This
+	effectively centers the view on the mouse cursor. Then rebuild the editors
+	only once, with the new width and the final viewport: both are needed to
+	query the right range of actions. There's no need to fetch actions again:
+	only the zoom level has changed. */
 
-	rebuild();
+	computeWidth(m_data.framesInSeq, m_data.framesInLoop);
 	m_splitScroll->setScrollX(m_splitScroll->getScrollX() + (mnow - mpre));
+	updateViewport(/*force=*/true);
 	redraw();
 }
 
@@ -188,7 +243,17 @@ void gdBaseActionEditor::zoomAbout(std::function<float()> f)
 
 void gdBaseActionEditor::refresh()
 {
-	redraw();
+	updateViewport();
+
+	/* Only the playhead moves during playback: damage the columns of its old
+	and new position rather than redrawing the whole window. */
+
+	const Pixel playheadX = currentFrameToPixel();
+	if (playheadX == m_playheadX)
+		return;
+	damage(FL_DAMAGE_ALL, m_playheadX, 0, 1, h());
+	damage(FL_DAMAGE_ALL, playheadX, 0, 1, h());
+	m_playheadX = playheadX;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -31,6 +31,7 @@
 #include "gui/dialogs/window.h"
 #include "gui/model.h"
 #include <functional>
+#include <utility>
 
 namespace giada::m
 {
@@ -50,10 +51,30 @@ public:
 
 	int  handle(int e) override;
 	void draw() override;
+	ID   getChannelId() const override;
+
+	/* Viewport
+	Area of the editors' content where action widgets are materialized, in
+	pixels relative to the content origin (i.e. scrolling included). */
+
+	struct Viewport
+	{
+		bool contains(const Viewport&) const;
+
+		Pixel x1 = 0;
+		Pixel x2 = 0;
+		Pixel y1 = 0;
+		Pixel y2 = 0;
+	};
 
 	Pixel frameToPixel(Frame f) const;
 	Frame pixelToFrame(Pixel p, Frame framesInBeat, bool snap = true) const;
 
+	/* getViewportFrames
+	Returns the [a, b) range of frames covered by the viewport horizontally. */
+
+	std::pair<Frame, Frame> getViewportFrames() const;
+
 	ID channelId;
 
 	geGridTool* gridTool;
@@ -61,6 +82,8 @@ public:
 	Pixel fullWidth; // Full widgets width, i.e. scaled-down full sequencer
 	Pixel loopWidth; // Loop width, i.e. scaled-down sequencer range
 
+	Viewport viewport;
+
 protected:
 	static constexpr float MIN_RATIO  = 25.0f;
 	static constexpr float MAX_RATIO  = 40000.0f;
@@ -86,6 +109,19 @@ protected:
 
 	void prepareWindow();
 
+	/* rebuildEditors
+	Rebuilds the action widgets of each editor out of the current data, without
+	fetching it again. */
+
+	virtual void rebuildEditors() = 0;
+
+	/* updateViewport
+	Moves the viewport around the visible area, padded by one screen on each
+	side, and rebuilds the editors if the visible area is no longer inside it.
+	Always rebuilds if 'force' is set. */
+
+	void updateViewport(bool force = false);
+
 	geImageButton* m_zoomInBtn;
 	geImageButton* m_zoomOutBtn;
 	geSplitScroll* m_splitScroll;
@@ -104,6 +140,11 @@ private:
 	Pixel currentFrameToPixel() const;
 
 	float m_ratio;
+
+	/* m_playheadX
+	Last drawn position of the playhead, in window coordinates. */
+
+	Pixel m_playheadX;
 };
 } // namespace giada::v
 #endif
@@ -37,7 +37,7 @@
 #include "gui/graphics.h"
 #include "gui/ui.h"
 
-extern giada::v::Ui g_ui;
+extern giada::v::Ui& g_ui;
 
 namespace giada::v
 {
@@ -88,7 +88,13 @@ void gdMidiActionEditor::rebuild()
 	m_data = c::actionEditor::getData(channelId);
 
 	computeWidth(m_data.framesInSeq, m_data.framesInLoop);
+	updateViewport(/*force=*/true);
+}
+
+/* -------------------------------------------------------------------------- */
 
+void gdMidiActionEditor::rebuildEditors()
+{
 	m_pianoRoll->rebuild(m_data);
 	m_velocityEditor->rebuild(m_data);
 }
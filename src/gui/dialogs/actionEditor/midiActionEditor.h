@@ -42,6 +42,8 @@ public:
 	void rebuild() override;
 
 private:
+	void rebuildEditors() override;
+
 	gePianoRoll*      m_pianoRoll;
 	geVelocityEditor* m_velocityEditor;
 };
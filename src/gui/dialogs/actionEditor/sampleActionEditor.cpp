@@ -41,7 +41,7 @@
 #include "gui/ui.h"
 #include <string>
 
-extern giada::v::Ui g_ui;
+extern giada::v::Ui& g_ui;
 
 namespace giada::v
 {
@@ -101,7 +101,13 @@ void gdSampleActionEditor::rebuild()
 
 	canChangeActionType() ? m_actionType->activate() : m_actionType->deactivate();
 	computeWidth(m_data.framesInSeq, m_data.framesInLoop);
+	updateViewport(/*force=*/true);
+}
+
+/* -------------------------------------------------------------------------- */
 
+void gdSampleActionEditor::rebuildEditors()
+{
 	m_sampleActionEditor->rebuild(m_data);
 	m_envelopeEditor->rebuild(m_data);
 }
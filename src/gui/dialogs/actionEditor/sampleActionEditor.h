@@ -44,6 +44,7 @@ public:
 	int getActionType() const;
 
 private:
+	void rebuildEditors() override;
 	bool canChangeActionType();
 
 	geSampleActionEditor* m_sampleActionEditor;
@@ -36,7 +36,7 @@
 #include "utils/string.h"
 #include <cstring>
 
-extern giada::v::Ui g_ui;
+extern giada::v::Ui& g_ui;
 
 namespace giada::v
 {
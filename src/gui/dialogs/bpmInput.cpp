@@ -38,7 +38,7 @@
 #include <cstring>
 #include <fmt/core.h>
 
-extern giada::v::Ui g_ui;
+extern giada::v::Ui& g_ui;
 
 namespace giada::v
 {
@@ -31,7 +31,7 @@
 #include "gui/ui.h"
 #include "utils/fs.h"
 
-extern giada::v::Ui g_ui;
+extern giada::v::Ui& g_ui;
 
 namespace giada::v
 {
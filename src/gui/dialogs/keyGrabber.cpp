@@ -37,7 +37,7 @@
 #include "utils/string.h"
 #include <cassert>
 
-extern giada::v::Ui g_ui;
+extern giada::v::Ui& g_ui;
 
 namespace giada::v
 {
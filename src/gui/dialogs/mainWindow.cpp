@@ -42,7 +42,7 @@
 #include <FL/Fl_Tooltip.H>
 #include <fmt/core.h>
 
-extern giada::v::Ui g_ui;
+extern giada::v::Ui& g_ui;
 
 namespace giada::v
 {
@@ -72,6 +72,7 @@ void gdMainWindow::ScopedProgress::setProgress(float v)
 
 gdMainWindow::gdMainWindow(geompp::Rect<int> r, const char* title, int argc, char** argv)
 : gdWindow(r, title)
+, m_active(false)
 {
 	Fl::visible_focus(0);
 
@@ -146,11 +147,20 @@ gdMainWindow::~gdMainWindow()
 
 void gdMainWindow::refresh()
 {
-	mainIO->refresh();
+	const bool io = mainIO->refresh();
 	mainTimer->refresh();
-	mainTransport->refresh();
-	sequencer->refresh();
-	keyboard->refresh();
+	const bool transport = mainTransport->refresh();
+	const bool seq       = sequencer->refresh();
+	const bool channels  = keyboard->refresh();
+
+	m_active = io || transport || seq || channels;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool gdMainWindow::isActive() const
+{
+	return m_active;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -50,6 +50,12 @@ public:
 	void refresh() override;
 	void rebuild() override;
 
+	/* isActive
+	Returns whether the last refresh() found something moving on screen, e.g.
+	playing channels, the running sequencer or audio signal in the meters. */
+
+	bool isActive() const;
+
 	/* clearKeyboard
 	Resets Keyboard to initial state, with no columns. */
 
@@ -83,6 +89,7 @@ private:
 	};
 
 	gdProgress m_progress;
+	bool       m_active;
 };
 } // namespace giada::v
 
@@ -43,7 +43,7 @@
 #include <cassert>
 #include <cstddef>
 
-extern giada::v::Ui g_ui;
+extern giada::v::Ui& g_ui;
 
 namespace giada::v
 {
@@ -34,7 +34,7 @@
 #include "utils/gui.h"
 #include <FL/Fl_Group.H>
 
-extern giada::v::Ui g_ui;
+extern giada::v::Ui& g_ui;
 
 namespace giada::v
 {
@@ -41,8 +41,8 @@
 #include <cassert>
 #include <string>
 
-extern giada::v::Ui     g_ui;
-extern giada::m::Engine g_engine;
+extern giada::v::Ui&     g_ui;
+extern giada::m::Engine& g_engine;
 
 namespace giada::v
 {
@@ -73,6 +73,13 @@ gdPluginList::~gdPluginList()
 
 /* -------------------------------------------------------------------------- */
 
+ID gdPluginList::getChannelId() const
+{
+	return m_channelId;
+}
+
+/* -------------------------------------------------------------------------- */
+
 void gdPluginList::rebuild()
 {
 	m_plugins = c::plugin::getPlugins(m_channelId);
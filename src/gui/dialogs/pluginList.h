@@ -43,6 +43,7 @@ public:
 	~gdPluginList();
 
 	void rebuild() override;
+	ID   getChannelId() const override;
 
 	const gePluginElement& getNextElement(const gePluginElement& curr) const;
 	const gePluginElement& getPrevElement(const gePluginElement& curr) const;
@@ -62,7 +62,7 @@
 #undef OUT
 #endif
 
-extern giada::v::Ui g_ui;
+extern giada::v::Ui& g_ui;
 
 namespace giada::v
 {
@@ -196,6 +196,7 @@ gdSampleEditor::~gdSampleEditor()
 	g_ui.model.sampleEditorGridVal = grid->getSelectedId();
 	g_ui.model.sampleEditorGridOn  = snap->value();
 
+	c::sampleEditor::cancel();
 	c::sampleEditor::stopPreview();
 	c::sampleEditor::cleanupPreview();
 }
@@ -222,6 +223,25 @@ void gdSampleEditor::refresh()
 {
 	waveTools->refresh();
 	play->setValue(m_data.a_getPreviewStatus() == ChannelStatus::PLAY);
+
+	if (c::sampleEditor::isProcessing())
+	{
+		c::sampleEditor::update();
+		updateInfo();
+	}
+
+	/* Peaks are computed in background: draw the waveform as soon as they are
+	available. */
+
+	if (m_data.peaks == nullptr && c::sampleEditor::arePeaksReady(m_channelId))
+		rebuild();
+}
+
+/* -------------------------------------------------------------------------- */
+
+ID gdSampleEditor::getChannelId() const
+{
+	return m_channelId;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -232,6 +252,10 @@ void gdSampleEditor::updateInfo()
 	    m_data.wavePath, m_data.waveSize, m_data.waveDuration,
 	    m_data.waveBits != 0 ? std::to_string(m_data.waveBits) : "?", m_data.waveRate);
 
+	if (c::sampleEditor::isProcessing())
+		infoText += "\n\n" + fmt::format(fmt::runtime(g_ui.getI18Text(LangMap::SAMPLEEDITOR_PROCESSING)),
+		                           static_cast<int>(c::sampleEditor::getProgress() * 100));
+
 	info->copy_label(infoText.c_str());
 }
 } // namespace giada::v
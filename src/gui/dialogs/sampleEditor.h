@@ -53,6 +53,7 @@ public:
 
 	void rebuild() override;
 	void refresh() override;
+	ID   getChannelId() const override;
 
 	geChoice*      grid;
 	geCheck*       snap;
@@ -34,7 +34,7 @@
 #include <FL/Fl.H>
 #include <FL/Fl_Window.H>
 
-extern giada::v::Ui g_ui;
+extern giada::v::Ui& g_ui;
 
 namespace giada::v
 {
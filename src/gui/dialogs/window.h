@@ -27,6 +27,7 @@
 #ifndef GD_WINDOW_H
 #define GD_WINDOW_H
 
+#include "core/types.h"
 #include "deps/geompp/src/rect.hpp"
 #include <FL/Fl_Double_Window.H>
 #include <FL/Fl_SVG_Image.H>
@@ -51,6 +52,12 @@ public:
 	virtual void rebuild(){};
 	virtual void refresh(){};
 
+	/* getChannelId
+	Returns the ID of the channel this window is bound to, if any. Returns 0
+	otherwise. */
+
+	virtual ID getChannelId() const { return 0; };
+
 	/* hasWindow
 	True if the window with id 'id' exists in the stack. */
 
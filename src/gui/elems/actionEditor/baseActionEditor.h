@@ -43,8 +43,9 @@ class geBaseAction;
 class geBaseActionEditor : public Fl_Group
 {
 public:
-	/* updateActions
-	Rebuild the actions widgets from scratch. */
+	/* rebuild
+	Rebuilds the action widgets from scratch. Only actions that fall inside the
+	viewport of the parent window get a widget. */
 
 	virtual void rebuild(c::actionEditor::Data& d) = 0;
 
@@ -40,6 +40,18 @@
 
 namespace giada::v
 {
+namespace
+{
+bool isPoint_(const m::Action& a)
+{
+	return a.isVolumeEnvelope();
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
 geEnvelopeEditor::geEnvelopeEditor(Pixel x, Pixel y, const char* l, gdBaseActionEditor* b)
 : geBaseActionEditor(x, y, 200, 40, b)
 {
@@ -103,12 +115,25 @@ void geEnvelopeEditor::rebuild(c::actionEditor::Data& d)
 	clear();
 	size(m_base->fullWidth, h());
 
-	for (const m::Action& a : m_data->actions)
-	{
-		if (a.event.getStatus() != m::MidiEvent::CHANNEL_CC)
-			continue;
+	/* Create widgets only for the points inside the viewport, plus the closest
+	one on each side so that lines crossing the viewport edges are drawn. */
+
+	const auto [f1, f2] = m_base->getViewportFrames();
+
+	auto addPoint = [this](const m::Action& a) {
 		add(new geEnvelopePoint(frameToX(a.frame), valueToY(a.event.getVelocity()), a));
-	}
+	};
+
+	if (const m::Action* a = m_data->actions.findBefore(f1, isPoint_); a != nullptr)
+		addPoint(*a);
+
+	m_data->actions.forEachInRange(f1, f2, [&addPoint](const m::Action& a) {
+		if (isPoint_(a))
+			addPoint(a);
+	});
+
+	if (const m::Action* a = m_data->actions.findAfter(f2, isPoint_); a != nullptr)
+		addPoint(*a);
 
 	resizable(nullptr);
 
@@ -119,12 +144,12 @@ void geEnvelopeEditor::rebuild(c::actionEditor::Data& d)
 
 bool geEnvelopeEditor::isFirstPoint() const
 {
-	return find(m_action) == 0;
+	return m_data->actions.findBefore(m_action->a1.frame, isPoint_) == nullptr;
 }
 
 bool geEnvelopeEditor::isLastPoint() const
 {
-	return find(m_action) == children() - 1;
+	return m_data->actions.findAfter(m_action->a1.frame + 1, isPoint_) == nullptr;
 }
 
 /* -------------------------------------------------------------------------- */
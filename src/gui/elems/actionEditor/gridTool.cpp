@@ -31,7 +31,7 @@
 #include "utils/math.h"
 #include <FL/Fl_Double_Window.H>
 
-extern giada::v::Ui g_ui;
+extern giada::v::Ui& g_ui;
 
 namespace giada::v
 {
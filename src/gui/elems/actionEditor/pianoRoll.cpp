@@ -359,22 +359,30 @@ void gePianoRoll::rebuild(c::actionEditor::Data& d)
 	clear();
 	size(m_base->fullWidth, (MAX_KEYS + 1) * CELL_H);
 
-	for (const m::Action& a1 : m_data->actions)
-	{
-		if (a1.event.getStatus() == m::MidiEvent::CHANNEL_NOTE_OFF)
-			continue;
+	/* Create widgets only for the notes inside the viewport, both in time and
+	pitch. */
+
+	const auto [f1, f2] = m_base->getViewportFrames();
+
+	m_data->actions.forEachInRange(f1, f2, [this](const m::Action& a1) {
+		if (a1.event.getStatus() == m::MidiEvent::CHANNEL_NOTE_OFF || a1.pluginId != -1)
+			return;
 
 		assert(a1.isValid()); // a2 might be null if orphaned
 
+		const Pixel ny = noteToY(a1.event.getNote());
+		if (ny + CELL_H <= m_base->viewport.y1 || ny >= m_base->viewport.y2)
+			return;
+
 		const m::Action& a2 = a1.next != nullptr ? *a1.next : m::Action{};
 
 		Pixel px = x() + m_base->frameToPixel(a1.frame);
-		Pixel py = y() + noteToY(a1.event.getNote());
+		Pixel py = y() + ny;
 		Pixel ph = CELL_H;
 		Pixel pw = getPianoItemW(px, a1, a2);
 
 		add(new gePianoItem(px, py, pw, ph, a1, a2));
-	}
+	});
 
 	drawSurfaceY();
 	drawSurfaceX();
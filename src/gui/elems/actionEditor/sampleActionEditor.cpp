@@ -38,7 +38,7 @@
 #include <FL/fl_draw.H>
 #include <cassert>
 
-extern giada::v::Ui g_ui;
+extern giada::v::Ui& g_ui;
 
 namespace giada::v
 {
@@ -62,10 +62,13 @@ void geSampleActionEditor::rebuild(c::actionEditor::Data& d)
 	clear();
 	size(m_base->fullWidth, h());
 
-	for (const m::Action& a1 : m_data->actions)
-	{
+	/* Create widgets only for the actions inside the viewport. */
+
+	const auto [f1, f2] = m_base->getViewportFrames();
+
+	m_data->actions.forEachInRange(f1, f2, [this, isSinglePressMode](const m::Action& a1) {
 		if (a1.event.getStatus() == m::MidiEvent::CHANNEL_CC || isNoteOffSinglePress(a1))
-			continue;
+			return;
 
 		const m::Action& a2 = a1.next != nullptr ? *a1.next : m::Action{};
 
@@ -79,7 +82,7 @@ void geSampleActionEditor::rebuild(c::actionEditor::Data& d)
 		geSampleAction* gsa = new geSampleAction(px, py, pw, ph, isSinglePressMode, a1, a2);
 		add(gsa);
 		resizable(gsa);
-	}
+	});
 
 	/* If channel is LOOP_ANY, deactivate it: a loop mode channel cannot hold 
 	keypress/keyrelease actions. */
@@ -38,7 +38,7 @@
 #include <FL/fl_draw.H>
 #include <cassert>
 
-extern giada::v::Ui g_ui;
+extern giada::v::Ui& g_ui;
 
 namespace giada::v
 {
@@ -106,17 +106,19 @@ void geVelocityEditor::rebuild(c::actionEditor::Data& d)
 	clear();
 	size(m_base->fullWidth, h());
 
-	for (const m::Action& action : m_data->actions)
-	{
+	/* Create widgets only for the notes inside the viewport. */
+
+	const auto [f1, f2] = m_base->getViewportFrames();
 
-		if (action.event.getStatus() == m::MidiEvent::CHANNEL_NOTE_OFF)
-			continue;
+	m_data->actions.forEachInRange(f1, f2, [this](const m::Action& action) {
+		if (action.event.getStatus() == m::MidiEvent::CHANNEL_NOTE_OFF || action.pluginId != -1)
+			return;
 
 		Pixel px = x() + m_base->frameToPixel(action.frame);
 		Pixel py = y() + valueToY(action.event.getVelocity());
 
 		add(new geEnvelopePoint(px, py, action));
-	}
+	});
 
 	resizable(nullptr);
 	redraw();
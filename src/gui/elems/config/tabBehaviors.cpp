@@ -32,7 +32,7 @@
 #include "gui/ui.h"
 #include <FL/Fl_Pack.H>
 
-extern giada::v::Ui g_ui;
+extern giada::v::Ui& g_ui;
 
 namespace giada::v
 {
@@ -36,7 +36,7 @@
 
 constexpr int LABEL_WIDTH = 120;
 
-extern giada::v::Ui g_ui;
+extern giada::v::Ui& g_ui;
 
 namespace giada::v
 {
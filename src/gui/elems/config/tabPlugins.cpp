@@ -44,7 +44,7 @@
 #include <fmt/core.h>
 #include <functional>
 
-extern giada::v::Ui g_ui;
+extern giada::v::Ui& g_ui;
 
 namespace giada::v
 {
@@ -38,13 +38,27 @@
 #include <FL/Fl.H>
 #include <FL/fl_draw.H>
 
-extern giada::v::Ui g_ui;
+extern giada::v::Ui& g_ui;
 
 namespace giada::v
 {
+namespace
+{
+void setValue_(geImageButton& b, bool v)
+{
+	if (b.getValue() != v)
+		b.setValue(v);
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+/* -------------------------------------------------------------------------- */
+
 geChannel::geChannel(int x, int y, int w, int h, c::channel::Data d)
 : geFlex(x, y, w, h, Direction::HORIZONTAL, G_GUI_INNER_MARGIN)
 , m_channel(d)
+, m_blink(false)
 {
 }
 
@@ -61,7 +75,11 @@ void geChannel::draw()
 	vol->resize(vol->x(), ny, G_GUI_UNIT, G_GUI_UNIT);
 	fx->resize(fx->x(), ny, G_GUI_UNIT, G_GUI_UNIT);
 
-	fl_rectf(x(), y(), w(), h(), G_COLOR_GREY_1_5);
+	/* Only children need repainting (e.g. a button after a status change):
+	leave the background alone, or it would cover the untouched ones. */
+
+	if ((damage() & ~FL_DAMAGE_CHILD) != 0)
+		fl_rectf(x(), y(), w(), h(), G_COLOR_GREY_1_5);
 
 	geFlex::draw();
 }
@@ -72,22 +90,41 @@ void geChannel::cb_changeVol(Fl_Widget* /*w*/, void* p) { ((geChannel*)p)->cb_ch
 
 /* -------------------------------------------------------------------------- */
 
-void geChannel::refresh()
+bool geChannel::refresh()
 {
-	ChannelStatus playStatus = m_channel.getPlayStatus();
-	ChannelStatus recStatus  = m_channel.getRecStatus();
+	const c::channel::State state   = m_channel.getState();
+	const bool              waiting = state.recStatus == ChannelStatus::WAIT || state.playStatus == ChannelStatus::WAIT;
+	const bool              blink   = waiting && g_ui.shouldBlink();
+	const bool              ledsLit = midiActivity->refresh();
 
-	if (mainButton->visible())
-		mainButton->refresh();
+	if (m_state == state && m_blink == blink)
+		return waiting || ledsLit;
 
-	if (recStatus == ChannelStatus::WAIT || playStatus == ChannelStatus::WAIT)
-		blink();
+	m_state = state;
+	m_blink = blink;
+	refreshWidgets(state);
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void geChannel::refreshWidgets(const c::channel::State& state)
+{
+	const bool waiting = state.recStatus == ChannelStatus::WAIT || state.playStatus == ChannelStatus::WAIT;
+
+	if (mainButton->visible())
+	{
+		mainButton->refresh(state);
+		if (waiting)
+			blink();
+		mainButton->flush();
+	}
 
-	playButton->setValue(playStatus == ChannelStatus::PLAY || playStatus == ChannelStatus::ENDING);
-	midiActivity->redraw();
-	arm->setValue(m_channel.isArmed());
-	mute->setValue(m_channel.isMuted());
-	solo->setValue(m_channel.isSoloed());
+	setValue_(*playButton, state.playStatus == ChannelStatus::PLAY || state.playStatus == ChannelStatus::ENDING);
+	setValue_(*arm, state.armed);
+	setValue_(*mute, state.muted);
+	setValue_(*solo, state.soloed);
 }
 
 /* -------------------------------------------------------------------------- */
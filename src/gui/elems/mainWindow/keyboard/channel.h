@@ -30,6 +30,7 @@
 #include "core/types.h"
 #include "glue/channel.h"
 #include "gui/elems/basics/flex.h"
+#include <optional>
 
 namespace giada::v
 {
@@ -46,9 +47,11 @@ public:
 	void draw() override;
 
 	/* refresh
-	Updates graphics. */
+	Updates graphics. Widgets are repainted only if the channel State they
+	display has changed since the last call. Returns whether the channel is
+	still active, i.e. something on screen might change on the next call. */
 
-	virtual void refresh();
+	bool refresh();
 
 	/* getColumnId
 	Returns the ID of the column this channel resides in. */
@@ -88,6 +91,12 @@ protected:
 	static void cb_changeVol(Fl_Widget* /*w*/, void* p);
 	void        cb_changeVol();
 
+	/* refreshWidgets
+	Called by refresh() when the channel State has changed. Sub-classes
+	override this to update their own widgets. */
+
+	virtual void refreshWidgets(const c::channel::State&);
+
 	/* blink
 	Blinks button when channel is in wait/ending status. */
 
@@ -97,6 +106,14 @@ protected:
 	Channel's data. */
 
 	c::channel::Data m_channel;
+
+private:
+	/* m_state, m_blink
+	State and blink phase currently displayed. An empty m_state forces a full
+	refresh. */
+
+	std::optional<c::channel::State> m_state;
+	bool                             m_blink;
 };
 } // namespace giada::v
 
@@ -38,14 +38,15 @@ namespace giada::v
 geChannelButton::geChannelButton(int x, int y, int w, int h, const c::channel::Data& d)
 : geTextButton(x, y, w, h, "")
 , m_channel(d)
+, m_drawnLook(getLook())
 {
 }
 
 /* -------------------------------------------------------------------------- */
 
-void geChannelButton::refresh()
+void geChannelButton::refresh(const c::channel::State& state)
 {
-	switch (m_channel.getPlayStatus())
+	switch (state.playStatus)
 	{
 	case ChannelStatus::OFF:
 	case ChannelStatus::EMPTY:
@@ -60,7 +61,7 @@ void geChannelButton::refresh()
 	default:
 		break;
 	}
-	switch (m_channel.getRecStatus())
+	switch (state.recStatus)
 	{
 	case ChannelStatus::ENDING:
 		setEndingMode();
@@ -72,10 +73,27 @@ void geChannelButton::refresh()
 
 /* -------------------------------------------------------------------------- */
 
+void geChannelButton::flush()
+{
+	if (getLook() != m_drawnLook)
+		redraw();
+}
+
+/* -------------------------------------------------------------------------- */
+
+geChannelButton::Look geChannelButton::getLook() const
+{
+	return {m_backgroundColorOff, m_borderColor, m_textColor};
+}
+
+/* -------------------------------------------------------------------------- */
+
 void geChannelButton::draw()
 {
 	geTextButton::draw();
 
+	m_drawnLook = getLook();
+
 	if (m_channel.key == 0)
 		return;
 
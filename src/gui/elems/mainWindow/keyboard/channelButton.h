@@ -32,6 +32,7 @@
 namespace giada::c::channel
 {
 struct Data;
+struct State;
 }
 
 namespace giada::v
@@ -41,7 +42,16 @@ class geChannelButton : public geTextButton
 public:
 	geChannelButton(int x, int y, int w, int h, const c::channel::Data& d);
 
-	virtual void refresh();
+	/* refresh
+	Sets colors according to the channel State. Nothing is repainted here: call
+	flush() when done. */
+
+	virtual void refresh(const c::channel::State&);
+
+	/* flush
+	Repaints the button only if its colors differ from the ones last drawn. */
+
+	void flush();
 
 	void draw() override;
 
@@ -53,6 +63,23 @@ public:
 
 protected:
 	const c::channel::Data& m_channel;
+
+private:
+	struct Look
+	{
+		bool operator==(const Look&) const = default;
+
+		Fl_Color background;
+		Fl_Color border;
+		Fl_Color text;
+	};
+
+	Look getLook() const;
+
+	/* m_drawnLook
+	Colors used in the last draw() call. */
+
+	Look m_drawnLook;
 };
 } // namespace giada::v
 
@@ -36,34 +36,45 @@ namespace giada::v
 geChannelStatus::geChannelStatus(int x, int y, int w, int h, c::channel::Data& d)
 : Fl_Box(x, y, w, h)
 , m_channel(d)
+, m_tracker(0)
+, m_active(false)
 {
 }
 
 /* -------------------------------------------------------------------------- */
 
-void geChannelStatus::draw()
+void geChannelStatus::refresh(const c::channel::State& state)
 {
-	const ChannelStatus playStatus = m_channel.getPlayStatus();
-	const Frame         tracker    = m_channel.sample->getTracker();
-	const Frame         begin      = m_channel.sample->begin;
-	const Frame         end        = m_channel.sample->end;
-	const Pixel         pos        = u::math::map(tracker, begin, end, 0, w());
+	const bool active = state.playStatus == ChannelStatus::PLAY ||
+	                   state.playStatus == ChannelStatus::WAIT ||
+	                   state.playStatus == ChannelStatus::ENDING;
+
+	/* Sub-pixel tracker movements are not visible: skip them. */
+
+	if (toPixel(state.tracker) == toPixel(m_tracker) && active == m_active)
+		return;
+
+	m_tracker = state.tracker;
+	m_active  = active;
+	redraw();
+}
+
+/* -------------------------------------------------------------------------- */
 
+Pixel geChannelStatus::toPixel(Frame tracker) const
+{
+	return u::math::map(tracker, m_channel.sample->begin, m_channel.sample->end, 0, w());
+}
+
+/* -------------------------------------------------------------------------- */
+
+void geChannelStatus::draw()
+{
 	const geompp::Rect<int> bounds(x(), y(), w(), h());
+	const Fl_Color          color = m_active ? G_COLOR_LIGHT_1 : G_COLOR_GREY_4;
 
 	drawRectf(bounds, G_COLOR_GREY_2); // reset background
-
-	if (playStatus == ChannelStatus::PLAY ||
-	    playStatus == ChannelStatus::WAIT ||
-	    playStatus == ChannelStatus::ENDING)
-	{
-		drawRectf(bounds.withW(pos), G_COLOR_LIGHT_1);
-		drawRect(bounds, G_COLOR_LIGHT_1);
-	}
-	else
-	{
-		drawRectf(bounds.withW(pos), G_COLOR_GREY_4);
-		drawRect(bounds, G_COLOR_GREY_4);
-	}
+	drawRectf(bounds.withW(toPixel(m_tracker)), color);
+	drawRect(bounds, color);
 }
-} // namespace giada::v
\ No newline at end of file
+} // namespace giada::v
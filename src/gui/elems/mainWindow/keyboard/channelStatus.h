@@ -29,11 +29,13 @@
 #ifndef GE_CHANNEL_STATUS_H
 #define GE_CHANNEL_STATUS_H
 
+#include "core/types.h"
 #include <FL/Fl_Box.H>
 
 namespace giada::c::channel
 {
 struct Data;
+struct State;
 }
 namespace giada::v
 {
@@ -44,8 +46,26 @@ public:
 
 	void draw() override;
 
+	/* refresh
+	Maps the channel State to screen coordinates and repaints the widget only
+	if the result differs from what is currently displayed. */
+
+	void refresh(const c::channel::State&);
+
 private:
 	c::channel::Data& m_channel;
+
+	/* toPixel
+	Maps a tracker position to the widget's width. */
+
+	Pixel toPixel(Frame tracker) const;
+
+	/* m_tracker, m_active
+	What is currently displayed: tracker position and whether the channel is
+	playing (or about to play/stop). */
+
+	Frame m_tracker;
+	bool  m_active;
 };
 } // namespace giada::v
 
@@ -40,9 +40,11 @@
 #include "utils/gui.h"
 #include "utils/log.h"
 #include "utils/string.h"
+#include <FL/Fl.H>
+#include <algorithm>
 #include <cassert>
 
-extern giada::v::Ui g_ui;
+extern giada::v::Ui& g_ui;
 
 namespace giada::v
 {
@@ -71,23 +73,20 @@ geColumn::geColumn(int X, int Y, int W, int H, ID id, geResizerBar* b)
 
 /* -------------------------------------------------------------------------- */
 
-void geColumn::refresh()
+bool geColumn::refresh()
 {
+	bool active = false;
 	for (geChannel* c : m_channels)
-		c->refresh();
+		active = c->refresh() || active;
+	return active;
 }
 
 /* -------------------------------------------------------------------------- */
 
 geChannel* geColumn::addChannel(c::channel::Data d)
 {
-	geChannel* gch  = nullptr;
 	Fl_Widget* last = m_channels.size() == 0 ? static_cast<Fl_Widget*>(m_addChannelBtn) : m_channels.back();
-
-	if (d.type == ChannelType::SAMPLE)
-		gch = new geSampleChannel(x(), last->y() + last->h() + G_GUI_INNER_MARGIN, w(), d.height, d);
-	else
-		gch = new geMidiChannel(x(), last->y() + last->h() + G_GUI_INNER_MARGIN, w(), d.height, d);
+	geChannel* gch  = makeChannel(x(), last->y() + last->h() + G_GUI_INNER_MARGIN, w(), d.height, d);
 
 	geResizerBar* bar = new geResizerBar(x(), gch->y() + gch->h(), w(),
 	    G_GUI_INNER_MARGIN, G_GUI_UNIT, geResizerBar::Direction::VERTICAL,
@@ -125,6 +124,62 @@ geChannel* geColumn::addChannel(c::channel::Data d)
 
 /* -------------------------------------------------------------------------- */
 
+void geColumn::updateChannel(c::channel::Data d)
+{
+	const auto it = std::find_if(m_channels.begin(), m_channels.end(),
+	    [id = d.id](const geChannel* c) { return c->getData().id == id; });
+
+	if (it == m_channels.end() || (*it)->getData() == d)
+		return;
+
+	geChannel* oldCh = *it;
+	geChannel* newCh = makeChannel(oldCh->x(), oldCh->y(), oldCh->w(), oldCh->h(), d);
+
+	/* Same resizability dance as in addChannel(). The old widget is deleted
+	lazily, as this might be called from one of its own callbacks. */
+
+	resizable(nullptr);
+	insert(*newCh, oldCh);
+	remove(oldCh);
+	init_sizes();
+	resizable(this);
+
+	Fl::delete_widget(oldCh);
+	*it = newCh;
+
+	newCh->redraw();
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool geColumn::hasLayout(const std::vector<c::channel::Data>& channels) const
+{
+	std::size_t i = 0;
+	for (const c::channel::Data& d : channels)
+	{
+		if (d.columnId != id)
+			continue;
+		if (i >= m_channels.size())
+			return false;
+		const c::channel::Data& curr = m_channels[i]->getData();
+		if (curr.id != d.id || curr.type != d.type || m_channels[i]->h() != d.height)
+			return false;
+		i++;
+	}
+	return i == m_channels.size();
+}
+
+/* -------------------------------------------------------------------------- */
+
+geChannel* geColumn::makeChannel(int x, int y, int w, int h, c::channel::Data d) const
+{
+	if (d.type == ChannelType::SAMPLE)
+		return new geSampleChannel(x, y, w, h, d);
+	return new geMidiChannel(x, y, w, h, d);
+}
+
+/* -------------------------------------------------------------------------- */
+
 void geColumn::addChannel()
 {
 	geMenu menu;
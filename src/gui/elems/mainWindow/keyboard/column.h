@@ -65,10 +65,24 @@ public:
 
 	geChannel* addChannel(c::channel::Data d);
 
+	/* updateChannel
+	Replaces the widget of channel 'd.id' with a new one, only if its data has
+	changed. Size and position are left untouched. */
+
+	void updateChannel(c::channel::Data d);
+
+	/* hasLayout
+	Returns true if this column contains the channels in 'channels' belonging
+	to it, no more, no less, in the same order and with the same type and 
+	height. */
+
+	bool hasLayout(const std::vector<c::channel::Data>& channels) const;
+
 	/* refreshChannels
-	Updates channels' graphical statues. Called on each GUI cycle. */
+	Updates channels' graphical statues. Called on each GUI cycle. Returns
+	whether any channel is still active. */
 
-	void refresh();
+	bool refresh();
 
 	void init();
 
@@ -81,6 +95,8 @@ public:
 private:
 	int computeHeight() const;
 
+	geChannel* makeChannel(int x, int y, int w, int h, c::channel::Data d) const;
+
 	void addChannel();
 
 	std::vector<geChannel*> m_channels;
@@ -47,7 +47,7 @@
 #include <FL/fl_draw.H>
 #include <cassert>
 
-extern giada::v::Ui g_ui;
+extern giada::v::Ui& g_ui;
 
 namespace giada::v
 {
@@ -121,7 +121,8 @@ void geKeyboard::ChannelDragger::end()
 	{
 		m_channelId = -1;
 		m_xoffset   = 0;
-		m_keyboard.rebuild(); // Just cleanup the UI
+		m_keyboard.remove(m_placeholder); // Just cleanup the UI
+		m_keyboard.redraw();
 		return;
 	}
 
@@ -134,6 +135,7 @@ void geKeyboard::ChannelDragger::end()
 	m_channelId = -1;
 	m_xoffset   = 0;
 	m_keyboard.remove(m_placeholder);
+	m_keyboard.redraw();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -181,6 +183,18 @@ void geKeyboard::init()
 
 void geKeyboard::rebuild()
 {
+	const std::vector<c::channel::Data> channels = c::channel::getChannels();
+
+	/* Same layout: just replace the channels that have changed. Useful for 
+	small changes (e.g. renaming a channel) in big projects. */
+
+	if (hasLayout(channels))
+	{
+		for (const c::channel::Data& ch : channels)
+			getColumn(ch.columnId)->updateChannel(ch);
+		return;
+	}
+
 	/* Wipe out all columns and add them according to the current layout in model. */
 
 	deleteAllColumns();
@@ -188,7 +202,7 @@ void geKeyboard::rebuild()
 	for (const Model::Column& c : g_ui.model.columns)
 		addColumn(c.width, c.id);
 
-	for (const c::channel::Data& ch : c::channel::getChannels())
+	for (const c::channel::Data& ch : channels)
 		getColumn(ch.columnId)->addChannel(ch);
 
 	redraw();
@@ -196,6 +210,25 @@ void geKeyboard::rebuild()
 
 /* -------------------------------------------------------------------------- */
 
+bool geKeyboard::hasLayout(const std::vector<c::channel::Data>& channels) const
+{
+	if (m_columns.size() != g_ui.model.columns.size())
+		return false;
+
+	for (std::size_t i = 0; i < m_columns.size(); i++)
+	{
+		const geColumn&      column = *m_columns[i];
+		const Model::Column& model  = g_ui.model.columns[i];
+
+		if (column.id != model.id || column.w() != model.width || !column.hasLayout(channels))
+			return false;
+	}
+
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
 void geKeyboard::deleteColumn(ID id)
 {
 	u::vector::removeIf(g_ui.model.columns, [=](const Model::Column& c) { return c.id == id; });
@@ -239,12 +272,14 @@ void geKeyboard::notifyMidiOut(ID channelId)
 
 /* -------------------------------------------------------------------------- */
 
-void geKeyboard::refresh()
+bool geKeyboard::refresh()
 {
 	if (m_channelDragger.isDragging())
-		return;
+		return true;
+	bool active = false;
 	for (geColumn* c : m_columns)
-		c->refresh();
+		active = c->refresh() || active;
+	return active;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -302,6 +337,12 @@ void geKeyboard::draw()
 {
 	geScroll::draw();
 
+	/* Only some channels have changed: geScroll::draw() has already repainted
+	them, the columns background is untouched. */
+
+	if ((damage() & ~FL_DAMAGE_CHILD) == 0)
+		return;
+
 	/* Paint columns background. Use a clip to draw only what's visible. */
 
 	fl_push_clip(
@@ -57,14 +57,17 @@ public:
 	ID getChannelColumnId(ID channelId) const;
 
 	/* rebuild
-	Rebuilds this widget from scratch. Used when the model has changed. */
+	Rebuilds this widget when the model has changed. If the columns layout
+	hasn't changed, only the channels with new data are replaced; otherwise 
+	everything is rebuilt from scratch. */
 
 	void rebuild();
 
 	/* refresh
-	Refreshes each column's channel, called on each GUI cycle. */
+	Refreshes each column's channel, called on each GUI cycle. Returns whether
+	any channel is still active. */
 
-	void refresh();
+	bool refresh();
 
 	/* deleteColumn
 	Deletes column by id. */
@@ -133,6 +136,12 @@ private:
 	geChannel*       getChannel(ID channelId);
 	const geChannel* getChannel(ID channelId) const;
 
+	/* hasLayout
+	Returns true if the current columns and channels widgets match the layout
+	in g_ui.model and 'channels'. */
+
+	bool hasLayout(const std::vector<c::channel::Data>& channels) const;
+
 	/* storeLayout
 	Stores the current column layout into the layout vector. */
 
@@ -46,7 +46,7 @@
 #include <FL/Fl_Menu_Button.H>
 #include <cassert>
 
-extern giada::v::Ui g_ui;
+extern giada::v::Ui& g_ui;
 
 namespace giada::v
 {
@@ -34,20 +34,17 @@ namespace giada::v
 geMidiChannelButton::geMidiChannelButton(int x, int y, int w, int h, const c::channel::Data& d)
 : geChannelButton(x, y, w, h, d)
 {
+	refreshLabel();
 }
 
 /* -------------------------------------------------------------------------- */
 
-void geMidiChannelButton::refresh()
+void geMidiChannelButton::refresh(const c::channel::State& state)
 {
-	geChannelButton::refresh();
-
-	refreshLabel();
+	geChannelButton::refresh(state);
 
-	if (m_channel.isRecordingActions() && m_channel.isArmed())
+	if (state.recordingActions && state.armed)
 		setActionRecordMode();
-
-	redraw();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -36,7 +36,7 @@ class geMidiChannelButton : public geChannelButton
 public:
 	geMidiChannelButton(int x, int y, int w, int h, const c::channel::Data& d);
 
-	void refresh() override;
+	void refresh(const c::channel::State&) override;
 
 private:
 	void refreshLabel();
@@ -45,7 +45,7 @@
 #include "gui/ui.h"
 #include "utils/gui.h"
 
-extern giada::v::Ui g_ui;
+extern giada::v::Ui& g_ui;
 
 namespace giada::v
 {
@@ -273,13 +273,13 @@ void geSampleChannel::readActions()
 
 /* -------------------------------------------------------------------------- */
 
-void geSampleChannel::refresh()
+void geSampleChannel::refreshWidgets(const c::channel::State& state)
 {
-	geChannel::refresh();
+	geChannel::refreshWidgets(state);
 
 	if (m_channel.sample->waveId != 0)
 	{
-		status->redraw();
+		status->refresh(state);
 		if (m_channel.sample->overdubProtection)
 			arm->deactivate();
 		else
@@ -289,7 +289,8 @@ void geSampleChannel::refresh()
 	if (m_channel.hasActions)
 	{
 		readActionsBtn->activate();
-		readActionsBtn->setValue(m_channel.getReadActions());
+		if (readActionsBtn->getValue() != state.readActions)
+			readActionsBtn->setValue(state.readActions);
 	}
 	else
 		readActionsBtn->deactivate();
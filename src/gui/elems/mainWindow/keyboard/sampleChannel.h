@@ -42,11 +42,12 @@ public:
 	void resize(int x, int y, int w, int h) override;
 	void draw() override;
 
-	void refresh() override;
-
 	geSampleChannelMode* modeBox;
 	geImageButton*       readActionsBtn;
 
+protected:
+	void refreshWidgets(const c::channel::State&) override;
+
 private:
 	void openMenu();
 	void readActions();
@@ -34,7 +34,7 @@
 #include "utils/string.h"
 #include <FL/Fl.H>
 
-extern giada::v::Ui g_ui;
+extern giada::v::Ui& g_ui;
 
 namespace giada::v
 {
@@ -55,16 +55,14 @@ geSampleChannelButton::geSampleChannelButton(int x, int y, int w, int h, const c
 
 /* -------------------------------------------------------------------------- */
 
-void geSampleChannelButton::refresh()
+void geSampleChannelButton::refresh(const c::channel::State& state)
 {
-	geChannelButton::refresh();
+	geChannelButton::refresh(state);
 
-	if (m_channel.isRecordingInput() && m_channel.isArmed())
+	if (state.recordingInput && state.armed)
 		setInputRecordMode();
-	else if (m_channel.isRecordingActions() && m_channel.sample->waveId != 0 && !m_channel.sample->isLoop)
+	else if (state.recordingActions && m_channel.sample->waveId != 0 && !m_channel.sample->isLoop)
 		setActionRecordMode();
-
-	redraw();
 }
 
 /* -------------------------------------------------------------------------- */
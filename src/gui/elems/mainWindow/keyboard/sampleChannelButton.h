@@ -40,7 +40,7 @@ public:
 
 	int handle(int e) override;
 
-	void refresh() override;
+	void refresh(const c::channel::State&) override;
 };
 } // namespace v
 } // namespace giada
@@ -38,7 +38,7 @@
 #include "gui/ui.h"
 #include "utils/gui.h"
 
-extern giada::v::Ui g_ui;
+extern giada::v::Ui& g_ui;
 
 namespace giada::v
 {
@@ -110,7 +110,7 @@ void geMainIO::setMasterFxInFull(bool v)
 
 /* -------------------------------------------------------------------------- */
 
-void geMainIO::refresh()
+bool geMainIO::refresh()
 {
 	m_outMeter->peak  = m_io.getMasterOutPeak();
 	m_outMeter->ready = m_io.isKernelReady();
@@ -118,7 +118,12 @@ void geMainIO::refresh()
 	m_inMeter->ready  = m_io.isKernelReady();
 	m_outMeter->redraw();
 	m_inMeter->redraw();
-	m_midiActivity->redraw();
+
+	const bool ledsLit = m_midiActivity->refresh();
+	const bool hasPeak = m_outMeter->peak.left != 0.0f || m_outMeter->peak.right != 0.0f ||
+	                     m_inMeter->peak.left != 0.0f || m_inMeter->peak.right != 0.0f;
+
+	return ledsLit || hasPeak;
 }
 
 /* -------------------------------------------------------------------------- */
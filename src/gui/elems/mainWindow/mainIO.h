@@ -42,7 +42,11 @@ class geMainIO : public geFlex
 public:
 	geMainIO();
 
-	void refresh();
+	/* refresh
+	Updates meters and MIDI leds. Returns whether there is some signal or MIDI
+	activity going on. */
+
+	bool refresh();
 	void rebuild();
 
 	void setOutVol(float v);
@@ -36,7 +36,7 @@
 #include "keyboard/keyboard.h"
 #include "utils/gui.h"
 
-extern giada::v::Ui g_ui;
+extern giada::v::Ui& g_ui;
 
 namespace giada::v
 {
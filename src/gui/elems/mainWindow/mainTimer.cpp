@@ -36,7 +36,7 @@
 #include "utils/gui.h"
 #include <fmt/core.h>
 
-extern giada::v::Ui g_ui;
+extern giada::v::Ui& g_ui;
 
 namespace giada::v
 {
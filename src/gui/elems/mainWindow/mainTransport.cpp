@@ -33,7 +33,7 @@
 #include "gui/graphics.h"
 #include "gui/ui.h"
 
-extern giada::v::Ui g_ui;
+extern giada::v::Ui& g_ui;
 
 namespace giada::v
 {
@@ -103,7 +103,7 @@ geMainTransport::geMainTransport()
 
 /* -------------------------------------------------------------------------- */
 
-void geMainTransport::refresh()
+bool geMainTransport::refresh()
 {
 	c::main::Transport transport = c::main::getTransport();
 
@@ -113,5 +113,7 @@ void geMainTransport::refresh()
 	m_metronome->setValue(transport.isMetronomeOn);
 	m_recTriggerMode->setValue(transport.recTriggerMode == RecTriggerMode::SIGNAL);
 	m_inputRecMode->setValue(transport.inputRecMode == InputRecMode::FREE);
+
+	return transport.isRunning;
 }
 } // namespace giada::v
@@ -37,7 +37,10 @@ class geMainTransport : public geFlex
 public:
 	geMainTransport();
 
-	void refresh();
+	/* refresh
+	Updates buttons. Returns whether the sequencer is running. */
+
+	bool refresh();
 
 private:
 	geImageButton* m_rewind;
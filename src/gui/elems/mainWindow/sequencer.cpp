@@ -33,7 +33,7 @@
 #include "utils/math.h"
 #include <FL/fl_draw.H>
 
-extern giada::v::Ui g_ui;
+extern giada::v::Ui& g_ui;
 
 namespace giada::v
 {
@@ -45,10 +45,14 @@ geSequencer::geSequencer()
 
 /* -------------------------------------------------------------------------- */
 
-void geSequencer::refresh()
+bool geSequencer::refresh()
 {
-	m_data = c::main::getSequencer();
+	const c::main::Sequencer data = c::main::getSequencer();
+	if (data == m_data)
+		return false;
+	m_data = data;
 	redraw();
+	return true;
 }
 
 /* -------------------------------------------------------------------------- */
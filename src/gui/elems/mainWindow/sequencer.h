@@ -43,7 +43,11 @@ public:
 
 	void draw() override;
 
-	void refresh();
+	/* refresh
+	Repaints the widget if the sequencer has changed since the last call.
+	Returns whether it has. */
+
+	bool refresh();
 
 private:
 	static constexpr int REC_BARS_H = 3;
@@ -29,7 +29,7 @@
 #include "gui/ui.h"
 #include <FL/fl_draw.H>
 
-extern giada::v::Ui g_ui;
+extern giada::v::Ui& g_ui;
 
 namespace giada::v
 {
@@ -48,8 +48,6 @@ void geMidiActivity::geLed::draw()
 
 	if (m_decay > 0) // If led is on
 	{
-		m_decay = (m_decay + 1) % (G_GUI_FPS / 4);
-
 		bgColor = G_COLOR_LIGHT_2;
 		bdColor = G_COLOR_LIGHT_2;
 	}
@@ -60,8 +58,23 @@ void geMidiActivity::geLed::draw()
 
 /* -------------------------------------------------------------------------- */
 
+bool geMidiActivity::geLed::refresh()
+{
+	if (m_decay == 0)
+		return false;
+
+	m_decay = (m_decay + 1) % (G_GUI_FPS / 4);
+	if (m_decay == 0)
+		redraw();
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
 void geMidiActivity::geLed::lit()
 {
+	if (m_decay == 0)
+		redraw();
 	m_decay = 1;
 }
 
@@ -78,4 +91,13 @@ geMidiActivity::geMidiActivity()
 	add(in);
 	end();
 }
+
+/* -------------------------------------------------------------------------- */
+
+bool geMidiActivity::refresh()
+{
+	const bool outLit = out->refresh();
+	const bool inLit  = in->refresh();
+	return outLit || inLit;
+}
 } // namespace giada::v
\ No newline at end of file
@@ -41,6 +41,16 @@ public:
 		geLed();
 
 		void draw() override;
+
+		/* refresh
+		Advances the decay of a lit led, repainting it when it turns off.
+		Returns whether the led is still lit. */
+
+		bool refresh();
+
+		/* lit
+		Turns the led on and repaints it. */
+
 		void lit();
 
 	private:
@@ -49,6 +59,11 @@ public:
 
 	geMidiActivity();
 
+	/* refresh
+	Refreshes both leds. Returns whether any of them is still lit. */
+
+	bool refresh();
+
 	geLed* out;
 	geLed* in;
 };
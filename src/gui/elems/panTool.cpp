@@ -37,7 +37,7 @@
 #include <FL/Fl.H>
 #include <fmt/core.h>
 
-extern giada::v::Ui g_ui;
+extern giada::v::Ui& g_ui;
 
 namespace giada::v
 {
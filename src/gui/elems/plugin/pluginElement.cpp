@@ -40,7 +40,7 @@
 #include <cassert>
 #include <string>
 
-extern giada::v::Ui g_ui;
+extern giada::v::Ui& g_ui;
 
 namespace giada::v
 {
@@ -35,7 +35,7 @@
 #include "gui/ui.h"
 #include "utils/string.h"
 
-extern giada::v::Ui g_ui;
+extern giada::v::Ui& g_ui;
 
 namespace giada::v
 {
@@ -37,7 +37,7 @@
 #include "waveform.h"
 #include <cstdint>
 
-extern giada::v::Ui g_ui;
+extern giada::v::Ui& g_ui;
 
 namespace giada::v
 {
@@ -56,7 +56,10 @@ enum class Menu
 	FADE_OUT,
 	SMOOTH_EDGES,
 	SET_BEGIN_END,
-	TO_NEW_CHANNEL
+	TO_NEW_CHANNEL,
+	UNDO,
+	REDO,
+	CONSOLIDATE
 };
 } // namespace
 
@@ -158,6 +161,9 @@ void geWaveTools::openMenu()
 	menu.addItem((ID)Menu::SMOOTH_EDGES, g_ui.getI18Text(LangMap::SAMPLEEDITOR_TOOLS_SMOOTH_EDGES));
 	menu.addItem((ID)Menu::SET_BEGIN_END, g_ui.getI18Text(LangMap::SAMPLEEDITOR_TOOLS_SET_BEGIN_END));
 	menu.addItem((ID)Menu::TO_NEW_CHANNEL, g_ui.getI18Text(LangMap::SAMPLEEDITOR_TOOLS_TO_NEW_CHANNEL));
+	menu.addItem((ID)Menu::UNDO, g_ui.getI18Text(LangMap::SAMPLEEDITOR_TOOLS_UNDO));
+	menu.addItem((ID)Menu::REDO, g_ui.getI18Text(LangMap::SAMPLEEDITOR_TOOLS_REDO));
+	menu.addItem((ID)Menu::CONSOLIDATE, g_ui.getI18Text(LangMap::SAMPLEEDITOR_TOOLS_CONSOLIDATE));
 
 	if (!waveform->isSelected())
 	{
@@ -174,6 +180,31 @@ void geWaveTools::openMenu()
 		menu.setEnabled((ID)Menu::TO_NEW_CHANNEL, false);
 	}
 
+	if (!c::sampleEditor::canUndo(m_data->channelId))
+		menu.setEnabled((ID)Menu::UNDO, false);
+	if (!c::sampleEditor::canRedo(m_data->channelId))
+		menu.setEnabled((ID)Menu::REDO, false);
+	if (m_data->getWaveRef().isConsolidated())
+		menu.setEnabled((ID)Menu::CONSOLIDATE, false);
+
+	/* Editing operations run in background, one at a time. */
+
+	if (c::sampleEditor::isProcessing())
+	{
+		menu.setEnabled((ID)Menu::CUT, false);
+		menu.setEnabled((ID)Menu::PASTE, false);
+		menu.setEnabled((ID)Menu::TRIM, false);
+		menu.setEnabled((ID)Menu::SILENCE, false);
+		menu.setEnabled((ID)Menu::REVERSE, false);
+		menu.setEnabled((ID)Menu::NORMALIZE, false);
+		menu.setEnabled((ID)Menu::FADE_IN, false);
+		menu.setEnabled((ID)Menu::FADE_OUT, false);
+		menu.setEnabled((ID)Menu::SMOOTH_EDGES, false);
+		menu.setEnabled((ID)Menu::UNDO, false);
+		menu.setEnabled((ID)Menu::REDO, false);
+		menu.setEnabled((ID)Menu::CONSOLIDATE, false);
+	}
+
 	menu.onSelect = [channelId = m_data->channelId,
 	                    a      = waveform->getSelectionA(),
 	                    b      = waveform->getSelectionB()](ID id) {
@@ -215,6 +246,15 @@ void geWaveTools::openMenu()
 		case Menu::TO_NEW_CHANNEL:
 			c::sampleEditor::toNewChannel(channelId, a, b);
 			break;
+		case Menu::UNDO:
+			c::sampleEditor::undo(channelId);
+			break;
+		case Menu::REDO:
+			c::sampleEditor::redo(channelId);
+			break;
+		case Menu::CONSOLIDATE:
+			c::sampleEditor::consolidate(channelId);
+			break;
 		}
 	};
 
@@ -30,6 +30,7 @@
 #include "core/model/model.h"
 #include "core/wave.h"
 #include "core/waveFx.h"
+#include "core/wavePeaks.h"
 #include "glue/channel.h"
 #include "glue/sampleEditor.h"
 #include "gui/dialogs/sampleEditor.h"
@@ -38,6 +39,7 @@
 #include "waveTools.h"
 #include <FL/Fl_Menu_Button.H>
 #include <FL/fl_draw.H>
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 
@@ -79,13 +81,13 @@ int geWaveform::alloc(int datasize, bool force)
 {
 	const m::Wave& wave = m_data->getWaveRef();
 
-	m_ratio = wave.getBuffer().countFrames() / (float)datasize;
+	m_ratio = wave.countFrames() / (float)datasize;
 
 	/* Limit 1:1 drawing (to avoid sub-frame drawing) by keeping m_ratio >= 1. */
 
 	if (m_ratio < 1)
 	{
-		datasize = wave.getBuffer().countFrames();
+		datasize = wave.countFrames();
 		m_ratio  = 1;
 	}
 
@@ -106,15 +108,23 @@ int geWaveform::alloc(int datasize, bool force)
 	/* Frid frequency: store a grid point every 'gridFreq' frame (if grid is
 	enabled). TODO - this will cause round off errors, since gridFreq is integer. */
 
-	int gridFreq = m_grid.level != 0 ? wave.getBuffer().countFrames() / m_grid.level : 0;
+	int gridFreq = m_grid.level != 0 ? wave.countFrames() / m_grid.level : 0;
 
-	/* Resampling the waveform, hardcore way. Many thanks to 
-	http://fourier.eng.hmc.edu/e161/lectures/resize/node3.html */
+	if (gridFreq != 0)
+		for (int k = gridFreq; k < wave.countFrames(); k += gridFreq)
+			m_grid.points.push_back(k);
+
+	/* Peaks are read from the precomputed peak pyramid, so the cost depends on 
+	the number of pixels, not on the length of the Wave. If not ready yet, just
+	draw a flat line: the Sample Editor will rebuild the widget later on. */
+
+	const m::WavePeaks* peaks = m_data->peaks.get();
+	if (peaks != nullptr && peaks->countFrames() != wave.countFrames())
+		peaks = nullptr;
 
 	for (int i = 0; i < m_waveform.size; i++)
 	{
-
-		/* Scan the original waveform in chunks [pc, pn]. */
+		/* Summarize the original waveform in chunks [pc, pn]. */
 
 		int pc = i * m_ratio;       // current point TODO - int until we switch to uint32_t for Wave size...
 		int pn = (i + 1) * m_ratio; // next point    TODO - int until we switch to uint32_t for Wave size...
@@ -122,31 +132,11 @@ int geWaveform::alloc(int datasize, bool force)
 		float peaksup = 0.0f;
 		float peakinf = 0.0f;
 
-		for (int k = pc; k < pn; k++)
-		{ // TODO - int until we switch to uint32_t for Wave size...
-
-			if (k >= wave.getBuffer().countFrames())
-				continue;
-
-			/* Compute average of stereo signal. */
-
-			float  avg   = 0.0f;
-			float* frame = wave.getBuffer()[k];
-			for (int j = 0; j < wave.getBuffer().countChannels(); j++)
-				avg += frame[j];
-			avg /= wave.getBuffer().countChannels();
-
-			/* Find peaks (greater and lower). */
-
-			if (avg > peaksup)
-				peaksup = avg;
-			else if (avg <= peakinf)
-				peakinf = avg;
-
-			/* Fill up grid vector. */
-
-			if (gridFreq != 0 && (int)k % gridFreq == 0 && k != 0)
-				m_grid.points.push_back(k);
+		if (peaks != nullptr && pc < pn)
+		{
+			const m::WavePeaks::Peak peak = peaks->get(wave, pc, pn);
+			peaksup                       = std::max(peak.max, 0.0f);
+			peakinf                       = std::min(peak.min, 0.0f);
 		}
 
 		m_waveform.sup[i] = zero - (peaksup * offset);
@@ -451,8 +441,8 @@ int geWaveform::handle(int e)
 
 			m_chanEnd = snap(m_mouseX);
 
-			if (m_chanEnd > wave.getBuffer().countFrames())
-				m_chanEnd = wave.getBuffer().countFrames();
+			if (m_chanEnd > wave.countFrames())
+				m_chanEnd = wave.countFrames();
 			else if (m_chanEnd <= m_chanStart)
 				m_chanEnd = m_chanStart + 2;
 
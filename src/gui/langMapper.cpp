@@ -91,6 +91,7 @@ LangMap::LangMap()
 	m_data[MESSAGE_STORAGE_FILEHASINVALIDCHARS] = "The file name contains invalid characters.";
 	m_data[MESSAGE_STORAGE_FILEEXISTS]          = "File exists: overwrite?";
 	m_data[MESSAGE_STORAGE_SAVINGFILEERROR]     = "Unable to save this sample!";
+	m_data[MESSAGE_STORAGE_PRELOADTOOLARGE]     = "This project doesn't fit in the preload memory budget.";
 
 	m_data[MAIN_MENU_FILE]                 = "File";
 	m_data[MAIN_MENU_FILE_OPENPROJECT]     = "Open project...";
@@ -201,6 +202,7 @@ LangMap::LangMap()
 	m_data[SAMPLEEDITOR_RELOAD]               = "Reload";
 	m_data[SAMPLEEDITOR_LOOP]                 = "Loop";
 	m_data[SAMPLEEDITOR_INFO]                 = "File: {}\nSize: {} frames\nDuration {} seconds\nBit depth: {}\nFrequency: {} Hz";
+	m_data[SAMPLEEDITOR_PROCESSING]           = "Processing... {}%";
 	m_data[SAMPLEEDITOR_PAN]                  = "Pan";
 	m_data[SAMPLEEDITOR_PITCH]                = "Pitch";
 	m_data[SAMPLEEDITOR_PITCH_TOBAR]          = "To bar";
@@ -220,6 +222,9 @@ LangMap::LangMap()
 	m_data[SAMPLEEDITOR_TOOLS_SMOOTH_EDGES]   = "Smooth edges";
 	m_data[SAMPLEEDITOR_TOOLS_SET_BEGIN_END]  = "Set begin/end here";
 	m_data[SAMPLEEDITOR_TOOLS_TO_NEW_CHANNEL] = "Copy to new channel";
+	m_data[SAMPLEEDITOR_TOOLS_UNDO]           = "Undo";
+	m_data[SAMPLEEDITOR_TOOLS_REDO]           = "Redo";
+	m_data[SAMPLEEDITOR_TOOLS_CONSOLIDATE]    = "Consolidate edits";
 
 	m_data[ACTIONEDITOR_TITLE]             = "Action Editor";
 	m_data[ACTIONEDITOR_VOLUME]            = "Volume";
@@ -96,6 +96,7 @@ public:
 	static constexpr auto MESSAGE_STORAGE_FILEHASINVALIDCHARS = "message_storage_fileHasInvalidChars";
 	static constexpr auto MESSAGE_STORAGE_FILEEXISTS          = "message_storage_fileExists";
 	static constexpr auto MESSAGE_STORAGE_SAVINGFILEERROR     = "message_storage_savingFileError";
+	static constexpr auto MESSAGE_STORAGE_PRELOADTOOLARGE     = "message_storage_preloadTooLarge";
 
 	static constexpr auto MAIN_MENU_FILE                 = "main_menu_file";
 	static constexpr auto MAIN_MENU_FILE_OPENPROJECT     = "main_menu_file_openProject";
@@ -198,6 +199,7 @@ public:
 	static constexpr auto SAMPLEEDITOR_RELOAD               = "sampleEditor_reload";
 	static constexpr auto SAMPLEEDITOR_LOOP                 = "sampleEditor_loop";
 	static constexpr auto SAMPLEEDITOR_INFO                 = "sampleEditor_info";
+	static constexpr auto SAMPLEEDITOR_PROCESSING           = "sampleEditor_processing";
 	static constexpr auto SAMPLEEDITOR_PAN                  = "sampleEditor_pan";
 	static constexpr auto SAMPLEEDITOR_PITCH                = "sampleEditor_pitch";
 	static constexpr auto SAMPLEEDITOR_PITCH_TOBAR          = "sampleEditor_pitch_toBar";
@@ -217,6 +219,9 @@ public:
 	static constexpr auto SAMPLEEDITOR_TOOLS_SMOOTH_EDGES   = "sampleEditor_tools_smoothEdgdes";
 	static constexpr auto SAMPLEEDITOR_TOOLS_SET_BEGIN_END  = "sampleEditor_tools_setBeginEnd";
 	static constexpr auto SAMPLEEDITOR_TOOLS_TO_NEW_CHANNEL = "sampleEditor_tools_toNewChannel";
+	static constexpr auto SAMPLEEDITOR_TOOLS_UNDO           = "sampleEditor_tools_undo";
+	static constexpr auto SAMPLEEDITOR_TOOLS_REDO           = "sampleEditor_tools_redo";
+	static constexpr auto SAMPLEEDITOR_TOOLS_CONSOLIDATE    = "sampleEditor_tools_consolidate";
 
 	static constexpr auto ACTIONEDITOR_TITLE             = "actionEditor_title";
 	static constexpr auto ACTIONEDITOR_VOLUME            = "actionEditor_volume";
@@ -37,6 +37,9 @@ void Model::store(m::Conf& conf) const
 	conf.patchPath    = patchPath;
 	conf.samplePath   = samplePath;
 
+	conf.compressSamples  = compressSamples;
+	conf.preloadMaxMemory = preloadMaxMemory;
+
 	conf.mainWindowBounds = mainWindowBounds;
 
 	conf.browserBounds    = browserBounds;
@@ -81,6 +84,8 @@ void Model::load(const m::Conf& conf)
 	pluginPath       = conf.pluginPath;
 	patchPath        = conf.patchPath;
 	samplePath       = conf.samplePath;
+	compressSamples  = conf.compressSamples;
+	preloadMaxMemory = conf.preloadMaxMemory;
 	mainWindowBounds = conf.mainWindowBounds;
 
 	browserBounds    = conf.browserBounds;
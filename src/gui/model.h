@@ -57,6 +57,9 @@ struct Model
 	std::string samplePath   = "";
 	std::string projectName  = "";
 
+	bool compressSamples  = false;
+	int  preloadMaxMemory = 0;
+
 	geompp::Rect<int> mainWindowBounds = {-1, -1, G_MIN_GUI_WIDTH, G_MIN_GUI_HEIGHT};
 
 	geompp::Rect<int> browserBounds = {-1, -1, G_DEFAULT_SUBWINDOW_W, G_DEFAULT_SUBWINDOW_W};
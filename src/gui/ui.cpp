@@ -26,11 +26,16 @@
 
 #include "gui/ui.h"
 #include "core/const.h"
+#include "core/model/model.h"
 #include "gui/dialogs/warnings.h"
 #include "gui/elems/mainWindow/keyboard/column.h"
 #include "gui/elems/mainWindow/keyboard/keyboard.h"
 #include "gui/elems/mainWindow/mainIO.h"
 #include "gui/elems/mainWindow/mainTimer.h"
+#include "glue/plugin.h"
+#include "glue/sampleEditor.h"
+#include "gui/dialogs/sampleEditor.h"
+#include "gui/elems/sampleEditor/pitchTool.h"
 #include "gui/updater.h"
 #include "utils/gui.h"
 #include "utils/log.h"
@@ -134,6 +139,7 @@ void Ui::init(int argc, char** argv, const m::Conf& conf, const std::string& pat
 
 void Ui::reset()
 {
+	m_updater.clearNotifications();
 	mainWindow->setTitle(G_DEFAULT_PATCH_NAME);
 	rebuildStaticWidgets();
 	closeAllSubwindows();
@@ -175,7 +181,61 @@ bool Ui::pumpEvent(const Updater::Event& e)
 
 /* -------------------------------------------------------------------------- */
 
-void Ui::refresh()
+bool Ui::notify(Updater::Notification n, ID id, float value)
+{
+	return m_updater.notify(n, id, value);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Ui::handleNotification(Updater::Notification n, ID id, float value)
+{
+	using Notification = Updater::Notification;
+
+	switch (n)
+	{
+	case Notification::CHANNEL_VOLUME:
+		mainWindow->keyboard->setChannelVolume(id, value);
+		break;
+
+	case Notification::CHANNEL_PITCH:
+		if (auto* w = c::sampleEditor::getWindow(); w != nullptr)
+			w->pitchTool->update(value);
+		break;
+
+	case Notification::CHANNEL_MIDI_IN:
+		mainWindow->keyboard->notifyMidiIn(id);
+		break;
+
+	case Notification::CHANNEL_MIDI_OUT:
+		mainWindow->keyboard->notifyMidiOut(id);
+		break;
+
+	case Notification::MASTER_IN_VOLUME:
+		mainWindow->mainIO->setInVol(value);
+		break;
+
+	case Notification::MASTER_OUT_VOLUME:
+		mainWindow->mainIO->setOutVol(value);
+		break;
+
+	case Notification::PLUGIN_PARAMETERS:
+		c::plugin::updateWindow(id, Thread::MIDI);
+		break;
+
+	case Notification::MIDI_IN_ACTIVITY:
+		mainWindow->mainIO->setMidiInActivity();
+		break;
+
+	case Notification::MIDI_OUT_ACTIVITY:
+		mainWindow->mainIO->setMidiOutActivity();
+		break;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool Ui::refresh()
 {
 	/* Update dynamic elements inside main window: in and out meters, beat meter
 	and each channel. */
@@ -190,6 +250,12 @@ void Ui::refresh()
 
 	refreshSubWindow(WID_SAMPLE_EDITOR);
 	refreshSubWindow(WID_ACTION_EDITOR);
+
+	/* Editors don't track their own changes: keep the full rate while open. */
+
+	return mainWindow->isActive() ||
+	       getSubwindow(*mainWindow.get(), WID_SAMPLE_EDITOR) != nullptr ||
+	       getSubwindow(*mainWindow.get(), WID_ACTION_EDITOR) != nullptr;
 }
 
 /* -------------------------------------------------------------------------- */
@@ -204,10 +270,48 @@ void Ui::rebuild()
 
 /* -------------------------------------------------------------------------- */
 
-void Ui::rebuildSubWindow(int wid)
+void Ui::rebuild(const m::model::Change& change)
+{
+	using Change = m::model::Change;
+
+	switch (change.scope)
+	{
+	case Change::CHANNELS:
+		mainWindow->keyboard->rebuild();
+		rebuildSubWindow(WID_FX_LIST, change.channelId);
+		rebuildSubWindow(WID_SAMPLE_EDITOR, change.channelId);
+		rebuildSubWindow(WID_ACTION_EDITOR, change.channelId);
+		break;
+
+	case Change::ACTIONS:
+		mainWindow->keyboard->rebuild(); // Channels display the 'has actions' state
+		rebuildSubWindow(WID_ACTION_EDITOR, change.channelId);
+		break;
+
+	case Change::PLUGINS:
+		mainWindow->keyboard->rebuild(); // Channels display the 'has plugins' state
+		mainWindow->mainIO->rebuild();   // Same for master channels
+		rebuildSubWindow(WID_FX_LIST, change.channelId);
+		break;
+
+	case Change::SEQUENCER:
+		mainWindow->mainTimer->rebuild();
+		rebuildSubWindow(WID_ACTION_EDITOR); // Grid depends on bpm, beats, ...
+		rebuildSubWindow(WID_SAMPLE_EDITOR); // Same for frames in bar and loop
+		break;
+
+	default:
+		rebuild();
+		break;
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Ui::rebuildSubWindow(int wid, ID channelId)
 {
 	v::gdWindow* w = getSubwindow(*mainWindow.get(), wid);
-	if (w != nullptr) // If its open
+	if (w != nullptr && (channelId == 0 || w->getChannelId() == channelId)) // If its open
 		w->rebuild();
 }
 
@@ -37,6 +37,11 @@
 #include <memory>
 #include <string>
 
+namespace giada::m::model
+{
+struct Change;
+}
+
 namespace giada::v
 {
 class Ui final
@@ -78,20 +83,39 @@ public:
 	void startUpdater();
 	bool pumpEvent(const Updater::Event&);
 
+	/* notify
+	Posts a coalesced notification to the UI. See Updater::notify(). */
+
+	bool notify(Updater::Notification, ID id = 0, float value = 0.0f);
+
+	/* handleNotification
+	Applies a notification to the widgets it refers to. Called by the Updater
+	on the main thread. */
+
+	void handleNotification(Updater::Notification, ID id, float value);
+
 	/* refresh
-	Repaints dynamic GUI elements. */
+	Repaints dynamic GUI elements. Returns whether something is still moving
+	on screen, i.e. the next refresh is likely to repaint something. */
 
-	void refresh();
+	bool refresh();
 
-	/* rebuild
+	/* rebuild (1)
 	Rebuilds the UI from scratch. Used when the model has changed. */
 
 	void rebuild();
 
+	/* rebuild (2)
+	Rebuilds only the parts of the UI affected by a model change. */
+
+	void rebuild(const m::model::Change&);
+
 	/* [rebuild|refresh]SubWindow 
-	Rebuilds or refreshes subwindow with ID 'wid' if it exists, i.e. if it's open. */
+	Rebuilds or refreshes subwindow with ID 'wid' if it exists, i.e. if it's open.
+	If 'channelId' != 0, the subwindow is rebuilt only if bound to that 
+	channel. */
 
-	void rebuildSubWindow(int wid);
+	void rebuildSubWindow(int wid, ID channelId = 0);
 	void refreshSubWindow(int wid);
 
 	/* getSubwindow
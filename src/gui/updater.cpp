@@ -29,11 +29,16 @@
 #include "core/model/model.h"
 #include "gui/ui.h"
 #include "utils/gui.h"
+#include <algorithm>
 
 namespace giada::v
 {
 Updater::Updater(Ui& ui)
 : m_ui(ui)
+, m_idleTicks(0)
+, m_running(false)
+, m_idle(false)
+, m_woken(false)
 {
 }
 
@@ -43,9 +48,19 @@ void Updater::run()
 {
 	while (Fl::wait() > 0)
 	{
+		bool  pumped = false;
 		Event e;
 		while (m_eventQueue.try_dequeue(e))
+		{
 			e();
+			pumped = true;
+		}
+
+		/* Events and notifications usually change something on screen: don't 
+		wait for the next refresh at the idle rate. */
+
+		if (m_woken.exchange(false) || pumped)
+			wake();
 	}
 }
 
@@ -53,7 +68,35 @@ void Updater::run()
 
 bool Updater::pumpEvent(const Event& e)
 {
-	return m_eventQueue.try_enqueue(e);
+	if (!m_eventQueue.try_enqueue(e))
+		return false;
+	Fl::awake();
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool Updater::notify(Notification n, ID id, float value)
+{
+	/* Key layout: [notification + 1 | target ID]. Never zero. */
+
+	const uint64_t key = (static_cast<uint64_t>(n) + 1) << 32 | static_cast<uint32_t>(id);
+	if (!m_notifications.set(key, value))
+		return false;
+
+	/* Wake up the UI thread only once while idle: at full rate notifications
+	are picked up soon enough. */
+
+	if (m_idle.load() && !m_woken.exchange(true))
+		Fl::awake();
+	return true;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Updater::clearNotifications()
+{
+	m_notifications.clear();
 }
 
 /* -------------------------------------------------------------------------- */
@@ -64,19 +107,53 @@ void Updater::update(void* p) { static_cast<Updater*>(p)->update(); }
 
 void Updater::update()
 {
-	m_ui.refresh();
-	Fl::add_timeout(G_GUI_REFRESH_RATE, update, this); // Repeat
+	/* Keep refreshing at full rate while something moves on screen, plus a
+	grace period so that blinking or decaying elements don't make the rate
+	bounce back and forth. Drop to the idle rate afterwards. */
+
+	const std::size_t notified = m_notifications.consume([this](uint64_t key, float value) {
+		const auto n  = static_cast<Notification>((key >> 32) - 1);
+		const ID   id = static_cast<ID>(key & 0xFFFFFFFF);
+		m_ui.handleNotification(n, id, value);
+	});
+
+	const bool moving = m_ui.refresh() || notified > 0;
+
+	m_idleTicks = moving ? 0 : std::min(m_idleTicks + 1, IDLE_TICKS);
+	m_idle.store(m_idleTicks == IDLE_TICKS);
+
+	const float rate = m_idleTicks < IDLE_TICKS ? G_GUI_REFRESH_RATE : G_GUI_IDLE_REFRESH_RATE;
+	Fl::add_timeout(rate, update, this); // Repeat
+}
+
+/* -------------------------------------------------------------------------- */
+
+void Updater::wake()
+{
+	if (!m_running || m_idleTicks < IDLE_TICKS)
+		return;
+
+	/* Refresh right away and get back to the full rate. */
+
+	Fl::remove_timeout(update, this);
+	m_idleTicks = 0;
+	update();
 }
 
 /* -------------------------------------------------------------------------- */
 
 void Updater::start()
 {
+	m_idleTicks = 0;
+	m_running   = true;
+	m_idle.store(false);
 	Fl::add_timeout(G_GUI_REFRESH_RATE, update, this);
 }
 
 void Updater::stop()
 {
+	m_running = false;
+	m_idle.store(false);
 	Fl::remove_timeout(update);
 }
 } // namespace giada::v
@@ -27,8 +27,12 @@
 #ifndef G_V_UPDATER_H
 #define G_V_UPDATER_H
 
+#include "core/coalescingMap.h"
+#include "core/const.h"
+#include "core/types.h"
 #include "deps/concurrentqueue/concurrentqueue.h"
 #include <FL/Fl.H>
+#include <atomic>
 #include <functional>
 
 namespace giada::v
@@ -39,20 +43,90 @@ class Updater final
 public:
 	using Event = std::function<void()>;
 
+	/* Notification
+	High-rate UI updates (e.g. knobs moved by a MIDI controller), coalesced by
+	notification type and target ID: only the latest value for each pair
+	reaches the UI, at most once per refresh. */
+
+	enum class Notification
+	{
+		CHANNEL_VOLUME,
+		CHANNEL_PITCH,
+		CHANNEL_MIDI_IN,
+		CHANNEL_MIDI_OUT,
+		MASTER_IN_VOLUME,
+		MASTER_OUT_VOLUME,
+		PLUGIN_PARAMETERS,
+		MIDI_IN_ACTIVITY,
+		MIDI_OUT_ACTIVITY
+	};
+
 	Updater(Ui& ui);
 
 	void start();
 	void stop();
 	void run();
+
+	/* pumpEvent
+	Enqueues an Event to be run by the UI thread, which is woken up right away.
+	Can be called by any non-realtime thread. Returns false if the queue is 
+	full. */
+
 	bool pumpEvent(const Event&);
 
+	/* notify
+	Posts a Notification for target 'id' with an optional value. Lock-free and
+	allocation-free, it can be called by any thread. Returns false if the 
+	notification table is full: the notification is dropped, as a later one
+	will bring the UI up to date anyway. */
+
+	bool notify(Notification, ID id = 0, float value = 0.0f);
+
+	/* clearNotifications
+	Frees up the notification table, e.g. when a new project is loaded and old
+	target IDs are gone. Main thread only. */
+
+	void clearNotifications();
+
 private:
 	static void update(void*);
 	void        update();
 
+	/* wake
+	Refreshes immediately if the updater is running at the idle rate, then 
+	brings it back to the full rate. Main thread only. */
+
+	void wake();
+
+	/* IDLE_TICKS
+	Number of consecutive refreshes without activity before the update rate
+	drops to G_GUI_IDLE_REFRESH_RATE. */
+
+	static constexpr int IDLE_TICKS = G_GUI_FPS;
+
 	Ui& m_ui;
 
+	/* m_idleTicks
+	Consecutive refreshes without activity so far. */
+
+	int m_idleTicks;
+
+	/* m_running, m_idle, m_woken
+	Whether the updater is started, whether it is running at the idle rate and
+	whether a notification has woken up the UI thread already. 'm_running' is
+	accessed by the main thread only. */
+
+	bool              m_running;
+	std::atomic<bool> m_idle;
+	std::atomic<bool> m_woken;
+
 	moodycamel::ConcurrentQueue<Event> m_eventQueue;
+
+	/* m_notifications
+	Latest value for each (Notification, target ID) key, consumed on each
+	refresh. */
+
+	m::CoalescingMap<float, G_GUI_MAX_NOTIFICATIONS> m_notifications;
 };
 } // namespace giada::v
 
@@ -26,17 +26,66 @@
 
 #include "core/engine.h"
 #include "gui/ui.h"
+#include <memory>
 
-giada::m::Engine g_engine;
-giada::v::Ui     g_ui;
+namespace
+{
+/* Deferred_
+Storage for a global object that is constructed later on, in main(). A
+reference to it can be handed out right away, as long as it isn't used before
+construct() is called. */
+
+template <typename T>
+class Deferred_
+{
+public:
+	Deferred_() {}
+	~Deferred_()
+	{
+		if (m_constructed)
+			std::destroy_at(&m_value);
+	}
+
+	T& get() { return m_value; }
+
+	void construct()
+	{
+		std::construct_at(&m_value);
+		m_constructed = true;
+	}
+
+private:
+	union
+	{
+		T m_value;
+	};
+	bool m_constructed = false;
+};
+
+/* The engine and the UI are not constructed when running tests or as a
+plug-in scanner worker: they would start threads and set up the whole audio
+stack for nothing. Declaration order matters: the UI is destroyed first. */
+
+Deferred_<giada::m::Engine> engine_;
+Deferred_<giada::v::Ui>     ui_;
+} // namespace
+
+giada::m::Engine& g_engine = engine_.get();
+giada::v::Ui&     g_ui     = ui_.get();
 
 int main(int argc, char** argv)
 {
 	if (int ret = giada::m::init::tests(argc, argv); ret != -1)
 		return ret;
 
+	if (int ret = giada::m::init::scanPlugin(argc, argv); ret != -1)
+		return ret;
+
+	engine_.construct();
+	ui_.construct();
+
 	giada::m::init::startup(argc, argv);
 	giada::m::init::run();
 
 	return 0;
-}
\ No newline at end of file
+}
@@ -96,6 +96,8 @@ std::string toString(Thread t)
 		return "AUDIO (rt)";
 	case Thread::EVENTS:
 		return "EVENTS";
+	case Thread::RENDER:
+		return "RENDER (rt)";
 	default:
 		return "(unknown)";
 	}
@@ -0,0 +1,86 @@
+#include "src/core/actions/actionIndex.h"
+#include "src/core/actions/action.h"
+#include "src/core/midiEvent.h"
+#include "src/core/types.h"
+#include <catch2/catch.hpp>
+#include <vector>
+
+TEST_CASE("ActionIndex")
+{
+	using namespace giada;
+	using namespace giada::m;
+
+	const Frame     framesInLoop = 1000;
+	const MidiEvent noteOn       = MidiEvent::makeFrom3Bytes(MidiEvent::CHANNEL_NOTE_ON, 0x00, 0x00, 0);
+	const MidiEvent noteOff      = MidiEvent::makeFrom3Bytes(MidiEvent::CHANNEL_NOTE_OFF, 0x00, 0x00, 0);
+	const MidiEvent cc           = MidiEvent::makeFrom3Bytes(MidiEvent::CHANNEL_CC, 0x00, 0x00, 0);
+
+	/* A long note [10, 500), a short one [100, 120), a ring-loop note [900, 50)
+	and a single CC point at 300. Actions are linked like the model does. */
+
+	std::vector<Action> actions = {
+	    {1, 1, 10, noteOn},
+	    {2, 1, 50, noteOff},
+	    {3, 1, 100, noteOn},
+	    {4, 1, 120, noteOff},
+	    {5, 1, 300, cc},
+	    {6, 1, 500, noteOff},
+	    {7, 1, 900, noteOn}};
+
+	actions[0].next = &actions[5];
+	actions[2].next = &actions[3];
+	actions[6].next = &actions[1];
+
+	ActionIndex index(actions, framesInLoop);
+
+	auto query = [&index](Frame a, Frame b) {
+		std::vector<ID> out;
+		index.forEachInRange(a, b, [&out](const Action& a) { out.push_back(a.id); });
+		return out;
+	};
+
+	REQUIRE(index.size() == actions.size());
+
+	SECTION("Test empty index")
+	{
+		ActionIndex empty;
+
+		REQUIRE(empty.empty());
+		REQUIRE(empty.findBefore(100, [](const Action&) { return true; }) == nullptr);
+		REQUIRE(empty.findAfter(100, [](const Action&) { return true; }) == nullptr);
+	}
+
+	SECTION("Test whole range")
+	{
+		REQUIRE(query(0, framesInLoop) == std::vector<ID>{1, 2, 3, 4, 5, 6, 7});
+	}
+
+	SECTION("Test overlapping spans")
+	{
+		/* The long note started before the range but still covers it. */
+
+		REQUIRE(query(200, 250) == std::vector<ID>{1});
+		REQUIRE(query(110, 301) == std::vector<ID>{1, 3, 4, 5});
+	}
+
+	SECTION("Test ring-loop spans")
+	{
+		/* The ring-loop note lasts until the end of the loop. */
+
+		REQUIRE(query(950, 999) == std::vector<ID>{7});
+		REQUIRE(query(600, 800).empty());
+	}
+
+	SECTION("Test find")
+	{
+		auto isCC     = [](const Action& a) { return a.event.getStatus() == MidiEvent::CHANNEL_CC; };
+		auto isNoteOn = [](const Action& a) { return a.event.getStatus() == MidiEvent::CHANNEL_NOTE_ON; };
+
+		REQUIRE(index.findBefore(300, isCC) == nullptr);
+		REQUIRE(index.findBefore(301, isCC)->id == 5);
+		REQUIRE(index.findAfter(300, isCC)->id == 5);
+		REQUIRE(index.findAfter(301, isCC) == nullptr);
+		REQUIRE(index.findBefore(900, isNoteOn)->id == 3);
+		REQUIRE(index.findAfter(101, isNoteOn)->id == 7);
+	}
+}
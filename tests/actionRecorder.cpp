@@ -4,6 +4,7 @@
 #include "src/core/const.h"
 #include "src/core/model/actions.h"
 #include "src/core/model/model.h"
+#include "src/core/scheduler.h"
 #include "src/core/types.h"
 #include <catch2/catch.hpp>
 
@@ -28,7 +29,8 @@ TEST_CASE("ActionRecorder")
 	model.addChannelShared(std::move(channel2.shared));
 	model.swap(model::SwapType::NONE);
 
-	ActionRecorder ar(model);
+	Scheduler      scheduler;
+	ActionRecorder ar(model, scheduler);
 
 	REQUIRE(ar.hasActions(channelID1) == false);
 
@@ -80,4 +82,95 @@ TEST_CASE("ActionRecorder")
 			REQUIRE(ar.hasActions(channelID1) == false);
 		}
 	}
+
+	SECTION("Test live record")
+	{
+		const MidiEvent on  = MidiEvent::makeFrom3Bytes(MidiEvent::CHANNEL_NOTE_ON, 0x00, 0x00, 0);
+		const MidiEvent off = MidiEvent::makeFrom3Bytes(MidiEvent::CHANNEL_NOTE_OFF, 0x00, 0x00, 0);
+
+		ar.init(4);
+
+		ar.liveRec(channelID1, on, 10);
+		ar.liveRec(channelID2, on, 20);
+		ar.liveRec(channelID1, off, 30);
+		ar.liveRec(channelID2, off, 40);
+		ar.liveRec(channelID1, on, 50); // Dropped, buffer is full
+
+		REQUIRE(ar.getLiveStats().recorded == 4);
+		REQUIRE(ar.getLiveStats().dropped == 1);
+
+		const std::unordered_set<ID> channels = ar.consolidate();
+
+		REQUIRE(channels == std::unordered_set<ID>{channelID1, channelID2});
+
+		const std::vector<Action> actions = ar.getActionsOnChannel(channelID1);
+
+		REQUIRE(actions.size() == 2);
+		REQUIRE(actions[0].frame == 10);
+		REQUIRE(actions[1].frame == 30);
+		REQUIRE(actions[0].nextId == actions[1].id);
+		REQUIRE(actions[1].prevId == actions[0].id);
+
+		SECTION("Test live record after consolidation")
+		{
+			ar.liveRec(channelID1, on, 60);
+
+			REQUIRE(ar.consolidate() == std::unordered_set<ID>{channelID1});
+			REQUIRE(ar.getActionsOnChannel(channelID1).size() == 3);
+		}
+	}
+
+	SECTION("Test live record plug-in parameters")
+	{
+		constexpr ID  pluginId   = 5;
+		constexpr int paramIndex = 3;
+
+		ar.init(4);
+
+		ar.liveRecPluginParam(channelID1, pluginId, paramIndex, 0.25f, 10);
+		ar.liveRecPluginParam(channelID1, pluginId, paramIndex, 0.75f, 20);
+
+		REQUIRE(ar.consolidate() == std::unordered_set<ID>{channelID1});
+
+		const std::vector<Action> actions = ar.getActionsOnChannel(channelID1);
+
+		REQUIRE(actions.size() == 2);
+		REQUIRE(actions[0].pluginId == pluginId);
+		REQUIRE(actions[0].pluginParam == paramIndex);
+		REQUIRE(actions[0].event.getVelocityFloat() == 0.25f);
+		REQUIRE(actions[1].event.getVelocityFloat() == 0.75f);
+		REQUIRE(actions[0].nextId == 0);
+		REQUIRE(actions[1].prevId == 0);
+
+		/* Automation points are not volume envelope points. */
+
+		REQUIRE(ar.hasActions(channelID1) == true);
+		REQUIRE(ar.hasActions(channelID1, MidiEvent::CHANNEL_CC) == false);
+	}
+
+	SECTION("Test live record on missing channels")
+	{
+		constexpr ID missingChannelID = 99;
+
+		const MidiEvent on  = MidiEvent::makeFrom3Bytes(MidiEvent::CHANNEL_NOTE_ON, 0x00, 0x00, 0);
+		const MidiEvent off = MidiEvent::makeFrom3Bytes(MidiEvent::CHANNEL_NOTE_OFF, 0x00, 0x00, 0);
+
+		ar.init(8);
+
+		ar.liveRecPluginParam(0, /*pluginId=*/5, /*paramIndex=*/3, 0.5f, 10);
+		ar.liveRecPluginParam(missingChannelID, /*pluginId=*/5, /*paramIndex=*/3, 0.5f, 10);
+		ar.liveRec(missingChannelID, on, 20);
+		ar.liveRec(channelID1, on, 30);
+		ar.liveRec(missingChannelID, off, 40);
+		ar.liveRec(channelID1, off, 50);
+
+		REQUIRE(ar.getLiveStats().recorded == 5);
+		REQUIRE(ar.consolidate() == std::unordered_set<ID>{channelID1});
+
+		const std::vector<Action> actions = ar.getActionsOnChannel(channelID1);
+
+		REQUIRE(actions.size() == 2);
+		REQUIRE(actions[0].nextId == actions[1].id);
+		REQUIRE(actions[1].prevId == actions[0].id);
+	}
 }
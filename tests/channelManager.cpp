@@ -0,0 +1,91 @@
+#include "src/core/channels/channelManager.h"
+#include "src/core/mixer.h"
+#include "src/core/model/model.h"
+#include "src/core/sequencer.h"
+#include <catch2/catch.hpp>
+#include <memory>
+
+TEST_CASE("ChannelManager::recallScene")
+{
+	using namespace giada;
+	using namespace giada::m;
+
+	constexpr int BUFFER_SIZE = 1024;
+
+	model::Model model;
+	model.registerThread(Thread::MAIN, /*realtime=*/false);
+	model.reset();
+
+	ChannelManager channelManager(model);
+	channelManager.reset(BUFFER_SIZE);
+
+	/* MIDI channels behave like loops: key presses make them wait for the next
+	bar or loop start. */
+
+	const ID id1 = channelManager.addChannel(ChannelType::MIDI, /*columnId=*/1, /*position=*/0, BUFFER_SIZE).id;
+	const ID id2 = channelManager.addChannel(ChannelType::MIDI, /*columnId=*/1, /*position=*/1, BUFFER_SIZE).id;
+
+	channelManager.getChannel(id1).shared->playStatus.store(ChannelStatus::PLAY);
+
+	model::Scene scene{1, "scene", {}};
+	scene.channels.push_back({id1, /*playing=*/false, /*mute=*/true, /*volume=*/0.5f});
+	scene.channels.push_back({id2, /*playing=*/true, /*mute=*/false, /*volume=*/0.2f});
+	scene.channels.push_back({/*channelId=*/999, /*playing=*/true, /*mute=*/false, /*volume=*/0.2f}); // Gone
+
+	auto status = [&channelManager](ID id) {
+		return channelManager.getChannel(id).shared->playStatus.load();
+	};
+
+	SECTION("Test recall with sequencer stopped")
+	{
+		channelManager.recallScene(scene);
+
+		REQUIRE(channelManager.getChannel(id1).isMuted());
+		REQUIRE(channelManager.getChannel(id1).volume == 0.5f);
+		REQUIRE(channelManager.getChannel(id2).volume == 0.2f);
+		REQUIRE(status(id1) == ChannelStatus::ENDING);
+		REQUIRE(status(id2) == ChannelStatus::WAIT);
+		REQUIRE(model.get().scenes.getRecall().channels.empty());
+	}
+
+	SECTION("Test recall with sequencer running")
+	{
+		model.get().sequencer.status = SeqStatus::RUNNING;
+		model.swap(model::SwapType::NONE);
+
+		Mixer mixer(model);
+		auto  events = std::make_unique<Sequencer::EventBuffer>();
+
+		channelManager.recallScene(scene);
+
+		/* Volume and mute right away, play state staged for the next bar. */
+
+		REQUIRE(channelManager.getChannel(id1).isMuted());
+		REQUIRE(channelManager.getChannel(id1).volume == 0.5f);
+		REQUIRE(status(id1) == ChannelStatus::PLAY);
+		REQUIRE(status(id2) == ChannelStatus::OFF);
+		REQUIRE(model.get().scenes.getRecall().channels.size() == 2);
+
+		/* No bar in the block: nothing happens. */
+
+		mixer.advanceChannels(*events, model.get(), {0, BUFFER_SIZE}, /*quantizerStep=*/1);
+
+		REQUIRE(status(id1) == ChannelStatus::PLAY);
+		REQUIRE(status(id2) == ChannelStatus::OFF);
+
+		/* Loop start: all channels switch together. */
+
+		events->pushGlobal({Sequencer::EventType::FIRST_BEAT, 0, 0});
+		mixer.advanceChannels(*events, model.get(), {0, BUFFER_SIZE}, /*quantizerStep=*/1);
+
+		REQUIRE(status(id1) == ChannelStatus::OFF);
+		REQUIRE(status(id2) == ChannelStatus::PLAY);
+
+		/* A recall is applied only once. */
+
+		channelManager.getChannel(id2).shared->playStatus.store(ChannelStatus::OFF);
+		mixer.advanceChannels(*events, model.get(), {0, BUFFER_SIZE}, /*quantizerStep=*/1);
+
+		REQUIRE(status(id2) == ChannelStatus::OFF);
+	}
+}
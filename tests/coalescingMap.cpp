@@ -0,0 +1,76 @@
+#include "src/core/coalescingMap.h"
+#include <catch2/catch.hpp>
+#include <map>
+#include <thread>
+
+TEST_CASE("CoalescingMap")
+{
+	using namespace giada;
+
+	m::CoalescingMap<float, 4> map;
+
+	std::map<uint64_t, float> consumed;
+	const auto                consume = [&consumed](uint64_t k, float v) { consumed[k] = v; };
+
+	SECTION("Test latest value wins")
+	{
+		REQUIRE(map.set(1, 0.1f));
+		REQUIRE(map.set(1, 0.2f));
+		REQUIRE(map.set(2, 0.5f));
+		REQUIRE(map.set(1, 0.3f));
+
+		REQUIRE(map.consume(consume) == 2);
+		REQUIRE(consumed == std::map<uint64_t, float>{{1, 0.3f}, {2, 0.5f}});
+
+		SECTION("Test nothing left after consume")
+		{
+			REQUIRE(map.consume(consume) == 0);
+		}
+	}
+
+	SECTION("Test full map")
+	{
+		for (uint64_t k = 1; k <= 4; k++)
+			REQUIRE(map.set(k, 1.0f));
+
+		REQUIRE(map.set(5, 1.0f) == false);
+		REQUIRE(map.set(3, 2.0f) == true); // Existing keys still work
+
+		REQUIRE(map.consume(consume) == 4);
+		REQUIRE(consumed.at(3) == 2.0f);
+
+		SECTION("Test clear makes room for new keys")
+		{
+			map.set(1, 3.0f);
+			map.clear();
+
+			REQUIRE(map.consume(consume) == 0);
+			REQUIRE(map.set(5, 1.0f));
+			REQUIRE(map.consume(consume) == 1);
+			REQUIRE(consumed.at(5) == 1.0f);
+		}
+	}
+
+	SECTION("Test concurrent writers")
+	{
+		m::CoalescingMap<int, 64> intMap;
+
+		auto writer = [&intMap](uint64_t first) {
+			for (int i = 0; i <= 1000; i++)
+				for (uint64_t k = first; k < first + 8; k++)
+					intMap.set(k, i);
+		};
+
+		std::thread t1(writer, 1);
+		std::thread t2(writer, 9);
+		t1.join();
+		t2.join();
+
+		std::map<uint64_t, int> result;
+		intMap.consume([&result](uint64_t k, int v) { result[k] = v; });
+
+		REQUIRE(result.size() == 16);
+		for (const auto& [k, v] : result)
+			REQUIRE(v == 1000);
+	}
+}
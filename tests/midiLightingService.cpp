@@ -0,0 +1,101 @@
+#include "../src/core/midiLightingService.h"
+#include "../src/core/channels/midiLighter.h"
+#include "../src/core/scheduler.h"
+#include "mocks/kernelMidiMock.h"
+#include <catch2/catch.hpp>
+
+TEST_CASE("MidiLightingService")
+{
+	using namespace giada;
+
+	using Service = m::MidiLightingService<m::KernelMidiMock>;
+
+	m::KernelMidiMock                kernelMidi;
+	m::MidiMapper<m::KernelMidiMock> midiMapper(kernelMidi);
+	m::MidiLighter                   midiLighter(midiMapper);
+	Scheduler                        scheduler;
+	Service                          service(midiMapper, scheduler);
+
+	midiMapper.currentMap = {
+	    "test-brand",
+	    "test-device",
+	    {{0, "0x000000", 0, 0x000000}}, // init commands
+	    {0, "0x000001", 0, 0x000001},   // mute on
+	    {0, "0x000002", 0, 0x000002},   // mute off
+	    {0, "0x000003", 0, 0x000003},   // solo on
+	    {0, "0x000004", 0, 0x000004},   // solo off
+	    {0, "0x000005", 0, 0x000005},   // waiting
+	    {0, "0x000006", 0, 0x000006},   // playing
+	    {0, "0x000007", 0, 0x000007},   // stopping
+	    {0, "0x000008", 0, 0x000008},   // stopped
+	    {0, "0x000009", 0, 0x000009},   // playingInaudible
+	};
+
+	int sends          = 0;
+	midiLighter.onSend = [&sends]() { sends++; };
+
+	midiLighter.playing = {0x000010, 0};
+	midiLighter.mute    = {0x000011, 0};
+	midiLighter.solo    = {0x000012, 0};
+
+	Service::ChannelState state = {&midiLighter, ChannelStatus::OFF, /*audible=*/true,
+	    /*muted=*/false, /*soloed=*/false};
+
+	service.update({state});
+
+	SECTION("Test first update sends everything")
+	{
+		REQUIRE(kernelMidi.sent.size() == 3);
+		REQUIRE(kernelMidi.sent[0].getRaw() == 0x000008); // Stopped
+		REQUIRE(kernelMidi.sent[1].getRaw() == 0x000002); // Mute off
+		REQUIRE(kernelMidi.sent[2].getRaw() == 0x000004); // Solo off
+		REQUIRE(sends == 1);
+	}
+
+	SECTION("Test unchanged state is not sent again")
+	{
+		service.update({state});
+
+		REQUIRE(kernelMidi.sent.size() == 3);
+		REQUIRE(service.getStats().sent == 3);
+		REQUIRE(service.getStats().skipped == 3);
+		REQUIRE(sends == 1);
+	}
+
+	SECTION("Test only changes are sent")
+	{
+		state.status = ChannelStatus::PLAY;
+		state.muted  = true;
+		service.update({state});
+
+		REQUIRE(kernelMidi.sent.size() == 5);
+		REQUIRE(kernelMidi.sent[3].getRaw() == 0x000006); // Playing
+		REQUIRE(kernelMidi.sent[4].getRaw() == 0x000001); // Mute on
+
+		state.audible = false;
+		service.update({state});
+
+		REQUIRE(kernelMidi.sent.size() == 6);
+		REQUIRE(kernelMidi.sent[5].getRaw() == 0x000009); // Playing inaudible
+	}
+
+	SECTION("Test reset")
+	{
+		service.reset();
+		service.update({state});
+
+		REQUIRE(kernelMidi.sent.size() == 6);
+	}
+
+	SECTION("Test targets not learnt")
+	{
+		midiLighter.mute = {0x0, 0};
+		midiLighter.solo = {0x0, 0};
+
+		state.muted  = true;
+		state.soloed = true;
+		service.update({state});
+
+		REQUIRE(kernelMidi.sent.size() == 3);
+	}
+}
@@ -0,0 +1,141 @@
+#include "src/core/model/model.h"
+#include "src/core/types.h"
+#include <catch2/catch.hpp>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Model")
+{
+	using namespace giada;
+	using namespace giada::m;
+
+	struct Swap
+	{
+		model::SwapType type;
+		model::Change   change;
+	};
+
+	std::vector<Swap> swaps;
+
+	model::Model model;
+
+	model.registerThread(Thread::MAIN, /*realtime=*/false);
+	model.reset();
+	model.onSwap = [&swaps](model::SwapType t, model::Change c) { swaps.push_back({t, c}); };
+
+	SECTION("Test swap without transaction")
+	{
+		model.swap(model::SwapType::SOFT);
+		model.swap(model::SwapType::NONE);
+
+		REQUIRE(swaps.size() == 2);
+		REQUIRE(swaps[0].type == model::SwapType::SOFT);
+		REQUIRE(swaps[1].type == model::SwapType::NONE);
+	}
+
+	SECTION("Test transaction merges swaps into the heaviest one")
+	{
+		{
+			model::Transaction t = model.beginTransaction();
+			model.swap(model::SwapType::NONE);
+			model.swap(model::SwapType::SOFT);
+			model.swap(model::SwapType::NONE);
+
+			REQUIRE(swaps.empty());
+		}
+
+		REQUIRE(swaps.size() == 1);
+		REQUIRE(swaps[0].type == model::SwapType::SOFT);
+
+		swaps.clear();
+
+		{
+			model::Transaction t = model.beginTransaction();
+			model.swap(model::SwapType::SOFT);
+			model.swap(model::SwapType::HARD, {model::Change::ACTIONS, 1});
+			model.swap(model::SwapType::NONE);
+		}
+
+		REQUIRE(swaps.size() == 1);
+		REQUIRE(swaps[0].type == model::SwapType::HARD);
+		REQUIRE(swaps[0].change.scope == model::Change::ACTIONS);
+		REQUIRE(swaps[0].change.channelId == 1);
+	}
+
+	SECTION("Test transaction without swaps")
+	{
+		{
+			model::Transaction t = model.beginTransaction();
+		}
+
+		REQUIRE(swaps.empty());
+	}
+
+	SECTION("Test HARD changes widen their scope when merged")
+	{
+		{
+			model::Transaction t = model.beginTransaction();
+			model.swap(model::SwapType::HARD, {model::Change::ACTIONS, 1});
+			model.swap(model::SwapType::HARD, {model::Change::ACTIONS, 2});
+		}
+
+		REQUIRE(swaps.size() == 1);
+		REQUIRE(swaps[0].change.scope == model::Change::ACTIONS);
+		REQUIRE(swaps[0].change.channelId == 0);
+
+		swaps.clear();
+
+		{
+			model::Transaction t = model.beginTransaction();
+			model.swap(model::SwapType::HARD, {model::Change::ACTIONS, 1});
+			model.swap(model::SwapType::HARD, {model::Change::PLUGINS, 1});
+		}
+
+		REQUIRE(swaps.size() == 1);
+		REQUIRE(swaps[0].change.scope == model::Change::ALL);
+	}
+
+	SECTION("Test nested transactions swap once, at the end")
+	{
+		{
+			model::Transaction outer = model.beginTransaction();
+			{
+				model::Transaction inner = model.beginTransaction();
+				model.swap(model::SwapType::SOFT);
+			}
+			REQUIRE(swaps.empty());
+			model.swap(model::SwapType::NONE);
+		}
+
+		REQUIRE(swaps.size() == 1);
+		REQUIRE(swaps[0].type == model::SwapType::SOFT);
+	}
+
+	SECTION("Test DataLock inside a transaction")
+	{
+		{
+			model::Transaction t = model.beginTransaction();
+			{
+				model::DataLock lock = model.lockData(model::SwapType::HARD, model::Change::SEQUENCER);
+			}
+			model.swap(model::SwapType::SOFT);
+		}
+
+		REQUIRE(swaps.size() == 1);
+		REQUIRE(swaps[0].type == model::SwapType::HARD);
+		REQUIRE(swaps[0].change.scope == model::Change::SEQUENCER);
+	}
+
+	SECTION("Test swaps from other threads wait for the transaction")
+	{
+		{
+			model::Transaction t = model.beginTransaction();
+			std::thread([&model]() { model.swap(model::SwapType::SOFT); }).join();
+
+			REQUIRE(swaps.empty());
+		}
+
+		REQUIRE(swaps.size() == 1);
+		REQUIRE(swaps[0].type == model::SwapType::SOFT);
+	}
+}
@@ -0,0 +1,379 @@
+#include "src/core/patchFactory.h"
+#include "src/core/patch.h"
+#include "src/core/types.h"
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <filesystem>
+#include <string>
+
+namespace
+{
+using namespace giada;
+using namespace giada::m;
+
+Patch makePatch_(std::size_t numActions)
+{
+	/* Every field gets a value of its own, different from the default one, so
+	that a field lost or swapped on the way is caught. */
+
+	Patch patch;
+	patch.name       = "test patch";
+	patch.bars       = 4;
+	patch.beats      = 16;
+	patch.bpm        = 133.0f;
+	patch.quantize   = true;
+	patch.samplerate = 48000;
+	patch.metronome  = true;
+	patch.columns    = {{1, 380}, {2, 420}};
+
+	Patch::Channel sample{};
+	sample.id                = 4;
+	sample.type              = ChannelType::SAMPLE;
+	sample.height            = 20;
+	sample.name              = "kick";
+	sample.columnId          = 1;
+	sample.position          = 1;
+	sample.key               = 65;
+	sample.mute              = true;
+	sample.solo              = true;
+	sample.volume            = 0.5f;
+	sample.pan               = 0.3f;
+	sample.hasActions        = true;
+	sample.armed             = true;
+	sample.midiIn            = true;
+	sample.midiInKeyPress    = 0x90234500;
+	sample.midiInKeyRel      = 0x80234500;
+	sample.midiInKill        = 0x90244500;
+	sample.midiInArm         = 0x90254500;
+	sample.midiInVolume      = 0xB0070000;
+	sample.midiInMute        = 0x90264500;
+	sample.midiInSolo        = 0x90274500;
+	sample.midiInFilter      = 2;
+	sample.midiOutL          = true;
+	sample.midiOutLplaying   = 0x90300000;
+	sample.midiOutLmute      = 0x90310000;
+	sample.midiOutLsolo      = 0x90320000;
+	sample.waveId            = 1;
+	sample.mode              = SamplePlayerMode::SINGLE_RETRIG;
+	sample.begin             = 10;
+	sample.end               = 44100;
+	sample.shift             = 5;
+	sample.readActions       = true;
+	sample.pitch             = 1.5f;
+	sample.inputMonitor      = true;
+	sample.overdubProtection = true;
+	sample.midiInVeloAsVol   = true;
+	sample.midiInReadActions = 0x90284500;
+	sample.midiInPitch       = 0xE0000000;
+	sample.midiOut           = true;
+	sample.midiOutChan       = 9;
+	sample.pluginIds         = {1, 2};
+
+	/* Pan and Wave ID are reset to defaults for MIDI channels on load. */
+
+	Patch::Channel midi{};
+	midi.id                = 5;
+	midi.type              = ChannelType::MIDI;
+	midi.height            = 30;
+	midi.name              = "synth";
+	midi.columnId          = 2;
+	midi.position          = 0;
+	midi.key               = 66;
+	midi.volume            = 0.7f;
+	midi.pan               = G_DEFAULT_PAN;
+	midi.midiInKeyPress    = 0x91234500;
+	midi.midiInKeyRel      = 0x81234500;
+	midi.midiInKill        = 0x91244500;
+	midi.midiInArm         = 0x91254500;
+	midi.midiInVolume      = 0xB1070000;
+	midi.midiInMute        = 0x91264500;
+	midi.midiInSolo        = 0x91274500;
+	midi.midiInFilter      = -1;
+	midi.midiOutLplaying   = 0x91300000;
+	midi.midiOutLmute      = 0x91310000;
+	midi.midiOutLsolo      = 0x91320000;
+	midi.mode              = SamplePlayerMode::SINGLE_BASIC;
+	midi.begin             = 20;
+	midi.end               = 30;
+	midi.shift             = 40;
+	midi.pitch             = 0.5f;
+	midi.midiInReadActions = 0x91284500;
+	midi.midiInPitch       = 0xE1000000;
+	midi.midiOut           = true;
+	midi.midiOutChan       = 3;
+	midi.pluginIds         = {3};
+
+	patch.channels = {sample, midi};
+
+	for (std::size_t i = 0; i < numActions; i++)
+	{
+		Patch::Action a{};
+		a.id        = static_cast<ID>(i + 1);
+		a.channelId = i % 2 == 0 ? 4 : 5;
+		a.frame     = static_cast<Frame>(i * 10);
+		a.event     = 0x90400000;
+		a.prevId    = i > 0 ? a.id - 1 : 0;
+		a.nextId    = i + 1 < numActions ? a.id + 1 : 0;
+		patch.actions.push_back(a);
+	}
+
+	Patch::Action automation{};
+	automation.id          = static_cast<ID>(numActions + 1);
+	automation.channelId   = 5;
+	automation.frame       = 300;
+	automation.event       = 0xB0100000;
+	automation.prevId      = 0;
+	automation.nextId      = 0;
+	automation.pluginId    = 2;
+	automation.pluginParam = 7;
+	automation.value       = 0.25f;
+	patch.actions.push_back(automation);
+
+	patch.waves = {{1, "kick.wav"}, {2, "snare.wav"}};
+
+	/* A plug-in state is stored either in a sidecar file or inline, never
+	both: cover one of each. */
+
+	Patch::Plugin plugin1{};
+	plugin1.id           = 1;
+	plugin1.path         = "/usr/lib/vst3/plugin.vst3";
+	plugin1.bypass       = true;
+	plugin1.statePath    = "0123456789abcdef-10.gstate";
+	plugin1.midiInParams = {0x1, 0x2};
+
+	Patch::Plugin plugin2{};
+	plugin2.id           = 2;
+	plugin2.path         = "/usr/lib/vst3/other.vst3";
+	plugin2.bypass       = false;
+	plugin2.state        = "c3RhdGU=";
+	plugin2.midiInParams = {0x3};
+
+	patch.plugins = {plugin1, plugin2};
+
+	patch.scenes = {{1, "intro", {{4, true, false, 0.8f}, {5, false, true, 1.0f}}}, {2, "empty", {}}};
+
+	return patch;
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* makeExpected_
+Returns what 'patch' looks like once stored in folder 'dir' and loaded back:
+relative paths are resolved against the patch folder. */
+
+Patch makeExpected_(const Patch& patch, const std::filesystem::path& dir)
+{
+	Patch expected  = patch;
+	expected.status = G_FILE_OK;
+
+	for (Patch::Wave& w : expected.waves)
+		w.path = (dir / w.path).string();
+	for (Patch::Plugin& p : expected.plugins)
+		if (!p.statePath.empty())
+			p.statePath = (dir / p.statePath).string();
+
+	return expected;
+}
+
+/* -------------------------------------------------------------------------- */
+
+void requireEqual_(const Patch::Channel& a, const Patch::Channel& b)
+{
+	REQUIRE(a.id == b.id);
+	REQUIRE(a.type == b.type);
+	REQUIRE(a.height == b.height);
+	REQUIRE(a.name == b.name);
+	REQUIRE(a.columnId == b.columnId);
+	REQUIRE(a.position == b.position);
+	REQUIRE(a.key == b.key);
+	REQUIRE(a.mute == b.mute);
+	REQUIRE(a.solo == b.solo);
+	REQUIRE(a.volume == b.volume);
+	REQUIRE(a.pan == b.pan);
+	REQUIRE(a.hasActions == b.hasActions);
+	REQUIRE(a.armed == b.armed);
+	REQUIRE(a.midiIn == b.midiIn);
+	REQUIRE(a.midiInKeyPress == b.midiInKeyPress);
+	REQUIRE(a.midiInKeyRel == b.midiInKeyRel);
+	REQUIRE(a.midiInKill == b.midiInKill);
+	REQUIRE(a.midiInArm == b.midiInArm);
+	REQUIRE(a.midiInVolume == b.midiInVolume);
+	REQUIRE(a.midiInMute == b.midiInMute);
+	REQUIRE(a.midiInSolo == b.midiInSolo);
+	REQUIRE(a.midiInFilter == b.midiInFilter);
+	REQUIRE(a.midiOutL == b.midiOutL);
+	REQUIRE(a.midiOutLplaying == b.midiOutLplaying);
+	REQUIRE(a.midiOutLmute == b.midiOutLmute);
+	REQUIRE(a.midiOutLsolo == b.midiOutLsolo);
+	REQUIRE(a.waveId == b.waveId);
+	REQUIRE(a.mode == b.mode);
+	REQUIRE(a.begin == b.begin);
+	REQUIRE(a.end == b.end);
+	REQUIRE(a.shift == b.shift);
+	REQUIRE(a.readActions == b.readActions);
+	REQUIRE(a.pitch == b.pitch);
+	REQUIRE(a.inputMonitor == b.inputMonitor);
+	REQUIRE(a.overdubProtection == b.overdubProtection);
+	REQUIRE(a.midiInVeloAsVol == b.midiInVeloAsVol);
+	REQUIRE(a.midiInReadActions == b.midiInReadActions);
+	REQUIRE(a.midiInPitch == b.midiInPitch);
+	REQUIRE(a.midiOut == b.midiOut);
+	REQUIRE(a.midiOutChan == b.midiOutChan);
+	REQUIRE(a.pluginIds == b.pluginIds);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void requireEqual_(const Patch::Action& a, const Patch::Action& b)
+{
+	REQUIRE(a.id == b.id);
+	REQUIRE(a.channelId == b.channelId);
+	REQUIRE(a.frame == b.frame);
+	REQUIRE(a.event == b.event);
+	REQUIRE(a.prevId == b.prevId);
+	REQUIRE(a.nextId == b.nextId);
+	REQUIRE(a.pluginId == b.pluginId);
+	REQUIRE(a.pluginParam == b.pluginParam);
+	REQUIRE(a.value == b.value);
+}
+
+/* -------------------------------------------------------------------------- */
+
+void requireEqual_(const Patch& a, const Patch& b)
+{
+	REQUIRE(a.status == b.status);
+	REQUIRE(a.version == b.version);
+	REQUIRE(a.name == b.name);
+	REQUIRE(a.bars == b.bars);
+	REQUIRE(a.beats == b.beats);
+	REQUIRE(a.bpm == b.bpm);
+	REQUIRE(a.quantize == b.quantize);
+	REQUIRE(a.samplerate == b.samplerate);
+	REQUIRE(a.metronome == b.metronome);
+
+	REQUIRE(a.columns.size() == b.columns.size());
+	for (std::size_t i = 0; i < a.columns.size(); i++)
+	{
+		REQUIRE(a.columns[i].id == b.columns[i].id);
+		REQUIRE(a.columns[i].width == b.columns[i].width);
+	}
+
+	REQUIRE(a.channels.size() == b.channels.size());
+	for (std::size_t i = 0; i < a.channels.size(); i++)
+		requireEqual_(a.channels[i], b.channels[i]);
+
+	REQUIRE(a.actions.size() == b.actions.size());
+	for (std::size_t i = 0; i < a.actions.size(); i++)
+		requireEqual_(a.actions[i], b.actions[i]);
+
+	REQUIRE(a.waves.size() == b.waves.size());
+	for (std::size_t i = 0; i < a.waves.size(); i++)
+	{
+		REQUIRE(a.waves[i].id == b.waves[i].id);
+		REQUIRE(a.waves[i].path == b.waves[i].path);
+	}
+
+	REQUIRE(a.plugins.size() == b.plugins.size());
+	for (std::size_t i = 0; i < a.plugins.size(); i++)
+	{
+		REQUIRE(a.plugins[i].id == b.plugins[i].id);
+		REQUIRE(a.plugins[i].path == b.plugins[i].path);
+		REQUIRE(a.plugins[i].bypass == b.plugins[i].bypass);
+		REQUIRE(a.plugins[i].params == b.plugins[i].params);
+		REQUIRE(a.plugins[i].state == b.plugins[i].state);
+		REQUIRE(a.plugins[i].statePath == b.plugins[i].statePath);
+		REQUIRE(a.plugins[i].midiInParams == b.plugins[i].midiInParams);
+	}
+
+	REQUIRE(a.scenes.size() == b.scenes.size());
+	for (std::size_t i = 0; i < a.scenes.size(); i++)
+	{
+		REQUIRE(a.scenes[i].id == b.scenes[i].id);
+		REQUIRE(a.scenes[i].name == b.scenes[i].name);
+		REQUIRE(a.scenes[i].channels.size() == b.scenes[i].channels.size());
+		for (std::size_t k = 0; k < a.scenes[i].channels.size(); k++)
+		{
+			REQUIRE(a.scenes[i].channels[k].channelId == b.scenes[i].channels[k].channelId);
+			REQUIRE(a.scenes[i].channels[k].playing == b.scenes[i].channels[k].playing);
+			REQUIRE(a.scenes[i].channels[k].mute == b.scenes[i].channels[k].mute);
+			REQUIRE(a.scenes[i].channels[k].volume == b.scenes[i].channels[k].volume);
+		}
+	}
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+
+TEST_CASE("patchFactory")
+{
+	const std::filesystem::path dir      = std::filesystem::temp_directory_path();
+	const std::string           jsonPath = (dir / "giada-test.gptc").string();
+	const std::string           binPath  = (dir / "giada-test.gptb").string();
+
+	const Patch patch = makePatch_(/*numActions=*/100);
+
+	REQUIRE(patchFactory::serialize(patch, jsonPath));
+	REQUIRE(patchFactory::serializeBinary(patch, binPath));
+
+	SECTION("JSON round trip")
+	{
+		requireEqual_(patchFactory::deserialize(jsonPath), makeExpected_(patch, dir));
+	}
+
+	SECTION("Binary round trip")
+	{
+		requireEqual_(patchFactory::deserialize(binPath), makeExpected_(patch, dir));
+	}
+
+	SECTION("Truncated binary patch")
+	{
+		const auto size = std::filesystem::file_size(binPath);
+		std::filesystem::resize_file(binPath, size / 2);
+
+		REQUIRE(patchFactory::deserialize(binPath).status == G_FILE_INVALID);
+	}
+
+	SECTION("Not a binary patch")
+	{
+		std::filesystem::copy_file(jsonPath, binPath, std::filesystem::copy_options::overwrite_existing);
+
+		REQUIRE(patchFactory::deserialize(binPath).status == G_FILE_INVALID);
+	}
+
+	std::filesystem::remove(jsonPath);
+	std::filesystem::remove(binPath);
+}
+
+/* -------------------------------------------------------------------------- */
+
+/* Load time benchmark, hidden. Run it with `--run-tests [benchmark]`. */
+
+TEST_CASE("patchFactory load time", "[.][benchmark]")
+{
+	using Clock = std::chrono::steady_clock;
+
+	const std::filesystem::path dir      = std::filesystem::temp_directory_path();
+	const std::string           jsonPath = (dir / "giada-bench.gptc").string();
+	const std::string           binPath  = (dir / "giada-bench.gptb").string();
+
+	const Patch patch = makePatch_(/*numActions=*/100000);
+
+	REQUIRE(patchFactory::serialize(patch, jsonPath));
+	REQUIRE(patchFactory::serializeBinary(patch, binPath));
+
+	const auto t0         = Clock::now();
+	const auto fromJson   = patchFactory::deserialize(jsonPath);
+	const auto t1         = Clock::now();
+	const auto fromBinary = patchFactory::deserialize(binPath);
+	const auto t2         = Clock::now();
+
+	using Ms = std::chrono::duration<double, std::milli>;
+
+	REQUIRE(fromJson.actions.size() == fromBinary.actions.size());
+
+	WARN("JSON load:   " << Ms(t1 - t0).count() << " ms");
+	WARN("Binary load: " << Ms(t2 - t1).count() << " ms");
+
+	std::filesystem::remove(jsonPath);
+	std::filesystem::remove(binPath);
+}
@@ -0,0 +1,102 @@
+#include "src/core/plugins/pluginFactory.h"
+#include "src/core/const.h"
+#include "src/core/patch.h"
+#include "src/core/plugins/pluginState.h"
+#include <catch2/catch.hpp>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+using namespace giada;
+using namespace giada::m;
+
+PluginState makeState_(const std::string& bytes)
+{
+	return PluginState(juce::MemoryBlock(bytes.data(), bytes.size()));
+}
+
+/* -------------------------------------------------------------------------- */
+
+bool sameContent_(const PluginState& a, const PluginState& b)
+{
+	return a.getSize() == b.getSize() && std::memcmp(a.getData(), b.getData(), a.getSize()) == 0;
+}
+} // namespace
+
+/* -------------------------------------------------------------------------- */
+
+TEST_CASE("pluginFactory")
+{
+	/* Work in a folder of its own: removeUnusedStates() deletes any state file
+	it finds. */
+
+	const std::filesystem::path dir = std::filesystem::temp_directory_path() / "giada-test-states";
+
+	std::filesystem::remove_all(dir);
+	std::filesystem::create_directories(dir);
+
+	const PluginState state1 = makeState_(std::string("state\0one", 9));
+	const PluginState state2 = makeState_(std::string("state\0two", 9));
+
+	const pluginFactory::SaveRequest req1{state1, state1.getHash() + G_STATE_EXT};
+	const pluginFactory::SaveRequest req2{state2, state2.getHash() + G_STATE_EXT};
+
+	SECTION("State hash")
+	{
+		/* 64-bit FNV-1a of "abc", followed by the size. */
+
+		REQUIRE(makeState_("abc").getHash() == "e71fa2190541574b-3");
+		REQUIRE(makeState_("abc").getHash() == makeState_("abc").getHash());
+		REQUIRE(makeState_("abc").getHash() != makeState_("abd").getHash());
+		REQUIRE(makeState_("abc").getHash() != makeState_("abcd").getHash());
+		REQUIRE(state1.getHash() != state2.getHash());
+	}
+
+	SECTION("Sidecar round trip")
+	{
+		REQUIRE(pluginFactory::saveState(dir.string(), req1));
+
+		const PluginState loaded{juce::File((dir / req1.fileName).string())};
+
+		REQUIRE(sameContent_(loaded, state1));
+		REQUIRE(loaded.getHash() == state1.getHash());
+		REQUIRE(loaded.asBase64() == state1.asBase64());
+	}
+
+	SECTION("Sidecar with the same name but different content is overwritten")
+	{
+		std::ofstream((dir / req1.fileName).string(), std::ios::binary) << std::string(state1.getSize(), 'x');
+
+		REQUIRE(pluginFactory::saveState(dir.string(), req1));
+		REQUIRE(sameContent_(PluginState(juce::File((dir / req1.fileName).string())), state1));
+	}
+
+	SECTION("Missing sidecar")
+	{
+		const PluginState loaded{juce::File((dir / "missing.gstate").string())};
+
+		REQUIRE(loaded.getSize() == 0);
+	}
+
+	SECTION("Unused states are removed")
+	{
+		REQUIRE(pluginFactory::saveState(dir.string(), req1));
+		REQUIRE(pluginFactory::saveState(dir.string(), req2));
+		std::ofstream((dir / "other.txt").string()) << "not a state";
+
+		Patch::Plugin plugin;
+		plugin.statePath = req1.fileName;
+
+		pluginFactory::removeUnusedStates(dir.string(), {plugin});
+
+		REQUIRE(std::filesystem::exists(dir / req1.fileName));
+		REQUIRE(!std::filesystem::exists(dir / req2.fileName));
+		REQUIRE(std::filesystem::exists(dir / "other.txt"));
+	}
+
+	std::filesystem::remove_all(dir);
+}
@@ -0,0 +1,83 @@
+#include "src/core/channels/renderLane.h"
+#include <catch2/catch.hpp>
+
+TEST_CASE("RenderLane")
+{
+	using namespace giada;
+	using namespace giada::m;
+
+	constexpr int BUFFER_SIZE = 64;
+
+	RenderLane lane(BUFFER_SIZE);
+
+	REQUIRE(lane.getOwner() == RenderLane::Owner::AUDIO);
+	REQUIRE(lane.isEmpty());
+	REQUIRE(lane.front() == nullptr);
+
+	SECTION("Test blocks are allocated with the buffer size")
+	{
+		REQUIRE(lane.back().audio.countFrames() == BUFFER_SIZE);
+
+		lane.setBufferSize(BUFFER_SIZE * 2);
+
+		REQUIRE(lane.back().audio.countFrames() == BUFFER_SIZE * 2);
+	}
+
+	SECTION("Test FIFO order")
+	{
+		for (int i = 0; i < G_RENDER_AHEAD_BLOCKS; i++)
+		{
+			REQUIRE_FALSE(lane.isFull());
+			lane.back().frame = i * BUFFER_SIZE;
+			lane.push();
+		}
+
+		REQUIRE(lane.isFull());
+
+		for (int i = 0; i < G_RENDER_AHEAD_BLOCKS; i++)
+		{
+			REQUIRE(lane.front() != nullptr);
+			REQUIRE(lane.front()->frame == i * BUFFER_SIZE);
+			lane.pop();
+		}
+
+		REQUIRE(lane.isEmpty());
+	}
+
+	SECTION("Test flush")
+	{
+		lane.push();
+		lane.push();
+		lane.flush();
+
+		REQUIRE(lane.isEmpty());
+		REQUIRE(lane.front() == nullptr);
+	}
+
+	SECTION("Test ownership")
+	{
+		REQUIRE_FALSE(lane.tryAcquire());
+
+		lane.push();
+		lane.handOver({BUFFER_SIZE, {/*tracker=*/10, ChannelStatus::PLAY}});
+
+		REQUIRE(lane.isEmpty()); // Handing over flushes the lane
+		REQUIRE(lane.getOwner() == RenderLane::Owner::AHEAD);
+		REQUIRE(lane.cursor.frame == BUFFER_SIZE);
+		REQUIRE(lane.cursor.state.tracker == 10);
+		REQUIRE(lane.cursor.state.playStatus == ChannelStatus::PLAY);
+
+		REQUIRE(lane.tryAcquire());
+		REQUIRE(lane.getOwner() == RenderLane::Owner::BUSY);
+		REQUIRE_FALSE(lane.tryAcquire());
+
+		lane.release();
+
+		REQUIRE(lane.getOwner() == RenderLane::Owner::AHEAD);
+		REQUIRE(lane.wait());
+		REQUIRE(lane.reclaim());
+		REQUIRE(lane.getOwner() == RenderLane::Owner::AUDIO);
+		REQUIRE_FALSE(lane.tryAcquire());
+		REQUIRE(lane.reclaim()); // Already owned by the audio thread
+	}
+}
@@ -20,7 +20,7 @@ TEST_CASE("SamplePlayer")
 	m::Resampler     resampler(m::Resampler::Quality::LINEAR, NUM_CHANNELS);
 
 	m::SamplePlayer samplePlayer(&resampler);
-	samplePlayer.onLastFrame = [](bool, bool) {};
+	samplePlayer.onLastFrame = [](m::ChannelShared&, bool, bool) {};
 
 	SECTION("Test initialization")
 	{
@@ -65,7 +65,8 @@ TEST_CASE("SamplePlayer")
 				// Point in audio buffer where the rewind takes place
 				const int OFFSET = 256;
 
-				samplePlayer.render(channelShared, {m::SamplePlayer::Render::Mode::REWIND, OFFSET}, /*seqIsRunning=*/false);
+				const m::SamplePlayer::Render commands[] = {{m::SamplePlayer::Render::Mode::REWIND, OFFSET}};
+				samplePlayer.render(channelShared, commands, /*seqIsRunning=*/false);
 
 				// Rendering should start over again at buffer[OFFSET]
 				REQUIRE(channelShared.audioBuffer[OFFSET][0] == 1.0f);
@@ -76,7 +77,8 @@ TEST_CASE("SamplePlayer")
 				// Point in audio buffer where the stop takes place
 				const int OFFSET = 256;
 
-				samplePlayer.render(channelShared, {m::SamplePlayer::Render::Mode::STOP, OFFSET}, /*seqIsRunning=*/false);
+				const m::SamplePlayer::Render commands[] = {{m::SamplePlayer::Render::Mode::STOP, OFFSET}};
+				samplePlayer.render(channelShared, commands, /*seqIsRunning=*/false);
 
 				int numFramesWritten = 0;
 				channelShared.audioBuffer.forEachFrame([&numFramesWritten](float* f, int) {
@@ -86,6 +88,43 @@ TEST_CASE("SamplePlayer")
 
 				REQUIRE(numFramesWritten == OFFSET);
 			}
+
+			SECTION("Multiple commands, pitch == " + std::to_string(pitch))
+			{
+				// Two rewinds and a stop in the same block
+				const int REWIND_1 = 128;
+				const int REWIND_2 = 384;
+				const int STOP     = 512;
+
+				const m::SamplePlayer::Render commands[] = {
+				    {m::SamplePlayer::Render::Mode::REWIND, REWIND_1},
+				    {m::SamplePlayer::Render::Mode::REWIND, REWIND_2},
+				    {m::SamplePlayer::Render::Mode::STOP, STOP}};
+				samplePlayer.render(channelShared, commands, /*seqIsRunning=*/false);
+
+				// Each rewind starts over again at its own offset
+				REQUIRE(channelShared.audioBuffer[REWIND_1][0] == 1.0f);
+				REQUIRE(channelShared.audioBuffer[REWIND_2][0] == 1.0f);
+
+				int numFramesWritten = 0;
+				channelShared.audioBuffer.forEachFrame([&numFramesWritten](float* f, int) {
+					if (f[0] != 0.0)
+						numFramesWritten++;
+				});
+
+				REQUIRE(numFramesWritten == STOP);
+			}
+
+			SECTION("Start mid-block, pitch == " + std::to_string(pitch))
+			{
+				const int OFFSET = 256;
+
+				const m::SamplePlayer::Render commands[] = {{m::SamplePlayer::Render::Mode::NORMAL, OFFSET}};
+				samplePlayer.render(channelShared, commands, /*seqIsRunning=*/false);
+
+				REQUIRE(channelShared.audioBuffer[OFFSET - 1][0] == 0.0f);
+				REQUIRE(channelShared.audioBuffer[OFFSET][0] == 1.0f);
+			}
 		}
 	}
 }
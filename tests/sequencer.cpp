@@ -0,0 +1,160 @@
+#include "src/core/model/actions.h"
+#include "src/core/model/sequencer.h"
+#include "src/core/sequencer.h"
+#include <catch2/catch.hpp>
+#include <memory>
+#include <vector>
+
+TEST_CASE("Sequencer::EventBuffer")
+{
+	using namespace giada;
+	using namespace giada::m;
+
+	using EventType = Sequencer::EventType;
+
+	auto buffer = std::make_unique<Sequencer::EventBuffer>();
+
+	const auto makeAction = [](ID id, ID channelId, Frame frame) {
+		Action a;
+		a.id        = id;
+		a.channelId = channelId;
+		a.frame     = frame;
+		return a;
+	};
+
+	const auto collect = [&buffer](ID channelId) {
+		std::vector<Sequencer::Event> out;
+		buffer->forEach(channelId, [&out](const Sequencer::Event& e) { out.push_back(e); });
+		return out;
+	};
+
+	SECTION("Test global events and actions interleaved in block order")
+	{
+		const std::vector<Action> as1 = {makeAction(1, 2, 10), makeAction(2, 1, 10)};
+		const std::vector<Action> as2 = {makeAction(3, 1, 30), makeAction(4, 2, 30)};
+
+		buffer->pushGlobal({EventType::FIRST_BEAT, 0, 0});
+		buffer->pushActions(as1, 10, 10);
+		buffer->pushGlobal({EventType::BAR, 20, 20});
+		buffer->pushActions(as2, 30, 30);
+		buffer->sort();
+
+		REQUIRE(buffer->countGlobals() == 2);
+		REQUIRE(buffer->countActions() == 4);
+
+		const std::vector<Sequencer::Event> events = collect(1);
+
+		REQUIRE(events.size() == 4);
+		REQUIRE(events[0].type == EventType::FIRST_BEAT);
+		REQUIRE(events[1].type == EventType::ACTIONS);
+		REQUIRE(events[1].action->id == 2);
+		REQUIRE(events[2].type == EventType::BAR);
+		REQUIRE(events[3].type == EventType::ACTIONS);
+		REQUIRE(events[3].action->id == 3);
+
+		SECTION("Test channel with no actions gets global events only")
+		{
+			const std::vector<Sequencer::Event> events = collect(3);
+
+			REQUIRE(events.size() == 2);
+			REQUIRE(events[0].type == EventType::FIRST_BEAT);
+			REQUIRE(events[1].type == EventType::BAR);
+		}
+	}
+
+	SECTION("Test global events after the last action")
+	{
+		const std::vector<Action> as = {makeAction(1, 1, 5)};
+
+		buffer->pushActions(as, 5, 5);
+		buffer->pushGlobal({EventType::REWIND, 0, 8});
+		buffer->sort();
+
+		const std::vector<Sequencer::Event> events = collect(1);
+
+		REQUIRE(events.size() == 2);
+		REQUIRE(events[0].type == EventType::ACTIONS);
+		REQUIRE(events[1].type == EventType::REWIND);
+		REQUIRE(buffer->has(EventType::REWIND));
+		REQUIRE_FALSE(buffer->has(EventType::BAR));
+	}
+
+	SECTION("Test dropped actions")
+	{
+		std::vector<Action> as;
+		for (int i = 0; i < G_MAX_SEQUENCER_ACTIONS + 3; i++)
+			as.push_back(makeAction(i + 1, 1, 0));
+
+		buffer->pushActions(as, 0, 0);
+		buffer->sort();
+
+		REQUIRE(buffer->countActions() == G_MAX_SEQUENCER_ACTIONS);
+		REQUIRE(buffer->countDropped() == 3);
+		REQUIRE(collect(1).front().action->id == 1);
+	}
+}
+
+/* -------------------------------------------------------------------------- */
+
+TEST_CASE("Sequencer::collectEvents")
+{
+	using namespace giada;
+	using namespace giada::m;
+
+	using EventType = Sequencer::EventType;
+
+	auto buffer = std::make_unique<Sequencer::EventBuffer>();
+
+	const auto makeAction = [](ID id, Frame frame) {
+		Action a;
+		a.id        = id;
+		a.channelId = 1;
+		a.frame     = frame;
+		return a;
+	};
+
+	model::Sequencer sequencer;
+	sequencer.framesInLoop = 100;
+	sequencer.framesInBar  = 25;
+	sequencer.framesInBeat = 5;
+
+	model::Actions actions;
+	actions.getAll()[5]  = {makeAction(1, 5)};
+	actions.getAll()[10] = {makeAction(2, 10)};
+	actions.getAll()[95] = {makeAction(3, 95)};
+
+	const auto collect = [&buffer]() {
+		std::vector<Sequencer::Event> out;
+		buffer->forEach(1, [&out](const Sequencer::Event& e) { out.push_back(e); });
+		return out;
+	};
+
+	SECTION("Test block across the end of the loop")
+	{
+		Sequencer::collectEvents(*buffer, sequencer, actions, /*start=*/90, /*bufferSize=*/20);
+
+		const std::vector<Sequencer::Event> events = collect();
+
+		REQUIRE(events.size() == 3);
+		REQUIRE(events[0].type == EventType::ACTIONS);
+		REQUIRE(events[0].action->id == 3);
+		REQUIRE(events[0].delta == 5);
+		REQUIRE(events[1].type == EventType::FIRST_BEAT);
+		REQUIRE(events[1].delta == 10);
+		REQUIRE(events[2].type == EventType::ACTIONS);
+		REQUIRE(events[2].action->id == 1);
+		REQUIRE(events[2].delta == 15);
+	}
+
+	SECTION("Test block with a bar")
+	{
+		Sequencer::collectEvents(*buffer, sequencer, actions, /*start=*/20, /*bufferSize=*/10);
+
+		const std::vector<Sequencer::Event> events = collect();
+
+		REQUIRE(events.size() == 1);
+		REQUIRE(events[0].type == EventType::BAR);
+		REQUIRE(events[0].global == 25);
+		REQUIRE(events[0].delta == 5);
+	}
+}
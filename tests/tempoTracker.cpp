@@ -0,0 +1,59 @@
+#include "../src/core/tempoTracker.h"
+#include <catch2/catch.hpp>
+#include <random>
+
+TEST_CASE("TempoTracker")
+{
+	using namespace giada::m;
+
+	constexpr double BPM    = 120.0;
+	constexpr double PERIOD = 60.0 / (BPM * 24.0);
+
+	TempoTracker tracker;
+
+	SECTION("Test steady clock")
+	{
+		for (int i = 0; i < 24 * 8; i++)
+			tracker.process(i * PERIOD);
+
+		REQUIRE(tracker.isLocked());
+		REQUIRE(tracker.isStable());
+		REQUIRE(tracker.getBpm() == Approx(BPM).margin(0.01));
+	}
+
+	SECTION("Test jittery clock")
+	{
+		std::mt19937                           gen(42);
+		std::uniform_real_distribution<double> jitter(-0.002, 0.002); // +/- 2 ms
+
+		for (int i = 0; i < 24 * 32; i++)
+			tracker.process(i * PERIOD + jitter(gen));
+
+		REQUIRE(tracker.isLocked());
+		REQUIRE(tracker.getBpm() == Approx(BPM).margin(0.25));
+	}
+
+	SECTION("Test tempo change")
+	{
+		constexpr double NEW_BPM    = 90.0;
+		constexpr double NEW_PERIOD = 60.0 / (NEW_BPM * 24.0);
+
+		double t = 0.0;
+		for (int i = 0; i < 24 * 8; i++, t += PERIOD)
+			tracker.process(t);
+		for (int i = 0; i < 24 * 32; i++, t += NEW_PERIOD)
+			tracker.process(t);
+
+		REQUIRE(tracker.isStable());
+		REQUIRE(tracker.getBpm() == Approx(NEW_BPM).margin(0.05));
+	}
+
+	SECTION("Test reset on gap")
+	{
+		for (int i = 0; i < 24 * 8; i++)
+			tracker.process(i * PERIOD);
+		tracker.process(100.0);
+
+		REQUIRE(!tracker.isLocked());
+	}
+}
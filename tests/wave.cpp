@@ -1,6 +1,8 @@
+#include "../src/core/const.h"
 #include "../src/core/wave.h"
 #include <catch2/catch.hpp>
 #include <memory>
+#include <utility>
 
 TEST_CASE("Wave")
 {
@@ -44,4 +46,203 @@ TEST_CASE("Wave")
 			REQUIRE(wave.getBasename(true) == "sample.wav");
 		}
 	}
+
+	SECTION("test segment editing")
+	{
+		constexpr int FRAMES = 100;
+
+		/* Frame i is filled with value i on every channel. */
+
+		m::Wave wave(1);
+		wave.alloc(FRAMES, CHANNELS, SAMPLE_RATE, BIT_DEPTH, "path/to/sample.wav");
+		wave.getBuffer().forEachFrame([](float* f, int i) {
+			f[0] = static_cast<float>(i);
+			f[1] = static_cast<float>(i);
+		});
+
+		auto frameAt = [&wave](Frame f) { return wave.getChunk(f).data[0]; };
+
+		REQUIRE(wave.isConsolidated());
+		REQUIRE_FALSE(wave.canUndo());
+
+		SECTION("test cut")
+		{
+			wave.cut(10, 20);
+
+			REQUIRE_FALSE(wave.isConsolidated());
+			REQUIRE(wave.countFrames() == FRAMES - 10);
+			REQUIRE(wave.countChannels() == CHANNELS);
+			REQUIRE(frameAt(9) == 9.0f);
+			REQUIRE(frameAt(10) == 20.0f);
+			REQUIRE(frameAt(FRAMES - 11) == FRAMES - 1);
+			REQUIRE(wave.getChunk(0).length == 10);
+		}
+
+		SECTION("test trim")
+		{
+			wave.trim(30, 40);
+
+			REQUIRE(wave.countFrames() == 10);
+			REQUIRE(frameAt(0) == 30.0f);
+			REQUIRE(frameAt(9) == 39.0f);
+		}
+
+		SECTION("test paste")
+		{
+			auto src = std::make_shared<const mcl::AudioBuffer>(wave.render(0, 5));
+			wave.paste(src, 50);
+
+			REQUIRE(wave.countFrames() == FRAMES + 5);
+			REQUIRE(frameAt(49) == 49.0f);
+			REQUIRE(frameAt(50) == 0.0f);
+			REQUIRE(frameAt(54) == 4.0f);
+			REQUIRE(frameAt(55) == 50.0f);
+		}
+
+		SECTION("test render across segments")
+		{
+			wave.cut(10, 90);
+
+			mcl::AudioBuffer out = wave.render(5, 15);
+
+			REQUIRE(out.countFrames() == 10);
+			REQUIRE(out[4][1] == 9.0f);
+			REQUIRE(out[5][1] == 90.0f);
+			REQUIRE(out[9][1] == 94.0f);
+		}
+
+		SECTION("test undo/redo")
+		{
+			wave.cut(0, 50);
+			wave.trim(0, 10);
+
+			REQUIRE(wave.countFrames() == 10);
+
+			wave.undo();
+			REQUIRE(wave.countFrames() == 50);
+			REQUIRE(frameAt(0) == 50.0f);
+
+			wave.undo();
+			REQUIRE(wave.countFrames() == FRAMES);
+			REQUIRE(frameAt(0) == 0.0f);
+			REQUIRE_FALSE(wave.canUndo());
+			REQUIRE(wave.canRedo());
+
+			wave.redo();
+			REQUIRE(wave.countFrames() == 50);
+
+			/* A new edit clears the redo history. */
+
+			wave.cut(0, 1);
+			REQUIRE_FALSE(wave.canRedo());
+		}
+
+		SECTION("test undo of buffer edit")
+		{
+			mcl::AudioBuffer silence(FRAMES, CHANNELS);
+			wave.edit(std::move(silence));
+
+			REQUIRE(wave.isConsolidated());
+			REQUIRE(frameAt(50) == 0.0f);
+
+			wave.undo();
+			REQUIRE(frameAt(50) == 50.0f);
+
+			wave.redo();
+			REQUIRE(frameAt(50) == 0.0f);
+		}
+
+		SECTION("test bounded history")
+		{
+			for (int i = 0; i < G_MAX_WAVE_HISTORY + 10; i++)
+				wave.cut(0, 1);
+
+			int steps = 0;
+			while (wave.canUndo())
+			{
+				wave.undo();
+				steps++;
+			}
+
+			REQUIRE(steps == G_MAX_WAVE_HISTORY);
+		}
+
+		SECTION("test consolidate")
+		{
+			wave.cut(10, 20);
+			wave.consolidate();
+
+			REQUIRE(wave.isConsolidated());
+			REQUIRE_FALSE(wave.canUndo());
+			REQUIRE(wave.getBuffer().countFrames() == FRAMES - 10);
+			REQUIRE(wave.getBuffer()[10][0] == 20.0f);
+		}
+	}
+
+	SECTION("test shared data")
+	{
+		m::Wave wave(1);
+		wave.alloc(BUFFER_SIZE, CHANNELS, SAMPLE_RATE, BIT_DEPTH, "path/to/sample.wav");
+
+		m::Wave other(2);
+		other.setSharedBuffer(wave.getSharedBuffer());
+
+		REQUIRE(std::as_const(other).getBuffer()[0] == std::as_const(wave).getBuffer()[0]);
+
+		SECTION("test copy-on-write")
+		{
+			other.getBuffer()[0][0] = 1.0f;
+
+			REQUIRE(other.getSharedBuffer() != wave.getSharedBuffer());
+			REQUIRE(std::as_const(wave).getBuffer()[0][0] == 0.0f);
+			REQUIRE(std::as_const(other).getBuffer()[0][0] == 1.0f);
+		}
+
+		SECTION("test slice")
+		{
+			m::Wave slice(3);
+			slice.makeSlice(wave, 100, 200);
+
+			REQUIRE(slice.countFrames() == 100);
+			REQUIRE(slice.getRate() == SAMPLE_RATE);
+			REQUIRE(slice.getChunk(0).data == wave.getChunk(100).data);
+
+			/* Writing to the original leaves the slice untouched. */
+
+			wave.getBuffer()[100][0] = 1.0f;
+
+			REQUIRE(slice.getChunk(0).data[0] == 0.0f);
+		}
+
+		SECTION("test whole slice")
+		{
+			m::Wave slice(3);
+			slice.makeSlice(wave, 0, BUFFER_SIZE);
+
+			REQUIRE(slice.isConsolidated());
+			REQUIRE(slice.getSharedBuffer() == wave.getSharedBuffer());
+		}
+	}
+
+	SECTION("test revisions")
+	{
+		/* Same ID, different content: revisions never match. */
+
+		m::Wave a(1);
+		m::Wave b(1);
+		a.alloc(BUFFER_SIZE, CHANNELS, SAMPLE_RATE, BIT_DEPTH, "path/to/a.wav");
+		b.alloc(BUFFER_SIZE, CHANNELS, SAMPLE_RATE, BIT_DEPTH, "path/to/b.wav");
+
+		REQUIRE(a.getRevision() != b.getRevision());
+
+		/* A copy shares the same content, hence the same revision. */
+
+		const m::Wave copy(a);
+
+		REQUIRE(copy.getRevision() == a.getRevision());
+
+		a.cut(0, 10);
+
+		REQUIRE(copy.getRevision() != a.getRevision());
+	}
 }
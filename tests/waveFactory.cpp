@@ -3,6 +3,7 @@
 #include "../src/core/resampler.h"
 #include "../src/core/wave.h"
 #include <catch2/catch.hpp>
+#include <filesystem>
 #include <memory>
 #include <samplerate.h>
 
@@ -56,4 +57,73 @@ TEST_CASE("waveFactory")
 		REQUIRE(res.wave->isLogical() == false);
 		REQUIRE(res.wave->isEdited() == false);
 	}
+
+	SECTION("test shared data")
+	{
+		waveFactory::Result res1 = waveFactory::createFromFile(TEST_RESOURCES_DIR "test.wav",
+		    /*ID=*/0, /*sampleRate=*/G_SAMPLE_RATE, Resampler::Quality::LINEAR);
+		waveFactory::Result res2 = waveFactory::createFromFile(TEST_RESOURCES_DIR "test.wav",
+		    /*ID=*/0, /*sampleRate=*/G_SAMPLE_RATE, Resampler::Quality::LINEAR);
+
+		REQUIRE(res1.wave->id != res2.wave->id);
+		REQUIRE(res1.wave->getSharedBuffer() == res2.wave->getSharedBuffer());
+		REQUIRE(res2.wave->getBits() == res1.wave->getBits());
+
+		SECTION("test clone")
+		{
+			std::unique_ptr<Wave> clone = waveFactory::createFromWave(*res1.wave);
+
+			REQUIRE(clone->isConsolidated());
+			REQUIRE(clone->getSharedBuffer() == res1.wave->getSharedBuffer());
+			REQUIRE(clone->isLogical() == true);
+		}
+
+		SECTION("test slice")
+		{
+			std::unique_ptr<Wave> slice = waveFactory::createFromWave(*res1.wave, 10, 20);
+
+			REQUIRE(slice->countFrames() == 10);
+			REQUIRE(slice->getChunk(0).data == res1.wave->getChunk(10).data);
+		}
+	}
+
+	SECTION("test lossless compression")
+	{
+		waveFactory::Result res = waveFactory::createFromFile(TEST_RESOURCES_DIR "test.wav",
+		    /*ID=*/0, /*sampleRate=*/G_SAMPLE_RATE, Resampler::Quality::LINEAR);
+
+		REQUIRE(waveFactory::canCompress(*res.wave));
+
+		SECTION("test transcoding")
+		{
+			const std::string path = (std::filesystem::temp_directory_path() / "giada-test.flac").string();
+
+			waveFactory::SaveRequest req{*res.wave, TEST_RESOURCES_DIR "test.wav"};
+			req.wave.setPath(path);
+
+			REQUIRE(waveFactory::save(req) == G_RES_OK);
+
+			waveFactory::Result flac = waveFactory::createFromFile(path, /*ID=*/0,
+			    /*sampleRate=*/G_SAMPLE_RATE, Resampler::Quality::LINEAR);
+
+			REQUIRE(flac.status == G_RES_OK);
+			REQUIRE(flac.wave->countFrames() == res.wave->countFrames());
+			for (int i = 0; i < flac.wave->countFrames(); i++)
+				REQUIRE(flac.wave->getBuffer()[i][0] == res.wave->getBuffer()[i][0]);
+
+			std::filesystem::remove(path);
+		}
+
+		SECTION("test edited")
+		{
+			res.wave->setEdited(true);
+			REQUIRE_FALSE(waveFactory::canCompress(*res.wave));
+		}
+
+		SECTION("test resampled")
+		{
+			waveFactory::resample(*res.wave.get(), Resampler::Quality::LINEAR, G_SAMPLE_RATE * 2);
+			REQUIRE_FALSE(waveFactory::canCompress(*res.wave));
+		}
+	}
 }
@@ -100,3 +100,91 @@ TEST_CASE("waveFx")
 		REQUIRE(waveStereo.getBuffer()[b][1] == 0.0f);
 	}
 }
+
+TEST_CASE("waveFx (buffer)")
+{
+	/* Big enough to be split in several chunks. */
+
+	static const int FRAMES   = 300000;
+	static const int CHANNELS = 2;
+
+	mcl::AudioBuffer buffer(FRAMES, CHANNELS);
+	for (int i = 0; i < FRAMES; i++)
+	{
+		buffer[i][0] = static_cast<float>(i);
+		buffer[i][1] = static_cast<float>(-i);
+	}
+
+	wfx::Progress progress;
+
+	SECTION("test reverse")
+	{
+		const int a = 1000;
+		const int b = 250000;
+
+		mcl::AudioBuffer out = wfx::reverse(buffer, a, b, progress);
+
+		REQUIRE(out.countFrames() == FRAMES);
+		REQUIRE(out[a - 1][0] == buffer[a - 1][0]);
+		REQUIRE(out[a][0] == buffer[b - 1][0]);
+		REQUIRE(out[a][1] == buffer[b - 1][1]); // Channels keep their order
+		REQUIRE(out[b - 1][0] == buffer[a][0]);
+		REQUIRE(out[b][0] == buffer[b][0]);
+		REQUIRE(progress.get() == 1.0f);
+	}
+
+	SECTION("test shift")
+	{
+		mcl::AudioBuffer right = wfx::shift(buffer, 100, progress);
+		mcl::AudioBuffer left  = wfx::shift(buffer, -100, progress);
+
+		REQUIRE(right[100][0] == buffer[0][0]);
+		REQUIRE(right[0][1] == buffer[FRAMES - 100][1]);
+		REQUIRE(left[0][0] == buffer[100][0]);
+		REQUIRE(left[FRAMES - 100][1] == buffer[0][1]);
+	}
+
+	SECTION("test cut and paste")
+	{
+		const int a = 70000;
+		const int b = 140000;
+
+		mcl::AudioBuffer selection = wfx::trim(buffer, a, b, progress);
+		mcl::AudioBuffer cut       = wfx::cut(buffer, a, b, progress);
+		mcl::AudioBuffer pasted    = wfx::paste(selection, cut, a, progress);
+
+		REQUIRE(selection.countFrames() == b - a);
+		REQUIRE(cut.countFrames() == FRAMES - (b - a));
+		REQUIRE(cut[a][0] == buffer[b][0]);
+		REQUIRE(pasted.countFrames() == FRAMES);
+		for (int i = 0; i < FRAMES; i += 997)
+		{
+			REQUIRE(pasted[i][0] == buffer[i][0]);
+			REQUIRE(pasted[i][1] == buffer[i][1]);
+		}
+	}
+
+	SECTION("test normalize")
+	{
+		for (int i = 0; i < FRAMES; i++)
+		{
+			buffer[i][0] = 0.1f;
+			buffer[i][1] = 0.0f;
+		}
+		buffer[200000][1] = -0.5f; // Peak on the second channel
+
+		mcl::AudioBuffer out = wfx::normalize(buffer, 0, FRAMES, progress);
+
+		REQUIRE(out[200000][1] == Approx(-1.0f));
+		REQUIRE(out[0][0] == Approx(0.2f));
+	}
+
+	SECTION("test cancel")
+	{
+		progress.cancel();
+		wfx::silence(buffer, 0, FRAMES, progress);
+
+		REQUIRE(progress.isCancelled());
+		REQUIRE(progress.get() == 0.0f);
+	}
+}
@@ -0,0 +1,128 @@
+#include "../src/core/wavePeaks.h"
+#include "../src/core/peakCache.h"
+#include "../src/core/wave.h"
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+TEST_CASE("WavePeaks")
+{
+	using namespace giada;
+
+	constexpr int FRAMES   = 100000;
+	constexpr int CHANNELS = 2;
+
+	/* A sine wave, with a spike in the middle. Channels are equal so that the
+	averaged signal matches each one of them. */
+
+	m::Wave wave(1);
+	wave.alloc(FRAMES, CHANNELS, 44100, 32, "path/to/sample.wav");
+	for (int i = 0; i < FRAMES; i++)
+	{
+		const float v = i == FRAMES / 2 ? 1.0f : 0.5f * std::sin(i * 0.01f);
+
+		wave.getBuffer()[i][0] = v;
+		wave.getBuffer()[i][1] = v;
+	}
+
+	auto scan = [&wave](Frame a, Frame b) {
+		float min = 1.0f, max = -1.0f;
+		for (Frame i = a; i < b; i++)
+		{
+			min = std::min(min, wave.getChunk(i).data[0]);
+			max = std::max(max, wave.getChunk(i).data[0]);
+		}
+		return std::make_pair(min, max);
+	};
+
+	m::WavePeaks peaks(wave);
+
+	REQUIRE(peaks.countFrames() == FRAMES);
+
+	SECTION("Test whole range")
+	{
+		m::WavePeaks::Peak peak = peaks.get(wave, 0, FRAMES);
+
+		REQUIRE(peak.max == 1.0f);
+		REQUIRE(peak.min == Approx(-0.5f).margin(0.001f));
+		REQUIRE(peak.rms == Approx(0.5f / std::sqrt(2.0f)).margin(0.01f));
+	}
+
+	SECTION("Test small range")
+	{
+		/* Below the block size: computed on raw data, must be exact. */
+
+		const auto [min, max]   = scan(1000, 1100);
+		m::WavePeaks::Peak peak = peaks.get(wave, 1000, 1100);
+
+		REQUIRE(peak.min == min);
+		REQUIRE(peak.max == max);
+	}
+
+	SECTION("Test any zoom level")
+	{
+		/* Blocks straddling the edges may extend the range a little: peaks can
+		only be larger than the real ones, never smaller. */
+
+		for (Frame size : {1, 100, 1000, 5000, 20000})
+			for (Frame a = 0; a + size <= FRAMES; a += size * 3 + 7)
+			{
+				const auto [min, max]   = scan(a, a + size);
+				m::WavePeaks::Peak peak = peaks.get(wave, a, a + size);
+
+				REQUIRE(peak.min <= min);
+				REQUIRE(peak.max >= max);
+			}
+	}
+
+	SECTION("Test edited Wave")
+	{
+		wave.cut(FRAMES / 2 - 10, FRAMES / 2 + 10);
+
+		m::WavePeaks edited(wave);
+
+		REQUIRE(edited.countFrames() == FRAMES - 20);
+		REQUIRE(edited.get(wave, 0, FRAMES - 20).max < 1.0f);
+	}
+}
+
+TEST_CASE("PeakCache")
+{
+	using namespace giada;
+
+	m::Wave wave(1);
+	wave.alloc(10000, 2, 44100, 32, "path/to/sample.wav");
+
+	m::PeakCache cache;
+
+	auto waitFor = [&cache](const m::Wave& w) {
+		for (int i = 0; i < 500; i++)
+		{
+			if (auto peaks = cache.get(w); peaks != nullptr)
+				return peaks;
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		}
+		return std::shared_ptr<const m::WavePeaks>();
+	};
+
+	cache.request(wave);
+
+	auto peaks = waitFor(wave);
+
+	REQUIRE(peaks != nullptr);
+	REQUIRE(peaks->countFrames() == 10000);
+
+	SECTION("Test out of date")
+	{
+		wave.cut(0, 5000);
+
+		REQUIRE(cache.get(wave) == nullptr);
+
+		auto updated = waitFor(wave);
+
+		REQUIRE(updated != nullptr);
+		REQUIRE(updated->countFrames() == 5000);
+	}
+}
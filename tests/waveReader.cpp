@@ -69,4 +69,23 @@ TEST_CASE("WaveReader")
 			REQUIRE(numFramesFilled == res.generated);
 		}
 	}
+
+	SECTION("Test fill, edited Wave")
+	{
+		/* Remove the first half: frames are now read from the second half of the
+		original buffer, through the segment list. */
+
+		wave.cut(0, BUFFER_SIZE / 2);
+
+		mcl::AudioBuffer out(BUFFER_SIZE, NUM_CHANNELS);
+
+		m::WaveReader::Result res = waveReader.fill(out,
+		    /*start=*/0, wave.countFrames(), /*offset=*/0, /*pitch=*/1.0f);
+
+		REQUIRE(res.used == BUFFER_SIZE / 2);
+		REQUIRE(res.generated == BUFFER_SIZE / 2);
+		REQUIRE(out[0][0] == static_cast<float>(BUFFER_SIZE / 2 + 1));
+		REQUIRE(out[(BUFFER_SIZE / 2) - 1][0] == static_cast<float>(BUFFER_SIZE));
+		REQUIRE(out[BUFFER_SIZE / 2][0] == 0.0f);
+	}
 }